@@ -38,6 +38,10 @@ void CommandLineOptions::parse(int argc, char* argv[])
     bool     encode  = false;
     bool     hexdump = false;
     bool     info    = false;
+    bool     stats   = false;
+    bool     diff    = false;
+    bool     analyse = false;
+    bool     evaluate = false;
 
     uint16_t palette = 1;
     uint16_t format  = 2;
@@ -55,11 +59,28 @@ void CommandLineOptions::parse(int argc, char* argv[])
             ("e,encode",    "Encodes a GRF file from YAGL script and sprite sheets", cxxopts::value<bool>(encode))
             ("x,hexdump",   "Reads a GRF file and dumps it to hex somewhat like NFO", cxxopts::value<bool>(hexdump))
             ("i,info",      "Display information about YAGL items, such as 'Feature:Trains'", cxxopts::value<bool>(info))
+            ("stats",       "Reads a GRF file and writes a JSON report of its contents and compression", cxxopts::value<bool>(stats))
+            ("diff",        "Compares two GRF files record by record: --diff <grf_file> <other_grf_file>", cxxopts::value<bool>(diff))
+            ("analyse",     "Reads a GRF file and reports the cost of evaluating its Action02 chains", cxxopts::value<bool>(analyse))
+            ("evaluate",    "Evaluates an Action02 chain with variables from a JSON file: --evaluate <grf_file> <json_file>", cxxopts::value<bool>(evaluate))
 
             // Other options
             ("p,palette",   "Choose the initial palette for the GRF", cxxopts::value<uint16_t>(palette), "<idx>")
             ("w,width",     "Maximum width of sprite sheets", cxxopts::value<uint16_t>(m_width), "<num>")
             ("h,height",    "Maximum height of sprite sheets", cxxopts::value<uint16_t>(m_height), "<num>")
+            ("stream",      "Encode each record as soon as it is parsed, to limit memory use", cxxopts::value<bool>(m_stream))
+            ("nfo",         "With --hexdump, write NFO which grfcodec can compile instead", cxxopts::value<bool>(m_nfo))
+            ("optimise",    "With --decode or --encode, rewrite the Action02 logic: simplify and bypass switches, merge duplicate sets and sprites, and remove sets which no Action03 can reach", cxxopts::value<bool>(m_optimise))
+            ("crop",        "With --decode or --encode, remove transparent borders from sprites not marked no_crop", cxxopts::value<bool>(m_crop))
+            ("best-compression", "With --encode, write each sprite chunked or plain, whichever is smaller", cxxopts::value<bool>(m_best_compression))
+            ("specialise",  "With --decode or --encode, remove records which are never loaded with the parameters in a JSON file", cxxopts::value<std::string>(m_specialise_file), "<file>")
+            ("budget-vars",    "With --analyse, flag chains which may read more variables", cxxopts::value<uint32_t>(m_budget_vars), "<num>")
+            ("budget-params",  "With --analyse, flag chains which may read more 60+x variables", cxxopts::value<uint32_t>(m_budget_params), "<num>")
+            ("budget-storage", "With --analyse, flag chains which may use storage more often", cxxopts::value<uint32_t>(m_budget_storage), "<num>")
+            ("iterations",  "With --evaluate, run this many evaluations with random values for unlisted variables", cxxopts::value<uint32_t>(m_iterations), "<num>")
+            ("profile",     "Write a Chrome trace of the time spent in each stage", cxxopts::value<std::string>(m_profile_file), "<file>")
+            ("timings",     "Print a summary of the time spent in each stage", cxxopts::value<bool>(m_timings))
+            ("j,jobs",      "Number of worker threads, which defaults to the number of hardware threads", cxxopts::value<uint32_t>(m_jobs), "<num>")
             ("v,version",   "Print version information")
             ("help",        "Print help")
 
@@ -89,15 +110,15 @@ void CommandLineOptions::parse(int argc, char* argv[])
         }
 
         // Make sure that one and only one operation is selected.
-        uint16_t operation = decode + encode + hexdump + info;
+        uint16_t operation = decode + encode + hexdump + info + stats + diff + analyse + evaluate;
         if (operation > 1)
         {
-            std::cout << "ERROR: The --encode.-e, --decode,-d, --info,-i, and --hexdump,-x options are mutually exclusive\n";
+            std::cout << "ERROR: The --encode.-e, --decode,-d, --info,-i, --hexdump,-x, --stats, --diff, --analyse and --evaluate options are mutually exclusive\n";
             exit(1);
         }
         if (operation == 0)
         {
-            std::cout << "ERROR: One of the --encode.-e, --decode,-d, --info,-i, or --hexdump,-x options is required\n";
+            std::cout << "ERROR: One of the --encode.-e, --decode,-d, --info,-i, --hexdump,-x, --stats, --diff, --analyse or --evaluate options is required\n";
             exit(1);
         }
         
@@ -105,6 +126,27 @@ void CommandLineOptions::parse(int argc, char* argv[])
         if (decode)  m_operation = Operation::Decode;
         if (hexdump) m_operation = Operation::HexDump;
         if (info)    m_operation = Operation::Info;
+        if (stats)   m_operation = Operation::Stats;
+        if (diff)    m_operation = Operation::Diff;
+        if (analyse) m_operation = Operation::Analyse;
+        if (evaluate) m_operation = Operation::Evaluate;
+
+        // Records are written as soon as they are parsed when streaming, so cannot be removed
+        // or changed.
+        if ((m_optimise || m_crop || m_best_compression || !m_specialise_file.empty()) && m_stream)
+        {
+            std::cout << "ERROR: The --optimise, --crop, --best-compression and --specialise options cannot be used with --stream\n";
+            exit(1);
+        }
+        if (!m_specialise_file.empty())
+        {
+            m_specialise_file = fs::path(m_specialise_file).make_preferred().string();
+            if (!fs::is_regular_file(m_specialise_file))
+            {
+                std::cout << "ERROR: File '" << m_specialise_file << "' does not exist\n";
+                exit(1);
+            }
+        }
 
         // We don't care about the other options if this is an information dump.
         if (m_operation == Operation::Info)
@@ -126,15 +168,51 @@ void CommandLineOptions::parse(int argc, char* argv[])
             exit(1);
         }
 
+        // We repurpose the second positional parameter from YAGL directory to the other GRF.
+        if (m_operation == Operation::Diff)
+        {
+            if (!result.count("yagl_dir"))
+            {
+                std::cout << "ERROR: The --diff option requires the names of two GRF files\n";
+                exit(1);
+            }
+            m_diff_file = fs::path(m_yagl_dir).make_preferred().string();
+            if (!fs::is_regular_file(m_diff_file))
+            {
+                std::cout << "ERROR: File '" << m_diff_file << "' does not exist\n";
+                exit(1);
+            }
+        }
+
+        // Likewise, to the variable values for the evaluation.
+        if (m_operation == Operation::Evaluate)
+        {
+            if (!result.count("yagl_dir"))
+            {
+                std::cout << "ERROR: The --evaluate option requires the names of a GRF file and a JSON file\n";
+                exit(1);
+            }
+            m_env_file = fs::path(m_yagl_dir).make_preferred().string();
+            if (!fs::is_regular_file(m_env_file))
+            {
+                std::cout << "ERROR: File '" << m_env_file << "' does not exist\n";
+                exit(1);
+            }
+        }
+
         // These are all the paths we might need. Image base is extended to create the name of each sprite sheet.
         std::string grf_name = fs::path(m_grf_file).filename().string();
         m_grf_file   = fs::path(m_grf_file).make_preferred().string();
         m_yagl_dir   = fs::path(m_grf_file).parent_path().append(m_yagl_dir).make_preferred().string();
         m_yagl_file  = fs::path(m_yagl_dir).append(grf_name).replace_extension("yagl").make_preferred().string();
         m_hex_file   = fs::path(m_yagl_file).replace_extension("hex").make_preferred().string();
+        m_nfo_file   = fs::path(m_yagl_file).replace_extension("nfo").make_preferred().string();
+        m_stats_file = fs::path(m_yagl_file).replace_extension("json").make_preferred().string();
         m_image_base = fs::path(m_yagl_file).replace_extension().make_preferred().string();
 
-        if ((m_operation == Operation::Decode) || (m_operation == Operation::HexDump))
+        if ((m_operation == Operation::Decode) || (m_operation == Operation::HexDump) ||
+            (m_operation == Operation::Stats) || (m_operation == Operation::Diff) ||
+            (m_operation == Operation::Analyse) || (m_operation == Operation::Evaluate))
         {
             if (!fs::is_regular_file(m_grf_file))
             {
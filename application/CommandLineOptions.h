@@ -28,7 +28,7 @@
 class CommandLineOptions
 {
     public:
-        enum class Operation { Decode, Encode, HexDump, Info };
+        enum class Operation { Decode, Encode, HexDump, Info, Stats, Diff, Analyse, Evaluate };
 
     public:
         void parse(int argc, char* argv[]);
@@ -40,6 +40,10 @@ class CommandLineOptions
         const std::string& yagl_dir()   const { return m_yagl_dir; }
         const std::string& yagl_file()  const { return m_yagl_file; }
         const std::string& hex_file()   const { return m_hex_file; }
+        const std::string& nfo_file()   const { return m_nfo_file; }
+        const std::string& stats_file() const { return m_stats_file; }
+        const std::string& diff_file()  const { return m_diff_file; }
+        const std::string& env_file()   const { return m_env_file; }
         const std::string& image_base() const { return m_image_base; }
         const std::string& info_item()  const { return m_info_item; }
 
@@ -47,6 +51,19 @@ class CommandLineOptions
         uint32_t           height()     const { return m_height; }
         PaletteType        palette()    const { return m_palette; }
         uint8_t            chunk_gap()  const { return m_chunk_gap; }
+        bool               stream()     const { return m_stream; }
+        bool               nfo()        const { return m_nfo; }
+        bool               optimise()   const { return m_optimise; }
+        bool               crop()       const { return m_crop; }
+        bool               best_compression() const { return m_best_compression; }
+        const std::string& specialise_file() const { return m_specialise_file; }
+        uint32_t           budget_vars()    const { return m_budget_vars; }
+        uint32_t           budget_params()  const { return m_budget_params; }
+        uint32_t           budget_storage() const { return m_budget_storage; }
+        uint32_t           iterations() const { return m_iterations; }
+        const std::string& profile_file() const { return m_profile_file; }
+        bool               timings()    const { return m_timings; }
+        uint32_t           jobs()       const { return m_jobs; }
 
         bool               debug()      const { return m_debug; }
         const std::string& test_args()  const { return m_test_args; }
@@ -65,12 +82,29 @@ class CommandLineOptions
         uint16_t    m_height    = 16'000;                 // Max height of spritesheets
         PaletteType m_palette   = PaletteType::Default;
         uint8_t     m_chunk_gap = 3;                      // Join chunks in tiles gaps smaller than is.
+        bool        m_stream    = false;                  // Write records as they are parsed when encoding.
+        bool        m_nfo       = false;                  // Hex dump as grfcodec NFO.
+        bool        m_optimise  = false;                  // Remove unused Action01 and Action02 records.
+        bool        m_crop      = false;                  // Remove transparent borders from sprites.
+        bool        m_best_compression = false;           // Choose chunked or plain for each sprite.
+        std::string m_specialise_file;                    // The JSON configuration to specialise the GRF for, if any.
+        uint32_t    m_budget_vars    = 32;                // Limits for each Action02 chain with --analyse.
+        uint32_t    m_budget_params  = 8;
+        uint32_t    m_budget_storage = 8;
+        uint32_t    m_iterations = 1;                     // Fuzz the chain with --evaluate if more than one.
+        std::string m_profile_file;                       // Chrome trace output, if any.
+        bool        m_timings   = false;                  // Print a table of stage timings.
+        uint32_t    m_jobs      = 0;                      // Size of the thread pool, or zero for one per hardware thread.
         std::string m_info_item;
+        std::string m_diff_file;                          // The GRF to compare with m_grf_file.
+        std::string m_env_file;                           // The JSON variable values for --evaluate.
 
         // Calculated from m_grf_file and m_yagl_dir.
         std::string m_yagl_dir  = "sprites";
         std::string m_yagl_file;
         std::string m_hex_file;
+        std::string m_nfo_file;
+        std::string m_stats_file;
         std::string m_image_base;
 
         // Used for debugging
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "GRFDiff.h"
+#include "NewGRFData.h"
+#include "SequenceDiff.h"
+#include "ThreadPool.h"
+#include "TextBuffer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <string_view>
+
+
+namespace {
+
+// Large enough that the tasks are not dominated by the overhead of queueing them.
+constexpr uint32_t RecordsPerTask = 256;
+
+
+// Hashing a record means serialising it, so the work is shared out between threads.
+std::vector<std::future<std::vector<uint64_t>>> submit_hashes(const NewGRFData& grf,
+    const std::vector<const Record*>& records)
+{
+    std::vector<std::future<std::vector<uint64_t>>> futures;
+    for (uint32_t start = 0; start < records.size(); start += RecordsPerTask)
+    {
+        uint32_t end = std::min<uint32_t>(start + RecordsPerTask, uint32_t(records.size()));
+        futures.push_back(ThreadPool::pool().submit(
+            [&grf, &records, start, end]()
+            {
+                std::vector<uint64_t> hashes;
+                hashes.reserve(end - start);
+                for (uint32_t i = start; i < end; ++i)
+                {
+                    hashes.push_back(grf.content_hash(*records[i]));
+                }
+                return hashes;
+            }));
+    }
+    return futures;
+}
+
+
+std::vector<uint64_t> collect_hashes(std::vector<std::future<std::vector<uint64_t>>>& futures)
+{
+    std::vector<uint64_t> result;
+    for (auto& future: futures)
+    {
+        std::vector<uint64_t> hashes = ThreadPool::pool().get(future);
+        result.insert(result.end(), hashes.begin(), hashes.end());
+    }
+    return result;
+}
+
+
+// The tasks refer to the records, so they must all finish before an exception leaves the diff.
+// They are run here if need be, as this may be the only thread which would run them.
+void finish_hashes(std::vector<std::future<std::vector<uint64_t>>>& futures)
+{
+    for (auto& future: futures)
+    {
+        try
+        {
+            if (future.valid())
+                ThreadPool::pool().get(future);
+        }
+        catch (...)
+        {
+            // Only the first exception is passed on.
+        }
+    }
+}
+
+
+// The records are printed with a marker at the start of each line, as for a unified diff.
+void print_record(std::ostream& os, const NewGRFData& grf, const Record& record, char marker)
+{
+    TextBuffer text;
+    grf.print_record(text, record);
+
+    std::string lines = text.take();
+    std::size_t start = 0;
+    while (start < lines.size())
+    {
+        std::size_t end = lines.find('\n', start);
+        if (end == std::string::npos)
+            end = lines.size();
+        os << marker << ' ' << std::string_view{lines}.substr(start, end - start) << '\n';
+        start = end + 1;
+    }
+}
+
+
+// A run of removals and additions between two runs of matching records. These are paired
+// off in order and reported as changes, and any left over are reported as removed or added.
+struct Hunk
+{
+    uint32_t a_start{};
+    uint32_t a_length{};
+    uint32_t b_start{};
+    uint32_t b_length{};
+};
+
+
+std::vector<Hunk> make_hunks(const std::vector<DiffEdit>& edits)
+{
+    std::vector<Hunk> hunks;
+    bool in_hunk = false;
+    for (const auto& edit: edits)
+    {
+        if (edit.op == DiffEdit::Op::Equal)
+        {
+            in_hunk = false;
+            continue;
+        }
+
+        if (!in_hunk)
+        {
+            hunks.push_back({edit.a, 0, edit.b, 0});
+            in_hunk = true;
+        }
+
+        if (edit.op == DiffEdit::Op::Remove)
+            hunks.back().a_length += edit.length;
+        else
+            hunks.back().b_length += edit.length;
+    }
+    return hunks;
+}
+
+} // namespace {
+
+
+void diff_grfs(const NewGRFData& grf1, const NewGRFData& grf2, std::ostream& os)
+{
+    ScopedTimer timer{"Diff"};
+
+    std::vector<const Record*> records1 = grf1.data_records();
+    std::vector<const Record*> records2 = grf2.data_records();
+
+    auto futures1 = submit_hashes(grf1, records1);
+    auto futures2 = submit_hashes(grf2, records2);
+    std::vector<uint64_t> hashes1;
+    std::vector<uint64_t> hashes2;
+    try
+    {
+        hashes1 = collect_hashes(futures1);
+        hashes2 = collect_hashes(futures2);
+    }
+    catch (...)
+    {
+        finish_hashes(futures1);
+        finish_hashes(futures2);
+        throw;
+    }
+
+    std::vector<Hunk> hunks = make_hunks(diff_sequences(hashes1, hashes2));
+
+    uint32_t changed = 0;
+    uint32_t removed = 0;
+    uint32_t added   = 0;
+    for (const auto& hunk: hunks)
+    {
+        uint32_t paired = std::min(hunk.a_length, hunk.b_length);
+        changed += paired;
+        removed += hunk.a_length - paired;
+        added   += hunk.b_length - paired;
+    }
+    uint32_t unchanged = uint32_t(records1.size()) - changed - removed;
+
+    os << "Records:   " << records1.size() << " => " << records2.size() << "\n";
+    os << "Unchanged: " << unchanged << "\n";
+    os << "Changed:   " << changed << "\n";
+    os << "Removed:   " << removed << "\n";
+    os << "Added:     " << added << "\n";
+
+    // Record numbers count from one, as in the hex dump.
+    for (const auto& hunk: hunks)
+    {
+        uint32_t paired = std::min(hunk.a_length, hunk.b_length);
+        for (uint32_t i = 0; i < paired; ++i)
+        {
+            uint32_t a = hunk.a_start + i;
+            uint32_t b = hunk.b_start + i;
+            os << "\nChanged record #" << (a + 1) << " => #" << (b + 1) << "\n";
+            print_record(os, grf1, *records1[a], '-');
+            print_record(os, grf2, *records2[b], '+');
+        }
+        for (uint32_t a = hunk.a_start + paired; a < hunk.a_start + hunk.a_length; ++a)
+        {
+            os << "\nRemoved record #" << (a + 1) << "\n";
+            print_record(os, grf1, *records1[a], '-');
+        }
+        for (uint32_t b = hunk.b_start + paired; b < hunk.b_start + hunk.b_length; ++b)
+        {
+            os << "\nAdded record #" << (b + 1) << "\n";
+            print_record(os, grf2, *records2[b], '+');
+        }
+    }
+}
@@ -0,0 +1,30 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <iosfwd>
+
+
+class NewGRFData;
+
+
+// Compares two GRFs record by record. Matching records are aligned as in a text diff, so an
+// inserted record does not make everything after it appear to have changed. Only the records
+// which were changed, removed or added are printed. The GRFs are compared after decoding
+// rather than by their raw bytes, because the same image may be compressed differently.
+void diff_grfs(const NewGRFData& grf1, const NewGRFData& grf2, std::ostream& os);
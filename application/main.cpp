@@ -24,6 +24,9 @@
 #include "Version.h"
 #include "FileSystem.h"
 #include "InfoDump.h"
+#include "GRFDiff.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
 // Unit testing framework
 #define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
@@ -61,6 +64,19 @@ static std::ofstream open_write_file(const std::string& file_name)
 }
 
 
+// Reads the configuration and removes whatever the GRF would not load with it.
+static void specialise(NewGRFData& grf_data)
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    std::cout << "Reading JSON:     " << options.specialise_file() << std::endl;
+    std::ifstream is = open_read_file(options.specialise_file());
+    TokenStream token_stream{is};
+    auto profile = GRFSpecialiser::Profile::parse(token_stream);
+    grf_data.specialise(profile);
+}
+
+
 static void decode()
 {
     CommandLineOptions& options = CommandLineOptions::options();
@@ -81,6 +97,18 @@ static void decode()
         NewGRFData grf_data;
         std::ifstream is = open_read_file(options.grf_file());
         grf_data.read(is);
+        if (!options.specialise_file().empty())
+        {
+            specialise(grf_data);
+        }
+        if (options.optimise())
+        {
+            grf_data.optimise();
+        }
+        if (options.crop())
+        {
+            grf_data.crop_sprites();
+        }
 
         // Write out the YAGL file and associated sprite sheets ...
         std::cout << "Writing YAGL and other files..." << std::endl;
@@ -94,6 +122,49 @@ static void decode()
 }
 
 
+static void back_up_grf()
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    fs::path grf_file = options.grf_file();
+    if (fs::is_regular_file(grf_file))
+    {
+        fs::path bak_file = grf_file;
+        bak_file.replace_extension("grf.bak");
+
+        std::cout << "Creating back up GRF: " << grf_file.string() << " => " << bak_file.string() << std::endl;
+        fs::rename(grf_file, bak_file);
+    }
+}
+
+
+// The GRF is written while the YAGL is being parsed, so the back up has to be made first.
+// If parsing fails the partially written GRF is removed.
+static void stream_encode(TokenStream& token_stream)
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    back_up_grf();
+
+    fs::path spool_file = options.grf_file();
+    spool_file.replace_extension("grf.spool");
+
+    std::cout << "Parsing YAGL and writing GRF (" << token_stream.num_tokens() << " tokens) ..." << std::endl;
+    try
+    {
+        NewGRFData grf_data;
+        std::ofstream os = open_write_file(options.grf_file());
+        grf_data.stream_encode(token_stream, os, spool_file.string());
+    }
+    catch (const std::exception&)
+    {
+        std::cout << "Removing incomplete GRF: " << options.grf_file() << std::endl;
+        fs::remove(options.grf_file());
+        throw;
+    }
+}
+
+
 static void encode()
 {
     CommandLineOptions& options = CommandLineOptions::options();
@@ -112,22 +183,36 @@ static void encode()
         std::ifstream is = open_read_file(options.yagl_file());
         TokenStream token_stream{is};
 
+        if (options.stream())
+        {
+            stream_encode(token_stream);
+            return;
+        }
+
         // Parse the YAGL script ...
         std::cout << "Parsing YAGL (" << token_stream.num_tokens() << " tokens) ..." << std::endl;
         NewGRFData grf_data;
         grf_data.parse(token_stream, options.yagl_dir(), options.image_base());
-
-        // Back up the GRF before overwriting it ...
-        fs::path grf_file = options.grf_file();
-        if (fs::is_regular_file(grf_file))
+        if (!options.specialise_file().empty())
         {
-            fs::path bak_file = grf_file;
-            bak_file.replace_extension("grf.bak");
-
-            std::cout << "Creating back up GRF: " << grf_file.string() << " => " << bak_file.string() << std::endl;
-            fs::rename(grf_file, bak_file);
+            specialise(grf_data);
+        }
+        if (options.optimise())
+        {
+            grf_data.optimise();
+        }
+        if (options.crop())
+        {
+            grf_data.crop_sprites();
+        }
+        if (options.best_compression())
+        {
+            grf_data.choose_sprite_compression();
         }
 
+        // Back up the GRF before overwriting it ...
+        back_up_grf();
+
         // Write out the GRF file ...
         std::cout << "Writing GRF..." << std::endl;
         std::ofstream os = open_write_file(options.grf_file());
@@ -150,7 +235,10 @@ static void hex_dump()
         fs::create_directory(options.yagl_dir());
 
         std::cout << "Reading GRF:      " << options.grf_file() << "\n";
-        std::cout << "Writing HEX:      " << options.yagl_file() << "\n";
+        if (options.nfo())
+            std::cout << "Writing NFO:      " << options.nfo_file() << "\n";
+        else
+            std::cout << "Writing HEX:      " << options.hex_file() << "\n";
         std::cout << "Output directory: " << options.yagl_dir() << "\n";
 
         // Read in the GRF file ...
@@ -160,6 +248,15 @@ static void hex_dump()
         std::ifstream is = open_read_file(options.grf_file());
         grf_data.read(is);
 
+        if (options.nfo())
+        {
+            // Write out the NFO file and the sprite sheets it refers to...
+            std::cout << "Writing NFO..." << std::endl;
+            std::ofstream os = open_write_file(options.nfo_file());
+            grf_data.nfo_dump(os, options.image_base());
+            return;
+        }
+
         // Write out the HEX file...
         std::cout << "Writing HEX..." << std::endl;
         std::ofstream os = open_write_file(options.hex_file());
@@ -172,6 +269,131 @@ static void hex_dump()
 }
 
 
+static void stats()
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    try
+    {
+        // We first create the sub-directory for the output files.
+        fs::create_directory(options.yagl_dir());
+
+        std::cout << "Reading GRF:      " << options.grf_file() << "\n";
+        std::cout << "Writing stats:    " << options.stats_file() << "\n" << std::endl;
+
+        // Read in the GRF file ...
+        // The GRF file already checked for existence.
+        std::cout << "Reading GRF..." << std::endl;
+        NewGRFData grf_data;
+        std::ifstream is = open_read_file(options.grf_file());
+        grf_data.read(is);
+
+        // Write out the JSON report...
+        std::cout << "Writing stats..." << std::endl;
+        std::ofstream os = open_write_file(options.stats_file());
+        grf_data.stats(os);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+    }
+}
+
+
+static void diff()
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    try
+    {
+        std::cout << "Comparing GRF:    " << options.grf_file() << "\n";
+        std::cout << "With GRF:         " << options.diff_file() << "\n" << std::endl;
+
+        // Read in both GRF files at the same time ...
+        // The GRF files already checked for existence.
+        std::cout << "Reading GRFs..." << std::endl;
+        auto read_grf = [](const std::string& file_name)
+        {
+            auto grf_data = std::make_unique<NewGRFData>();
+            std::ifstream is = open_read_file(file_name);
+            grf_data->read(is);
+            return grf_data;
+        };
+        auto future1 = ThreadPool::pool().submit([&]() { return read_grf(options.grf_file()); });
+        auto future2 = ThreadPool::pool().submit([&]() { return read_grf(options.diff_file()); });
+        std::unique_ptr<NewGRFData> grf_data1 = ThreadPool::pool().get(future1);
+        std::unique_ptr<NewGRFData> grf_data2 = ThreadPool::pool().get(future2);
+
+        // Write the differences to the console...
+        std::cout << "Comparing records..." << std::endl;
+        diff_grfs(*grf_data1, *grf_data2, std::cout);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+    }
+}
+
+
+static void analyse()
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    try
+    {
+        std::cout << "Reading GRF:      " << options.grf_file() << "\n" << std::endl;
+
+        // Read in the GRF file ...
+        // The GRF file already checked for existence.
+        std::cout << "Reading GRF..." << std::endl;
+        NewGRFData grf_data;
+        std::ifstream is = open_read_file(options.grf_file());
+        grf_data.read(is);
+
+        // Write the report to the console...
+        ChainBudgets budgets;
+        budgets.variables     = options.budget_vars();
+        budgets.parameterised = options.budget_params();
+        budgets.storage       = options.budget_storage();
+        grf_data.analyse(std::cout, budgets);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+    }
+}
+
+
+
+static void evaluate()
+{
+    CommandLineOptions& options = CommandLineOptions::options();
+
+    try
+    {
+        std::cout << "Reading GRF:      " << options.grf_file() << "\n";
+        std::cout << "Reading JSON:     " << options.env_file() << "\n" << std::endl;
+
+        // Read in the GRF file and the variable values ...
+        // The files already checked for existence.
+        std::cout << "Reading GRF..." << std::endl;
+        NewGRFData grf_data;
+        std::ifstream is = open_read_file(options.grf_file());
+        grf_data.read(is);
+
+        std::ifstream env_is = open_read_file(options.env_file());
+        TokenStream token_stream{env_is};
+        auto env = ChainEvaluator::Environment::parse(token_stream);
+
+        // Write the result to the console...
+        grf_data.evaluate(std::cout, env, options.iterations());
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+    }
+}
+
 std::vector<std::string> split(const std::string& str)
 {
     std::vector<std::string> result;
@@ -194,6 +416,13 @@ int main (int argc, char* argv[])
 
     CommandLineOptions& options = CommandLineOptions::options();
     options.parse(argc, argv);
+    ThreadPool::set_pool_size(options.jobs());
+
+    Profiler& profiler = Profiler::profiler();
+    if (!options.profile_file().empty() || options.timings())
+    {
+        profiler.enable();
+    }
 
     switch (options.operation())
     {
@@ -212,6 +441,35 @@ int main (int argc, char* argv[])
         case CommandLineOptions::Operation::Info:
             info_dump();
             break;
+
+        case CommandLineOptions::Operation::Stats:
+            stats();
+            break;
+
+        case CommandLineOptions::Operation::Diff:
+            diff();
+            break;
+
+        case CommandLineOptions::Operation::Analyse:
+            analyse();
+            break;
+
+        case CommandLineOptions::Operation::Evaluate:
+            evaluate();
+            break;
+    }
+
+    if (!options.profile_file().empty())
+    {
+        std::cout << "Writing profile:  " << options.profile_file() << std::endl;
+        std::ofstream os = open_write_file(options.profile_file());
+        profiler.write_trace(os);
+    }
+
+    if (options.timings())
+    {
+        profiler.print_timings(std::cout);
+        profiler.print_workers(std::cout, ThreadPool::pool().worker_stats());
     }
 
     return 0;
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "Workloads.h"
+#include "LZ77.h"
+#include "ChunkEncoder.h"
+#include "RealSpriteRecord.h"
+#include "SpriteSheetGenerator.h"
+#include "FileSystem.h"
+#include <sstream>
+
+
+TEST_CASE("LZ77", "[bench][graphics]")
+{
+    const std::vector<uint8_t> pixels = GRFGenerator::make_pixels(256, 256, GRFGenerator::Colour::Palette, 0.4, 1);
+    const std::vector<uint8_t> compressed = encode_lz77(pixels);
+    const std::string data(compressed.begin(), compressed.end());
+
+    BENCHMARK("encode_lz77 256x256 8bpp")
+    {
+        return encode_lz77(pixels);
+    };
+
+    BENCHMARK("decode_lz77 256x256 8bpp")
+    {
+        std::istringstream is{data};
+        uint32_t input_size;
+        return decode_lz77(is, uint32_t(pixels.size()), input_size);
+    };
+}
+
+
+TEST_CASE("Chunk encoding", "[bench][graphics]")
+{
+    const uint8_t palette = RealSpriteRecord::HAS_PALETTE | RealSpriteRecord::CHUNKED_FORMAT;
+    const uint8_t rgba    = RealSpriteRecord::HAS_RGB | RealSpriteRecord::HAS_ALPHA | RealSpriteRecord::CHUNKED_FORMAT;
+
+    const std::vector<uint8_t> pixels8  = GRFGenerator::make_pixels(256, 256, GRFGenerator::Colour::Palette, 0.4, 2);
+    const std::vector<uint8_t> pixels32 = GRFGenerator::make_pixels(256, 256, GRFGenerator::Colour::RGBA, 0.4, 3);
+    const std::vector<uint8_t> chunks8  = encode_tile(pixels8, 256, 256, palette, GRFFormat::Container2);
+    const std::vector<uint8_t> chunks32 = encode_tile(pixels32, 256, 256, rgba, GRFFormat::Container2);
+
+    BENCHMARK("encode_tile 256x256 8bpp")
+    {
+        return encode_tile(pixels8, 256, 256, palette, GRFFormat::Container2);
+    };
+
+    BENCHMARK("decode_tile 256x256 8bpp")
+    {
+        return decode_tile(chunks8, 256, 256, palette, GRFFormat::Container2);
+    };
+
+    BENCHMARK("encode_tile 256x256 32bpp")
+    {
+        return encode_tile(pixels32, 256, 256, rgba, GRFFormat::Container2);
+    };
+
+    BENCHMARK("decode_tile 256x256 32bpp")
+    {
+        return decode_tile(chunks32, 256, 256, rgba, GRFFormat::Container2);
+    };
+}
+
+
+TEST_CASE("SpriteSheetGenerator", "[bench][graphics]")
+{
+    const SpriteZoomMap sprites = make_sprites(300);
+    const fs::path dir = fs::temp_directory_path() / "yagl_bench";
+    fs::create_directories(dir);
+    const std::string base = (dir / "sheet").string();
+
+    BENCHMARK("SpriteSheetGenerator 300 sprites")
+    {
+        SpriteSheetGenerator generator{sprites, base, GRFFormat::Container2};
+        generator.generate();
+    };
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "Workloads.h"
+#include "Action00Record.h"
+#include "Action00Trains.h"
+#include "NewGRFData.h"
+#include <iostream>
+#include <sstream>
+
+
+TEST_CASE("Action00Record", "[bench][records]")
+{
+    const std::string yagl = workload_generator().train_yagl(0);
+    SpriteZoomMap sprites;
+    GRFInfo info;
+
+    std::istringstream is{yagl};
+    TokenStream ts{is};
+    Action00Record record;
+    record.parse(ts, sprites);
+    std::ostringstream os;
+    record.write(os, info);
+    // Skip the action byte, which is read by NewGRFData.
+    const std::string data = os.str().substr(1);
+
+    BENCHMARK("Action00Record::read")
+    {
+        std::istringstream is{data};
+        Action00Record record;
+        record.read(is, info);
+        return record.feature();
+    };
+
+    BENCHMARK("Action00Record::print")
+    {
+        std::ostringstream os;
+        record.print(os, sprites, 0);
+        return os.str().size();
+    };
+
+    BENCHMARK("Action00Record::parse")
+    {
+        TokenStream view{ts, 0, ts.end()};
+        Action00Record record;
+        record.parse(view, sprites);
+        return record.feature();
+    };
+}
+
+
+TEST_CASE("Action00Record storage", "[bench][records]")
+{
+    // Every train in the workload sets the same properties, so one record is typical.
+    const std::string yagl = workload_generator().train_yagl(0);
+    SpriteZoomMap sprites;
+    GRFInfo info;
+
+    std::istringstream is{yagl};
+    TokenStream ts{is};
+    Action00Record record;
+    record.parse(ts, sprites);
+    std::ostringstream os;
+    record.write(os, info);
+    const std::string data = os.str().substr(1);
+
+    // The heap values are not counted in the bytes, as their size depends on the type.
+    std::size_t slots       = 0;
+    std::size_t heap_values = 0;
+    for (const auto& instance: record.instances())
+    {
+        slots       += instance->properties().num_values();
+        heap_values += instance->properties().num_heap_values();
+    }
+    const std::size_t instances = record.instances().size();
+    const std::size_t bytes     = instances * sizeof(Action00Trains) + slots * sizeof(PropertySlot);
+    std::cout << "Action00Record per instance: " << (double(slots) / instances) << " slots, ";
+    std::cout << (double(heap_values) / instances) << " heap values, ";
+    std::cout << (double(bytes) / instances) << " bytes\n";
+
+    // Only the construction is timed, not the destruction.
+    BENCHMARK_ADVANCED("Action00Record construct " + std::to_string(instances) + " instances")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Action00Record> records(meter.runs());
+        meter.measure([&records, &data, &info](int run)
+        {
+            std::istringstream is{data};
+            records[run].read(is, info);
+            return records[run].instances().size();
+        });
+    };
+}
+
+
+TEST_CASE("NewGRFData", "[bench][records]")
+{
+    const std::string grf = make_grf(500, 40);
+
+    BENCHMARK("NewGRFData read-write 1500 records 40 sprites")
+    {
+        std::istringstream is{grf};
+        NewGRFData grf_data;
+        grf_data.read(is);
+
+        std::ostringstream os;
+        grf_data.write(os);
+        return os.str().size();
+    };
+}
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "Workloads.h"
+#include "Lexer.h"
+#include "TokenStream.h"
+#include "GRFStrings.h"
+#include <sstream>
+
+
+TEST_CASE("Lexer", "[bench][text]")
+{
+    const std::string yagl = make_yagl(100);
+
+    BENCHMARK("Lexer::lex 200 records")
+    {
+        std::istringstream is{yagl};
+        Lexer lexer;
+        return lexer.lex(is);
+    };
+}
+
+
+TEST_CASE("TokenStream", "[bench][text]")
+{
+    std::istringstream is{make_yagl(100)};
+    TokenStream tokens{is};
+
+    BENCHMARK("TokenStream::find_record_ends 200 records")
+    {
+        return tokens.find_record_ends();
+    };
+
+    BENCHMARK("TokenStream::match 200 records")
+    {
+        // Peek and match every token, as a parser does.
+        TokenStream ts{tokens, tokens.index(), tokens.end()};
+        uint32_t count = 0;
+        while (ts.index() < ts.end())
+        {
+            count += uint32_t(ts.match(ts.peek().type).size());
+        }
+        return count;
+    };
+}
+
+
+TEST_CASE("GRF strings", "[bench][text]")
+{
+    const std::vector<std::string> strings = make_grf_strings(200);
+    std::vector<std::string> readable;
+    for (const auto& str: strings)
+    {
+        readable.push_back(grf_string_to_readable_utf8(str));
+    }
+
+    BENCHMARK("grf_string_to_readable_utf8 3200 strings")
+    {
+        std::size_t size = 0;
+        for (const auto& str: strings)
+            size += grf_string_to_readable_utf8(str).size();
+        return size;
+    };
+
+    BENCHMARK("readable_utf8_to_grf_string 3200 strings")
+    {
+        std::size_t size = 0;
+        for (const auto& str: readable)
+            size += readable_utf8_to_grf_string(str).size();
+        return size;
+    };
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "Workloads.h"
+#include "GRFStrings.h"
+#include <sstream>
+
+
+namespace {
+
+GRFGenerator::Config workload_config(uint32_t count, uint32_t num_sprites)
+{
+    GRFGenerator::Config config;
+    config.seed         = 0x5EED;
+    config.instances    = count * 8;
+    config.strings      = count * 16;
+    config.switches     = count;
+    config.sprites      = num_sprites;
+    config.colour       = GRFGenerator::Colour::RGBAMask;
+    config.transparency = 0.4;
+    return config;
+}
+
+} // namespace {
+
+
+const GRFGenerator& workload_generator()
+{
+    // Large enough for any of the workloads.
+    static const GRFGenerator generator{workload_config(10'000, 10'000)};
+    return generator;
+}
+
+
+SpriteZoomMap make_sprites(uint32_t count)
+{
+    SpriteZoomMap sprites;
+    for (uint32_t id = 1; id <= count; ++id)
+    {
+        sprites[id].push_back(workload_generator().make_sprite(id, GRFGenerator::ZoomLevel::Normal));
+    }
+    return sprites;
+}
+
+
+std::string make_yagl(uint32_t count)
+{
+    std::string result;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        result += workload_generator().train_yagl(i);
+        result += workload_generator().strings_yagl(i);
+    }
+    return result;
+}
+
+
+std::vector<std::string> make_grf_strings(uint32_t count)
+{
+    std::vector<std::string> result;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::istringstream is{workload_generator().strings_yagl(i)};
+        TokenStream ts{is};
+        // Skip the header to the first string.
+        while (ts.peek().type != TokenType::String)
+            ts.match(ts.peek().type);
+        while (ts.peek().type == TokenType::String)
+        {
+            result.push_back(readable_utf8_to_grf_string(ts.match(TokenType::String)));
+            ts.match(TokenType::SemiColon);
+        }
+    }
+    return result;
+}
+
+
+std::string make_grf(uint32_t count, uint32_t num_sprites)
+{
+    GRFGenerator generator{workload_config(count, num_sprites)};
+    std::ostringstream os;
+    generator.write(os);
+    return os.str();
+}
@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "GRFGenerator.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+// Deterministic inputs for the benchmarks, made with GRFGenerator from fixed seeds, so that
+// each run of yagl_bench measures exactly the same work, on every platform.
+
+// The generator used for all of the workloads below.
+const GRFGenerator& workload_generator();
+
+// Sprites of assorted sizes, with IDs starting from 1.
+SpriteZoomMap make_sprites(uint32_t count);
+
+// A script with count Action00 and count Action04 records.
+std::string make_yagl(uint32_t count);
+
+// The binary form of some GRF strings, with control codes and non-ASCII characters.
+std::vector<std::string> make_grf_strings(uint32_t count);
+
+// A complete Container2 GRF.
+std::string make_grf(uint32_t count, uint32_t num_sprites);
@@ -0,0 +1,494 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "GRFGenerator.h"
+#include "Action00Record.h"
+#include "Action02VariableRecord.h"
+#include "Action04Record.h"
+#include "Action08Record.h"
+#include "StreamHelpers.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <array>
+#include <sstream>
+
+
+namespace {
+
+// Container sizes for the pseudo-sprites.
+constexpr uint32_t InstancesPerRecord = 8;
+constexpr uint32_t StringsPerRecord   = 16;
+constexpr uint32_t SpritesPerSet      = 8;
+constexpr uint32_t MaxSetsPerRecord   = 255;
+
+constexpr std::array<uint8_t, 8> CONTAINER2_IDENTIFIER
+    = { 0x47, 0x52, 0x46, 0x82, 0x0D, 0x0A, 0x1A, 0x0A };
+
+constexpr std::array<const char*, 4> LANGUAGES = { "en_GB", "de_DE", "fr_FR", "nl_NL" };
+
+
+// A small xorshift generator. The standard distributions are not guaranteed to give the
+// same values on every platform.
+class Random
+{
+public:
+    explicit Random(uint32_t seed) : m_state{seed | 1U} {}
+
+    uint32_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    uint32_t next(uint32_t min, uint32_t max) { return min + next() % (max - min + 1); }
+
+private:
+    uint32_t m_state;
+};
+
+
+// Each record and sprite has its own seed so that it can be generated independently.
+uint32_t mix_seed(uint32_t seed, uint32_t index, uint32_t salt)
+{
+    uint32_t value = seed ^ (index * 0x9E3779B9U) ^ (salt * 0x85EBCA6BU);
+    value ^= value >> 16;
+    value *= 0x7FEB352DU;
+    value ^= value >> 15;
+    return value;
+}
+
+
+template <typename T>
+std::string record_data(const std::string& yagl, const GRFInfo& info)
+{
+    std::istringstream is{yagl};
+    TokenStream ts{is};
+    SpriteZoomMap sprites;
+    T record;
+    record.parse(ts, sprites);
+
+    std::ostringstream os;
+    record.write(os, info);
+    return os.str();
+}
+
+
+uint32_t pixel_size(GRFGenerator::Colour colour)
+{
+    switch (colour)
+    {
+        case GRFGenerator::Colour::Palette:  return 1;
+        case GRFGenerator::Colour::RGBA:     return 4;
+        case GRFGenerator::Colour::RGBAMask: return 5;
+    }
+    return 1;
+}
+
+
+uint8_t colour_bits(GRFGenerator::Colour colour)
+{
+    switch (colour)
+    {
+        case GRFGenerator::Colour::Palette:  return RealSpriteRecord::HAS_PALETTE;
+        case GRFGenerator::Colour::RGBA:     return RealSpriteRecord::HAS_RGB | RealSpriteRecord::HAS_ALPHA;
+        case GRFGenerator::Colour::RGBAMask: return RealSpriteRecord::HAS_RGB | RealSpriteRecord::HAS_ALPHA |
+                                                    RealSpriteRecord::HAS_PALETTE;
+    }
+    return RealSpriteRecord::HAS_PALETTE;
+}
+
+
+// The size of each image relative to the normal zoom level.
+uint16_t scale(uint16_t size, GRFGenerator::ZoomLevel zoom)
+{
+    using ZoomLevel = GRFGenerator::ZoomLevel;
+    switch (zoom)
+    {
+        case ZoomLevel::ZoomInX4:  return size * 4;
+        case ZoomLevel::ZoomInX2:  return size * 2;
+        case ZoomLevel::Normal:    return size;
+        case ZoomLevel::ZoomOutX2: return std::max<uint16_t>(size / 2, 1);
+        case ZoomLevel::ZoomOutX4: return std::max<uint16_t>(size / 4, 1);
+        case ZoomLevel::ZoomOutX8: return std::max<uint16_t>(size / 8, 1);
+    }
+    return size;
+}
+
+
+uint32_t divide_round_up(uint32_t value, uint32_t divisor)
+{
+    return (value + divisor - 1) / divisor;
+}
+
+
+// The number of sets, and of sprites in each set, for each Action01. Each record has up to
+// 255 full sets. Any leftover sprites which do not fill a set go in a final record.
+struct SpriteSets
+{
+    uint32_t num_sets;
+    uint32_t per_set;
+};
+
+std::vector<SpriteSets> sprite_sets(uint32_t num_sprites)
+{
+    std::vector<SpriteSets> result;
+    while (num_sprites > 0)
+    {
+        uint32_t per_set  = std::min(num_sprites, SpritesPerSet);
+        uint32_t num_sets = std::min(num_sprites / per_set, MaxSetsPerRecord);
+        result.push_back({num_sets, per_set});
+        num_sprites -= num_sets * per_set;
+    }
+    return result;
+}
+
+} // namespace {
+
+
+GRFGenerator::GRFGenerator(const Config& config)
+: m_config{config}
+{
+    m_info.format = config.format;
+
+    if (m_config.format == GRFFormat::Container1)
+    {
+        bool normal_only = (m_config.zooms.size() == 1) && (m_config.zooms[0] == ZoomLevel::Normal);
+        if (!normal_only || (m_config.colour != Colour::Palette))
+        {
+            throw RUNTIME_ERROR("Container1 supports only 8bpp sprites at normal zoom");
+        }
+    }
+    if (m_config.zooms.empty())
+    {
+        throw RUNTIME_ERROR("At least one zoom level is required");
+    }
+    if ((m_config.transparency < 0.0) || (m_config.transparency > 1.0))
+    {
+        throw RUNTIME_ERROR("Transparency must be between 0 and 1");
+    }
+}
+
+
+std::string GRFGenerator::train_yagl(uint32_t index) const
+{
+    Random random{mix_seed(m_config.seed, index, 1)};
+    uint32_t first = index * InstancesPerRecord;
+    uint32_t count = std::min(InstancesPerRecord, m_config.instances - first);
+
+    std::ostringstream os;
+    os << "properties<Trains, " << to_hex(uint16_t(first % 0x4000)) << ">\n";
+    os << "{\n";
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        os << "    {\n";
+        os << "        track_type: " << random.next(0, 3) << ";\n";
+        os << "        ai_special_flag: false;\n";
+        os << "        speed_kmh: " << random.next(40, 320) << ";\n";
+        os << "        power: " << random.next(100, 8000) << ";\n";
+        os << "        running_cost_factor: " << to_hex(uint8_t(random.next())) << ";\n";
+        os << "        running_cost_base: 0x00002F80;\n";
+        os << "        sprite_id: 0xFD;\n";
+        os << "        cargo_capacity: " << random.next(0, 80) << ";\n";
+        os << "        cargo_type: 0xFF;\n";
+        os << "        weight_tons: " << random.next(10, 200) << ";\n";
+        os << "        cost_factor: " << to_hex(uint8_t(random.next())) << ";\n";
+        os << "        engine_traction_type: 0x08;\n";
+        os << "        callback_flags_mask: 0x16;\n";
+        os << "        visual_effect: effect(SteamPuffs, 0x07, Disable);\n";
+        os << "        long_introduction_date: date(" << random.next(1850, 2050) << "/3/2);\n";
+        os << "        always_refittable_cargos: [ 0x02 0x04 0x16 ];\n";
+        os << "    }\n";
+    }
+    os << "}\n";
+    return os.str();
+}
+
+
+std::string GRFGenerator::strings_yagl(uint32_t index) const
+{
+    Random random{mix_seed(m_config.seed, index, 2)};
+    uint32_t first = index * StringsPerRecord;
+    uint32_t count = std::min(StringsPerRecord, m_config.strings - first);
+
+    std::ostringstream os;
+    os << "strings<Trains, " << LANGUAGES[index % LANGUAGES.size()] << ", ";
+    os << to_hex(uint16_t(0xD000 + first % 0x400)) << "*>\n";
+    os << "{\n";
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        switch (random.next() % 4)
+        {
+            case 0: os << "    \"{black}Locomotive " << random.next(1, 9999) << "\";\n"; break;
+            case 1: os << "    \"{lt-gray}Speed: {sw-speed}{new-line}Capacity: {uw}\";\n"; break;
+            case 2: os << "    \"{white}Built by Café & Co. {yellow}»{green}" << random.next() << "\";\n"; break;
+            case 3: os << "    \"{gold}Wagon {blue}" << random.next(1, 99) << "{red} – class " << random.next(1, 9) << "\";\n"; break;
+        }
+    }
+    os << "}\n";
+    return os.str();
+}
+
+
+std::string GRFGenerator::switch_yagl(uint32_t index) const
+{
+    Random random{mix_seed(m_config.seed, index, 3)};
+
+    std::ostringstream os;
+    os << "switch<Trains, " << to_hex(uint8_t(index)) << ", PrimaryDWord>\n";
+    os << "{\n";
+    os << "    expression:\n";
+    os << "    {\n";
+    os << "        value1 = variable[" << to_hex(uint8_t(random.next(0x40, 0x4F))) << "] & 0x0000FFFF;\n";
+    os << "    };\n";
+    os << "    ranges:\n";
+    os << "    {\n";
+    uint32_t value = 0;
+    for (uint32_t i = random.next(1, 6); i > 0; --i)
+    {
+        value += random.next(1, 100);
+        os << "        " << to_hex(value) << ": " << to_hex(uint16_t(random.next(0, 0xFE))) << ";\n";
+    }
+    os << "    };\n";
+    os << "    default: " << to_hex(uint16_t(random.next(0, 0xFE))) << ";\n";
+    os << "}\n";
+    return os.str();
+}
+
+
+std::vector<uint8_t> GRFGenerator::make_pixels(uint16_t xdim, uint16_t ydim, Colour colour,
+    double transparency, uint32_t seed)
+{
+    Random random{seed};
+    const uint32_t size = pixel_size(colour);
+    std::vector<uint8_t> pixels(uint32_t(xdim) * ydim * size);
+
+    // Each row has a single opaque span, whose width gives about the right transparency.
+    const uint32_t opaque = uint32_t(xdim * (1.0 - transparency) + 0.5);
+
+    uint8_t* row = pixels.data();
+    for (uint32_t y = 0; y < ydim; ++y, row += xdim * size)
+    {
+        uint32_t width = opaque;
+        if ((width > 0) && (width < xdim))
+        {
+            // A little jitter to the edges so that the rows are not all the same.
+            width = std::min<uint32_t>(xdim, width + random.next(0, 2));
+        }
+        uint32_t start = (xdim - width) / 2;
+
+        for (uint32_t x = start; x < start + width; ++x)
+        {
+            // Bands of colour, with about one pixel in eight disturbed.
+            uint8_t value = uint8_t(0x10 + ((x / 4 + y / 3 + seed) % 24));
+            if ((random.next() & 0x07) == 0)
+                value = uint8_t(random.next(1, 0xFF));
+
+            uint8_t* pixel = row + x * size;
+            switch (colour)
+            {
+                case Colour::Palette:
+                    pixel[0] = value;
+                    break;
+                case Colour::RGBAMask:
+                    pixel[4] = value;
+                    [[fallthrough]];
+                case Colour::RGBA:
+                    pixel[0] = uint8_t(value * 3);
+                    pixel[1] = uint8_t(value * 5);
+                    pixel[2] = uint8_t(value * 7);
+                    pixel[3] = 0xFF;
+                    break;
+            }
+        }
+    }
+
+    return pixels;
+}
+
+
+std::unique_ptr<RealSpriteRecord> GRFGenerator::make_sprite(uint32_t sprite_id, ZoomLevel zoom) const
+{
+    // The size is the same for every zoom level of a sprite, so it is seeded only by the image.
+    uint32_t image = (m_config.distinct > 0) ? ((sprite_id - 1) % m_config.distinct) + 1 : sprite_id;
+    Random random{mix_seed(m_config.seed, image, 4)};
+    uint16_t xdim = scale(uint16_t(random.next(8, 128)), zoom);
+    uint16_t ydim = scale(uint16_t(random.next(8, 96)), zoom);
+
+    uint32_t seed = mix_seed(m_config.seed, image, 5 + static_cast<uint32_t>(zoom));
+    std::vector<uint8_t> pixels = make_pixels(xdim, ydim, m_config.colour, m_config.transparency, seed);
+
+    uint8_t colour      = colour_bits(m_config.colour);
+    uint8_t compression = (m_config.transparency > 0.0) ? RealSpriteRecord::CHUNKED_FORMAT : 0;
+    if (m_config.format == GRFFormat::Container2)
+    {
+        compression |= colour;
+    }
+
+    auto sprite = std::make_unique<RealSpriteRecord>(sprite_id, 0, compression);
+    sprite->set_image(zoom, xdim, ydim, -int16_t(xdim / 2), -int16_t(ydim / 2), colour, std::move(pixels));
+    return sprite;
+}
+
+
+uint32_t GRFGenerator::num_records() const
+{
+    // The GRF header, and the Action01 records and their sprites or sprite references.
+    uint32_t result = 1;
+    result += divide_round_up(m_config.instances, InstancesPerRecord);
+    result += divide_round_up(m_config.strings, StringsPerRecord);
+    result += m_config.switches;
+    for (const auto& sets: sprite_sets(m_config.sprites))
+    {
+        result += 1 + (m_config.graphics ? 2 * sets.num_sets : 0);
+    }
+    result += m_config.sprites;
+    return result;
+}
+
+
+void GRFGenerator::write_record(std::ostream& os, const std::string& data, uint8_t info) const
+{
+    if (m_info.format == GRFFormat::Container1)
+        write_uint16(os, uint16_t(data.size()));
+    else
+        write_uint32(os, uint32_t(data.size()));
+    write_uint8(os, info);
+    os.write(data.data(), data.size());
+}
+
+
+void GRFGenerator::write_sprite_sets(std::ostream& os) const
+{
+    // In Container1, the sprites follow each Action01. In Container2, they are references into
+    // the sprite section.
+    uint32_t sprite_id = 1;
+    for (const auto& sets: sprite_sets(m_config.sprites))
+    {
+        std::ostringstream action01;
+        write_uint8(action01, 0x01);
+        write_uint8(action01, static_cast<uint8_t>(FeatureType::Trains));
+        write_uint8(action01, uint8_t(sets.num_sets));
+        write_uint8_ext(action01, uint16_t(sets.per_set));
+        write_record(os, action01.str());
+
+        for (uint32_t i = 0; i < sets.num_sets * sets.per_set; ++i, ++sprite_id)
+        {
+            if (m_info.format == GRFFormat::Container1)
+            {
+                make_sprite(sprite_id, ZoomLevel::Normal)->write(os, m_info);
+            }
+            else
+            {
+                std::ostringstream index;
+                write_uint32(index, sprite_id);
+                write_record(os, index.str(), 0xFD);
+            }
+        }
+
+        // The Action01 records all start at set zero, so each set is used straight away.
+        for (uint32_t set = 0; m_config.graphics && (set < sets.num_sets); ++set)
+        {
+            std::ostringstream action02;
+            write_uint8(action02, 0x02);
+            write_uint8(action02, static_cast<uint8_t>(FeatureType::Trains));
+            write_uint8(action02, uint8_t(set));
+            write_uint8(action02, 1);
+            write_uint8(action02, 0);
+            write_uint16(action02, uint16_t(set));
+            write_record(os, action02.str());
+
+            std::ostringstream action03;
+            write_uint8(action03, 0x03);
+            write_uint8(action03, static_cast<uint8_t>(FeatureType::Trains));
+            write_uint8(action03, 1);
+            write_uint8(action03, uint8_t(set));
+            write_uint8(action03, 0);
+            write_uint16(action03, uint16_t(set));
+            write_record(os, action03.str());
+        }
+    }
+}
+
+
+void GRFGenerator::write_sprites(std::ostream& os) const
+{
+    for (uint32_t sprite_id = 1; sprite_id <= m_config.sprites; ++sprite_id)
+    {
+        for (auto zoom: m_config.zooms)
+        {
+            make_sprite(sprite_id, zoom)->write(os, m_info);
+        }
+    }
+    write_uint32(os, 0);
+}
+
+
+void GRFGenerator::write(std::ostream& os) const
+{
+    // Header, which is patched at the end with the offset of the sprite section.
+    if (m_info.format == GRFFormat::Container2)
+    {
+        write_uint16(os, 0x0000);
+        for (auto byte: CONTAINER2_IDENTIFIER)
+            write_uint8(os, byte);
+        write_uint32(os, 0);
+        write_uint8(os, 0);
+    }
+
+    // Counter. This does not count itself.
+    std::ostringstream counter;
+    write_uint32(counter, num_records());
+    write_record(os, counter.str());
+
+    write_record(os, record_data<Action08Record>(
+        "grf\n"
+        "{\n"
+        "    grf_id: \"YAGL\";\n"
+        "    version: GRF8;\n"
+        "    name: \"Synthetic GRF\";\n"
+        "    description: \"Generated by yagl_gen\";\n"
+        "}\n", m_info));
+
+    for (uint32_t i = 0; i < divide_round_up(m_config.instances, InstancesPerRecord); ++i)
+        write_record(os, record_data<Action00Record>(train_yagl(i), m_info));
+    for (uint32_t i = 0; i < divide_round_up(m_config.strings, StringsPerRecord); ++i)
+        write_record(os, record_data<Action04Record>(strings_yagl(i), m_info));
+    for (uint32_t i = 0; i < m_config.switches; ++i)
+        write_record(os, record_data<Action02VariableRecord>(switch_yagl(i), m_info));
+
+    write_sprite_sets(os);
+
+    // Data section terminator.
+    if (m_info.format == GRFFormat::Container1)
+    {
+        write_uint16(os, 0);
+        return;
+    }
+    write_uint32(os, 0);
+
+    // The offset is from the end of the header.
+    uint32_t sprite_offs = static_cast<uint32_t>(os.tellp()) - 14U;
+    write_sprites(os);
+
+    auto end = os.tellp();
+    os.seekp(2 + CONTAINER2_IDENTIFIER.size(), std::ostream::beg);
+    write_uint32(os, sprite_offs);
+    os.seekp(end);
+}
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Record.h"
+#include "RealSpriteRecord.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// Creates synthetic GRFs of any size for benchmarks and scale testing, since real sets cannot
+// be committed. Everything is derived from the seed, so the same configuration always gives
+// the same GRF. The pseudo-sprites are made by parsing generated YAGL with the Record classes,
+// and the sprites are written by RealSpriteRecord, so the output is valid by construction.
+// Records and sprites are generated one at a time as they are written, so memory use does
+// not depend on the size of the GRF.
+class GRFGenerator
+{
+public:
+    using ZoomLevel = RealSpriteRecord::ZoomLevel;
+    enum class Colour { Palette, RGBA, RGBAMask };
+
+    struct Config
+    {
+        uint32_t  seed         = 1;
+        GRFFormat format       = GRFFormat::Container2;
+
+        // The mix of pseudo-sprites.
+        uint32_t  instances    = 100;  // Trains defined in Action00 records, 8 to a record.
+        uint32_t  strings      = 100;  // Strings in Action04 records, 16 to a record.
+        uint32_t  switches     = 0;    // Action02 variable records.
+
+        // The real sprites. Each sprite has an image for each zoom level. Container1 supports
+        // only 8bpp images at normal zoom.
+        uint32_t  sprites      = 100;
+        std::vector<ZoomLevel> zooms{ ZoomLevel::Normal };
+        Colour    colour       = Colour::Palette;
+        // The approximate proportion of transparent pixels. Images with any transparency
+        // are written in the chunked format.
+        double    transparency = 0.5;
+        // If non-zero, the images repeat after this many sprites, as when the same images
+        // are used in more than one sprite set.
+        uint32_t  distinct     = 0;
+        // Use each sprite set in an Action02 and Action03, so that none of them are unused.
+        bool      graphics     = false;
+    };
+
+public:
+    GRFGenerator(const Config& config);
+
+    // The output stream must be seekable for Container2, so that the offset of the sprite
+    // section can be written into the header.
+    void write(std::ostream& os) const;
+
+    // The building blocks, also used directly by the benchmarks.
+    std::string train_yagl(uint32_t index) const;
+    std::string strings_yagl(uint32_t index) const;
+    std::string switch_yagl(uint32_t index) const;
+    std::unique_ptr<RealSpriteRecord> make_sprite(uint32_t sprite_id, ZoomLevel zoom) const;
+
+    // A sprite-like image: bands of colour with some noise in an opaque region surrounded by
+    // transparent pixels.
+    static std::vector<uint8_t> make_pixels(uint16_t xdim, uint16_t ydim, Colour colour,
+        double transparency, uint32_t seed);
+
+private:
+    uint32_t num_records() const;
+    void write_record(std::ostream& os, const std::string& data, uint8_t info = 0xFF) const;
+    void write_sprite_sets(std::ostream& os) const;
+    void write_sprites(std::ostream& os) const;
+
+private:
+    Config   m_config;
+    GRFInfo  m_info;
+};
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "GRFGenerator.h"
+#include "NewGRFData.h"
+#include "Version.h"
+#include "FileSystem.h"
+#include "Exceptions.h"
+#include "cxxopts.hpp"
+#include <fstream>
+#include <iostream>
+
+
+namespace {
+
+GRFGenerator::ZoomLevel zoom_from_name(const std::string& name)
+{
+    using ZoomLevel = GRFGenerator::ZoomLevel;
+    if (name == "normal") return ZoomLevel::Normal;
+    if (name == "zin2")   return ZoomLevel::ZoomInX2;
+    if (name == "zin4")   return ZoomLevel::ZoomInX4;
+    if (name == "zout2")  return ZoomLevel::ZoomOutX2;
+    if (name == "zout4")  return ZoomLevel::ZoomOutX4;
+    if (name == "zout8")  return ZoomLevel::ZoomOutX8;
+    throw RUNTIME_ERROR("Unknown zoom level: " + name);
+}
+
+
+GRFGenerator::Colour colour_from_name(const std::string& name)
+{
+    using Colour = GRFGenerator::Colour;
+    if (name == "8bpp")  return Colour::Palette;
+    if (name == "32bpp") return Colour::RGBA;
+    if (name == "mask")  return Colour::RGBAMask;
+    throw RUNTIME_ERROR("Unknown colour depth: " + name);
+}
+
+} // namespace {
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "\n";
+    std::cout << "yagl_gen (synthetic GRF generator) " << str_yagl_version << "\n";
+    std::cout << "Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)\n";
+    std::cout << "Released under GNU General Public License version 3\n" << std::endl;
+
+    GRFGenerator::Config config;
+    uint16_t    format = 2;
+    std::vector<std::string> zooms;
+    std::string colour = "8bpp";
+    bool        yagl   = false;
+    std::string grf_file;
+    std::string yagl_dir = "sprites";
+
+    try
+    {
+        cxxopts::Options options(argv[0], "yagl_gen: creates synthetic GRF files for testing");
+        options
+            .positional_help("<grf_file> [<yagl_dir>]")
+            .show_positional_help()
+            .add_options()
+            ("s,seed",         "Seed from which everything is generated", cxxopts::value<uint32_t>(config.seed), "<num>")
+            ("f,format",       "Container format: 1 or 2", cxxopts::value<uint16_t>(format), "<num>")
+            ("instances",      "Number of trains defined with Action00", cxxopts::value<uint32_t>(config.instances), "<num>")
+            ("strings",        "Number of strings defined with Action04", cxxopts::value<uint32_t>(config.strings), "<num>")
+            ("switches",       "Number of Action02 variable records", cxxopts::value<uint32_t>(config.switches), "<num>")
+            ("sprites",        "Number of real sprites", cxxopts::value<uint32_t>(config.sprites), "<num>")
+            ("zooms",          "Zoom levels of each sprite, e.g. 'normal,zin2,zin4'", cxxopts::value<std::vector<std::string>>(zooms)->default_value("normal"), "<list>")
+            ("colour",         "Colour depth of the sprites: 8bpp, 32bpp or mask", cxxopts::value<std::string>(colour), "<depth>")
+            ("transparency",   "Proportion of transparent pixels, from 0 to 1", cxxopts::value<double>(config.transparency), "<ratio>")
+            ("distinct",       "Repeat the images after this many sprites (0 for no repeats)", cxxopts::value<uint32_t>(config.distinct), "<num>")
+            ("graphics",       "Use each sprite set in an Action02 and Action03", cxxopts::value<bool>(config.graphics))
+            ("yagl",           "Also decode the GRF to YAGL and sprite sheets", cxxopts::value<bool>(yagl))
+            ("help",           "Print help")
+            ("grf_file",       "Path of the GRF file to create", cxxopts::value<std::string>(grf_file))
+            ("yagl_dir",       "Name of the sub-folder for YAGL script and sprite sheets", cxxopts::value<std::string>(yagl_dir), "sprites");
+        options.parse_positional({"grf_file", "yagl_dir"});
+
+        auto result = options.parse(argc, argv);
+        if (result.count("help") || !result.count("grf_file"))
+        {
+            std::cout << options.help({""}) << '\n';
+            return result.count("help") ? 0 : 1;
+        }
+    }
+    catch (const cxxopts::OptionException& e)
+    {
+        std::cout << "ERROR: Error parsing options: " << e.what() << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        switch (format)
+        {
+            case 1:  config.format = GRFFormat::Container1; break;
+            case 2:  config.format = GRFFormat::Container2; break;
+            default: throw RUNTIME_ERROR("Invalid container format. Permitted values are 1 and 2.");
+        }
+
+        config.zooms.clear();
+        for (const auto& zoom: zooms)
+        {
+            config.zooms.push_back(zoom_from_name(zoom));
+        }
+        config.colour = colour_from_name(colour);
+
+        std::cout << "Writing GRF:      " << grf_file << std::endl;
+        {
+            GRFGenerator generator{config};
+            std::ofstream os(grf_file, std::ios::binary);
+            if (os.fail())
+            {
+                throw RUNTIME_ERROR("Error opening file for writing: " + grf_file);
+            }
+            generator.write(os);
+        }
+
+        if (yagl)
+        {
+            // The same paths as yagl uses for decoding.
+            std::string grf_name  = fs::path(grf_file).filename().string();
+            yagl_dir              = fs::path(grf_file).parent_path().append(yagl_dir).make_preferred().string();
+            std::string yagl_file = fs::path(yagl_dir).append(grf_name).replace_extension("yagl").make_preferred().string();
+            std::string image_base = fs::path(yagl_file).replace_extension().make_preferred().string();
+            fs::create_directory(yagl_dir);
+
+            std::cout << "Writing YAGL:     " << yagl_file << std::endl;
+            NewGRFData grf_data;
+            std::ifstream is(grf_file, std::ios::binary);
+            grf_data.read(is);
+            std::ofstream os(yagl_file, std::ios::binary);
+            grf_data.print(os, yagl_dir, image_base);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -24,16 +24,33 @@
 #include <iostream>
 
 
+// Base class for the descriptions of each feature's properties. The derived classes
+// declare their properties as members, and these register themselves with the table.
+// See static_property_table().
+class FeatureProperties
+{
+public:
+    PropertyTable& table() { return m_table; }
+
+protected:
+    PropertyTable m_table;
+};
+
+
 // Base class for all the different types of features.
 // Each one has its own distinct set of properties.
 class Action00Feature
 {
 public:
-    Action00Feature(FeatureType feature) : m_feature{feature} {}
+    Action00Feature(FeatureType feature, const PropertyTable& table)
+    : m_feature{feature}
+    , m_properties{table}
+    {
+    }
     virtual ~Action00Feature() {}
 
-    void register_property(PropertyBase* property) { m_properties.register_property(property); }
     FeatureType feature() const {return m_feature; }
+    const PropertyMap& properties() const { return m_properties; }
 
     // These methods only return bool so we can know if the base class for vehicles, ships, etc.
     // handled the property or not. We don't care about the result - an exception will be thrown
@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "ChainCostAnalyser.h"
+#include "Action02VariableRecord.h"
+#include "Action02RandomRecord.h"
+#include "Action03Record.h"
+#include "StreamHelpers.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+
+namespace {
+
+struct Choice
+{
+    ChainCostAnalyser::Cost cost;
+    double                  weight;
+};
+
+
+// The cost of a record is its own cost plus that of whichever set it selects.
+ChainCostAnalyser::Cost combine(const ChainCostAnalyser::Cost& own, const std::vector<Choice>& choices)
+{
+    ChainCostAnalyser::Cost result;
+    double total_weight = 0.0;
+    for (const auto& choice: choices)
+    {
+        auto& worst = result.worst;
+        worst.variables     = std::max(worst.variables,     choice.cost.worst.variables);
+        worst.parameterised = std::max(worst.parameterised, choice.cost.worst.parameterised);
+        worst.storage       = std::max(worst.storage,       choice.cost.worst.storage);
+
+        auto& average = result.average;
+        average.variables     += choice.weight * choice.cost.average.variables;
+        average.parameterised += choice.weight * choice.cost.average.parameterised;
+        average.storage       += choice.weight * choice.cost.average.storage;
+        total_weight          += choice.weight;
+    }
+
+    if (total_weight > 0.0)
+    {
+        result.average.variables     /= total_weight;
+        result.average.parameterised /= total_weight;
+        result.average.storage       /= total_weight;
+    }
+
+    result.worst.variables       += own.worst.variables;
+    result.worst.parameterised   += own.worst.parameterised;
+    result.worst.storage         += own.worst.storage;
+    result.average.variables     += own.average.variables;
+    result.average.parameterised += own.average.parameterised;
+    result.average.storage       += own.average.storage;
+    return result;
+}
+
+
+void print_counts(std::ostream& os, const char* name, double worst, double average)
+{
+    os << "  " << name << " " << std::setw(3) << uint32_t(worst);
+    os << " / " << std::fixed << std::setprecision(2) << std::setw(6) << average;
+}
+
+
+std::string print_instances(const Action03Record& action03)
+{
+    // Long lists are shortened, as the line is about the chain rather than the instances.
+    constexpr std::size_t MaxInstances = 4;
+
+    const auto& ids = action03.feature_ids();
+    std::ostringstream os;
+    os << FeatureName(*action03.feature()) << " [";
+    for (std::size_t i = 0; i < std::min(ids.size(), MaxInstances); ++i)
+    {
+        os << ((i > 0) ? ", " : "") << as_hex(ids[i]);
+    }
+    if (ids.size() > MaxInstances)
+        os << ", ... " << ids.size() << " instances";
+    os << "]";
+    return os.str();
+}
+
+} // namespace {
+
+
+ChainCostAnalyser::ChainCostAnalyser(const std::vector<const Record*>& records)
+: m_records{records}
+, m_graph{records}
+{
+}
+
+
+ChainCostAnalyser::Cost ChainCostAnalyser::set_cost(uint32_t index, uint16_t set_id)
+{
+    // Callback results and undefined sets end the chain.
+    if (set_id & Action02VariableRecord::CALLBACK_RESULT)
+        return Cost{};
+
+    auto binding = m_graph.act02_binding(index, set_id);
+    return binding ? cost(*binding) : Cost{};
+}
+
+
+ChainCostAnalyser::Cost ChainCostAnalyser::own_cost(uint32_t index)
+{
+    const auto& action02 = static_cast<const Action02VariableRecord&>(*m_records[index]);
+    auto accesses = action02.accesses();
+
+    Cost result;
+    for (auto counts: { &result.worst, &result.average })
+    {
+        counts->variables     = accesses.variables;
+        counts->parameterised = accesses.parameterised;
+        counts->storage       = accesses.storage;
+    }
+
+    // Procedures called through variable 7E are evaluated every time, whatever is selected.
+    for (auto set_id: action02.procedure_set_ids())
+    {
+        result = combine(result, {{set_cost(index, set_id), 1.0}});
+    }
+    return result;
+}
+
+
+ChainCostAnalyser::Cost ChainCostAnalyser::cost(uint32_t index)
+{
+    auto it = m_costs.find(index);
+    if (it != m_costs.end())
+        return it->second;
+
+    // Other types of Action02 select sprites or a production callback, and do no further work.
+    Cost result;
+    const Record& record = *m_records[index];
+    if (record.record_type() == RecordType::ACTION_02_VARIABLE)
+    {
+        const auto& action02 = static_cast<const Action02VariableRecord&>(record);
+        std::vector<Choice> choices;
+        for (const auto& range: action02.ranges())
+        {
+            choices.push_back({set_cost(index, range.set_id), 1.0});
+        }
+        choices.push_back({set_cost(index, action02.default_set_id()), 1.0});
+        result = combine(own_cost(index), choices);
+    }
+    else if (record.record_type() == RecordType::ACTION_02_RANDOM)
+    {
+        const auto& action02 = static_cast<const Action02RandomRecord&>(record);
+        std::vector<Choice> choices;
+        for (const auto& [set_id, count]: action02.set_id_counts())
+        {
+            choices.push_back({set_cost(index, set_id), double(count)});
+        }
+        result = combine({}, choices);
+    }
+
+    m_costs[index] = result;
+    return result;
+}
+
+
+uint32_t ChainCostAnalyser::report(std::ostream& os, const ChainBudgets& budgets)
+{
+    // Record numbers count from one and include the sprites, as in the hex dump.
+    std::vector<uint32_t> numbers;
+    uint32_t number = 1;
+    for (const auto record: m_records)
+    {
+        numbers.push_back(number);
+        number += 1 + record->num_sprites_to_write();
+    }
+
+    uint32_t num_lines       = 0;
+    uint32_t num_over_budget = 0;
+    auto print_line = [&](uint32_t index, const std::string& entry, const Cost& cost)
+    {
+        const auto& action03 = static_cast<const Action03Record&>(*m_records[index]);
+        os << "#" << numbers[index] << " " << print_instances(action03) << " " << entry << ":";
+        print_counts(os, "variables", cost.worst.variables, cost.average.variables);
+        print_counts(os, "parameterised", cost.worst.parameterised, cost.average.parameterised);
+        print_counts(os, "storage", cost.worst.storage, cost.average.storage);
+
+        std::string over;
+        if (cost.worst.variables > budgets.variables)         over += " variables";
+        if (cost.worst.parameterised > budgets.parameterised) over += " parameterised";
+        if (cost.worst.storage > budgets.storage)             over += " storage";
+        if (!over.empty())
+        {
+            os << "  OVER BUDGET:" << over;
+            ++num_over_budget;
+        }
+        os << "\n";
+        ++num_lines;
+    };
+
+    auto print_entry = [&](uint32_t index, const std::string& entry, uint16_t set_id)
+    {
+        auto binding = ((set_id & Action02VariableRecord::CALLBACK_RESULT) == 0) ? m_graph.act02_binding(index, set_id) : std::nullopt;
+        const Record* root = binding ? m_records[*binding] : nullptr;
+        if ((root == nullptr) || (root->record_type() != RecordType::ACTION_02_VARIABLE) ||
+            !static_cast<const Action02VariableRecord*>(root)->selects_callback())
+        {
+            print_line(index, entry, set_cost(index, set_id));
+            return;
+        }
+
+        // Each callback is evaluated separately, so it is more useful to see them separately.
+        const auto& action02 = static_cast<const Action02VariableRecord&>(*root);
+        for (const auto& range: action02.ranges())
+        {
+            // Callback IDs have up to 15 bits.
+            std::string callback = entry + " callback " + to_hex(uint16_t(range.low_range));
+            if (range.high_range != range.low_range)
+                callback += "-" + to_hex(uint16_t(range.high_range));
+            print_line(index, callback, combine(own_cost(*binding), {{set_cost(*binding, range.set_id), 1.0}}));
+        }
+        print_line(index, entry + " other callbacks",
+            combine(own_cost(*binding), {{set_cost(*binding, action02.default_set_id()), 1.0}}));
+    };
+
+    os << "Action02 chains for each Action03 (worst / average):\n";
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        if (m_records[index]->record_type() != RecordType::ACTION_03)
+            continue;
+
+        const auto& action03 = static_cast<const Action03Record&>(*m_records[index]);
+        for (const auto& cargo_type: action03.cargo_types())
+        {
+            print_entry(index, "cargo " + to_hex(cargo_type.cargo_type), cargo_type.act02_set_id);
+        }
+        print_entry(index, "default", action03.default_set_id());
+    }
+
+    os << "Entry points: " << num_lines << ", over budget: " << num_over_budget;
+    os << " (budgets: " << budgets.variables << " variables, " << budgets.parameterised;
+    os << " parameterised, " << budgets.storage << " storage)\n";
+    if (!m_graph.is_static())
+    {
+        os << "Action06, Action07 or Action09 may change which sets are used, so these are estimates\n";
+    }
+    return num_over_budget;
+}
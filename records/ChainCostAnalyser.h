@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "SpriteGroupGraph.h"
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+
+// Limits on the work done by the Action02 chain for one Action03 entry point. Chains which
+// may exceed them are flagged in the report.
+struct ChainBudgets
+{
+    uint32_t variables     = 32;
+    uint32_t parameterised = 8;
+    uint32_t storage       = 8;
+};
+
+
+// Estimates the work OpenTTD does to evaluate the Action02 chains used by each Action03,
+// which happens for every vehicle or tile concerned, sometimes on every tick. The ranges
+// and default of a switch are treated as equally likely, and the sets of a random switch
+// in proportion to their number of entries.
+class ChainCostAnalyser
+{
+public:
+    struct Counts
+    {
+        double variables{};
+        double parameterised{};
+        double storage{};
+    };
+
+    struct Cost
+    {
+        Counts worst;
+        Counts average;
+    };
+
+public:
+    // The top level records of the data section, in file order.
+    explicit ChainCostAnalyser(const std::vector<const Record*>& records);
+
+    // The cost of evaluating a record and everything it may select.
+    Cost cost(uint32_t index);
+    // The cost of evaluating a set ID selected by a record.
+    Cost set_cost(uint32_t index, uint16_t set_id);
+
+    // Writes a line for each Action03 entry point, split by callback where the chain starts
+    // with a switch on the callback. Returns the number of lines over budget.
+    uint32_t report(std::ostream& os, const ChainBudgets& budgets);
+
+private:
+    // The cost of a switch itself, including any procedures it calls.
+    Cost own_cost(uint32_t index);
+
+private:
+    std::vector<const Record*> m_records;
+    SpriteGroupGraph           m_graph;
+    std::map<uint32_t, Cost>   m_costs;
+};
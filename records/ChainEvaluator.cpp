@@ -0,0 +1,561 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "ChainEvaluator.h"
+#include "Action02RandomRecord.h"
+#include "Action03Record.h"
+#include "StreamHelpers.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+
+namespace {
+
+constexpr uint32_t CALLBACK_FAILED = 0xFFFF;
+
+using Action02 = Action02VariableRecord;
+
+
+// Stored values are sign extended from the size of the switch.
+uint32_t sign_extend(Action02::VarType type, uint32_t value)
+{
+    switch (Action02::type_mask(type))
+    {
+        case 0x000000FF: return uint32_t(int32_t(int8_t(value)));
+        case 0x0000FFFF: return uint32_t(int32_t(int16_t(value)));
+        default:         return value;
+    }
+}
+
+
+// Ranges mostly cover small values, so these are favoured.
+uint32_t random_value(uint32_t iteration, uint8_t variable, uint32_t parameter)
+{
+    uint64_t hash  = Action02::mix((uint64_t{iteration} << 40) ^ (uint64_t{variable} << 32) ^ parameter);
+    uint32_t value = uint32_t(hash >> 32);
+    switch (hash & 0x07)
+    {
+        case 0:  return 0;
+        case 1:
+        case 2:  return value & 0x0F;
+        case 3:
+        case 4:  return value & 0xFF;
+        case 5:  return value & 0xFFFF;
+        default: return value;
+    }
+}
+
+
+} // namespace {
+
+
+struct ChainEvaluator::State
+{
+    const Environment* env{};
+    // Variables which are not in the environment have random values when fuzzing.
+    bool                fuzzing{};
+    uint32_t            iteration{};
+    uint32_t            random_bits{};
+
+    uint32_t            last_value{};
+    uint32_t            instructions{};
+    std::vector<uint32_t>*                 trace{};
+    std::unordered_map<uint32_t, uint32_t> temp_storage;
+    std::map<uint32_t, uint32_t>           persistent_storage;
+
+    // Reads a variable, whether it is named directly or through variable 7B. The variables
+    // which the game calculates from the state of the evaluation are handled here, and the
+    // others come from the environment. Storage registers are given by the parameter.
+    std::optional<uint32_t> read(uint8_t variable, uint32_t parameter) const
+    {
+        switch (variable)
+        {
+            case Action02::CONSTANT_VARIABLE:
+                return 0xFFFFFFFF;
+            case Action02::LAST_VALUE:
+                return last_value;
+            case Action02::TEMP_STORAGE:
+            {
+                auto it = temp_storage.find(parameter);
+                return (it != temp_storage.end()) ? it->second : 0;
+            }
+            case Action02::PERM_STORAGE:
+            {
+                auto it = persistent_storage.find(parameter);
+                return (it != persistent_storage.end()) ? it->second : 0;
+            }
+            default:
+                return this->variable(variable, parameter);
+        }
+    }
+
+    std::optional<uint32_t> variable(uint8_t variable, uint32_t parameter) const
+    {
+        auto it = env->variables.find({ variable, uint8_t(parameter) });
+        if (it != env->variables.end())
+            return it->second;
+        if (fuzzing)
+            return random_value(iteration, variable, parameter);
+        return std::nullopt;
+    }
+};
+
+
+ChainEvaluator::Environment ChainEvaluator::Environment::parse(TokenStream& is)
+{
+    Environment env;
+    is.match_object([&](const std::string& key, const TokenValue& token)
+    {
+        if (key == "feature")
+        {
+            env.feature = FeatureFromName(is.match(TokenType::String));
+        }
+        else if (key == "feature_id")
+        {
+            env.feature_id = is.match_uint16();
+        }
+        else if (key == "cargo_type")
+        {
+            env.cargo_type = is.match_uint8();
+        }
+        else if (key == "random_bits")
+        {
+            env.random_bits = is.match_uint32();
+        }
+        else if (key == "variables")
+        {
+            // The key is the variable, followed by the parameter for 60+x variables: "0x60:0x05".
+            is.match_object([&](const std::string& name, const TokenValue& token)
+            {
+                auto colon = name.find(':');
+                uint32_t variable  = TokenStream::parse_number(name.substr(0, colon), token);
+                uint32_t parameter = (colon != std::string::npos) ? TokenStream::parse_number(name.substr(colon + 1), token) : 0;
+                env.variables[{ uint8_t(variable), uint8_t(parameter) }] = is.match_uint32();
+            });
+        }
+        else if (key == "persistent_storage")
+        {
+            is.match_object([&](const std::string& name, const TokenValue& token)
+            {
+                env.persistent_storage[TokenStream::parse_number(name, token)] = is.match_uint32();
+            });
+        }
+        else
+        {
+            throw PARSER_ERROR("Unexpected key: '" + key + "'", token);
+        }
+    });
+    return env;
+}
+
+
+ChainEvaluator::ChainEvaluator(const std::vector<const Record*>& records)
+: m_records{records}
+, m_graph{records}
+{
+    uint32_t number = 1;
+    for (const auto record: m_records)
+    {
+        m_numbers.push_back(number);
+        number += 1 + record->num_sprites_to_write();
+    }
+
+    // References always point to earlier records, so these are compiled first.
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        const Record& record = *m_records[index];
+        switch (record.record_type())
+        {
+            case RecordType::ACTION_02_VARIABLE:
+            case RecordType::ACTION_02_RANDOM:
+                compile(index);
+                break;
+
+            case RecordType::ACTION_03:
+            {
+                // Livery overrides only apply to wagons pulled by particular engines.
+                const auto& action03 = static_cast<const Action03Record&>(record);
+                if (action03.livery_override())
+                    break;
+
+                Entry entry;
+                for (const auto& cargo_type: action03.cargo_types())
+                {
+                    entry.cargo_types[cargo_type.cargo_type] = make_target(index, cargo_type.act02_set_id);
+                }
+                entry.fallback = make_target(index, action03.default_set_id());
+                for (auto feature_id: action03.feature_ids())
+                {
+                    m_entries[{ *action03.feature(), feature_id }] = entry;
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+
+uint32_t ChainEvaluator::make_target(uint32_t index, uint16_t set_id)
+{
+    Target target{ false, Result::Kind::Unresolved, set_id };
+    if (set_id & Action02::CALLBACK_RESULT)
+    {
+        target.kind  = Result::Kind::Callback;
+        target.value = set_id & 0x7FFF;
+    }
+    else if (auto binding = m_graph.act02_binding(index, set_id); binding)
+    {
+        auto it = m_starts.find(*binding);
+        if (it != m_starts.end())
+        {
+            target.is_switch = true;
+            target.value     = it->second;
+        }
+        else
+        {
+            target.kind  = Result::Kind::SpriteGroup;
+            target.value = *binding;
+        }
+    }
+
+    m_targets.push_back(target);
+    return uint32_t(m_targets.size() - 1);
+}
+
+
+void ChainEvaluator::compile(uint32_t index)
+{
+    const uint32_t start = uint32_t(m_instructions.size());
+    const Record& record = *m_records[index];
+
+    // The targets are created first, as they may be needed by the loads.
+    if (record.record_type() == RecordType::ACTION_02_RANDOM)
+    {
+        const auto& action02 = static_cast<const Action02RandomRecord&>(record);
+        auto table = action02.set_id_table();
+
+        Instruction instruction;
+        instruction.opcode = Opcode::Random;
+        instruction.a      = uint32_t(m_targets.size());
+        instruction.b      = uint32_t(table.size());
+        instruction.c      = action02.random_bit();
+        for (auto set_id: table)
+        {
+            make_target(index, set_id);
+        }
+        m_instructions.push_back(instruction);
+    }
+    else
+    {
+        const auto& action02 = static_cast<const Action02VariableRecord&>(record);
+        const VarType type   = action02.var_type();
+
+        for (const auto& va: action02.actions())
+        {
+            Instruction instruction;
+            instruction.type   = type;
+            instruction.action = va;
+            // The first value is simply assigned.
+            if (&va == &action02.actions()[0])
+                instruction.action.operation = Operation::Assign;
+
+            switch (va.variable)
+            {
+                case Action02::CONSTANT_VARIABLE:
+                    instruction.opcode = (va.action == 0x00) ? Opcode::Constant : Opcode::Variable;
+                    instruction.a      = Action02VariableRecord::adjust_value(type, va, 0xFFFFFFFF);
+                    break;
+                case Action02::INDIRECT_VARIABLE: instruction.opcode = Opcode::Indirect;  break;
+                case Action02::PROCEDURE_VARIABLE:
+                    instruction.opcode = Opcode::Call;
+                    instruction.a      = make_target(index, va.parameter);
+                    break;
+                default:                          instruction.opcode = Opcode::Variable;  break;
+            }
+            m_instructions.push_back(instruction);
+        }
+
+        Instruction instruction;
+        instruction.type = type;
+        if (action02.ranges().empty())
+        {
+            instruction.opcode = Opcode::Calculated;
+        }
+        else
+        {
+            instruction.opcode = Opcode::Select;
+            instruction.a      = uint32_t(m_ranges.size());
+            instruction.b      = uint32_t(action02.ranges().size());
+            for (const auto& range: action02.ranges())
+            {
+                m_ranges.push_back({ range.low_range, range.high_range, make_target(index, range.set_id) });
+            }
+        }
+        instruction.c = make_target(index, action02.default_set_id());
+        m_instructions.push_back(instruction);
+
+        // The game selects the set of the first range if a variable is not available.
+        m_error_targets[start] = action02.ranges().empty() ? instruction.c : m_ranges[instruction.a].target;
+    }
+
+    m_starts[index] = start;
+    m_owners.resize(m_instructions.size(), index);
+}
+
+
+std::optional<uint32_t> ChainEvaluator::read_value(State& state, const Instruction& instruction, uint32_t last) const
+{
+    const auto& va = instruction.action;
+    switch (instruction.opcode)
+    {
+        case Opcode::Constant:
+            return instruction.a;
+
+        case Opcode::Variable:
+        {
+            auto value = state.read(va.variable, va.parameter);
+            if (!value)
+                return std::nullopt;
+            return Action02VariableRecord::adjust_value(instruction.type, va, *value);
+        }
+
+        case Opcode::Indirect:
+        {
+            auto value = state.read(va.parameter, last);
+            if (!value)
+                return std::nullopt;
+            return Action02VariableRecord::adjust_value(instruction.type, va, *value);
+        }
+
+        case Opcode::Call:
+        {
+            // Anything other than a callback result counts as a failed callback.
+            Result result  = run(state, instruction.a);
+            uint32_t value = (result.kind == Result::Kind::Callback) ? result.value : CALLBACK_FAILED;
+            return Action02VariableRecord::adjust_value(instruction.type, va, value);
+        }
+
+        default:
+            return std::nullopt;
+    }
+}
+
+
+ChainEvaluator::Result ChainEvaluator::run(State& state, uint32_t target_index) const
+{
+    const Target* target = &m_targets[target_index];
+    while (target->is_switch)
+    {
+        const uint32_t start = target->value;
+        if (state.trace != nullptr)
+            state.trace->push_back(m_owners[start]);
+
+        uint32_t last = 0;
+        for (uint32_t pc = start; ; ++pc)
+        {
+            const Instruction& instruction = m_instructions[pc];
+            ++state.instructions;
+
+            if (instruction.opcode == Opcode::Select)
+            {
+                uint32_t selected = instruction.c;
+                for (uint32_t i = instruction.a; i < instruction.a + instruction.b; ++i)
+                {
+                    const Range& range = m_ranges[i];
+                    if ((range.low <= last) && (last <= range.high))
+                    {
+                        selected = range.target;
+                        break;
+                    }
+                }
+                state.last_value = last;
+                target = &m_targets[selected];
+                break;
+            }
+
+            if (instruction.opcode == Opcode::Calculated)
+            {
+                state.last_value = last;
+                // A failed callback is passed on as it is, rather than as a result.
+                uint32_t result = (last == CALLBACK_FAILED) ? last : (last & 0x7FFF);
+                return { Result::Kind::Callback, result, last, state.instructions };
+            }
+
+            if (instruction.opcode == Opcode::Random)
+            {
+                uint32_t entry = (state.random_bits >> instruction.c) & (instruction.b - 1);
+                target = &m_targets[instruction.a + entry];
+                break;
+            }
+
+            auto value = read_value(state, instruction, last);
+            if (!value)
+            {
+                target = &m_targets[m_error_targets.at(start)];
+                break;
+            }
+
+            // The stores write the running value to the register given by the value.
+            const auto& va = instruction.action;
+            uint32_t register_id = *value & Action02::type_mask(instruction.type);
+            if (va.operation == Operation::TempStore)
+                state.temp_storage[register_id] = sign_extend(instruction.type, last);
+            else if (va.operation == Operation::PermStore)
+                state.persistent_storage[register_id] = sign_extend(instruction.type, last);
+
+            last = Action02VariableRecord::apply_operation(instruction.type, va.operation, last, *value);
+        }
+    }
+
+    return { target->kind, target->value, state.last_value, state.instructions };
+}
+
+
+ChainEvaluator::Result ChainEvaluator::evaluate(const Environment& env, State& state) const
+{
+    state.env = &env;
+    state.persistent_storage = env.persistent_storage;
+
+    auto it = m_entries.find({ env.feature, env.feature_id });
+    if (it == m_entries.end())
+        return { Result::Kind::NoChain, 0, 0, 0 };
+
+    const Entry& entry = it->second;
+    uint32_t target    = entry.fallback;
+    if (env.cargo_type)
+    {
+        auto cargo = entry.cargo_types.find(*env.cargo_type);
+        if (cargo != entry.cargo_types.end())
+            target = cargo->second;
+    }
+    return run(state, target);
+}
+
+
+ChainEvaluator::Result ChainEvaluator::evaluate(const Environment& env) const
+{
+    State state;
+    state.random_bits = env.random_bits;
+    return evaluate(env, state);
+}
+
+
+ChainEvaluator::Result ChainEvaluator::evaluate(const Environment& env, std::vector<uint32_t>& trace) const
+{
+    State state;
+    state.random_bits = env.random_bits;
+    state.trace       = &trace;
+    return evaluate(env, state);
+}
+
+
+void ChainEvaluator::fuzz(std::ostream& os, const Environment& env, uint32_t iterations) const
+{
+    std::map<std::pair<Result::Kind, uint32_t>, uint32_t> counts;
+    uint64_t instructions = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    State state;
+    state.fuzzing = true;
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        state.iteration    = iteration;
+        state.random_bits  = uint32_t(Action02::mix(iteration));
+        state.last_value   = 0;
+        state.instructions = 0;
+        state.temp_storage.clear();
+
+        Result result = evaluate(env, state);
+        ++counts[{ result.kind, result.value }];
+        instructions += result.instructions;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double seconds = std::max(elapsed.count(), 1e-9);
+    os << "Evaluations: " << iterations << " in " << std::fixed << std::setprecision(3) << seconds << "s (";
+    os << std::setprecision(0) << (iterations / seconds) << " per second, ";
+    os << std::setprecision(2) << (double(instructions) / std::max(iterations, 1U)) << " instructions each)\n";
+
+    std::vector<std::pair<uint32_t, Result>> results;
+    for (const auto& [key, count]: counts)
+    {
+        results.push_back({ count, Result{ key.first, key.second, 0, 0 } });
+    }
+    std::stable_sort(results.begin(), results.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    os << "Results:\n";
+    for (const auto& [count, result]: results)
+    {
+        os << std::setw(10) << count << "  ";
+        print_result(os, result);
+        os << "\n";
+    }
+}
+
+
+void ChainEvaluator::report(std::ostream& os, const Environment& env, uint32_t iterations) const
+{
+    if (iterations > 1)
+    {
+        fuzz(os, env, iterations);
+        return;
+    }
+
+    std::vector<uint32_t> trace;
+    Result result = evaluate(env, trace);
+    os << "Chain for " << FeatureName(env.feature) << " " << as_hex(env.feature_id) << ":\n";
+    for (auto index: trace)
+    {
+        os << "    ";
+        print_record(os, index);
+        os << "\n";
+    }
+    os << "Result: ";
+    print_result(os, result);
+    os << "\nLast value: " << as_hex(result.last_value) << ", instructions: " << result.instructions << "\n";
+}
+
+
+void ChainEvaluator::print_result(std::ostream& os, const Result& result) const
+{
+    switch (result.kind)
+    {
+        case Result::Kind::SpriteGroup: print_record(os, result.value); break;
+        case Result::Kind::Callback:
+            if (result.value == CALLBACK_FAILED)
+                os << "callback failed";
+            else
+                os << "callback " << as_hex(uint16_t(result.value));
+            break;
+        case Result::Kind::Unresolved:  os << "undefined set " << as_hex(uint16_t(result.value)); break;
+        case Result::Kind::NoChain:     os << "no Action03 for this feature and ID"; break;
+    }
+}
+
+
+void ChainEvaluator::print_record(std::ostream& os, uint32_t index) const
+{
+    const Record& record = *m_records[index];
+    os << "#" << m_numbers[index] << " " << RecordName(record.record_type());
+    os << " " << as_hex(SpriteGroupGraph::act02_set_id(record));
+}
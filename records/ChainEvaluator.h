@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "SpriteGroupGraph.h"
+#include "Action02VariableRecord.h"
+#include "TokenStream.h"
+#include <iosfwd>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+
+// Compiles the Action02 chains of a GRF into a compact bytecode so that they can be evaluated
+// outside the game, to test their logic or to measure how quickly they run. Each switch becomes
+// a short run of instructions, one for each variable it reads, ending with an instruction which
+// selects the next switch, a sprite group or a callback result.
+class ChainEvaluator
+{
+public:
+    // The inputs for one evaluation. Variables below 60 and from 80 have parameter 0.
+    struct Environment
+    {
+        FeatureType            feature    = FeatureType::Trains;
+        uint16_t               feature_id = 0;
+        std::optional<uint8_t> cargo_type;  // The default chain is used if not set.
+        uint32_t               random_bits = 0;
+        std::map<std::pair<uint8_t, uint8_t>, uint32_t> variables;
+        std::map<uint32_t, uint32_t>                     persistent_storage;
+
+        // Reads a JSON object such as:
+        // { "feature": "Trains", "feature_id": 5, "variables": { "0x40": 7, "0x60:0x05": 3 } }
+        // Numbers may also be written in hex.
+        static Environment parse(TokenStream& is);
+    };
+
+    struct Result
+    {
+        enum class Kind { SpriteGroup, Callback, Unresolved, NoChain };
+
+        Kind     kind;
+        // The record for a sprite group, the callback result or the set ID. A calculated
+        // callback result of 0xFFFF means that the callback failed.
+        uint32_t value;
+        uint32_t last_value;   // The value calculated by the last switch.
+        uint32_t instructions; // The number of instructions executed.
+    };
+
+public:
+    // The top level records of the data section, in file order.
+    explicit ChainEvaluator(const std::vector<const Record*>& records);
+
+    // Variables which are not in the environment are not available.
+    Result evaluate(const Environment& env) const;
+    // As above, but also lists the records visited.
+    Result evaluate(const Environment& env, std::vector<uint32_t>& trace) const;
+    // Runs many evaluations in which the variables which are not in the environment have
+    // pseudo-random values, and writes the number of times each result was selected and
+    // the rate of evaluation.
+    void fuzz(std::ostream& os, const Environment& env, uint32_t iterations) const;
+
+    // Writes the records visited and the result of one evaluation, or runs fuzz() if there is
+    // more than one iteration.
+    void report(std::ostream& os, const Environment& env, uint32_t iterations) const;
+
+    void print_result(std::ostream& os, const Result& result) const;
+    void print_record(std::ostream& os, uint32_t index) const;
+    std::size_t num_instructions() const { return m_instructions.size(); }
+
+private:
+    using VarType   = Action02VariableRecord::VarType;
+    using Operation = Action02VariableRecord::Operation;
+
+    enum class Opcode : uint8_t
+    {
+        // These read a value, adjust it, and combine it with the running value.
+        Constant,   // The adjusted value is in a.
+        Variable,   // A variable and its parameter, which may be storage or the last value.
+        Indirect,   // The variable in the parameter, with the running value as its parameter.
+        Call,       // The callback result of target a (variable 7E).
+        // These end a switch.
+        Select,     // Ranges [a, a + b) and the default target c.
+        Calculated, // Returns the running value as a callback result.
+        Random,     // Targets [a, a + b), indexed by the random bits shifted right by c.
+    };
+
+    struct Instruction
+    {
+        Opcode   opcode{};
+        VarType  type{};
+        uint32_t a{};
+        uint32_t b{};
+        uint32_t c{};
+        // The variable, adjustment and operation for the loads.
+        Action02VariableRecord::VarAction action{};
+    };
+
+    // Where a reference leads: to another compiled record, or the end of the evaluation.
+    struct Target
+    {
+        bool         is_switch;
+        Result::Kind kind;
+        uint32_t     value; // The first instruction for a switch.
+    };
+
+    struct Range
+    {
+        uint32_t low;
+        uint32_t high;
+        uint32_t target;
+    };
+
+    struct Entry
+    {
+        std::map<uint8_t, uint32_t> cargo_types;
+        uint32_t                    fallback;
+    };
+
+    // The state of one evaluation, shared with the procedures it calls.
+    struct State;
+
+private:
+    uint32_t make_target(uint32_t index, uint16_t set_id);
+    void     compile(uint32_t index);
+    std::optional<uint32_t> read_value(State& state, const Instruction& instruction, uint32_t last) const;
+    Result   run(State& state, uint32_t target) const;
+    Result   evaluate(const Environment& env, State& state) const;
+
+private:
+    std::vector<const Record*>  m_records;
+    SpriteGroupGraph            m_graph;
+    std::vector<Instruction>    m_instructions;
+    std::vector<Range>          m_ranges;
+    std::vector<Target>         m_targets;
+    // The first instruction of each compiled record, and the record of each instruction.
+    std::map<uint32_t, uint32_t> m_starts;
+    std::vector<uint32_t>        m_owners;
+    // The targets used when a variable is not available, by first instruction.
+    std::unordered_map<uint32_t, uint32_t> m_error_targets;
+    // The Action03 entry points for each feature and instance.
+    std::map<std::pair<FeatureType, uint16_t>, Entry> m_entries;
+    // The number of each record as in the hex dump, counting from one and including sprites.
+    std::vector<uint32_t> m_numbers;
+};
@@ -0,0 +1,747 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "GRFSpecialiser.h"
+#include "Action06Record.h"
+#include "Action07Record.h"
+#include "Action0DRecordSimple.h"
+#include "Action10Record.h"
+#include "properties/GRFLabel.h"
+#include "StreamHelpers.h"
+#include <algorithm>
+
+
+namespace {
+
+constexpr uint8_t NUM_PARAMS     = 0x80;
+// The loading stage, which is the only global variable whose value differs between stages.
+constexpr uint8_t LOADING_STAGE  = 0x84;
+// Used with conditions 06 to 0A to test whether another GRF is active.
+constexpr uint8_t GRF_ID_VARIABLE = 0x88;
+
+
+bool is_skip(RecordType type)
+{
+    return (type == RecordType::ACTION_07) || (type == RecordType::ACTION_09);
+}
+
+
+// The calculation done by an Action0D, as in the game.
+std::optional<uint32_t> calculate(uint8_t operation, uint32_t src1, uint32_t src2)
+{
+    int32_t ssrc1 = int32_t(src1);
+    int32_t ssrc2 = int32_t(src2);
+    switch (operation)
+    {
+        case 0x00: return src1;                               // Assignment
+        case 0x01: return src1 + src2;                        // Addition
+        case 0x02: return src1 - src2;                        // Subtraction
+        case 0x03: return src1 * src2;                        // Unsigned multiplication
+        case 0x04: return uint32_t(int64_t{ssrc1} * ssrc2);   // Signed multiplication
+        case 0x07: return src1 & src2;                        // Bitwise AND
+        case 0x08: return src1 | src2;                        // Bitwise OR
+
+        // Shifts: a negative amount shifts to the right.
+        case 0x05:
+            if (ssrc2 >= 0)
+                return src1 << (src2 & 0x1F);
+            return (ssrc2 > -32) ? (src1 >> -ssrc2) : 0;
+        case 0x06:
+            if (ssrc2 >= 0)
+                return uint32_t(ssrc1) << (src2 & 0x1F);
+            return uint32_t(ssrc1 >> std::min(-int64_t{ssrc2}, int64_t{31}));
+
+        // Division and modulus: division by zero leaves the first value unchanged.
+        case 0x09: return (src2 == 0) ? src1 : src1 / src2;
+        case 0x0A: return (src2 == 0) ? src1 : uint32_t(int64_t{ssrc1} / ssrc2);
+        case 0x0B: return (src2 == 0) ? src1 : src1 % src2;
+        case 0x0C: return (src2 == 0) ? src1 : uint32_t(int64_t{ssrc1} % ssrc2);
+    }
+
+    // The game ignores unknown operations.
+    return std::nullopt;
+}
+
+} // namespace {
+
+
+// The known values at one point in one stage. Values which are not known could differ between
+// the ways of reaching that point, or depend on something which is not in the profile.
+struct GRFSpecialiser::State
+{
+    bool reachable{};
+    std::array<std::optional<uint32_t>, NUM_PARAMS> params;
+    // Parameters below this are defined.
+    std::optional<uint32_t>     param_end;
+    std::map<uint8_t, uint32_t> variables;
+
+    std::optional<uint32_t> value(uint8_t variable) const
+    {
+        if (variable < NUM_PARAMS)
+            return params[variable];
+        auto it = variables.find(variable);
+        if (it != variables.end())
+            return it->second;
+        return std::nullopt;
+    }
+
+    void forget()
+    {
+        params.fill(std::nullopt);
+        param_end.reset();
+        variables.clear();
+    }
+
+    // Keeps only the values which are the same in both states.
+    void merge(const State& other)
+    {
+        if (!other.reachable)
+            return;
+        if (!reachable)
+        {
+            *this = other;
+            return;
+        }
+
+        for (uint8_t i = 0; i < NUM_PARAMS; ++i)
+        {
+            if (params[i] != other.params[i])
+                params[i].reset();
+        }
+        if (param_end != other.param_end)
+            param_end.reset();
+        for (auto it = variables.begin(); it != variables.end(); )
+        {
+            auto other_it = other.variables.find(it->first);
+            if ((other_it == other.variables.end()) || (other_it->second != it->second))
+                it = variables.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void set_parameter(const Action0DRecordSimple& action)
+    {
+        uint8_t target         = action.target();
+        uint8_t operation      = action.operation() & 0x7F;
+        bool    not_if_defined = (action.operation() & 0x80) != 0;
+        if (not_if_defined && (target < NUM_PARAMS))
+        {
+            if (!param_end)
+            {
+                params[target].reset();
+                return;
+            }
+            if (target < *param_end)
+                return;
+        }
+
+        // Reading other GRFs' parameters, game settings and reserving resources are not simulated.
+        std::optional<uint32_t> result;
+        if (action.source2() != 0xFE)
+        {
+            auto src1 = (action.source1() == 0xFF) ? action.data_value() : value(action.source1());
+            auto src2 = (action.source2() == 0xFF) ? action.data_value() : value(action.source2());
+            if (src1 && (src2 || (operation == 0x00)))
+            {
+                result = calculate(operation, *src1, src2.value_or(0));
+                if (!result)
+                    return;
+            }
+        }
+
+        if (target < NUM_PARAMS)
+        {
+            params[target] = result;
+            if (param_end)
+                param_end = std::max<uint32_t>(*param_end, target + 1);
+        }
+        else
+        {
+            // Only some global variables can be written, so the value is not used.
+            variables.erase(target);
+        }
+    }
+
+    std::optional<bool> condition(const Action07Record& action, Stage stage, const Profile& profile) const
+    {
+        using Condition = Action07Record::Condition;
+        switch (action.condition())
+        {
+            case Condition::BitSet:
+            case Condition::BitClear:
+            case Condition::Equal:
+            case Condition::NotEqual:
+            case Condition::LessThan:
+            case Condition::GreaterThan:
+                break;
+
+            case Condition::GRFActivated:
+            case Condition::GRFNotActivated:
+            case Condition::GRFInitialised:
+            case Condition::GRFInitOrActive:
+            case Condition::GRFDisabled:
+                return grf_condition(action, stage, profile);
+
+            // These depend on what other GRFs have defined.
+            default:
+                return std::nullopt;
+        }
+
+        uint8_t variable = action.variable();
+        if (variable < NUM_PARAMS)
+        {
+            // The test is not made for a parameter which is not defined.
+            if (!param_end)
+                return std::nullopt;
+            if (variable >= *param_end)
+                return false;
+        }
+
+        auto param_val = value(variable);
+        if (!param_val)
+            return std::nullopt;
+
+        uint32_t cond_val = action.value();
+        switch (action.condition())
+        {
+            case Condition::BitSet:      return (cond_val < 32) && ((*param_val >> cond_val) & 1) != 0;
+            case Condition::BitClear:    return (cond_val >= 32) || ((*param_val >> cond_val) & 1) == 0;
+            case Condition::Equal:       return (*param_val & action.mask()) == cond_val;
+            case Condition::NotEqual:    return (*param_val & action.mask()) != cond_val;
+            case Condition::LessThan:    return (*param_val & action.mask()) < cond_val;
+            case Condition::GreaterThan: return (*param_val & action.mask()) > cond_val;
+            default:                     return std::nullopt;
+        }
+    }
+
+    // The profile lists the GRFs which are active before this one. GRFs which come later are
+    // still being loaded, so only some conditions can be decided, and only during activation.
+    // A GRF which is not listed may not be in the configuration at all, in which case the game
+    // does not skip for conditions 06 to 09, so "not activated" cannot be decided for it.
+    static std::optional<bool> grf_condition(const Action07Record& action, Stage stage, const Profile& profile)
+    {
+        using Condition = Action07Record::Condition;
+        if ((action.variable() != GRF_ID_VARIABLE) || (stage != Stage::Activation) || !profile.grf_ids)
+            return std::nullopt;
+
+        uint32_t grf_id = action.value() & action.mask();
+        bool active = std::any_of(profile.grf_ids->begin(), profile.grf_ids->end(),
+            [&](uint32_t id) { return (id & action.mask()) == grf_id; });
+
+        switch (action.condition())
+        {
+            case Condition::GRFActivated:    return active;
+            case Condition::GRFNotActivated: if (active) return false; break;
+            case Condition::GRFInitOrActive: if (active) return true; break;
+            case Condition::GRFInitialised:
+            case Condition::GRFDisabled:     if (active) return false; break;
+            default:                         break;
+        }
+        return std::nullopt;
+    }
+};
+
+
+// The records skipped by an Action07 or Action09 if its condition is true.
+struct GRFSpecialiser::Skip
+{
+    uint32_t end;  // The index of the first record which is not skipped.
+    bool     jump; // True for a jump to a label rather than a number of sprites.
+};
+
+
+GRFSpecialiser::Profile GRFSpecialiser::Profile::parse(TokenStream& is)
+{
+    Profile profile;
+    is.match_object([&](const std::string& key, const TokenValue& token)
+    {
+        if (key == "parameters")
+        {
+            is.match_list([&]() { profile.parameters.push_back(is.match_uint32()); });
+            if (profile.parameters.size() > NUM_PARAMS)
+                throw PARSER_ERROR("Too many parameters", token);
+        }
+        else if (key == "variables")
+        {
+            is.match_object([&](const std::string& name, const TokenValue& token)
+            {
+                uint32_t variable = TokenStream::parse_number(name, token);
+                if ((variable < NUM_PARAMS) || (variable > 0xFF))
+                    throw PARSER_ERROR("Expected a global variable from 0x80 to 0xFF: '" + name + "'", token);
+                profile.variables[uint8_t(variable)] = is.match_uint32();
+            });
+        }
+        else if (key == "grfs")
+        {
+            profile.grf_ids.emplace();
+            is.match_list([&]()
+            {
+                GRFLabel label;
+                label.parse(is);
+                profile.grf_ids->insert(label.value());
+            });
+        }
+        else
+        {
+            throw PARSER_ERROR("Unexpected key: '" + key + "'", token);
+        }
+    });
+    return profile;
+}
+
+
+GRFSpecialiser::GRFSpecialiser(const std::vector<const Record*>& records, const RecordReader& reader, const RecordWriter& writer)
+: m_records{records}
+, m_reader{reader}
+, m_writer{writer}
+{
+    uint32_t number = 1;
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        const Record& record = *m_records[index];
+        m_numbers.push_back(number);
+        m_indices[number] = index;
+        number += 1 + record.num_sprites_to_write();
+
+        if (record.record_type() == RecordType::ACTION_10)
+            m_labels.push_back({ index, static_cast<const Action10Record&>(record).label() });
+    }
+    // The end of the file.
+    m_indices[number] = uint32_t(m_records.size());
+}
+
+
+// Whether the game handles a type of record in a loading stage. All records are handled
+// during activation.
+bool GRFSpecialiser::is_processed(RecordType type, Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::Init:
+            switch (type)
+            {
+                case RecordType::ACTION_06:
+                case RecordType::ACTION_08:
+                case RecordType::ACTION_09:
+                case RecordType::ACTION_0B:
+                case RecordType::ACTION_0C:
+                case RecordType::ACTION_0D:
+                case RecordType::ACTION_0E:
+                case RecordType::ACTION_0F:
+                case RecordType::ACTION_11:
+                    return true;
+                default:
+                    return false;
+            }
+
+        case Stage::Reserve:
+            switch (type)
+            {
+                case RecordType::ACTION_00:
+                case RecordType::ACTION_06:
+                case RecordType::ACTION_07:
+                case RecordType::ACTION_08:
+                case RecordType::ACTION_09:
+                case RecordType::ACTION_0B:
+                case RecordType::ACTION_0D:
+                case RecordType::ACTION_0E:
+                    return true;
+                default:
+                    return false;
+            }
+
+        default:
+            return true;
+    }
+}
+
+
+// The game jumps to the first label after the skip with the given number, if there is one, and
+// otherwise to an earlier one. Jumping back is not supported here.
+std::optional<GRFSpecialiser::Skip> GRFSpecialiser::skip_range(uint32_t index, const Record& record) const
+{
+    uint8_t num_sprites = static_cast<const Action07Record&>(record).num_sprites();
+
+    bool has_label = false;
+    for (const auto& [label_index, label]: m_labels)
+    {
+        if (label != num_sprites)
+            continue;
+        if (label_index > index)
+            return Skip{ label_index, true };
+        has_label = true;
+    }
+    if (has_label)
+        return std::nullopt;
+
+    if (num_sprites == 0)
+        return Skip{ uint32_t(m_records.size()), false };
+
+    // The skip must end on a record, rather than part way through the sprites of a container.
+    uint32_t end_number = m_numbers[index] + 1 + num_sprites;
+    if (end_number >= m_indices.rbegin()->first)
+        return Skip{ uint32_t(m_records.size()), false };
+    auto it = m_indices.find(end_number);
+    if (it == m_indices.end())
+        return std::nullopt;
+    return Skip{ it->second, false };
+}
+
+
+// The data of the record following an Action06, patched as in the game.
+std::optional<std::string> GRFSpecialiser::apply_patch(const Record& action06, const State& state, uint32_t index) const
+{
+    if ((index + 1) >= m_records.size())
+        return std::nullopt;
+
+    // Only pseudo-sprites can be patched, and the sprites in containers are not read again.
+    const Record& next = *m_records[index + 1];
+    if ((next.record_type() < RecordType::ACTION_00) || (next.record_type() > RecordType::ACTION_14) ||
+        (next.num_sprites_to_write() > 0))
+        return std::nullopt;
+
+    // The offsets include the action byte.
+    std::string data = m_writer(next);
+    for (const auto& mod: static_cast<const Action06Record&>(action06).modifications())
+    {
+        // The remaining modifications are ignored if a parameter is not defined.
+        if (mod.param_num < NUM_PARAMS)
+        {
+            if (!state.param_end)
+                return std::nullopt;
+            if (uint32_t(mod.param_num + (mod.param_size - 1) / 4) >= *state.param_end)
+                break;
+        }
+
+        bool carry = false;
+        for (uint32_t i = 0; (i < mod.param_size) && ((mod.offset + i) < data.size()); ++i)
+        {
+            // Global variables have only one value.
+            if ((mod.param_num >= NUM_PARAMS) && (i >= 4))
+                return std::nullopt;
+            auto value = state.value(uint8_t(mod.param_num + i / 4));
+            if (!value)
+                return std::nullopt;
+
+            if ((i % 4) == 0)
+                carry = false;
+
+            uint8_t  byte = uint8_t(*value >> ((i % 4) * 8));
+            uint8_t& old  = reinterpret_cast<uint8_t&>(data[mod.offset + i]);
+            if (mod.add_bytes)
+            {
+                uint32_t sum = old + byte + (carry ? 1 : 0);
+                old   = uint8_t(sum);
+                carry = sum >= 0x100;
+            }
+            else
+            {
+                old = byte;
+            }
+        }
+    }
+    return data;
+}
+
+
+// Follows one loading stage through the records, keeping the values known on every path. A skip
+// which may or may not be taken joins the state before it to the record where it ends.
+bool GRFSpecialiser::simulate(Stage stage, const Profile& profile, Outcomes& outcomes,
+    std::vector<std::unique_ptr<Record>>& patched, std::string& failure) const
+{
+    State state;
+    state.reachable = true;
+    for (uint8_t i = 0; i < NUM_PARAMS; ++i)
+        state.params[i] = (i < profile.parameters.size()) ? profile.parameters[i] : 0;
+    state.param_end = uint32_t(profile.parameters.size());
+    state.variables = profile.variables;
+    switch (stage)
+    {
+        case Stage::Init:       state.variables[LOADING_STAGE] = 0x000; break;
+        case Stage::Reserve:    state.variables[LOADING_STAGE] = 0x101; break;
+        case Stage::Activation: state.variables[LOADING_STAGE] = 0x201; break;
+    }
+
+    std::map<uint32_t, State> pending;
+    // A skip whose target is not known may land anywhere after it.
+    State anywhere;
+
+    outcomes.assign(m_records.size(), Outcome{});
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        Outcome& outcome = outcomes[index];
+        auto it = pending.find(index);
+        if (it != pending.end())
+        {
+            outcome.joined = it->second.reachable;
+            state.merge(it->second);
+            pending.erase(it);
+        }
+        if (anywhere.reachable)
+        {
+            outcome.joined = true;
+            state.merge(anywhere);
+        }
+        outcome.reachable = state.reachable;
+
+        // The record is changed by an Action06 before it, unless it can also be reached another way.
+        RecordType type = m_records[index]->record_type();
+        outcome.record  = m_records[index];
+        if ((index > 0) && outcomes[index - 1].reachable &&
+            (m_records[index - 1]->record_type() == RecordType::ACTION_06))
+        {
+            outcome.record = nullptr;
+            const auto& patch = outcomes[index - 1].patch;
+            if (patch && !outcome.joined)
+            {
+                try
+                {
+                    patched.push_back(m_reader(*patch));
+                    outcome.record = patched.back().get();
+                }
+                catch (const std::exception&)
+                {
+                }
+            }
+        }
+
+        if (!state.reachable || !is_processed(type, stage))
+            continue;
+
+        if (type == RecordType::ACTION_06)
+        {
+            if (outcome.record)
+                outcome.patch = apply_patch(*outcome.record, state, index);
+        }
+        else if (type == RecordType::ACTION_0D)
+        {
+            if (outcome.record)
+                state.set_parameter(static_cast<const Action0DRecordSimple&>(*outcome.record));
+            else
+                state.forget();
+        }
+        else if (is_skip(type))
+        {
+            if (!outcome.record)
+            {
+                if (!m_labels.empty())
+                {
+                    failure = "the target of the skip at sprite " + std::to_string(m_numbers[index]) +
+                        " is patched, and there are labels";
+                    return false;
+                }
+                anywhere.merge(state);
+                continue;
+            }
+
+            auto skip = skip_range(index, *outcome.record);
+            if (!skip)
+            {
+                failure = "the skip at sprite " + std::to_string(m_numbers[index]) +
+                    " may jump back to a label or ends inside a container";
+                return false;
+            }
+
+            const auto& action07 = static_cast<const Action07Record&>(*outcome.record);
+            outcome.skips = state.condition(action07, stage, profile);
+            if (outcome.skips == false)
+                continue;
+
+            if (skip->end < m_records.size())
+                pending[skip->end].merge(state);
+            if (outcome.skips == true)
+                state.reachable = false;
+        }
+    }
+
+    return true;
+}
+
+
+GRFSpecialiser::Result GRFSpecialiser::specialise(const Profile& profile) const
+{
+    Result result;
+    const uint32_t num_records = uint32_t(m_records.size());
+
+    std::array<Outcomes, NUM_STAGES> outcomes;
+    std::vector<std::unique_ptr<Record>> patched;
+    for (uint8_t stage = 0; stage < NUM_STAGES; ++stage)
+    {
+        if (!simulate(Stage(stage), profile, outcomes[stage], patched, result.failure))
+            return result;
+    }
+
+    auto is_processed_at = [&](uint32_t index)
+    {
+        for (uint8_t stage = 0; stage < NUM_STAGES; ++stage)
+        {
+            if (outcomes[stage][index].reachable && is_processed(m_records[index]->record_type(), Stage(stage)))
+                return true;
+        }
+        return false;
+    };
+
+    // An Action06 is applied if the next record is patched in the same way every time it is
+    // processed. Otherwise the next record must be left alone. A skip which is patched at load
+    // time may have any range, so nothing after it is removed.
+    std::vector<bool> applied(num_records);
+    std::vector<bool> keep(num_records);
+    std::map<uint32_t, std::string> patches;
+    for (uint32_t index = 0; (index + 1) < num_records; ++index)
+    {
+        if (m_records[index]->record_type() != RecordType::ACTION_06)
+            continue;
+
+        std::optional<std::string> patch;
+        bool consistent = true;
+        for (uint8_t stage = 0; stage < NUM_STAGES; ++stage)
+        {
+            const Outcome& next = outcomes[stage][index + 1];
+            if (!next.reachable || !is_processed(m_records[index + 1]->record_type(), Stage(stage)))
+                continue;
+
+            const auto& stage_patch = outcomes[stage][index].patch;
+            if (next.joined || !next.record || !stage_patch || (patch && (*patch != *stage_patch)))
+            {
+                consistent = false;
+                break;
+            }
+            patch = stage_patch;
+        }
+
+        if (consistent)
+        {
+            applied[index] = true;
+            if (patch)
+                patches[index + 1] = *patch;
+        }
+        else if (is_skip(m_records[index + 1]->record_type()))
+        {
+            std::fill(keep.begin() + index + 1, keep.end(), true);
+        }
+        else
+        {
+            keep[index + 1] = true;
+        }
+    }
+
+    auto num_sprites = [&](uint32_t index) { return 1 + m_records[index]->num_sprites_to_write(); };
+
+    // Removing sprites changes the number skipped, which could then match a label. The sprites
+    // are kept in that case, and the removals worked out again.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        result.removed.assign(num_records, false);
+        result.replaced = patches;
+        result.num_resolved = 0;
+
+        for (uint32_t index = 0; index < num_records; ++index)
+        {
+            switch (m_records[index]->record_type())
+            {
+                // These are also read when scanning the files.
+                case RecordType::ACTION_08:
+                case RecordType::ACTION_10:
+                case RecordType::ACTION_14:
+                    break;
+                default:
+                    result.removed[index] = applied[index] || (!keep[index] && !is_processed_at(index));
+            }
+        }
+
+        // Inner skips first, as removing them changes the number of sprites skipped by outer ones.
+        for (uint32_t index = num_records; index-- > 0; )
+        {
+            if (!is_skip(m_records[index]->record_type()) || result.removed[index] || keep[index])
+                continue;
+
+            std::unique_ptr<Record> patched_skip;
+            const Record* record = m_records[index];
+            auto patch = patches.find(index);
+            if (patch != patches.end())
+            {
+                patched_skip = m_reader(patch->second);
+                record       = patched_skip.get();
+            }
+            auto skip = skip_range(index, *record);
+            if (!skip)
+                continue;
+
+            // The skip makes no difference in a stage if its condition is always false there, or
+            // if none of the records it skips are both kept and processed in that stage.
+            bool has_effect = false;
+            for (uint8_t stage = 0; stage < NUM_STAGES; ++stage)
+            {
+                const Outcome& outcome = outcomes[stage][index];
+                if (!outcome.reachable || !is_processed(record->record_type(), Stage(stage)) || (outcome.skips == false))
+                    continue;
+                for (uint32_t i = index + 1; i < skip->end; ++i)
+                {
+                    if (!result.removed[i] && is_processed(m_records[i]->record_type(), Stage(stage)))
+                        has_effect = true;
+                }
+            }
+            uint32_t num_removed = 0;
+            for (uint32_t i = index + 1; i < skip->end; ++i)
+            {
+                if (result.removed[i])
+                    num_removed += num_sprites(i);
+            }
+
+            if (!has_effect)
+            {
+                result.removed[index] = true;
+                ++result.num_resolved;
+                continue;
+            }
+
+            uint8_t count = static_cast<const Action07Record&>(*record).num_sprites();
+            if (skip->jump || (count == 0) || (num_removed == 0))
+                continue;
+
+            uint8_t new_count = uint8_t(count - std::min<uint32_t>(num_removed, count));
+            bool is_label = std::any_of(m_labels.begin(), m_labels.end(),
+                [&](const auto& label) { return label.second == new_count; });
+            if (is_label)
+            {
+                std::fill(keep.begin() + index + 1, keep.begin() + skip->end, true);
+                changed = true;
+                break;
+            }
+
+            // The number of sprites is the last byte of the record.
+            std::string data = (patch != patches.end()) ? patch->second : m_writer(*record);
+            data.back() = char(new_count);
+            result.replaced[index] = data;
+        }
+    }
+
+    for (uint32_t index = 0; index < num_records; ++index)
+    {
+        if (result.removed[index])
+        {
+            result.replaced.erase(index);
+            if (applied[index] && patches.count(index + 1))
+                ++result.num_patches;
+        }
+    }
+    return result;
+}
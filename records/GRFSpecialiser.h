@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Record.h"
+#include "TokenStream.h"
+#include <array>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+
+// Partially evaluates the loading of a GRF for a fixed configuration. The parameter values set
+// by Action0D are followed through the file, and the Action07 and Action09 conditions which
+// depend only on known values are resolved. This finds the records which can never be loaded,
+// the conditional skips which make no difference, and the Action06 patches whose inputs are
+// known, so that a smaller GRF can be written for that configuration.
+//
+// The game reads the file once for each loading stage, starting with the configured parameters
+// each time, and not every action is processed in every stage. This matters because Action07
+// is not evaluated during initialisation, when Action09 and Action0D are. The stages are
+// simulated separately, and a record is only removed if it is skipped in every stage in which
+// it would be processed. Action08, Action10 and Action14 are always kept, as they are also
+// read when scanning the files.
+class GRFSpecialiser
+{
+public:
+    // The configuration for which the GRF is specialised.
+    struct Profile
+    {
+        // The parameters set in the configuration. Others are not defined.
+        std::vector<uint32_t>       parameters;
+        // Known values of global variables (80+), such as the climate (83).
+        std::map<uint8_t, uint32_t> variables;
+        // The GRFs which are active and loaded before this one, if known.
+        std::optional<std::set<uint32_t>> grf_ids;
+
+        // Reads a JSON object such as:
+        // { "parameters": [ 1, 0, 0x10 ], "variables": { "0x83": 2 }, "grfs": [ "ABCD", "DJT\x01" ] }
+        // Numbers may also be written in hex.
+        static Profile parse(TokenStream& is);
+    };
+
+    // Converts the data of a top level record, starting with the action, to a record and back.
+    using RecordReader = std::function<std::unique_ptr<Record>(const std::string& data)>;
+    using RecordWriter = std::function<std::string(const Record& record)>;
+
+    struct Result
+    {
+        // Empty if the GRF could be specialised. Otherwise the reason it could not.
+        std::string failure;
+        // The records to remove, with their sprites.
+        std::vector<bool> removed;
+        // The new data for records which are kept but changed, by an Action06 patch or because
+        // some of the sprites they skip have been removed.
+        std::map<uint32_t, std::string> replaced;
+
+        uint32_t num_resolved = 0; // Action07 and Action09 removed because their outcome is known.
+        uint32_t num_patches  = 0; // Action06 applied and removed.
+    };
+
+public:
+    // The top level records of the data section, in file order.
+    GRFSpecialiser(const std::vector<const Record*>& records, const RecordReader& reader, const RecordWriter& writer);
+
+    Result specialise(const Profile& profile) const;
+
+private:
+    enum class Stage { Init, Reserve, Activation };
+    static constexpr uint8_t NUM_STAGES = 3;
+
+    struct State;
+    struct Skip;
+    // What happened to one record in one stage.
+    struct Outcome
+    {
+        bool                       reachable{};
+        // True if the record can be reached other than by falling through from the one before.
+        bool                       joined{};
+        // The record as seen in this stage: the original, or patched by the Action06 before it.
+        // Null if the patch is not known.
+        const Record*              record{};
+        // For Action07 and Action09, if known.
+        std::optional<bool>        skips;
+        // For Action06, the patched data of the next record, if known.
+        std::optional<std::string> patch;
+    };
+    using Outcomes = std::vector<Outcome>;
+
+    static bool is_processed(RecordType type, Stage stage);
+
+    bool simulate(Stage stage, const Profile& profile, Outcomes& outcomes,
+        std::vector<std::unique_ptr<Record>>& patched, std::string& failure) const;
+    std::optional<Skip> skip_range(uint32_t index, const Record& record) const;
+    std::optional<std::string> apply_patch(const Record& action06, const State& state, uint32_t index) const;
+
+private:
+    std::vector<const Record*> m_records;
+    RecordReader               m_reader;
+    RecordWriter               m_writer;
+
+    // The sprite number of each record, and the index of the record starting at each number.
+    std::vector<uint32_t>             m_numbers;
+    std::map<uint32_t, uint32_t>      m_indices;
+    // The label defined by each Action10, in file order.
+    std::vector<std::pair<uint32_t, uint8_t>> m_labels;
+};
@@ -51,11 +51,23 @@
 #include "StreamHelpers.h"
 #include "EnumDescriptor.h"
 #include "SpriteSheetGenerator.h"
+#include "SpriteSheetReader.h"
 #include "CommandLineOptions.h"
 #include "Exceptions.h"
 #include "Version.h"
+#include "FileSystem.h"
+#include "ThreadPool.h"
+#include "FileQueue.h"
+#include "TextBuffer.h"
+#include "Profiler.h"
+#include "StringPool.h"
+#include "SpriteGroupGraph.h"
 #include <sstream>
 #include <fstream>
+#include <iomanip>
+#include <set>
+#include <algorithm>
+#include <unordered_map>
 #include <csignal>
 
 
@@ -65,12 +77,15 @@ static constexpr std::array<uint8_t, 8> CONTAINER2_IDENTIFIER
 
 
 NewGRFData::NewGRFData()
+: m_strings{std::make_unique<StringPool>()}
 {
 }
 
 
 void NewGRFData::read(std::istream& is)
 {
+    ScopedTimer timer{"Read GRF"};
+
     // The structure of a GRF file is pretty simple. It is just a list of
     // variable length records in up to three sections:
     // Header:  Format2 only        - exactly one record.
@@ -335,6 +350,8 @@ void NewGRFData::read_sprite(std::istream& is, uint32_t sprite_id, uint32_t size
 
 std::unique_ptr<Record> NewGRFData::read_record(std::istream& is, uint32_t size, bool top_level, const GRFInfo& info)
 {
+    StringPool::Scope strings{*m_strings};
+
     // Extract the type and data of this record. A little bit of interpretation is
     // required to work out how to parse the data. Whether we parse the data or not,
     // it has now been taken out of the file stream.
@@ -543,7 +560,7 @@ void NewGRFData::write_format(std::ostream& os, uint32_t sprite_offs) const
 }
 
 
-void NewGRFData::write_counter(std::ostream& os) const
+void NewGRFData::write_counter(std::ostream& os, uint32_t num_records) const
 {
     // Create the counter record at the start of the file.
     switch (m_info.format)
@@ -553,19 +570,19 @@ void NewGRFData::write_counter(std::ostream& os) const
     }
     write_uint8(os, 0xFF);
     // It appears we should not count the counter itself.
-    write_uint32(os, total_records());
+    write_uint32(os, num_records);
 }
 
 
 // void compare_strings(const std::string& read, const std::string& write)
 // {
 //     std::ostringstream ros;
-//     for (auto c: read) ros << to_hex(c, false) << ' ';
+//     for (auto c: read) ros << as_hex(c, false) << ' ';
 
 //     std::ostringstream wos;
 //     uint32_t len = write.length();
 //     for (uint32_t i = 1; i < len; ++i)
-//         wos << to_hex(write[i], false) << ' ';
+//         wos << as_hex(write[i], false) << ' ';
 
 //     if (write[0] == 2)
 //         return;
@@ -573,7 +590,7 @@ void NewGRFData::write_counter(std::ostream& os) const
 //     if (ros.str() != wos.str())
 //     {
 //         std::cout << ros.str() << '\n';
-//         std::cout << to_hex(write[0]) << '\n';
+//         std::cout << as_hex(write[0]) << '\n';
 //         std::cout << wos.str() << '\n';
 //         std::cout << '\n';
 //     }
@@ -646,10 +663,12 @@ void NewGRFData::write_record(std::ostream& os, const Record& record) const
 
 void NewGRFData::write(std::ostream& os) const
 {
+    ScopedTimer timer{"Write GRF"};
+
     // Header section indicates that this a Container2 format, or not.
     // The counter is an optional record containing the number of records in the GRF.
     write_format(os);
-    write_counter(os);
+    write_counter(os, total_records());
 
     for (const auto& record: m_records)
     {
@@ -711,8 +730,28 @@ const EnumDescriptorT<GRFFormat> desc_format
 } // namespace {
 
 
+// Runs make_text(index) for each index on the thread pool, and writes the results to the stream
+// in index order. after_write(index) is called as soon as the text for each index has been written.
+template <typename MakeText, typename AfterWrite>
+static void write_in_order(std::ostream& os, uint32_t count, MakeText make_text, AfterWrite after_write)
+{
+    ThreadPool::pool().for_each_ordered(count, make_text,
+        [&os, &after_write](uint32_t index, const std::string& text)
+        {
+            os.write(text.data(), static_cast<std::streamsize>(text.size()));
+            after_write(index);
+        });
+}
+
+
+// Enough for most records without growing the buffer.
+static constexpr std::size_t TypicalRecordText = 512;
+
+
 void NewGRFData::print(std::ostream& os, const std::string& output_dir, const std::string& image_file_base) const
 {
+    ScopedTimer timer{"Print YAGL"};
+
     // Create sprite sheets first in order to have the filenames and locations in place
     // for when we write out the YAGL.
     SpriteSheetGenerator generator(m_sprites, image_file_base, m_info.format);
@@ -726,26 +765,150 @@ void NewGRFData::print(std::ostream& os, const std::string& output_dir, const st
 
     // Finally write out the YAGL script.
     std::cout << "Writing YAGL script...\n";
-    uint32_t index = 1;
-    for (const auto& record: m_records)
-    {
-        os << "// Record #" << index << '\n';
-        record->print(os, m_sprites, 0);
 
-        // This includes the number of real sprites and so on inside container record,
-        // which is probably a mistake. The real sprites are printed inline.
-        //index = index + record->num_sprites_to_write() + 1;
-        ++index;
+    // The text for each record is independent of the others, so the records are printed
+    // concurrently into their own buffers, which are then written out in order. Files which
+    // records write as a side effect are queued, and written in the same order.
+    FileQueue& files = FileQueue::queue();
+    try
+    {
+        write_in_order(os, static_cast<uint32_t>(m_records.size()),
+            [this](uint32_t index)
+            {
+                ScopedTimer timer{"Print record"};
+                FileQueue::Deferral deferral{index};
+                TextBuffer ss{TypicalRecordText};
+
+                // This includes the number of real sprites and so on inside container record,
+                // which is probably a mistake. The real sprites are printed inline.
+                ss << "// Record #" << (index + 1) << '\n';
+                m_records[index]->print(ss, m_sprites, 0);
+                return ss.take();
+            },
+            [&files](uint32_t index)
+            {
+                files.flush(index);
+            });
+    }
+    catch (...)
+    {
+        files.flush(static_cast<uint32_t>(m_records.size()));
+        throw;
     }
 }
 
 
 void NewGRFData::parse(TokenStream& is, const std::string& output_dir, const std::string& image_file_base)
 {
+    ScopedTimer timer{"Parse YAGL"};
+
     // A bit of a bodge, but provide the ability to append sprites from other classes as
     // the objects are created. Probably only needed in SpriteIndexRecord.
     //g_new_grf_data = this;
 
+    parse_header(is);
+
+    // Top level parser. Every record has the format 'keyword [<...>] { ... }'.
+    // We create an object corresponding to the keyword, and then have that object
+    // parse its own internals. The GRF file is nothing more than a long list of
+    // such records. Reading the text should result in the same data structure as
+    // reading the equivalent binary file.
+    //
+    // The records are self-contained, so we first find the range of tokens for each
+    // of them, and then parse them concurrently into pre-sized slots. Each record has
+    // its own sprite map, and these are merged in record order afterwards, so the result
+    // is the same as parsing in sequence.
+    struct ParsedRecord
+    {
+        std::unique_ptr<Record> record;
+        SpriteZoomMap           sprites;
+        std::string             error;
+    };
+
+    const std::vector<uint32_t> ends = is.find_record_ends();
+    std::vector<ParsedRecord> slots(ends.size());
+
+    // Records are parsed in batches to keep the overhead of the tasks down.
+    static constexpr uint32_t BATCH_SIZE = 64;
+    ThreadPool& pool = ThreadPool::pool();
+    std::vector<std::future<void>> batches;
+    for (uint32_t first = 0; first < slots.size(); first += BATCH_SIZE)
+    {
+        uint32_t last = std::min(first + BATCH_SIZE, static_cast<uint32_t>(slots.size()));
+        uint32_t begin = is.index();
+        batches.push_back(pool.submit([this, &is, &ends, &slots, first, last, begin]()
+        {
+            ScopedTimer timer{"Parse records"};
+            StringPool::Scope strings{*m_strings};
+            for (uint32_t index = first; index < last; ++index)
+            {
+                ParsedRecord& slot = slots[index];
+                TokenStream record_is{is, (index == 0) ? begin : ends[index - 1], ends[index]};
+                try
+                {
+                    RecordType type = parse_record_type(record_is);
+                    record_is.unmatch();
+
+                    slot.record = make_record(type);
+                    slot.record->parse(record_is, slot.sprites);
+
+                    const TokenValue& token = record_is.peek();
+                    if (token.type != TokenType::Terminator)
+                    {
+                        throw PARSER_ERROR("Unexpected token after end of record: '" + token.value + "'", token);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    slot.record.reset();
+                    slot.error = e.what();
+                }
+            }
+        }));
+    }
+
+    for (auto& batch: batches)
+    {
+        pool.get(batch);
+    }
+
+    // Every sprite has its pixels, so the sheets and the pixels shared between sprites are
+    // no longer needed.
+    SpriteSheetPool::pool().release_all();
+
+    // Now gather up the results in order.
+    uint32_t exceptions = 0;
+    for (uint32_t record_number = 0; record_number < slots.size(); ++record_number)
+    {
+        ParsedRecord& slot = slots[record_number];
+        if (!slot.record)
+        {
+            std::cout << "ERROR in record #" << record_number << ": ";
+            std::cout << slot.error << "\n";
+            ++exceptions;
+            continue;
+        }
+
+        update_version_info(*slot.record);
+        m_records.push_back(std::move(slot.record));
+
+        // Sprites merged by --optimise are referred to by more than one record, and each
+        // reference repeats the images. The first one defines the sprite.
+        for (auto& it: slot.sprites)
+        {
+            m_sprites.emplace(it.first, std::move(it.second));
+        }
+    }
+
+    if (exceptions > 0)
+    {
+        throw RUNTIME_ERROR("Exceptions occurred during parsing - terminating");
+    }
+}
+
+
+void NewGRFData::parse_header(TokenStream& is)
+{
     // Read the actual version number.
     const TokenValue& token = is.peek();
     if (is.match(TokenType::Ident) != "yagl_version")
@@ -778,25 +941,118 @@ void NewGRFData::parse(TokenStream& is, const std::string& output_dir, const std
         os << "Expected: " << str_yagl_version << "; found: " << yagl_version;
         throw PARSER_ERROR(os.str(), token);
     }
+}
 
-    // Top level parser. Every record has the format 'keyword [<...>] { ... }'.
-    // We create an object corresponding to the keyword, and then have that object
-    // parse its own internals. The GRF file is nothing more than a long list of
-    // such records. Reading the text should result in the same data structure as
-    // reading the equivalent binary file.
+
+std::unique_ptr<Record> NewGRFData::parse_record(TokenStream& is)
+{
+    RecordType type  = parse_record_type(is);
+    is.unmatch();
+
+    StringPool::Scope strings{*m_strings};
+    std::unique_ptr<Record> record = make_record(type);
+    record->parse(is, m_sprites);
+    update_version_info(*record);
+    return record;
+}
+
+
+namespace {
+
+// Real sprites refer to their sprite sheets as '"<file_name>", [<x>, <y>]'. Scan the whole token
+// stream for these to find the last token which refers to each sheet. The result is keyed on that
+// token index so that sheets can be released in order as the parse moves past them.
+std::map<uint32_t, std::vector<std::string>> find_sprite_sheet_last_uses(const TokenStream& is)
+{
+    std::map<std::string, uint32_t> last_uses;
+    for (uint32_t index = is.index(); (index + 2) < is.end(); ++index)
+    {
+        if ( (is.at(index).type     == TokenType::String) &&
+             (is.at(index + 1).type == TokenType::Comma)  &&
+             (is.at(index + 2).type == TokenType::OpenBracket) )
+        {
+            last_uses[RealSpriteRecord::sprite_sheet_path(is.at(index).value)] = index;
+        }
+    }
+
+    std::map<uint32_t, std::vector<std::string>> result;
+    for (const auto& it: last_uses)
+    {
+        result[it.second].push_back(it.first);
+    }
+    return result;
+}
+
+} // namespace {
+
+
+void NewGRFData::stream_encode(TokenStream& is, std::ostream& os, const std::string& spool_file)
+{
+    ScopedTimer timer{"Stream encode"};
+
+    parse_header(is);
+
+    // For Container2 the sprites are compressed as soon as they have been parsed, and spooled into
+    // a temporary file. This is copied to the output as the sprite section once the data section is
+    // complete. Container1 sprites are written inline with the records which refer to them.
+    std::fstream spool;
+    if (m_info.format == GRFFormat::Container2)
+    {
+        spool.open(spool_file, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        if (spool.fail())
+        {
+            throw RUNTIME_ERROR("Error opening sprite spool file: " + spool_file);
+        }
+    }
+
+    // We don't know the number of records until the end, so the counter is patched afterwards,
+    // along with the sprite offset in the header.
+    write_format(os);
+    std::streampos counter_pos = os.tellp();
+    write_counter(os, 0);
+
+    std::map<uint32_t, std::vector<std::string>> sheet_last_uses = find_sprite_sheet_last_uses(is);
+    SpriteSheetPool& pool = SpriteSheetPool::pool();
+
+    // The same sprite ID may be referenced by more than one record, but is only written once.
+    std::set<uint32_t> spooled_ids;
+
+    // Same top level loop as parse(), except that each record is written out and discarded as soon
+    // as it is parsed. Only the sprites for the current record are held in m_sprites.
+    uint32_t num_records   = 0;
     uint32_t exceptions    = 0;
     uint32_t record_number = 0;
     while (is.peek().type != TokenType::Terminator)
     {
         try
         {
-            RecordType type  = parse_record_type(is);
-            is.unmatch();
+            std::unique_ptr<Record> record = parse_record(is);
 
-            std::unique_ptr<Record> record = make_record(type);
-            record->parse(is, m_sprites);
-            update_version_info(*record);
-            m_records.push_back(std::move(record));
+            // There is no point writing anything more once the output is known to be broken, but
+            // we carry on parsing to report any other errors.
+            if (exceptions == 0)
+            {
+                write_record(os, *record);
+                for (uint32_t j = 0; j < record->num_sprites_to_write(); ++j)
+                {
+                    write_record(os, *(record->get_sprite(j)));
+                }
+                num_records += 1 + record->num_sprites_to_write();
+
+                if (m_info.format == GRFFormat::Container2)
+                {
+                    for (const auto& it: m_sprites)
+                    {
+                        if (spooled_ids.insert(it.first).second)
+                        {
+                            for (const auto& sprite: it.second)
+                            {
+                                sprite->write(spool, m_info);
+                            }
+                        }
+                    }
+                }
+            }
         }
         catch (const std::exception& e)
         {
@@ -806,13 +1062,62 @@ void NewGRFData::parse(TokenStream& is, const std::string& output_dir, const std
             ++exceptions;
         }
 
+        m_sprites.clear();
+
+        // Close any sprite sheets which are not referred to again.
+        auto it = sheet_last_uses.begin();
+        while ((it != sheet_last_uses.end()) && (it->first < is.index()))
+        {
+            for (const auto& file_name: it->second)
+            {
+                pool.release_sprite_sheet(file_name);
+            }
+            it = sheet_last_uses.erase(it);
+        }
+
         ++record_number;
     }
 
     if (exceptions > 0)
     {
+        spool.close();
+        fs::remove(spool_file);
         throw RUNTIME_ERROR("Exceptions occurred during parsing - terminating");
     }
+
+    // Data section terminator - zero-length record
+    if (m_info.format == GRFFormat::Container1)
+    {
+        write_uint16(os, 0x0000);
+    }
+    else
+    {
+        write_uint32(os, 0x0000000);
+    }
+
+    // Now we know the offset for the graphics section.
+    // There is a fixed offset here which skips the file header.
+    uint32_t sprite_offs = static_cast<uint32_t>(os.tellp()) - 14U;
+
+    if (m_info.format == GRFFormat::Container2)
+    {
+        // Copying an empty buffer would set the failbit on the output.
+        if (spool.tellp() > 0)
+        {
+            spool.seekg(0, std::istream::beg);
+            os << spool.rdbuf();
+        }
+        write_uint32(os, 0x0000000);
+
+        spool.close();
+        fs::remove(spool_file);
+    }
+
+    // Restore the stream to the beginning to rewrite the header and the counter.
+    os.seekp(0, std::istream::beg);
+    write_format(os, sprite_offs);
+    os.seekp(counter_pos);
+    write_counter(os, num_records);
 }
 
 
@@ -828,55 +1133,1000 @@ void NewGRFData::update_version_info(const Record& record)
 }
 
 
-static std::string to_nfo(const std::string& binary, uint32_t offset)
+// The binary data of a record, without the length and info byte.
+std::string NewGRFData::record_data(const Record& record) const
 {
-    std::ostringstream os;
+    TextBuffer ss;
+    record.write(ss, m_info);
+    return ss.take();
+}
+
+
+void NewGRFData::hex_dump(std::ostream& os) const
+{
+    ScopedTimer timer{"Hex dump"};
 
-    uint32_t size = (uint32_t)(binary.size() - offset);
-    for (uint32_t index = 0; index < size; ++index)
+    // Each record and each sprite is serialised and formatted independently, so these are
+    // dumped concurrently and written out in order.
+    write_in_order(os, static_cast<uint32_t>(m_records.size()),
+        [this](uint32_t index)
+        {
+            const Record& record = *m_records[index];
+            std::string data = record_data(record);
+
+            std::string text = "Record #" + std::to_string(index + 1) + "\n";
+            text += RecordName(record.record_type());
+            text += '\n';
+            append_hex_bytes(text, data, HexLayout::Dump);
+            text += "\n\n";
+            return text;
+        },
+        [](uint32_t) {});
+
+    if (m_info.format == GRFFormat::Container2)
     {
-        os << to_hex<uint8_t>(binary[index + offset], false) << " ";
-        if ((index % 16) == 15)
+        std::vector<const RealSpriteRecord*> sprites;
+        for (const auto& it: m_sprites)
         {
-            os << "\n";
+            for (const auto& record: it.second)
+            {
+                sprites.push_back(dynamic_cast<const RealSpriteRecord*>(record.get()));
+            }
         }
+
+        write_in_order(os, static_cast<uint32_t>(sprites.size()),
+            [this, &sprites](uint32_t index)
+            {
+                const RealSpriteRecord* sprite = sprites[index];
+                std::string data = record_data(*sprite);
+
+                std::string text = "Sprite #" + to_hex(sprite->sprite_id()) + "\n";
+                append_hex_bytes(text, data, HexLayout::Dump);
+                text += '\n';
+                return text;
+            },
+            [](uint32_t) {});
     }
-    return os.str();
 }
 
 
-void NewGRFData::hex_dump(std::ostream& os)
-{
-    uint32_t index = 0;
+namespace {
 
-    for (const auto& record: m_records)
-    {
-        ++index;
+// Pseudo-sprites are written as their size and bytes.
+void append_pseudo_sprite(std::string& text, const std::string& prefix, const std::string& data)
+{
+    text += prefix;
+    text += " * ";
+    text += std::to_string(data.size());
+    text += '\t';
+    append_hex_bytes(text, data, HexLayout::NFO);
+    text += '\n';
+}
 
+} // namespace {
 
-        std::ostringstream ss;
-        record->write(ss, m_info);
 
-        os << "Record #" << index << "\n";
-        os << RecordName(record->record_type()) << "\n";
-        os << to_nfo(ss.str(), 0) << "\n\n";
+void NewGRFData::print_nfo_sprite(std::string& text, uint32_t number, const Record& record) const
+{
+    // The sprite number is right aligned in the first five columns.
+    std::string prefix = std::to_string(number);
+    if (prefix.size() < 5)
+    {
+        prefix.insert(0, 5 - prefix.size(), ' ');
     }
 
-    if (m_info.format == GRFFormat::Container2)
+    if ((record.record_type() == RecordType::SPRITE_INDEX) || (record.record_type() == RecordType::REAL_SPRITE))
     {
-        for (const auto& it: m_sprites)
+        // Real sprites are described by their location in the sprite sheets. The alternative
+        // zoom levels and colour depths for the same sprite follow on continuation lines.
+        uint32_t sprite_id = (record.record_type() == RecordType::SPRITE_INDEX) ?
+            static_cast<const SpriteIndexRecord&>(record).sprite_id() :
+            static_cast<const RealSpriteRecord&>(record).sprite_id();
+
+        for (const auto& sprite: m_sprites.at(sprite_id))
         {
-            for (const auto& record: it.second)
+            if (sprite->record_type() == RecordType::SPRITE_WRAPPER)
             {
-                ++index;
-                auto sprite = dynamic_cast<RealSpriteRecord*>(record.get());
-
-                std::ostringstream ss;
-                sprite->write(ss, m_info);
-                os << "Sprite #" << to_hex(sprite->sprite_id()) << "\n";
-                os << to_nfo(ss.str(), 0) << "\n";
+                // Sound effects can be stored in the sprite section of Container2 files.
+                const Record& wrapped = static_cast<const SpriteWrapperRecord&>(*sprite).sprite();
+                append_pseudo_sprite(text, prefix, record_data(wrapped));
+            }
+            else
+            {
+                TextBuffer ss;
+                ss << prefix << ' ';
+                static_cast<const RealSpriteRecord&>(*sprite).print_nfo(ss);
+                ss << '\n';
+                text += ss.take();
             }
+            prefix = "    |";
         }
     }
+    else
+    {
+        // All the others are pseudo-sprites, which are just the bytes.
+        append_pseudo_sprite(text, prefix, record_data(record));
+    }
+}
+
+
+void NewGRFData::nfo_dump(std::ostream& os, const std::string& image_file_base) const
+{
+    ScopedTimer timer{"NFO dump"};
+
+    // Real sprites refer to the sprite sheets, so these have to be created first.
+    SpriteSheetGenerator generator(m_sprites, image_file_base, m_info.format);
+    generator.generate();
+
+    // This is the version of the format written by current versions of grfcodec. Sprite 0
+    // is the counter, which holds the number of sprites which follow it.
+    os << "// Automatically generated by yagl " << str_yagl_version << ". Do not modify!\n";
+    os << "// (Info version 32)\n";
+    os << "// Format: spritenum imagefile depth xpos ypos xsize ysize xrel yrel zoom flags\n";
+
+    std::string counter = "    0 * 4\t";
+    std::string data;
+    uint32_t num_sprites = total_records();
+    for (uint8_t byte = 0; byte < 4; ++byte)
+    {
+        data += static_cast<char>((num_sprites >> (8 * byte)) & 0xFF);
+    }
+    append_hex_bytes(counter, data, HexLayout::NFO);
+    os << counter << '\n';
+
+    // Containers are numbered along with the sprites they hold, so we need the number of
+    // each top level record before they can be formatted concurrently.
+    std::vector<uint32_t> numbers;
+    numbers.reserve(m_records.size());
+    uint32_t number = 1;
+    for (const auto& record: m_records)
+    {
+        numbers.push_back(number);
+        number += 1 + record->num_sprites_to_write();
+    }
+
+    write_in_order(os, static_cast<uint32_t>(m_records.size()),
+        [this, &numbers](uint32_t index)
+        {
+            const Record& record = *m_records[index];
+            uint32_t number = numbers[index];
+
+            std::string text;
+            print_nfo_sprite(text, number++, record);
+            for (uint16_t j = 0; j < record.num_sprites_to_write(); ++j)
+            {
+                print_nfo_sprite(text, number++, *record.get_sprite(j));
+            }
+            return text;
+        },
+        [](uint32_t) {});
+}
+
+
+
+namespace {
+
+// Running totals for one line of the statistics report.
+struct RecordTotals
+{
+    uint32_t count{};
+    uint64_t bytes{};
+};
+
+
+struct SpriteTotals
+{
+    uint32_t sprites{};
+    uint64_t pixel_bytes{};      // Raw image data.
+    uint64_t chunked_bytes{};    // After chunk encoding, if any, and before LZ77 compression.
+    uint64_t compressed_bytes{}; // As stored in the GRF.
+};
+
+
+// Ratios are written as fractions of the original size, so smaller is better.
+void print_ratio(std::ostream& os, uint64_t numerator, uint64_t denominator)
+{
+    os << std::fixed << std::setprecision(3);
+    os << ((denominator > 0) ? double(numerator) / double(denominator) : 1.0);
 }
 
+} // namespace {
+
+
+void NewGRFData::stats(std::ostream& os) const
+{
+    ScopedTimer timer{"Stats"};
+
+    // Counts and sizes of the records in the data section, by type and by feature. For
+    // Container1, the sprite indices stand in for the real sprites, which are counted below.
+    std::map<RecordType, RecordTotals>  record_types;
+    std::map<FeatureType, RecordTotals> features;
+    auto add_record = [&](const Record& record)
+    {
+        if ((record.record_type() == RecordType::SPRITE_INDEX) && (m_info.format == GRFFormat::Container1))
+            return;
+
+        uint64_t bytes = 0;
+        if (record.record_type() == RecordType::REAL_SPRITE)
+            bytes = static_cast<const RealSpriteRecord&>(record).compressed_size();
+        else
+            bytes = record_data(record).size();
+
+        RecordTotals& totals = record_types[record.record_type()];
+        ++totals.count;
+        totals.bytes += bytes;
+
+        if (auto feature = record.feature())
+        {
+            RecordTotals& totals = features[*feature];
+            ++totals.count;
+            totals.bytes += bytes;
+        }
+    };
+
+    for (const auto& record: m_records)
+    {
+        add_record(*record);
+        for (uint16_t j = 0; j < record->num_sprites_to_write(); ++j)
+        {
+            add_record(*record->get_sprite(j));
+        }
+    }
+
+    // The real sprites are grouped in the same way as for the sprite sheets. The data for
+    // a mask is held in the 32bpp sprite, so masks are only counted.
+    std::map<SpriteSheetGenerator::Category, SpriteTotals> categories;
+    for (const auto& [category, sprites]: SpriteSheetGenerator::partition(m_sprites))
+    {
+        SpriteTotals& totals = categories[category];
+        totals.sprites = static_cast<uint32_t>(sprites.size());
+        if (category.colour == SpriteSheetGenerator::ColourType::Mask)
+            continue;
+
+        for (const auto sprite: sprites)
+        {
+            totals.pixel_bytes      += sprite->pixels_size();
+            totals.chunked_bytes    += sprite->chunked_size();
+            totals.compressed_bytes += sprite->compressed_size();
+        }
+    }
+
+    uint32_t num_sprites = 0;
+    for (const auto& it: m_sprites)
+    {
+        num_sprites += static_cast<uint32_t>(it.second.size());
+    }
+
+    // The report is JSON so that it can be tracked by scripts from one release to the next.
+    os << "{\n";
+    os << "    \"format\": \"" << desc_format.value(m_info.format) << "\",\n";
+    os << "    \"records\": " << total_records() << ",\n";
+    os << "    \"sprites\": " << num_sprites << ",\n";
+
+    os << "    \"record_types\": {";
+    const char* sep = "\n";
+    for (const auto& [type, totals]: record_types)
+    {
+        os << sep << "        \"" << RecordName(type) << "\": { \"count\": " << totals.count;
+        os << ", \"bytes\": " << totals.bytes << " }";
+        sep = ",\n";
+    }
+    os << "\n    },\n";
+
+    os << "    \"features\": {";
+    sep = "\n";
+    for (const auto& [feature, totals]: features)
+    {
+        os << sep << "        \"" << FeatureName(feature) << "\": { \"records\": " << totals.count;
+        os << ", \"bytes\": " << totals.bytes << " }";
+        sep = ",\n";
+    }
+    os << "\n    },\n";
+
+    os << "    \"sprite_categories\": {";
+    sep = "\n";
+    for (const auto& [category, totals]: categories)
+    {
+        os << sep << "        \"" << SpriteSheetGenerator::category_name(category) << "\": { ";
+        os << "\"sprites\": " << totals.sprites;
+        if (category.colour != SpriteSheetGenerator::ColourType::Mask)
+        {
+            os << ", \"pixel_bytes\": " << totals.pixel_bytes;
+            os << ", \"chunked_bytes\": " << totals.chunked_bytes;
+            os << ", \"compressed_bytes\": " << totals.compressed_bytes;
+            os << ", \"chunk_ratio\": ";
+            print_ratio(os, totals.chunked_bytes, totals.pixel_bytes);
+            os << ", \"lz77_ratio\": ";
+            print_ratio(os, totals.compressed_bytes, totals.chunked_bytes);
+            os << ", \"ratio\": ";
+            print_ratio(os, totals.compressed_bytes, totals.pixel_bytes);
+        }
+        os << " }";
+        sep = ",\n";
+    }
+    os << "\n    },\n";
+
+    StringPool::Stats strings = m_strings->stats();
+    os << "    \"strings\": { \"count\": " << strings.strings;
+    os << ", \"unique\": " << strings.unique;
+    os << ", \"bytes\": " << strings.bytes;
+    os << ", \"unique_bytes\": " << strings.unique_bytes << " }\n";
+    os << "}\n";
+}
+
+
+std::vector<const Record*> NewGRFData::data_records() const
+{
+    std::vector<const Record*> result;
+    result.reserve(total_records());
+
+    for (const auto& record: m_records)
+    {
+        result.push_back(record.get());
+        for (uint16_t j = 0; j < record->num_sprites_to_write(); ++j)
+        {
+            result.push_back(record->get_sprite(j));
+        }
+    }
+
+    return result;
+}
+
+
+namespace {
+
+// FNV-1a. This only has to tell records apart within a pair of files, and is cheap.
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME        = 0x00000100000001b3;
+
+
+uint64_t hash_bytes(uint64_t hash, const void* data, std::size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+
+template <typename T>
+uint64_t hash_value(uint64_t hash, T value)
+{
+    return hash_bytes(hash, &value, sizeof(value));
+}
+
+
+std::string sprite_summary(const RealSpriteRecord& sprite)
+{
+    using ColourType = SpriteSheetGenerator::ColourType;
+    ColourType colour = (sprite.colour() & RealSpriteRecord::HAS_RGB) ? ColourType::RGBA : ColourType::Palette;
+
+    std::ostringstream os;
+    os << SpriteSheetGenerator::category_name({sprite.zoom(), colour});
+    if ((sprite.colour() & RealSpriteRecord::HAS_RGB) && (sprite.colour() & RealSpriteRecord::HAS_PALETTE))
+        os << " with mask";
+    os << ", [" << sprite.xdim() << ", " << sprite.ydim() << ", " << sprite.xrel() << ", " << sprite.yrel() << "]";
+    os << ", pixels " << as_hex(hash_bytes(FNV_OFFSET_BASIS, sprite.pixels().data(), sprite.pixels().size()));
+    return os.str();
+}
+
+} // namespace {
+
+
+uint64_t NewGRFData::content_hash(const Record& record) const
+{
+    uint64_t hash = hash_value(FNV_OFFSET_BASIS, record.record_type());
+
+    if (record.record_type() == RecordType::SPRITE_INDEX)
+    {
+        auto reference = static_cast<const SpriteIndexRecord*>(&record);
+        auto it = m_sprites.find(reference->sprite_id());
+        return (it != m_sprites.end()) ? sprites_hash(hash, it->second) : hash;
+    }
+
+    std::string data = record_data(record);
+    return hash_bytes(hash, data.data(), data.size());
+}
+
+
+uint64_t NewGRFData::sprites_hash(uint64_t hash, const SpriteZoomVector& sprites) const
+{
+    for (const auto& sprite: sprites)
+    {
+        if (sprite->record_type() != RecordType::REAL_SPRITE)
+        {
+            std::string data = record_data(*sprite);
+            hash = hash_bytes(hash, data.data(), data.size());
+            continue;
+        }
+
+        // The compressed data depends on the encoder, so only the image itself counts.
+        auto real = static_cast<const RealSpriteRecord*>(sprite.get());
+        hash = hash_value(hash, real->zoom());
+        hash = hash_value(hash, real->colour());
+        hash = hash_value(hash, real->xdim());
+        hash = hash_value(hash, real->ydim());
+        hash = hash_value(hash, real->xrel());
+        hash = hash_value(hash, real->yrel());
+        hash = hash_bytes(hash, real->pixels().data(), real->pixels().size());
+    }
+    return hash;
+}
+
+
+// The same comparison as for sprites_hash(), for when the hashes match.
+bool NewGRFData::same_sprites(const SpriteZoomVector& sprites1, const SpriteZoomVector& sprites2) const
+{
+    if (sprites1.size() != sprites2.size())
+        return false;
+
+    for (std::size_t i = 0; i < sprites1.size(); ++i)
+    {
+        const Record& record1 = *sprites1[i];
+        const Record& record2 = *sprites2[i];
+        if (record1.record_type() != record2.record_type())
+            return false;
+
+        if (record1.record_type() != RecordType::REAL_SPRITE)
+        {
+            if (record_data(record1) != record_data(record2))
+                return false;
+            continue;
+        }
+
+        auto& real1 = static_cast<const RealSpriteRecord&>(record1);
+        auto& real2 = static_cast<const RealSpriteRecord&>(record2);
+        if ((real1.zoom() != real2.zoom()) || (real1.colour() != real2.colour()) ||
+            (real1.xdim() != real2.xdim()) || (real1.ydim() != real2.ydim()) ||
+            (real1.xrel() != real2.xrel()) || (real1.yrel() != real2.yrel()) ||
+            (real1.pixels() != real2.pixels()))
+            return false;
+    }
+    return true;
+}
+
+
+void NewGRFData::print_record(std::ostream& os, const Record& record) const
+{
+    if (record.record_type() == RecordType::SPRITE_INDEX)
+    {
+        auto reference = static_cast<const SpriteIndexRecord*>(&record);
+        os << RecordName(record.record_type()) << " " << reference->sprite_id() << "\n";
+
+        auto it = m_sprites.find(reference->sprite_id());
+        if (it == m_sprites.end())
+            return;
+
+        for (const auto& sprite: it->second)
+        {
+            if (sprite->record_type() == RecordType::REAL_SPRITE)
+                os << pad(4) << sprite_summary(*static_cast<const RealSpriteRecord*>(sprite.get())) << "\n";
+            else
+                sprite->print(os, m_sprites, 4);
+        }
+    }
+    else if (record.num_sprites_to_write() > 0)
+    {
+        // Containers print their sprites as well, but those are compared separately.
+        std::string text = RecordName(record.record_type());
+        text += "\n";
+        append_hex_bytes(text, record_data(record), HexLayout::Dump);
+        os << text << "\n";
+    }
+    else
+    {
+        record.print(os, m_sprites, 0);
+    }
+}
+
+
+std::vector<const Record*> NewGRFData::top_level_records() const
+{
+    std::vector<const Record*> records;
+    records.reserve(m_records.size());
+    for (const auto& record: m_records)
+    {
+        records.push_back(record.get());
+    }
+    return records;
+}
+
+
+void NewGRFData::optimise()
+{
+    ScopedTimer timer{"Optimise"};
+
+    if (SpriteGroupGraph{top_level_records()}.is_static())
+    {
+        simplify_switches();
+        merge_duplicate_sets();
+        remove_dead_sets();
+    }
+    else
+    {
+        std::cout << "Not optimising sets: Action06, Action07 and Action09 may change which sets are used\n";
+    }
+
+    merge_duplicate_sprites();
+}
+
+
+namespace {
+
+// Sprites are shared by ID, so those used by a removed container may still be used elsewhere.
+void add_sprite_ids(std::set<uint32_t>& sprite_ids, const Record& record)
+{
+    for (uint16_t j = 0; j < record.num_sprites_to_write(); ++j)
+    {
+        const Record* sprite = record.get_sprite(j);
+        if (sprite->record_type() == RecordType::SPRITE_INDEX)
+            sprite_ids.insert(static_cast<const SpriteIndexRecord*>(sprite)->sprite_id());
+    }
+}
+
+
+void rename_act02_set_id(Record& record, uint16_t from, uint16_t to)
+{
+    switch (record.record_type())
+    {
+        case RecordType::ACTION_02_VARIABLE: static_cast<Action02VariableRecord&>(record).rename_act02_set_id(from, to); break;
+        case RecordType::ACTION_02_RANDOM:   static_cast<Action02RandomRecord&>(record).rename_act02_set_id(from, to); break;
+        case RecordType::ACTION_03:          static_cast<Action03Record&>(record).rename_act02_set_id(from, to); break;
+        default: break;
+    }
+}
+
+
+bool calls_procedure(const Record& record, uint16_t set_id)
+{
+    if (record.record_type() != RecordType::ACTION_02_VARIABLE)
+        return false;
+
+    auto set_ids = static_cast<const Action02VariableRecord&>(record).procedure_set_ids();
+    return std::find(set_ids.begin(), set_ids.end(), set_id) != set_ids.end();
+}
+
+} // namespace {
+
+
+void NewGRFData::specialise(const GRFSpecialiser::Profile& profile)
+{
+    ScopedTimer timer{"Specialise"};
+
+    GRFSpecialiser specialiser{top_level_records(),
+        [this](const std::string& data)
+        {
+            std::istringstream is(data);
+            return read_record(is, uint32_t(data.size()), true, m_info);
+        },
+        [this](const Record& record) { return record_data(record); }};
+    auto result = specialiser.specialise(profile);
+    if (!result.failure.empty())
+    {
+        std::cout << "Not specialising: " << result.failure << "\n";
+        return;
+    }
+
+    uint32_t num_removed   = 0;
+    uint32_t num_sprites   = 0;
+    uint64_t removed_bytes = 0;
+    std::set<uint32_t> removed_sprite_ids;
+    std::set<uint32_t> kept_sprite_ids;
+    std::vector<std::unique_ptr<Record>> kept;
+    kept.reserve(m_records.size());
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        auto& record = m_records[index];
+        if (result.removed[index])
+        {
+            add_sprite_ids(removed_sprite_ids, *record);
+            ++num_removed;
+            num_sprites   += record->num_sprites_to_write();
+            removed_bytes += record_data(*record).size();
+            continue;
+        }
+
+        auto it = result.replaced.find(index);
+        if (it != result.replaced.end())
+        {
+            std::istringstream is(it->second);
+            record = read_record(is, uint32_t(it->second.size()), true, m_info);
+        }
+        add_sprite_ids(kept_sprite_ids, *record);
+        kept.push_back(std::move(record));
+    }
+    m_records = std::move(kept);
+
+    for (auto sprite_id: removed_sprite_ids)
+    {
+        if (kept_sprite_ids.find(sprite_id) == kept_sprite_ids.end())
+            m_sprites.erase(sprite_id);
+    }
+
+    std::cout << "Specialising: removed " << num_removed << " records (" << removed_bytes << " bytes) and ";
+    std::cout << num_sprites << " sprites, resolved " << result.num_resolved << " skips, ";
+    std::cout << "applied " << result.num_patches << " Action06 patches\n";
+}
+
+
+void NewGRFData::crop_sprites()
+{
+    uint32_t num_sprites = 0;
+    uint32_t num_cropped = 0;
+    uint64_t removed_pixels = 0;
+    uint64_t removed_bytes  = 0;
+    for (auto& [sprite_id, sprites]: m_sprites)
+    {
+        for (auto& record: sprites)
+        {
+            if (record->record_type() != RecordType::REAL_SPRITE)
+                continue;
+
+            auto sprite = static_cast<RealSpriteRecord*>(record.get());
+            uint32_t removed = sprite->crop();
+            ++num_sprites;
+            if (removed > 0)
+            {
+                ++num_cropped;
+                removed_pixels += removed;
+                removed_bytes  += uint64_t{removed} * sprite->pixel_size();
+            }
+        }
+    }
+
+    std::cout << "Cropping: removed " << removed_pixels << " transparent pixels (" << removed_bytes;
+    std::cout << " bytes before compression) from " << num_cropped << " of " << num_sprites << " sprites\n";
+}
+
+
+// Each sprite is compressed both ways, so this is done on the thread pool. The sprites are
+// independent, and each task changes only its own.
+void NewGRFData::choose_sprite_compression()
+{
+    ScopedTimer timer{"Choose compression"};
+
+    std::vector<RealSpriteRecord*> sprites;
+    for (auto& [sprite_id, zooms]: m_sprites)
+    {
+        for (auto& record: zooms)
+        {
+            if (record->record_type() == RecordType::REAL_SPRITE)
+                sprites.push_back(static_cast<RealSpriteRecord*>(record.get()));
+        }
+    }
+
+    struct Saving
+    {
+        uint32_t changed = 0;
+        int64_t  bytes   = 0;
+    };
+
+    // Sprites are compressed in batches to keep the overhead of the tasks down.
+    static constexpr uint32_t BATCH_SIZE = 16;
+    ThreadPool& pool = ThreadPool::pool();
+    std::vector<std::future<Saving>> batches;
+    for (uint32_t first = 0; first < sprites.size(); first += BATCH_SIZE)
+    {
+        uint32_t last = std::min(first + BATCH_SIZE, static_cast<uint32_t>(sprites.size()));
+        batches.push_back(pool.submit([this, &sprites, first, last]()
+        {
+            Saving saving;
+            for (uint32_t index = first; index < last; ++index)
+            {
+                uint8_t compression = sprites[index]->compression();
+                saving.bytes += sprites[index]->choose_compression(m_info.format);
+                saving.changed += (sprites[index]->compression() != compression) ? 1 : 0;
+            }
+            return saving;
+        }));
+    }
+
+    Saving total;
+    try
+    {
+        for (auto& batch: batches)
+        {
+            Saving saving = pool.get(batch);
+            total.changed += saving.changed;
+            total.bytes   += saving.bytes;
+        }
+    }
+    catch (...)
+    {
+        // The tasks refer to the sprite list, so make sure they have all finished before leaving.
+        for (auto& batch: batches)
+        {
+            if (batch.valid())
+                batch.wait();
+        }
+        throw;
+    }
+
+    std::cout << "Compression: changed the format of " << total.changed << " of " << sprites.size();
+    std::cout << " sprites, saving " << total.bytes << " bytes\n";
+}
+
+
+// Generated switches often have constant operands, operations which do nothing, and ranges
+// which could be combined. Each simplified switch is checked against the original on sampled
+// inputs. Switches which always select the same set or callback result are then bypassed by
+// changing the references to them, unless evaluating them has side effects.
+void NewGRFData::simplify_switches()
+{
+    constexpr uint32_t NUM_SAMPLES = 256;
+
+    uint32_t num_simplified   = 0;
+    uint64_t saved_bytes      = 0;
+    bool     reads_last_value = false;
+    for (auto& record: m_records)
+    {
+        if (record->record_type() != RecordType::ACTION_02_VARIABLE)
+            continue;
+
+        auto& action02   = static_cast<Action02VariableRecord&>(*record);
+        reads_last_value = reads_last_value || action02.reads_variable(Action02VariableRecord::LAST_VALUE);
+
+        Action02VariableRecord original = action02;
+        if (!action02.simplify())
+            continue;
+
+        if (action02.equivalent(original, NUM_SAMPLES))
+        {
+            ++num_simplified;
+            saved_bytes += record_data(original).size() - record_data(action02).size();
+        }
+        else
+        {
+            std::cout << "Not simplifying switch " << uint16_t(action02.set_id());
+            std::cout << ": the result differs from the original\n";
+            action02 = original;
+        }
+    }
+
+    // Bypassing a switch changes the value seen by the next one as variable 1C.
+    std::set<uint32_t> bypassed;
+    bool changed = !reads_last_value;
+    while (changed)
+    {
+        changed = false;
+        SpriteGroupGraph graph{top_level_records()};
+        for (uint32_t index = 0; index < m_records.size(); ++index)
+        {
+            if (m_records[index]->record_type() != RecordType::ACTION_02_VARIABLE)
+                continue;
+
+            const auto& action02 = static_cast<const Action02VariableRecord&>(*m_records[index]);
+            auto target = action02.single_target();
+            if (!target || action02.has_side_effects())
+                continue;
+
+            // An Action03 or a procedure call cannot use a callback result directly. Otherwise
+            // the target must be bound to the same record where the reference is.
+            bool is_callback = (*target & Action02VariableRecord::CALLBACK_RESULT) != 0;
+            auto binding     = graph.act02_binding(index, *target);
+            for (auto referrer: graph.referrers(index))
+            {
+                Record& record = *m_records[referrer];
+                if (is_callback ? ((record.record_type() == RecordType::ACTION_03) ||
+                    calls_procedure(record, action02.set_id())) :
+                    (graph.act02_binding(referrer, *target) != binding))
+                    continue;
+
+                rename_act02_set_id(record, action02.set_id(), *target);
+                bypassed.insert(index);
+                changed = true;
+            }
+        }
+    }
+
+    std::cout << "Optimising: simplified " << num_simplified << " switches (" << saved_bytes << " bytes), ";
+    std::cout << "bypassed " << bypassed.size() << " switches";
+    if (reads_last_value)
+        std::cout << " (not bypassing: variable 1C is read)";
+    std::cout << "\n";
+}
+
+// Machine generated GRFs often repeat the same chains of Action02 under different set IDs.
+// A record is a duplicate if it has the same content as an earlier one apart from its own
+// set ID, and its references are bound to the same records. It is merged if everything which
+// uses it would see the earlier record under that record's set ID.
+void NewGRFData::merge_duplicate_sets()
+{
+    SpriteGroupGraph graph{top_level_records()};
+
+    // The record which replaces each record: itself unless it is merged.
+    std::vector<uint32_t> replacement(m_records.size());
+    std::map<std::string, uint32_t> signatures;
+    uint32_t num_merged   = 0;
+    uint64_t merged_bytes = 0;
+
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        replacement[index] = index;
+        Record& record     = *m_records[index];
+
+        // References always point to earlier records, which have already been merged. The
+        // references to a set ID from one record are all bound to the same definition.
+        for (auto reference: graph.references(index))
+        {
+            if (replacement[reference] != reference)
+            {
+                rename_act02_set_id(record, SpriteGroupGraph::act02_set_id(*m_records[reference]),
+                    SpriteGroupGraph::act02_set_id(*m_records[replacement[reference]]));
+            }
+        }
+
+        if (!SpriteGroupGraph::is_action02(record.record_type()))
+            continue;
+
+        // The data starts with the action, feature and set ID.
+        std::string data      = record_data(record);
+        std::string signature = data;
+        signature[2] = 0;
+        for (auto reference: graph.references(index))
+        {
+            uint32_t target = replacement[reference];
+            signature.append(reinterpret_cast<const char*>(&target), sizeof(target));
+        }
+
+        auto [it, inserted] = signatures.try_emplace(signature, index);
+        if (inserted)
+            continue;
+
+        uint32_t original = it->second;
+        uint16_t set_id   = SpriteGroupGraph::act02_set_id(*m_records[original]);
+        // A record with no referrers is left for remove_dead_sets().
+        const auto& referrers = graph.referrers(index);
+        bool can_merge = !referrers.empty() && std::all_of(referrers.begin(), referrers.end(),
+            [&](uint32_t referrer) { return graph.act02_binding(referrer, set_id) == original; });
+
+        if (can_merge)
+        {
+            replacement[index] = original;
+            ++num_merged;
+            merged_bytes += data.size();
+        }
+        else
+        {
+            // The original is hidden by the time this record is used, so later duplicates
+            // are more likely to be merged with this one.
+            it->second = index;
+        }
+    }
+
+    std::vector<std::unique_ptr<Record>> kept;
+    kept.reserve(m_records.size() - num_merged);
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        if (replacement[index] == index)
+            kept.push_back(std::move(m_records[index]));
+    }
+    m_records = std::move(kept);
+
+    std::cout << "Optimising: merged " << num_merged << " duplicate Action02 records (";
+    std::cout << merged_bytes << " bytes)\n";
+}
+
+
+void NewGRFData::remove_dead_sets()
+{
+    SpriteGroupGraph graph{top_level_records()};
+
+    uint32_t num_action01 = 0;
+    uint32_t num_action02 = 0;
+    std::set<uint32_t> removed_sprite_ids;
+    std::set<uint32_t> kept_sprite_ids;
+    std::vector<std::unique_ptr<Record>> kept;
+    kept.reserve(m_records.size());
+    for (uint32_t index = 0; index < m_records.size(); ++index)
+    {
+        auto& record = m_records[index];
+        if (!graph.is_dead(index))
+        {
+            add_sprite_ids(kept_sprite_ids, *record);
+            kept.push_back(std::move(record));
+        }
+        else if (record->record_type() == RecordType::ACTION_01)
+        {
+            add_sprite_ids(removed_sprite_ids, *record);
+            ++num_action01;
+        }
+        else
+        {
+            ++num_action02;
+        }
+    }
+    m_records = std::move(kept);
+
+    for (auto sprite_id: removed_sprite_ids)
+    {
+        if (kept_sprite_ids.find(sprite_id) == kept_sprite_ids.end())
+            m_sprites.erase(sprite_id);
+    }
+
+    std::cout << "Optimising: removed " << num_action02 << " unreachable Action02 and ";
+    std::cout << num_action01 << " unused Action01 records\n";
+}
+
+
+// Identical images are often used in more than one sprite set. In Container2 the sprite
+// references can share a single copy in the sprite section.
+void NewGRFData::merge_duplicate_sprites()
+{
+    if (m_info.format != GRFFormat::Container2)
+        return;
+
+    std::map<uint32_t, uint32_t> duplicates;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> originals;
+    uint32_t num_images  = 0;
+    uint64_t pixel_bytes = 0;
+    for (const auto& [sprite_id, sprites]: m_sprites)
+    {
+        if (sprites.empty())
+            continue;
+
+        auto& candidates = originals[sprites_hash(FNV_OFFSET_BASIS, sprites)];
+        auto it = std::find_if(candidates.begin(), candidates.end(),
+            [&](uint32_t original) { return same_sprites(m_sprites.at(original), sprites); });
+        if (it == candidates.end())
+        {
+            candidates.push_back(sprite_id);
+            continue;
+        }
+
+        duplicates[sprite_id] = *it;
+        for (const auto& sprite: sprites)
+        {
+            ++num_images;
+            if (sprite->record_type() == RecordType::REAL_SPRITE)
+                pixel_bytes += static_cast<const RealSpriteRecord*>(sprite.get())->pixels_size();
+        }
+    }
+
+    auto redirect = [&duplicates](Record& record)
+    {
+        if (record.record_type() != RecordType::SPRITE_INDEX)
+            return;
+        auto& reference = static_cast<SpriteIndexRecord&>(record);
+        auto it = duplicates.find(reference.sprite_id());
+        if (it != duplicates.end())
+            reference.set_sprite_id(it->second);
+    };
+
+    for (auto& record: m_records)
+    {
+        redirect(*record);
+        for (uint16_t j = 0; j < record->num_sprites_to_write(); ++j)
+        {
+            redirect(*record->get_sprite(j));
+        }
+    }
+
+    for (const auto& it: duplicates)
+    {
+        m_sprites.erase(it.first);
+    }
+
+    std::cout << "Optimising: merged " << duplicates.size() << " duplicate sprites (";
+    std::cout << num_images << " images, " << pixel_bytes << " bytes of pixels)\n";
+}
+
+
+void NewGRFData::analyse(std::ostream& os, const ChainBudgets& budgets) const
+{
+    ScopedTimer timer{"Analyse"};
+
+    ChainCostAnalyser analyser{top_level_records()};
+    analyser.report(os, budgets);
+}
+
+
+void NewGRFData::evaluate(std::ostream& os, const ChainEvaluator::Environment& env, uint32_t iterations) const
+{
+    ScopedTimer timer{"Evaluate"};
+
+    ChainEvaluator evaluator{top_level_records()};
+    evaluator.report(os, env, iterations);
+}
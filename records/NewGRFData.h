@@ -18,6 +18,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Record.h"
+#include "ChainCostAnalyser.h"
+#include "ChainEvaluator.h"
+#include "GRFSpecialiser.h"
+#include "StringPool.h"
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -40,9 +44,49 @@ public:
     void print(std::ostream& os, const std::string& output_dir, const std::string& image_file_base) const;
     void parse(TokenStream& is, const std::string& output_dir, const std::string& image_file_base);
 
+    // Combined parse and write for large GRFs. Each record is written as soon as it has been
+    // parsed, and then discarded. For Container2, sprites are compressed immediately and spooled
+    // to a temporary file, which is appended to the output as the sprite section. The output
+    // stream must be seekable so that the header and counter can be patched at the end.
+    void stream_encode(TokenStream& is, std::ostream& os, const std::string& spool_file);
+
     // Primarily for testing - comparing two GRFs at the binary level, record by record.
     // Dump the records as hex, but break lines between records so that diff tools can recover after diffs.
-    void hex_dump(std::ostream& os);
+    void hex_dump(std::ostream& os) const;
+    // Write NFO which grfcodec can compile. The sprite sheets are created as for print().
+    void nfo_dump(std::ostream& os, const std::string& image_file_base) const;
+    // Write a JSON report of the record counts and sizes, and of how well each category
+    // of sprites is compressed.
+    void stats(std::ostream& os) const;
+
+    // Support for comparing GRFs. These are the records of the data section in file order,
+    // with the contents of each container following it.
+    std::vector<const Record*> data_records() const;
+    // A hash of the content of one of those records. For references to sprites, this covers
+    // the decoded images rather than the sprite ID, so that renumbering or recompressing the
+    // sprites does not count as a change.
+    uint64_t content_hash(const Record& record) const;
+    // Print one of those records as YAGL, or a summary of the images for a sprite reference.
+    void print_record(std::ostream& os, const Record& record) const;
+
+    // Removes the records which are never loaded with the given configuration, and the conditional
+    // skips which make no difference to it, and applies Action06 patches whose inputs are known.
+    void specialise(const GRFSpecialiser::Profile& profile);
+
+    // Simplifies switches and bypasses those which always select the same set. Merges duplicate
+    // Action02 records and sprites, and then removes the Action02 records which no Action03 can
+    // reach, and the Action01 records none of whose sprite sets are used, along with their sprites.
+    void optimise();
+
+    // Removes the transparent borders from the sprites which are not marked no_crop.
+    void crop_sprites();
+    // Writes each sprite in whichever of the chunked and plain formats compresses better.
+    void choose_sprite_compression();
+
+    // Writes an estimate of the work done to evaluate the Action02 chains used by each Action03.
+    void analyse(std::ostream& os, const ChainBudgets& budgets) const;
+    // Evaluates the Action02 chain selected by the environment, or fuzzes it for a number of iterations.
+    void evaluate(std::ostream& os, const ChainEvaluator::Environment& env, uint32_t iterations) const;
 
 private:
     // Helpers for reading a GRF binary file
@@ -55,15 +99,35 @@ private:
     void append_sprite(uint32_t sprite_id, std::unique_ptr<Record> sprite);
     void update_version_info(const Record& record);
 
+    // Helpers for parsing a YAGL script
+    void parse_header(TokenStream& is);
+    std::unique_ptr<Record> parse_record(TokenStream& is);
+
     // Helpers for writing a GRF binary file
     void write_format(std::ostream& os, uint32_t sprite_offs = 0) const;
-    void write_counter(std::ostream& os) const;
+    void write_counter(std::ostream& os, uint32_t num_records) const;
     void write_record(std::ostream& os, const Record& record) const;
     uint32_t total_records() const;
 
+    // Helpers for dumping a GRF as hex or NFO.
+    std::string record_data(const Record& record) const;
+
+    // Helpers for comparing and optimising GRFs.
+    uint64_t sprites_hash(uint64_t hash, const SpriteZoomVector& sprites) const;
+    bool     same_sprites(const SpriteZoomVector& sprites1, const SpriteZoomVector& sprites2) const;
+    std::vector<const Record*> top_level_records() const;
+    void     simplify_switches();
+    void     merge_duplicate_sets();
+    void     remove_dead_sets();
+    void     merge_duplicate_sprites();
+    void print_nfo_sprite(std::string& text, uint32_t number, const Record& record) const;
+
 private:
     GRFInfo m_info;
 
+    // The strings used by the records, which must outlive them.
+    std::unique_ptr<StringPool> m_strings;
+
     // Simple list of all records in the data section.
     // Should be consistent between Format1 and Format2, so manufacture sprite references
     // when reading Format1 (sprites are in the data section), and place the actual sprites
@@ -27,6 +27,7 @@
 #include <map>
 #include <memory>
 #include <array>
+#include <optional>
 
 
 // Record types are distinct from action types because there are several
@@ -165,6 +166,9 @@ public:
     virtual uint16_t num_sprites_to_write() const { return 0; }
     virtual Record* get_sprite(uint16_t index) const { return nullptr; }
 
+    // The feature to which the record applies, for those actions which have one.
+    virtual std::optional<FeatureType> feature() const { return std::nullopt; }
+
     RecordType record_type() const { return m_record_type; }
 
     // Overloaded for testing purposes only
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "SpriteGroupGraph.h"
+#include "Action01Record.h"
+#include "Action02BasicRecord.h"
+#include "Action02VariableRecord.h"
+#include "Action02RandomRecord.h"
+#include "Action02IndustryRecord.h"
+#include "Action02SpriteLayoutRecord.h"
+#include "Action03Record.h"
+#include <algorithm>
+
+
+bool SpriteGroupGraph::is_action02(RecordType type)
+{
+    switch (type)
+    {
+        case RecordType::ACTION_02_BASIC:
+        case RecordType::ACTION_02_VARIABLE:
+        case RecordType::ACTION_02_RANDOM:
+        case RecordType::ACTION_02_INDUSTRY:
+        case RecordType::ACTION_02_SPRITE_LAYOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+uint8_t SpriteGroupGraph::act02_set_id(const Record& record)
+{
+    switch (record.record_type())
+    {
+        case RecordType::ACTION_02_BASIC:         return static_cast<const Action02BasicRecord&>(record).set_id();
+        case RecordType::ACTION_02_VARIABLE:      return static_cast<const Action02VariableRecord&>(record).set_id();
+        case RecordType::ACTION_02_RANDOM:        return static_cast<const Action02RandomRecord&>(record).set_id();
+        case RecordType::ACTION_02_INDUSTRY:      return static_cast<const Action02IndustryRecord&>(record).set_id();
+        case RecordType::ACTION_02_SPRITE_LAYOUT: return static_cast<const Action02SpriteLayoutRecord&>(record).set_id();
+        default: throw RUNTIME_ERROR("Not an Action02 record");
+    }
+}
+
+
+SpriteGroupGraph::SpriteGroupGraph(const std::vector<const Record*>& records)
+: m_references(records.size())
+, m_referrers(records.size())
+{
+    // The current definition of each Action01 sprite set ID for each feature. Action02 set
+    // IDs are shared by all features.
+    std::map<FeatureType, std::map<uint16_t, uint32_t>> act01_sets;
+
+    auto bind = [this](uint32_t index, std::optional<uint32_t> definition)
+    {
+        if (definition)
+            m_references[index].push_back(*definition);
+        else
+            ++m_unresolved;
+    };
+
+    auto bind_act02 = [&](uint32_t index, const std::vector<uint16_t>& set_ids)
+    {
+        for (auto set_id: set_ids)
+        {
+            if ((set_id & Action02VariableRecord::CALLBACK_RESULT) == 0)
+                bind(index, act02_binding(index, set_id));
+        }
+    };
+
+    auto bind_act01 = [&](uint32_t index, const Record& record, const std::vector<uint16_t>& set_ids)
+    {
+        const auto& sets = act01_sets[*record.feature()];
+        for (auto set_id: set_ids)
+        {
+            auto it = sets.find(set_id);
+            bind(index, (it != sets.end()) ? std::optional<uint32_t>{it->second} : std::nullopt);
+        }
+    };
+
+    m_types.reserve(records.size());
+    for (uint32_t index = 0; index < records.size(); ++index)
+    {
+        const Record& record = *records[index];
+        m_types.push_back(record.record_type());
+
+        // A record may refer to the previous definition of its own set ID, so its references
+        // are bound before its definition replaces that one.
+        switch (record.record_type())
+        {
+            case RecordType::ACTION_01:
+            {
+                const auto& action01 = static_cast<const Action01Record&>(record);
+                auto& sets = act01_sets[*record.feature()];
+                for (uint16_t set = 0; set < action01.num_sets(); ++set)
+                {
+                    sets[uint16_t(action01.first_set() + set)] = index;
+                }
+                break;
+            }
+
+            case RecordType::ACTION_02_BASIC:
+                bind_act01(index, record, static_cast<const Action02BasicRecord&>(record).act01_set_ids());
+                break;
+
+            case RecordType::ACTION_02_SPRITE_LAYOUT:
+                bind_act01(index, record, static_cast<const Action02SpriteLayoutRecord&>(record).act01_set_ids());
+                break;
+
+            case RecordType::ACTION_02_VARIABLE:
+            {
+                const auto& action02 = static_cast<const Action02VariableRecord&>(record);
+                bind_act02(index, action02.procedure_set_ids());
+                bind_act02(index, action02.act02_set_ids());
+                break;
+            }
+
+            case RecordType::ACTION_02_RANDOM:
+                bind_act02(index, static_cast<const Action02RandomRecord&>(record).act02_set_ids());
+                break;
+
+            case RecordType::ACTION_03:
+                bind_act02(index, static_cast<const Action03Record&>(record).act02_set_ids());
+                break;
+
+            case RecordType::ACTION_06:
+            case RecordType::ACTION_07:
+            case RecordType::ACTION_09:
+                m_is_static = false;
+                break;
+
+            default:
+                break;
+        }
+
+        if (is_action02(record.record_type()))
+        {
+            m_act02_definitions[act02_set_id(record)].push_back(index);
+        }
+    }
+
+    for (uint32_t index = 0; index < m_references.size(); ++index)
+    {
+        for (auto reference: m_references[index])
+        {
+            m_referrers[reference].push_back(index);
+        }
+    }
+
+    mark_live();
+}
+
+
+std::optional<uint32_t> SpriteGroupGraph::act02_binding(uint32_t index, uint16_t set_id) const
+{
+    auto it = m_act02_definitions.find(set_id);
+    if (it == m_act02_definitions.end())
+        return std::nullopt;
+
+    // The last definition before the record.
+    const auto& definitions = it->second;
+    auto pos = std::lower_bound(definitions.begin(), definitions.end(), index);
+    if (pos == definitions.begin())
+        return std::nullopt;
+    return *(pos - 1);
+}
+
+
+void SpriteGroupGraph::mark_live()
+{
+    m_live.assign(m_types.size(), false);
+
+    std::vector<uint32_t> pending;
+    for (uint32_t index = 0; index < m_types.size(); ++index)
+    {
+        if (m_types[index] == RecordType::ACTION_03)
+        {
+            m_live[index] = true;
+            pending.push_back(index);
+        }
+    }
+
+    // References always point to earlier records, so there are no cycles, but a set may be
+    // reached along more than one path.
+    while (!pending.empty())
+    {
+        uint32_t index = pending.back();
+        pending.pop_back();
+        for (auto reference: m_references[index])
+        {
+            if (!m_live[reference])
+            {
+                m_live[reference] = true;
+                pending.push_back(reference);
+            }
+        }
+    }
+}
+
+
+bool SpriteGroupGraph::is_dead(uint32_t index) const
+{
+    RecordType type = m_types[index];
+    return ((type == RecordType::ACTION_01) || is_action02(type)) && !m_live[index];
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Record.h"
+#include <vector>
+#include <map>
+#include <optional>
+
+
+// Models how the Action03, Action02 and Action01 records in a GRF refer to one another.
+// The references are by set ID, and the IDs are reused as the file goes on, so each
+// reference is bound to the most recent definition of that ID which precedes it. The
+// Action03 records are the roots of the graph, and any Action02 or Action01 which none
+// of them can reach is dead.
+class SpriteGroupGraph
+{
+public:
+    static bool    is_action02(RecordType type);
+    static uint8_t act02_set_id(const Record& record);
+
+public:
+    // The top level records of the data section, in file order.
+    explicit SpriteGroupGraph(const std::vector<const Record*>& records);
+
+    // Action06 can rewrite the set IDs in the record which follows it, and Action07 and
+    // Action09 can skip records, so the bindings are only certain when there are none.
+    bool is_static() const { return m_is_static; }
+
+    // Indices of the records which the references in the given record are bound to.
+    const std::vector<uint32_t>& references(uint32_t index) const { return m_references[index]; }
+    // Indices of the records whose references are bound to the given record.
+    const std::vector<uint32_t>& referrers(uint32_t index) const { return m_referrers[index]; }
+    // The Action02 which a reference to the set ID from the given record would be bound to.
+    std::optional<uint32_t> act02_binding(uint32_t index, uint16_t set_id) const;
+    // References to set IDs which had not been defined at that point in the file.
+    uint32_t num_unresolved() const { return m_unresolved; }
+
+    // True for Action01 and Action02 records which no Action03 can reach.
+    bool is_dead(uint32_t index) const;
+
+private:
+    void mark_live();
+
+private:
+    std::vector<RecordType>            m_types;
+    std::vector<std::vector<uint32_t>> m_references;
+    std::vector<std::vector<uint32_t>> m_referrers;
+    // The records defining each Action02 set ID, in file order.
+    std::map<uint16_t, std::vector<uint32_t>> m_act02_definitions;
+    std::vector<bool>                  m_live;
+    bool                               m_is_static  = true;
+    uint32_t                           m_unresolved = 0;
+};
@@ -25,10 +25,46 @@ const TokenValue& TokenStream::peek(uint16_t lookahead)
     static const TokenValue terminator{TokenType::Terminator, NumberType::None, ""};
 
     uint32_t index = m_index + lookahead;
-    if (index >= static_cast<uint32_t>(m_tokens.size()))
+    if (index >= m_end)
         return terminator;
 
-    return m_tokens[index];
+    return (*m_tokens)[index];
+}
+
+
+std::vector<uint32_t> TokenStream::find_record_ends() const
+{
+    std::vector<uint32_t> result;
+
+    uint32_t depth = 0;
+    for (uint32_t index = m_index; index < m_end; ++index)
+    {
+        switch ((*m_tokens)[index].type)
+        {
+            case TokenType::OpenBrace:
+                ++depth;
+                break;
+
+            case TokenType::CloseBrace:
+                // An unmatched brace is left for the record parser to complain about.
+                if ((depth > 0) && (--depth == 0))
+                {
+                    result.push_back(index + 1);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    uint32_t last = result.empty() ? m_index : result.back();
+    if (last < m_end)
+    {
+        result.push_back(m_end);
+    }
+
+    return result;
 }
 
 
@@ -212,6 +248,22 @@ uint32_t TokenStream::match_date(DataType type)
 }
 
 
+uint32_t TokenStream::parse_number(const std::string& text, const TokenValue& token)
+{
+    try
+    {
+        std::size_t length = 0;
+        unsigned long value = std::stoul(text, &length, 0);
+        if (length == text.size())
+            return uint32_t(value);
+    }
+    catch (const std::exception&)
+    {
+    }
+    throw PARSER_ERROR("Expected a number: '" + text + "'", token);
+}
+
+
 uint32_t TokenStream::match_uint32()
 {
     TokenValue token;
@@ -18,7 +18,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Lexer.h"
+#include "Profiler.h"
 #include <fstream>
+#include <memory>
 
 
 // Can we make this more stream based? Get the lexer to some work, and then a bit
@@ -29,8 +31,20 @@ class TokenStream
 public:
     TokenStream(std::istream& is) //const std::vector<TokenValue> tokens)
     {
+        ScopedTimer timer{"Lex YAGL"};
         Lexer lexer;
-        m_tokens = lexer.lex(is);
+        m_tokens = std::make_shared<const std::vector<TokenValue>>(lexer.lex(is));
+        m_end    = static_cast<uint32_t>(m_tokens->size());
+    }
+
+    // A view of the tokens [begin, end) of another stream. The tokens are shared rather
+    // than copied. This is used to parse top level records independently of each other.
+    TokenStream(const TokenStream& other, uint32_t begin, uint32_t end)
+    : m_tokens{other.m_tokens}
+    , m_index{begin}
+    , m_begin{begin}
+    , m_end{end}
+    {
     }
 
     const TokenValue& peek(uint16_t lookahead = 0);
@@ -71,6 +85,40 @@ public:
     enum class DataType { U32, U16, U8 };
     uint32_t match_date(DataType type);
 
+    // The JSON subset used for the --profile and --environment files. These match
+    // { "key": value, ... } and [ value, ... ], calling the function for each key or value
+    // to match the value itself. Numeric keys such as "0x7B" are converted with parse_number().
+    template <typename Func>
+    void match_object(Func func)
+    {
+        match(TokenType::OpenBrace);
+        while (peek().type != TokenType::CloseBrace)
+        {
+            const TokenValue& token = peek();
+            std::string key = match(TokenType::String);
+            match(TokenType::Colon);
+            func(key, token);
+            if (peek().type != TokenType::CloseBrace)
+                match(TokenType::Comma);
+        }
+        match(TokenType::CloseBrace);
+    }
+
+    template <typename Func>
+    void match_list(Func func)
+    {
+        match(TokenType::OpenBracket);
+        while (peek().type != TokenType::CloseBracket)
+        {
+            func();
+            if (peek().type != TokenType::CloseBracket)
+                match(TokenType::Comma);
+        }
+        match(TokenType::CloseBracket);
+    }
+
+    static uint32_t parse_number(const std::string& text, const TokenValue& token);
+
     // Added to allow us to move to the beginning of the next record when an exception occurs
     // during parsing.
     void next_record();
@@ -78,19 +126,33 @@ public:
     // Backtrack one step. This is a bodge really, and could easily be removed. For now the
     // names of records are parsed to create the right type of object, but backtracked and
     // parsed again by that object. This gives a nicer exception...
-    void unmatch() { if (m_index > 0) --m_index; }
+    void unmatch() { if (m_index > m_begin) --m_index; }
+
+    auto num_tokens() const { return m_end - m_begin; }
+
+    // Position of the next token to be matched, and random access to the whole list. These
+    // allow a caller to scan ahead without disturbing the parse, e.g. to find the last record
+    // which refers to some sprite sheet. Indices are the same for a stream and its views.
+    uint32_t index() const { return m_index; }
+    uint32_t end() const { return m_end; }
+    const TokenValue& at(uint32_t index) const { return m_tokens->at(index); }
 
-    auto num_tokens() const { return m_tokens.size(); }
+    // Find the end of each top level 'keyword [<...>] { ... }' record from the current position,
+    // by tracking the block depth. Any trailing tokens which are not part of a complete record
+    // are treated as a final (invalid) record so that they are not silently ignored.
+    std::vector<uint32_t> find_record_ends() const;
 
 private:
     uint64_t match_uint64(TokenValue& token, DataType type);
 
 private:
-    // List of all tokens found in the YAGL by the lexer, in order.
-    std::vector<TokenValue> m_tokens;
+    // List of all tokens found in the YAGL by the lexer, in order. Shared with any views.
+    std::shared_ptr<const std::vector<TokenValue>> m_tokens;
 
-    // Current position in the stream while parsing.
+    // Current position in the stream while parsing, and the range of tokens in this stream.
     uint32_t m_index = 0;
+    uint32_t m_begin = 0;
+    uint32_t m_end   = 0;
 
     // Current block depth. Blocks are delineated by { and }. This can used
     // after an exception to start parsing again with the next record.
@@ -77,8 +77,8 @@ void Action00Record::read(std::istream& is, const GRFInfo& info)
             if (CommandLineOptions::options().debug())
             {
                 std::cout << "Feature=" << FeatureName(m_feature);
-                std::cout << ", index=" << to_hex(i);
-                std::cout << ", property=" << to_hex(property);
+                std::cout << ", index=" << as_hex(i);
+                std::cout << ", property=" << as_hex(property);
                 std::cout << "\n";
             }
             m_instances[i]->read_property(is, property);
@@ -119,15 +119,15 @@ void Action00Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
 {
     os << pad(indent) << RecordName(record_type()) << "<";
     os << FeatureName(m_feature) << ", ";
-    os << to_hex(m_first_id) << "> // Action00" << '\n';
+    os << as_hex(m_first_id) << "> // Action00" << '\n';
     os << pad(indent) << "{\n";
 
     uint16_t id = m_first_id;
     for (const auto& instance: m_instances)
     {
         // Made this into a comment since we only need the ID of the first instance, and we already have that.
-        //os << pad(indent + 4) << str_instance_id << ": " << to_hex(id++) << "\n";
-        os << pad(indent + 4) << "// " << str_instance_id << ": " << to_hex(id++) << "\n";
+        //os << pad(indent + 4) << str_instance_id << ": " << as_hex(id++) << "\n";
+        os << pad(indent + 4) << "// " << str_instance_id << ": " << as_hex(id++) << "\n";
         os << pad(indent + 4) << "{\n";
 
         for (auto property: m_properties)
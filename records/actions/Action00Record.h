@@ -36,6 +36,9 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+    const std::vector<std::unique_ptr<Action00Feature>>& instances() const { return m_instances; }
+
 private:
     std::unique_ptr<Action00Feature> make_feature(FeatureType feature_type);
 
@@ -74,7 +74,7 @@ void Action01Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
 {
     os << pad(indent) << RecordName(record_type()) << "<";
     os << FeatureName(m_feature) << ", ";
-    os << to_hex(m_first_set) << "> // <feature, first_set> Action01" << '\n';
+    os << as_hex(m_first_set) << "> // <feature, first_set> Action01" << '\n';
     os << pad(indent) << "{" << '\n';
 
     uint16_t index = 0;
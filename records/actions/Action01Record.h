@@ -42,6 +42,12 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    // The range of sprite set IDs defined by this record.
+    uint16_t first_set() const { return m_first_set; }
+    uint16_t num_sets() const  { return m_num_sets; }
+
     // This is the number of real sprites records (or references) we expect to
     // follow immediately after this record in the file.
     uint16_t num_sprites_to_read() const override { return m_num_sets * m_num_sprites; }
@@ -40,6 +40,14 @@ void Action02BasicRecord::read(std::istream& is, const GRFInfo& info)
 }
 
 
+std::vector<uint16_t> Action02BasicRecord::act01_set_ids() const
+{
+    std::vector<uint16_t> result{m_act01_set_ids_1};
+    result.insert(result.end(), m_act01_set_ids_2.begin(), m_act01_set_ids_2.end());
+    return result;
+}
+
+
 void Action02BasicRecord::write(std::ostream& os, const GRFInfo& info) const
 {
     ActionRecord::write(os, info);
@@ -93,7 +101,7 @@ const IntegerListDescriptorT<uint16_t> secondary_desc{0x01, str_secondary_sprite
 void Action02BasicRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
     os << pad(indent) << RecordName(record_type()) << "<" << FeatureName(m_feature);
-    os << ", " << to_hex(m_act02_set_id);
+    os << ", " << as_hex(m_act02_set_id);
     os << "> // Action02 basic\n";
     os << pad(indent) << "{\n";
 
@@ -39,6 +39,12 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    uint8_t set_id() const { return m_act02_set_id; }
+    // The Action01 sprite sets used by this record.
+    std::vector<uint16_t> act01_set_ids() const;
+
 private:
     // The type of feature to which this record relates: trains or whatever.
     FeatureType m_feature = FeatureType::Trains;
@@ -127,7 +127,7 @@ const EnumDescriptorT<Action02IndustryRecord::Format> desc_format =
 void Action02IndustryRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
     os << pad(indent) << RecordName(record_type()) << "<" << FeatureName(m_feature);
-    os << ", " << to_hex(m_act02_set_id);
+    os << ", " << as_hex(m_act02_set_id);
     os << ", " << desc_format.value(m_format);
     os << "> // Action02 industry\n";
     os << pad(indent) << "{\n";
@@ -322,7 +322,7 @@ void Action02IndustryRecord::CargoList::print(std::ostream& os, uint16_t indent)
     os << "[";
     for (const auto& c: cargos)
     {
-        os << " (" << to_hex(c.cargo) << ", " << to_hex(c.reg) << ")";
+        os << " (" << as_hex(c.cargo) << ", " << as_hex(c.reg) << ")";
     }
     os << " ];\n";
 }
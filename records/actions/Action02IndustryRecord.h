@@ -45,6 +45,10 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    uint8_t set_id() const { return m_act02_set_id; }
+
 private:
     void print_version0(std::ostream& os, uint16_t indent) const;
     void print_version1(std::ostream& os, uint16_t indent) const;
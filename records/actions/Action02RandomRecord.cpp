@@ -61,6 +61,41 @@ void Action02RandomRecord::read(std::istream& is, const GRFInfo& info)
 }
 
 
+std::vector<uint16_t> Action02RandomRecord::act02_set_ids() const
+{
+    std::vector<uint16_t> result;
+    for (const auto& it: m_set_ids)
+    {
+        result.push_back(it.first);
+    }
+    return result;
+}
+
+
+
+std::vector<uint16_t> Action02RandomRecord::set_id_table() const
+{
+    std::vector<uint16_t> result;
+    for (const auto& [set_id, count]: m_set_ids)
+    {
+        result.insert(result.end(), count, set_id);
+    }
+    return result;
+}
+
+void Action02RandomRecord::rename_act02_set_id(uint16_t from, uint16_t to)
+{
+    auto it = m_set_ids.find(from);
+    if (it == m_set_ids.end())
+        return;
+
+    // The entries are held as counts, so the two sets simply share the probability.
+    uint16_t count = it->second;
+    m_set_ids.erase(it);
+    m_set_ids[to] += count;
+}
+
+
 void Action02RandomRecord::write(std::ostream& os, const GRFInfo& info) const
 {
     ActionRecord::write(os, info);
@@ -146,13 +181,13 @@ const IntegerDescriptorT<uint8_t> randbit_desc { 0x03, str_rand_bit, UIntFormat:
 void Action02RandomRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
     os << pad(indent) << RecordName(record_type()) << "<" << FeatureName(m_feature);
-    os << ", " << to_hex(m_set_id);
+    os << ", " << as_hex(m_set_id);
     os << ", " << random_desc.value(m_type);
 
     if (m_type == RandomType::Consist)
     {
         os << ", " << consist_desc.value(m_method);
-        os << "[" << to_hex(m_count) << "]";
+        os << "[" << as_hex(m_count) << "]";
     }
 
     os << "> // Action02 random\n";
@@ -166,7 +201,7 @@ void Action02RandomRecord::print(std::ostream& os, const SpriteZoomMap& sprites,
     os << pad(indent + 4) << "{\n";
     for (const auto& it: m_set_ids)
     {
-        os << pad(indent + 8) << to_hex(it.first) << ": " << it.second << ";\n";
+        os << pad(indent + 8) << as_hex(it.first) << ": " << it.second << ";\n";
     }
     os << pad(indent + 4) << "};\n";
 
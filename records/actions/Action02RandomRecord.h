@@ -35,6 +35,19 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    uint8_t set_id() const { return m_set_id; }
+    // The other Action02 sets or callback results selected by this record.
+    std::vector<uint16_t> act02_set_ids() const;
+    void rename_act02_set_id(uint16_t from, uint16_t to);
+    // The number of entries for each set, which gives its probability.
+    const std::map<uint16_t, uint16_t>& set_id_counts() const { return m_set_ids; }
+    // The set IDs in the order they are written, which the random bits index.
+    std::vector<uint16_t> set_id_table() const;
+    // The lowest of the random bits used to choose a set.
+    uint8_t random_bit() const { return m_randbit; }
+
 public:
     // Use 80 to randomize the object (vehicle, station, building, industry, object)
     //   based on its own triggers and bits.
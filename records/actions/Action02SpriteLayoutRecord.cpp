@@ -315,6 +315,31 @@ void Action02SpriteLayoutRecord::read(std::istream& is, const GRFInfo& info)
 }
 
 
+std::vector<uint16_t> Action02SpriteLayoutRecord::act01_set_ids() const
+{
+    // Bit 31 marks a sprite from an Action01 set rather than a base sprite, and the set ID is
+    // in the low 14 bits. The recolour sprite in the high word may also come from a set.
+    constexpr uint32_t CUSTOM_SPRITE = 0x80000000;
+    constexpr uint32_t SET_ID_MASK   = 0x3FFF;
+
+    std::vector<uint16_t> result;
+    auto add_sprite = [&result](uint32_t sprite, const SpriteRegisters& regs)
+    {
+        if (sprite & CUSTOM_SPRITE)
+            result.push_back(uint16_t(sprite & SET_ID_MASK));
+        if (regs.flags & SpriteRegisters::BIT3_RECOLOUR_ACT01)
+            result.push_back(uint16_t((sprite >> 16) & SET_ID_MASK));
+    };
+
+    add_sprite(m_ground_sprite, m_ground_regs);
+    for (const auto& sprite: m_building_sprites)
+    {
+        add_sprite(sprite.sprite, sprite.regs);
+    }
+    return result;
+}
+
+
 void Action02SpriteLayoutRecord::write(std::ostream& os, const GRFInfo& info) const
 {
     ActionRecord::write(os, info);
@@ -390,11 +415,11 @@ void Action02SpriteLayoutRecord::write(std::ostream& os, const GRFInfo& info) co
 void Action02SpriteLayoutRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
     os << pad(indent) << RecordName(record_type()) << "<" << FeatureName(m_feature);
-    os << ", " << to_hex(m_set_id);
+    os << ", " << as_hex(m_set_id);
     os << "> // Action02 sprite layout\n";
     os << pad(indent) << "{\n";
 
-    os << pad(indent + 4) << str_ground_sprite << "<" << to_hex(m_ground_sprite) << ">\n";
+    os << pad(indent + 4) << str_ground_sprite << "<" << as_hex(m_ground_sprite) << ">\n";
     os << pad(indent + 4) << "{" << '\n';
     m_ground_regs.print(os, true, indent + 8); // true = is a parent
     os << pad(indent + 4) << "}" << '\n';
@@ -403,18 +428,18 @@ void Action02SpriteLayoutRecord::print(std::ostream& os, const SpriteZoomMap& sp
     {
         if (sprite.new_bb)
         {
-            os << pad(indent + 4) << str_building_sprite << "<" << to_hex(sprite.sprite) << ">\n";
+            os << pad(indent + 4) << str_building_sprite << "<" << as_hex(sprite.sprite) << ">\n";
             os << pad(indent + 4) << "{\n";
-            os << pad(indent + 8) << str_offset << ": " << to_hex(sprite.xofs) << ", " << to_hex(sprite.yofs) << ", " << to_hex(sprite.zofs) << ";\n";
-            os << pad(indent + 8) << str_extent << ": " << to_hex(sprite.xext) << ", " << to_hex(sprite.yext) << ", " << to_hex(sprite.zext) << ";\n";
+            os << pad(indent + 8) << str_offset << ": " << as_hex(sprite.xofs) << ", " << as_hex(sprite.yofs) << ", " << as_hex(sprite.zofs) << ";\n";
+            os << pad(indent + 8) << str_extent << ": " << as_hex(sprite.xext) << ", " << as_hex(sprite.yext) << ", " << as_hex(sprite.zext) << ";\n";
             sprite.regs.print(os, true, indent + 8); // true = is a parent
             os << pad(indent + 4) << "}\n";
         }
         else
         {
-            os << pad(indent + 4) << str_child_sprite << "<" << to_hex(sprite.sprite) << ">\n";
+            os << pad(indent + 4) << str_child_sprite << "<" << as_hex(sprite.sprite) << ">\n";
             os << pad(indent + 4) << "{\n";
-            os << pad(indent + 8) << str_offset << ": " << to_hex(sprite.xofs) << ", " << to_hex(sprite.yofs) << ";\n";
+            os << pad(indent + 8) << str_offset << ": " << as_hex(sprite.xofs) << ", " << as_hex(sprite.yofs) << ";\n";
             sprite.regs.print(os, false, indent + 8); // false = not a parent
             os << pad(indent + 4) << "}\n";
         }
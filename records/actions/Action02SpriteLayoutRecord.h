@@ -35,6 +35,12 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    uint8_t set_id() const { return m_set_id; }
+    // The Action01 sprite sets used by this record for its sprites and recolour sprites.
+    std::vector<uint16_t> act01_set_ids() const;
+
 private:
     void parse_ground_sprite(TokenStream& is);
     void parse_building_sprite(TokenStream& is);
@@ -19,6 +19,7 @@
 #include "Action02VariableRecord.h"
 #include "StreamHelpers.h"
 #include "EnumDescriptor.h"
+#include <algorithm>
 
 
 using VarType = Action02VariableRecord::VarType;
@@ -150,6 +151,472 @@ void Action02VariableRecord::read(std::istream& is, const GRFInfo& info)
 }
 
 
+std::vector<uint16_t> Action02VariableRecord::act02_set_ids() const
+{
+    std::vector<uint16_t> result;
+    for (const auto& range: m_ranges)
+    {
+        result.push_back(range.set_id);
+    }
+    result.push_back(m_default.get());
+    return result;
+}
+
+
+Action02VariableRecord::Accesses Action02VariableRecord::accesses() const
+{
+    Accesses result;
+    for (std::size_t i = 0; i < m_actions.size(); ++i)
+    {
+        const VarAction& va = m_actions[i];
+        ++result.variables;
+        if (va.has_parameter())
+            ++result.parameterised;
+        if ((va.variable == PERM_STORAGE) || (va.variable == TEMP_STORAGE))
+            ++result.storage;
+
+        // The operation of the first action is not used.
+        if ((i > 0) && ((va.operation == Operation::TempStore) || (va.operation == Operation::PermStore)))
+            ++result.storage;
+    }
+    return result;
+}
+
+
+bool Action02VariableRecord::selects_callback() const
+{
+    constexpr uint8_t CALLBACK_ID = 0x0C;
+
+    return (m_actions.size() == 1) && (m_actions[0].variable == CALLBACK_ID) &&
+        (m_actions[0].shift_num == 0) && (m_actions[0].action == 0x00);
+}
+
+
+namespace {
+
+using Operation = Action02VariableRecord::Operation;
+
+int64_t signed_value(VarType type, uint32_t value)
+{
+    switch (type)
+    {
+        case VarType::PrimaryByte:
+        case VarType::RelatedByte:  return int8_t(value);
+        case VarType::PrimaryWord:
+        case VarType::RelatedWord:  return int16_t(value);
+        default:                    return int32_t(value);
+    }
+}
+
+
+// The operations follow OpenTTD: U and S are the unsigned and signed types for the size of
+// the switch. Division by zero leaves the running value unchanged.
+template <typename U, typename S>
+U apply_operation_t(Operation operation, U last, uint32_t value)
+{
+    const U u = U(value);
+    const S s = S(value);
+    const uint32_t shift = u & 0x1F;
+
+    switch (operation)
+    {
+        case Operation::Addition:           return U(last + value);
+        case Operation::Subtraction:        return U(last - value);
+        case Operation::SignedMin:          return U(std::min<S>(S(last), s));
+        case Operation::SignedMax:          return U(std::max<S>(S(last), s));
+        case Operation::UnsignedMin:        return std::min<U>(last, u);
+        case Operation::UnsignedMax:        return std::max<U>(last, u);
+        // Dividing the most negative value by -1 overflows, so negate instead.
+        case Operation::SignedDiv:          return (s == 0) ? last : (s == -1) ? U(U(0) - last) : U(S(last) / s);
+        case Operation::SignedMod:          return (s == 0) ? last : (s == -1) ? U(0) : U(S(last) % s);
+        case Operation::UnsignedDiv:        return (u == 0) ? last : U(last / u);
+        case Operation::UnsignedMod:        return (u == 0) ? last : U(last % u);
+        case Operation::Multiply:           return U(last * value);
+        case Operation::BitwiseAnd:         return U(last & value);
+        case Operation::BitwiseOr:          return U(last | value);
+        case Operation::BitwiseXor:         return U(last ^ value);
+        case Operation::TempStore:          return last;
+        case Operation::Assign:             return u;
+        case Operation::PermStore:          return last;
+        case Operation::RotateRight:
+        {
+            uint32_t x = last;
+            return U((shift == 0) ? x : (x >> shift) | (x << (32 - shift)));
+        }
+        case Operation::SignedCmp:          return (S(last) == s) ? 1 : (S(last) < s) ? 0 : 2;
+        case Operation::UnsignedCmp:        return (last == u) ? 1 : (last < u) ? 0 : 2;
+        case Operation::ShiftLeft:          return U(uint32_t(last) << shift);
+        case Operation::UnsignedShiftRight: return U(uint32_t(last) >> shift);
+        case Operation::SignedShiftRight:   return U(int32_t(S(last)) >> shift);
+    }
+
+    return u;
+}
+
+
+// Pseudo-random input for one sample, which is the same for each read of a given variable.
+std::optional<uint32_t> sample_variable(uint32_t sample, uint8_t variable, uint32_t parameter)
+{
+    uint64_t hash = Action02VariableRecord::mix((uint64_t{sample} << 40) ^ (uint64_t{variable} << 32) ^ parameter);
+
+    // Ranges mostly cover small values, so favour those, and the edge cases.
+    uint32_t value = uint32_t(hash >> 32);
+    switch (hash & 0x0F)
+    {
+        case 0:  return std::nullopt;
+        case 1:  return 0;
+        case 2:  return 0xFFFFFFFF;
+        case 3:
+        case 4:
+        case 5:  return value & 0x0F;
+        case 6:
+        case 7:
+        case 8:  return value & 0xFF;
+        case 9:  return value & 0xFFFF;
+        default: return value;
+    }
+}
+
+} // namespace {
+
+
+uint32_t Action02VariableRecord::type_mask(VarType type)
+{
+    switch (type)
+    {
+        case VarType::PrimaryByte:
+        case VarType::RelatedByte:  return 0x000000FF;
+        case VarType::PrimaryWord:
+        case VarType::RelatedWord:  return 0x0000FFFF;
+        default:                    return 0xFFFFFFFF;
+    }
+}
+
+
+uint64_t Action02VariableRecord::mix(uint64_t hash)
+{
+    hash += 0x9E3779B97F4A7C15;
+    hash  = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+    hash  = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+    return hash ^ (hash >> 31);
+}
+
+
+uint32_t Action02VariableRecord::apply_operation(VarType type, Operation operation, uint32_t last, uint32_t value)
+{
+    switch (type)
+    {
+        case VarType::PrimaryByte:
+        case VarType::RelatedByte:  return apply_operation_t<uint8_t, int8_t>(operation, uint8_t(last), value);
+        case VarType::PrimaryWord:
+        case VarType::RelatedWord:  return apply_operation_t<uint16_t, int16_t>(operation, uint16_t(last), value);
+        default:                    return apply_operation_t<uint32_t, int32_t>(operation, last, value);
+    }
+}
+
+
+uint32_t Action02VariableRecord::adjust_value(VarType type, const VarAction& va, uint32_t value)
+{
+    value = (value >> va.shift_num) & va.and_mask;
+    if ((va.action == 0x40) || (va.action == 0x80))
+    {
+        int64_t sum     = signed_value(type, value) + signed_value(type, va.add_value);
+        int64_t divisor = signed_value(type, va.div_mod_value);
+        if (divisor != 0)
+        {
+            value = uint32_t((va.action == 0x40) ? (sum / divisor) : (sum % divisor));
+        }
+    }
+    return value;
+}
+
+
+std::optional<uint32_t> Action02VariableRecord::constant_value(const VarAction& va) const
+{
+    if ((va.variable != CONSTANT_VARIABLE) || (va.action != 0x00))
+        return std::nullopt;
+    return adjust_value(m_var_type, va, 0xFFFFFFFF);
+}
+
+
+bool Action02VariableRecord::is_identity(const VarAction& va) const
+{
+    auto constant = constant_value(va);
+    if (!constant)
+        return false;
+
+    uint32_t value = *constant;
+    switch (va.operation)
+    {
+        case Operation::Addition:
+        case Operation::Subtraction:
+        case Operation::UnsignedMax:
+        case Operation::BitwiseOr:
+        case Operation::BitwiseXor:
+        case Operation::SignedMod:
+        case Operation::UnsignedMod:        return value == 0;
+        case Operation::SignedDiv:
+        case Operation::UnsignedDiv:        return value <= 1;
+        case Operation::Multiply:           return value == 1;
+        case Operation::UnsignedMin:
+        case Operation::BitwiseAnd:         return value == type_mask(m_var_type);
+        case Operation::RotateRight:
+        case Operation::ShiftLeft:
+        case Operation::UnsignedShiftRight:
+        case Operation::SignedShiftRight:   return (value & 0x1F) == 0;
+        default:                            return false;
+    }
+}
+
+
+bool Action02VariableRecord::has_side_effects() const
+{
+    for (std::size_t i = 0; i < m_actions.size(); ++i)
+    {
+        const VarAction& va = m_actions[i];
+        if ((i > 0) && ((va.operation == Operation::TempStore) || (va.operation == Operation::PermStore)))
+            return true;
+    }
+    return reads_variable(PROCEDURE_VARIABLE);
+}
+
+
+std::vector<uint16_t> Action02VariableRecord::procedure_set_ids() const
+{
+    std::vector<uint16_t> result;
+    for (const auto& va: m_actions)
+    {
+        if (va.variable == PROCEDURE_VARIABLE)
+            result.push_back(va.parameter);
+    }
+    return result;
+}
+
+
+bool Action02VariableRecord::reads_variable(uint8_t variable) const
+{
+    for (const auto& va: m_actions)
+    {
+        if ((va.variable == variable) || ((va.variable == INDIRECT_VARIABLE) && (va.parameter == variable)))
+            return true;
+    }
+    return false;
+}
+
+
+std::optional<uint16_t> Action02VariableRecord::single_target() const
+{
+    // With no ranges, the calculated value is returned as a callback result.
+    if (m_ranges.empty())
+        return std::nullopt;
+
+    for (const auto& range: m_ranges)
+    {
+        if (range.set_id != m_default.get())
+            return std::nullopt;
+    }
+    return m_default.get();
+}
+
+
+Action02VariableRecord::Outcome Action02VariableRecord::evaluate(const VariableReader& read_variable) const
+{
+    uint32_t last = 0;
+    for (std::size_t i = 0; i < m_actions.size(); ++i)
+    {
+        const VarAction& va = m_actions[i];
+
+        std::optional<uint32_t> value;
+        if (va.variable == CONSTANT_VARIABLE)
+            value = 0xFFFFFFFF;
+        else if (va.variable == INDIRECT_VARIABLE)
+            value = read_variable(va.parameter, last);
+        else
+            value = read_variable(va.variable, va.parameter);
+
+        // The game selects the set of the first range if a variable is not available.
+        if (!value)
+            return { false, 0, m_ranges.empty() ? m_default.get() : m_ranges[0].set_id };
+
+        // The first value is simply assigned.
+        Operation operation = (i > 0) ? va.operation : Operation::Assign;
+        last = apply_operation(m_var_type, operation, last, adjust_value(m_var_type, va, *value));
+    }
+
+    if (m_ranges.empty())
+        return { true, last, uint16_t(0x8000 | (last & 0x7FFF)) };
+
+    for (const auto& range: m_ranges)
+    {
+        if ((range.low_range <= last) && (last <= range.high_range))
+            return { true, last, range.set_id };
+    }
+    return { true, last, m_default.get() };
+}
+
+
+bool Action02VariableRecord::simplify_actions()
+{
+    // The running value, for as long as it is a constant. The kept actions are then a
+    // single constant action.
+    std::optional<uint32_t> known;
+    std::vector<VarAction>  actions;
+
+    for (const auto& va: m_actions)
+    {
+        auto constant = constant_value(va);
+        bool is_store = (va.operation == Operation::TempStore) || (va.operation == Operation::PermStore);
+
+        if (actions.empty())
+        {
+            known = constant;
+            actions.push_back(va);
+        }
+        else if (known && constant && !is_store)
+        {
+            known = apply_operation(m_var_type, va.operation, *known, *constant);
+            actions.back().variable  = CONSTANT_VARIABLE;
+            actions.back().shift_num = 0;
+            actions.back().and_mask  = *known;
+        }
+        else if (is_identity(va))
+        {
+            continue;
+        }
+        else if (known && (va.operation == Operation::Assign))
+        {
+            // The constant is discarded, so this becomes the first action.
+            known = constant;
+            actions.back() = va;
+        }
+        else
+        {
+            known.reset();
+            actions.push_back(va);
+        }
+    }
+
+    bool changed = (actions.size() != m_actions.size());
+    m_actions = std::move(actions);
+    return changed;
+}
+
+
+bool Action02VariableRecord::simplify_ranges()
+{
+    auto is_empty = [](const VarRange& range) { return range.low_range > range.high_range; };
+    auto overlap  = [](const VarRange& a, const VarRange& b)
+    {
+        return (a.low_range <= b.high_range) && (b.low_range <= a.high_range);
+    };
+
+    // The first range is always kept because the game selects it if a variable is not available.
+    std::vector<VarRange> ranges;
+    for (std::size_t i = 0; i < m_ranges.size(); ++i)
+    {
+        const VarRange& range = m_ranges[i];
+        if ((i > 0) && is_empty(range))
+            continue;
+
+        // A later range selecting the default makes no difference unless it hides another range.
+        if ((i > 0) && (range.set_id == m_default.get()))
+        {
+            auto hides = [&](const VarRange& later)
+            {
+                return (later.set_id != range.set_id) && !is_empty(later) && overlap(range, later);
+            };
+            if (std::none_of(m_ranges.begin() + i + 1, m_ranges.end(), hides))
+                continue;
+        }
+
+        // Consecutive ranges selecting the same set can be combined if there is no gap between them.
+        if (!ranges.empty())
+        {
+            VarRange& last = ranges.back();
+            bool touch = (uint64_t{last.low_range} <= uint64_t{range.high_range} + 1) &&
+                (uint64_t{range.low_range} <= uint64_t{last.high_range} + 1);
+            if ((last.set_id == range.set_id) && !is_empty(last) && !is_empty(range) && touch)
+            {
+                last.low_range  = std::min(last.low_range, range.low_range);
+                last.high_range = std::max(last.high_range, range.high_range);
+                continue;
+            }
+        }
+
+        ranges.push_back(range);
+    }
+
+    bool changed = (ranges.size() != m_ranges.size());
+    m_ranges = std::move(ranges);
+    return changed;
+}
+
+
+bool Action02VariableRecord::simplify()
+{
+    bool changed = simplify_actions();
+
+    // A constant calculation always selects the same set. The first range is only used if a
+    // variable is not available, which cannot happen here.
+    auto constant = (m_actions.size() == 1) ? constant_value(m_actions[0]) : std::nullopt;
+    if (constant && !m_ranges.empty() && !single_target())
+    {
+        uint16_t target = m_default.get();
+        for (const auto& range: m_ranges)
+        {
+            if ((range.low_range <= *constant) && (*constant <= range.high_range))
+            {
+                target = range.set_id;
+                break;
+            }
+        }
+
+        m_ranges = { VarRange{ target, *constant, *constant } };
+        m_default.set(target);
+        changed = true;
+    }
+
+    if (simplify_ranges())
+        changed = true;
+    return changed;
+}
+
+
+bool Action02VariableRecord::equivalent(const Action02VariableRecord& other, uint32_t num_samples) const
+{
+    for (uint32_t sample = 0; sample < num_samples; ++sample)
+    {
+        auto read_variable = [sample](uint8_t variable, uint32_t parameter)
+        {
+            return sample_variable(sample, variable, parameter);
+        };
+
+        if (!(evaluate(read_variable) == other.evaluate(read_variable)))
+            return false;
+    }
+    return true;
+}
+
+void Action02VariableRecord::rename_act02_set_id(uint16_t from, uint16_t to)
+{
+    for (auto& range: m_ranges)
+    {
+        if (range.set_id == from)
+            range.set_id = to;
+    }
+    if (m_default.get() == from)
+        m_default.set(to);
+
+    // Procedure calls refer to the set ID in the parameter of variable 7E, and cannot call
+    // a callback result.
+    for (auto& va: m_actions)
+    {
+        if ((va.variable == PROCEDURE_VARIABLE) && (va.parameter == from) && (to <= 0xFF))
+            va.parameter = uint8_t(to);
+    }
+}
+
+
 void Action02VariableRecord::write(std::ostream& os, const GRFInfo& info) const
 {
     ActionRecord::write(os, info);
@@ -281,11 +748,11 @@ const UIntDescriptor<UInt16> desc_default { 0x03, str_default };
 std::string Action02VariableRecord::variable_name(const VarAction& va) const
 {
     std::ostringstream os;
-    os << str_variable << "[" << to_hex(va.variable);
+    os << str_variable << "[" << as_hex(va.variable);
     // Some variables take an additional argument
     if (va.variable >= 0x60 && va.variable < 0x80)
     {
-        os << ", " << to_hex(va.parameter);
+        os << ", " << as_hex(va.parameter);
     }
     os  << "]";
 
@@ -304,18 +771,18 @@ std::string Action02VariableRecord::variable_expression(const VarAction& va) con
         os << " >> " << uint16_t(va.shift_num);
     }
 
-    os << " & " << to_hex(va.and_mask);
+    os << " & " << as_hex(va.and_mask);
 
     if ((va.action & 0xC0) != 0x00)
     {
         // No point showing the add value if it is zero.
         if (va.add_value > 0)
         {
-            os << " + " << to_hex(va.add_value);
+            os << " + " << as_hex(va.add_value);
         }
 
         os << (((va.action & 0x80) == 0x00) ? " / " : " % ");
-        os << to_hex(va.div_mod_value);
+        os << as_hex(va.div_mod_value);
     }
 
     return os.str();
@@ -530,13 +997,13 @@ void Action02VariableRecord::print_ranges(std::ostream& os, uint16_t indent) con
         os << pad(indent + 4);
         if (r.low_range == r.high_range)
         {
-            os << to_hex(r.low_range) << ": ";
+            os << as_hex(r.low_range) << ": ";
         }
         else
         {
-            os << to_hex(r.low_range) << ".." << to_hex(r.high_range) << ": ";
+            os << as_hex(r.low_range) << ".." << as_hex(r.high_range) << ": ";
         }
-        os << to_hex(r.set_id) << ";\n";
+        os << as_hex(r.set_id) << ";\n";
     }
     os << pad(indent) << "};\n" ;
 }
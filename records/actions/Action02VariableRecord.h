@@ -19,6 +19,7 @@
 #pragma once
 #include "Record.h"
 #include "IntegerDescriptor.h"
+#include <functional>
 
 
 class Action02VariableRecord : public ActionRecord
@@ -36,18 +37,78 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
-private:
-    struct VarAction;
-    std::string variable_name(const VarAction& va) const;
-    std::string variable_expression(const VarAction& va) const;
+    std::optional<FeatureType> feature() const override { return m_feature; }
 
-    void print_ranges(std::ostream& os, uint16_t indent) const;
-    void print_expression(std::ostream& os, uint16_t indent) const;
+    uint8_t set_id() const { return m_set_id.get(); }
+    // The other Action02 sets or callback results selected by this record.
+    std::vector<uint16_t> act02_set_ids() const;
+    // The other Action02 sets called as procedures by variable 7E.
+    std::vector<uint16_t> procedure_set_ids() const;
+    void rename_act02_set_id(uint16_t from, uint16_t to);
 
-    void parse_ranges(TokenStream& is);
-    void parse_expression(TokenStream& is);
+    // The work done by one evaluation of this record, not counting the sets it selects.
+    struct Accesses
+    {
+        uint32_t variables     = 0; // All variable reads.
+        uint32_t parameterised = 0; // Reads of 60+x variables, which take a parameter.
+        uint32_t storage       = 0; // Reads and writes of temporary and persistent storage.
+    };
+    Accesses accesses() const;
+
+    struct VarRange
+    {
+        uint16_t set_id;
+        uint32_t low_range;
+        uint32_t high_range;
+    };
+    const std::vector<VarRange>& ranges() const { return m_ranges; }
+    uint16_t default_set_id() const { return m_default.get(); }
+    // True if this is a plain switch on the current callback (variable 0C), so that each
+    // range selects the chain for one or more callbacks.
+    bool selects_callback() const;
+    // True if evaluating this record may write to storage, directly or through a procedure call.
+    bool has_side_effects() const;
+    bool reads_variable(uint8_t variable) const;
+    // The set or callback result selected for every input, if there is only one.
+    std::optional<uint16_t> single_target() const;
+
+    // The value of a variable for one evaluation, or nothing if it is not available. Variable
+    // 7B is passed to the reader as the variable in its parameter, with the running value.
+    using VariableReader = std::function<std::optional<uint32_t>(uint8_t variable, uint32_t parameter)>;
+    struct Outcome
+    {
+        bool     available; // False if a variable was not available.
+        uint32_t value;     // The calculated value, which later records read as variable 1C.
+        uint16_t set_id;    // The selected set, or the callback result.
+
+        bool operator==(const Outcome& other) const
+        {
+            return (available == other.available) && (value == other.value) && (set_id == other.set_id);
+        }
+    };
+    // Calculates the result as the game does. The reader provides storage, and writes to
+    // storage are ignored.
+    Outcome evaluate(const VariableReader& read_variable) const;
+
+    // Folds operations with constant operands, drops operations which do nothing, and merges or
+    // drops ranges which make no difference to the selected set. Returns true if anything changed.
+    bool simplify();
+    // Checks that this record and another have the same outcome for a number of pseudo-random
+    // inputs. This is used to verify simplify().
+    bool equivalent(const Action02VariableRecord& other, uint32_t num_samples) const;
 
 public:
+    // Set IDs with bit 15 set are callback results rather than other Action02 sets.
+    static constexpr uint16_t CALLBACK_RESULT    = 0x8000;
+
+    // Variables with special meanings in a switch.
+    static constexpr uint8_t  CONSTANT_VARIABLE  = 0x1A; // Always 0xFFFFFFFF, so with a mask it gives a constant.
+    static constexpr uint8_t  LAST_VALUE         = 0x1C; // The value calculated by the last switch.
+    static constexpr uint8_t  INDIRECT_VARIABLE  = 0x7B; // Reads the variable in its parameter, with the running value as the parameter.
+    static constexpr uint8_t  PERM_STORAGE       = 0x7C;
+    static constexpr uint8_t  TEMP_STORAGE       = 0x7D;
+    static constexpr uint8_t  PROCEDURE_VARIABLE = 0x7E; // Calls another Action02 chain as a procedure.
+
     // Must be 0x81/0x82(B), 0x85/0x86(W), 0x89/0x8A(D)
     enum class VarType : uint8_t
     {
@@ -86,7 +147,13 @@ public:
         SignedShiftRight   = 0x16,
     };
 
-private:
+    // Combines the running value with the next adjusted variable, truncated to the size of the type.
+    static uint32_t apply_operation(VarType type, Operation operation, uint32_t last, uint32_t value);
+    // The bits of the running value which are kept for the size of the type.
+    static uint32_t type_mask(VarType type);
+    // SplitMix64, which gives well distributed pseudo-random values for sampling the variables.
+    static uint64_t mix(uint64_t hash);
+
     struct VarAction
     {
         bool has_parameter() const { return (variable >= 0x60) && (variable < 0x80); }
@@ -100,13 +167,26 @@ private:
         uint32_t   add_value;     // If bit6 or bit7 of shift_num set
         uint32_t   div_mod_value; // If bit6 or bit7  of shift_num set
     };
+    const std::vector<VarAction>& actions() const { return m_actions; }
+    VarType var_type() const { return m_var_type; }
 
-    struct VarRange
-    {
-        uint16_t set_id;
-        uint32_t low_range;
-        uint32_t high_range;
-    };
+    // Shifts and masks a variable, and then applies the division or modulus, if any.
+    static uint32_t adjust_value(VarType type, const VarAction& va, uint32_t value);
+
+private:
+    std::optional<uint32_t> constant_value(const VarAction& va) const;
+    bool                    is_identity(const VarAction& va) const;
+    bool                    simplify_actions();
+    bool                    simplify_ranges();
+
+    std::string variable_name(const VarAction& va) const;
+    std::string variable_expression(const VarAction& va) const;
+
+    void print_ranges(std::ostream& os, uint16_t indent) const;
+    void print_expression(std::ostream& os, uint16_t indent) const;
+
+    void parse_ranges(TokenStream& is);
+    void parse_expression(TokenStream& is);
 
 private:
     FeatureType m_feature;
@@ -70,6 +70,30 @@ void Action03Record::read(std::istream& is, const GRFInfo& info)
 }
 
 
+std::vector<uint16_t> Action03Record::act02_set_ids() const
+{
+    std::vector<uint16_t> result;
+    for (const auto& cargo_type: m_cargo_types)
+    {
+        result.push_back(cargo_type.act02_set_id);
+    }
+    result.push_back(m_default_act02_set_id);
+    return result;
+}
+
+
+void Action03Record::rename_act02_set_id(uint16_t from, uint16_t to)
+{
+    for (auto& cargo_type: m_cargo_types)
+    {
+        if (cargo_type.act02_set_id == from)
+            cargo_type.act02_set_id = to;
+    }
+    if (m_default_act02_set_id == from)
+        m_default_act02_set_id = to;
+}
+
+
 void Action03Record::write(std::ostream& os, const GRFInfo& info) const
 {
     ActionRecord::write(os, info);
@@ -145,7 +169,7 @@ void Action03Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
     os << pad(indent + 8) << "// <cargo_type>: <cargo_id>;\n";
     for (const auto& c: m_cargo_types)
     {
-        os << pad(indent + 8) << to_hex(c.cargo_type) << ": " << to_hex(c.act02_set_id) << ";\n";
+        os << pad(indent + 8) << as_hex(c.cargo_type) << ": " << as_hex(c.act02_set_id) << ";\n";
     }
     os << pad(indent + 4) << "};\n";
 
@@ -37,10 +37,16 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    std::optional<FeatureType> feature() const override { return m_feature; }
+
+    // The Action02 sets used by this record, including the default.
+    std::vector<uint16_t> act02_set_ids() const;
+    void rename_act02_set_id(uint16_t from, uint16_t to);
+
 private:
     void parse_cargo_types(TokenStream& is);
 
-private:
+public:
     struct CargoType
     {
         // If defined, cargo-type FF is used for graphics shown in the purchase
@@ -52,6 +58,11 @@ private:
         uint16_t act02_set_id = 0;
     };
 
+    const std::vector<uint16_t>&  feature_ids() const    { return m_feature_ids; }
+    const std::vector<CargoType>& cargo_types() const    { return m_cargo_types; }
+    uint16_t                      default_set_id() const { return m_default_act02_set_id; }
+    bool                          livery_override() const { return m_livery_override; }
+
 private:
     // The type of feature for which we are making an association
     // of graphics with properties.
@@ -104,14 +104,14 @@ void Action04Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
     os << language_iso(m_language) << ", ";
     // Come up with something better than this. The * is used to disambiguate whether the original
     // GRF used 16-bit IDs. Or we could ignore that and just go off the actual value of the ID.
-    os << to_hex(m_first_string_id) << (m_uint16_ids ? "*" : "");
+    os << as_hex(m_first_string_id) << (m_uint16_ids ? "*" : "");
     os << "> // <feature, language, first_id> Action04, " << language_name(m_language) << "\n";
     os << pad(indent) << "{\n";
 
     uint16_t string_id = m_first_string_id;
     for (const auto& s: m_strings)
     {
-        os << pad(indent + 4) << "/* " << to_hex(string_id++) << " */ ";
+        os << pad(indent + 4) << "/* " << as_hex(string_id++) << " */ ";
         os << "\"" << s.readable() << "\";\n";
     }
 
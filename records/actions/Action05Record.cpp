@@ -95,7 +95,7 @@ void Action05Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
 {
     os << pad(indent) << RecordName(record_type()) << "<";
     os << NewFeatureName(m_sprite_type) << ", ";
-    os << to_hex(m_offset) << "> // <new_feature_type, offset>  Action05\n";
+    os << as_hex(m_offset) << "> // <new_feature_type, offset>  Action05\n";
     os << pad(indent) << "{\n";
 
     uint16_t num_sprites = num_sprites_to_write();
@@ -75,7 +75,7 @@ void Action06Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
     for (const auto& mod: m_modifications)
     {
         os << pad(indent + 4) << str_modification << "(";
-        os << str_parameter << "[" << to_hex(mod.param_num) << "], ";
+        os << str_parameter << "[" << as_hex(mod.param_num) << "], ";
         os << static_cast<uint16_t>(mod.param_size) << ", ";
         os << mod.offset << ", ";
         os << (mod.add_bytes ? "true" : "false") << ");\n";
@@ -40,7 +40,7 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
-private:
+public:
     struct Modification
     {
         uint8_t  param_num;  // One of the user settable parameters - can be set with Action0D, for example.
@@ -49,5 +49,8 @@ private:
         uint16_t offset;     // Offset into the next sprite - this is where the modification is made.
     };
 
+    const std::vector<Modification>& modifications() const { return m_modifications; }
+
+private:
     std::vector<Modification> m_modifications;
 };
@@ -61,11 +61,11 @@ std::string param_description(uint8_t param)
     std::ostringstream ss;
     if (param & 0x80)
     {
-        ss << str_global_var << "[" << to_hex(param) << "]";
+        ss << str_global_var << "[" << as_hex(param) << "]";
     }
     else
     {
-        ss << str_param << "[" << to_hex(param) << "]";
+        ss << str_param << "[" << as_hex(param) << "]";
     }
     return ss.str();
 }
@@ -169,7 +169,7 @@ void Action07Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
         case Condition::GRFInitOrActive:
         case Condition::GRFDisabled:
             os << desc_condition.value(m_condition) << "(";
-            os << "\"" << label.to_string() << "\", " << to_hex(m_mask) << ")";
+            os << "\"" << label.to_string() << "\", " << as_hex(m_mask) << ")";
             break;
 
         // e.g. CargoTypeInvalid(m_value) - 4-byte value
@@ -190,7 +190,7 @@ void Action07Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
     os << (record_type() == RecordType::ACTION_07 ? "7" : "9");
     os << pad(indent) << "\n{\n";
 
-    os << pad(indent + 4) << str_skip_sprites << ": " << to_hex(m_num_sprites) << ";\n";
+    os << pad(indent + 4) << str_skip_sprites << ": " << as_hex(m_num_sprites) << ";\n";
     os << pad(indent + 4) << "// Or skip to the next label (Action10) with this value - search wraps at end of GRF.\n";
     os << pad(indent + 4) << "// 0x00 means skip to end of GRF file - may disable the GRF.\n";
 
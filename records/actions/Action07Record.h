@@ -76,6 +76,13 @@ public:
         TramTypeValid    = 0x12,
     };
 
+    uint8_t   variable() const    { return m_variable; }
+    Condition condition() const   { return m_condition; }
+    uint32_t  value() const       { return m_value; }
+    uint32_t  mask() const        { return m_mask; }
+    // This is the last byte of the record data.
+    uint8_t   num_sprites() const { return m_num_sprites; }
+
 private:
     uint8_t   m_variable{};    // This sets the variable to base the decision on.
     uint8_t   m_varsize{};     // For GRF parameters, this is the same as <param-size>
@@ -143,7 +143,7 @@ void Action0BRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
     os << pad(indent) << RecordName(record_type()) << "<";
     os << severity_desc.value(m_severity) << ", ";
     os << language_iso(m_language_id) << ", ";
-    os << to_hex(m_message_id) << "> // Action0B <severity, language, message>\n";
+    os << as_hex(m_message_id) << "> // Action0B <severity, language, message>\n";
     os << pad(indent) << "{\n";
 
     // Indicate the standard message, if this is one.
@@ -273,15 +273,15 @@ std::string Action0DRecord::param_description(uint8_t param) const
     std::ostringstream ss;
     if (param == 0xFF)
     {
-        ss << to_hex(m_data);
+        ss << as_hex(m_data);
     }
     else if (param & 0x80)
     {
-        ss << str_global_var << "[" << to_hex(param) << "]";
+        ss << str_global_var << "[" << as_hex(param) << "]";
     }
     else
     {
-        ss << str_param << "[" << to_hex(param) << "]";
+        ss << str_param << "[" << as_hex(param) << "]";
     }
     return ss.str();
 }
@@ -392,10 +392,10 @@ void Action0DRecord::parse_other(TokenStream& is)
 void Action0DRecord::print_patch(std::ostream& os, uint16_t indent) const
 {
     //os << pad(indent) << str_target  << ": " << param_description(m_target) << ";\n";
-    //os << pad(indent) << str_source1 << ": " << str_patch_var << "[" << to_hex(m_source1) << ";\n";
+    //os << pad(indent) << str_source1 << ": " << str_patch_var << "[" << as_hex(m_source1) << ";\n";
 
     os << pad(indent) << str_expression << ": " << param_description(m_target) << " = ";
-    os << str_patch_var << "[" << to_hex(m_source1) << "];\n";
+    os << str_patch_var << "[" << as_hex(m_source1) << "];\n";
 
 }
 
@@ -417,7 +417,7 @@ void Action0DRecord::print_resources(std::ostream& os, uint16_t indent) const
 {
     os << pad(indent) << str_expression << ": " << param_description(m_target) << " = ";
     os << desc_grm_op.value(static_cast<GRMOperator>(m_source1)) << "(";
-    os << desc_feature.value(m_feature) << ", " << to_hex(m_number) << ");\n";
+    os << desc_feature.value(m_feature) << ", " << as_hex(m_number) << ");\n";
 }
 
 
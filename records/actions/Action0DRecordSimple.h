@@ -42,6 +42,13 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    uint8_t  target() const     { return m_target.get(); }
+    // Add 0x80 to apply the operation only if the target is not yet defined.
+    uint8_t  operation() const  { return m_operation.get(); }
+    uint8_t  source1() const    { return m_source1.get(); }
+    uint8_t  source2() const    { return m_source2.get(); }
+    uint32_t data_value() const { return m_data_value.get(); }
+
 private:
     bool has_data() const;
 
@@ -121,7 +121,7 @@ constexpr const char* str_town_names = "town_names";
 
 void Action0FRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
-    os << RecordName(record_type()) << "<" << to_hex(m_id) << "> // Action0F\n";
+    os << RecordName(record_type()) << "<" << as_hex(m_id) << "> // Action0F\n";
     os << "{\n";
 
     // Names in various languages for this town names style.
@@ -155,7 +155,7 @@ void Action0FRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
             }
             else
             {
-                os << pad(indent + 8) << str_town_names << "(" << to_hex(text.action_0F_id);
+                os << pad(indent + 8) << str_town_names << "(" << as_hex(text.action_0F_id);
             }
             os << ", " << uint16_t(text.probability) << ");\n";
         }
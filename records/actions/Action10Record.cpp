@@ -39,7 +39,7 @@ void Action10Record::write(std::ostream& os, const GRFInfo& info) const
 
 void Action10Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
-    os << RecordName(record_type()) << "<" << to_hex(m_label) << "> // Action10 - target for Action07 or Action09\n";
+    os << RecordName(record_type()) << "<" << as_hex(m_label) << "> // Action10 - target for Action07 or Action09\n";
     os << "{\n";
 
     // TODO This is probably not a valid thing to do. Should more likely
@@ -36,6 +36,8 @@ public:
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
 
+    uint8_t label() const { return m_label; }
+
 private:
     uint8_t   m_label;
     GRFString m_comment;
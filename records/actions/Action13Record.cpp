@@ -87,13 +87,13 @@ void Action13Record::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
 {
     os << pad(indent) << RecordName(record_type()) << "<\"" << m_grf_id.to_string() << "\", ";
     os << language_iso(m_language) << ", ";
-    os << to_hex(m_first_string_id) << "> // <grf_id, language, first_id> Action13, " << language_name(m_language) << "\n";
+    os << as_hex(m_first_string_id) << "> // <grf_id, language, first_id> Action13, " << language_name(m_language) << "\n";
     os << pad(indent) << "{\n";
 
     uint16_t string_id = m_first_string_id;
     for (const auto& str: m_strings)
     {
-        os << pad(indent + 4) << "/*" << to_hex(string_id++) << "*/ ";
+        os << pad(indent + 4) << "/*" << as_hex(string_id++) << "*/ ";
         os << "\"" << str.readable() << "\";\n";
     }
 
@@ -21,6 +21,7 @@
 #include "GRFStrings.h"
 #include "FileSystem.h"
 #include "CommandLineOptions.h"
+#include "FileQueue.h"
 #include <fstream>
 
 
@@ -92,11 +93,8 @@ void ActionFFRecord::write_binary_file(const std::string& binary_dir) const
     fs::path binary_path(binary_dir);
     binary_path.append(m_filename);
 
-    const std::string file_path = binary_path.make_preferred().string();
-    std::cout << "Writing binary file: " << file_path << "..." << std::endl;
-
-    std::ofstream os(binary_path, std::ios::binary);
-    os.write((char*)&m_binary[0], m_binary.size());
+    // This may be deferred if the records are being printed concurrently.
+    FileQueue::queue().write_file(binary_path.make_preferred().string(), m_binary);
 }
 
 
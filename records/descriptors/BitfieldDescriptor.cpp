@@ -19,6 +19,19 @@
 #include "BitfieldDescriptor.h"
 
 
+BitfieldDescriptor::BitfieldDescriptor(uint8_t index, const char* name, std::vector<Item> items_)
+: PropertyDescriptor{index, name}
+, items{std::move(items_)}
+{
+    std::vector<std::pair<std::string, uint8_t>> bits;
+    for (const auto& item: items)
+    {
+        bits.emplace_back(item.name, item.bit);
+    }
+    m_bits.build(std::move(bits));
+}
+
+
 void BitfieldDescriptor::print_impl(uint32_t bits, std::ostream& os, uint16_t indent) const
 {
     prefix(os, indent);
@@ -51,13 +64,9 @@ void BitfieldDescriptor::parse_impl(uint32_t& bits, TokenStream& is) const
     while (true)
     {
         std::string name = is.match(TokenType::Ident);
-        for (const auto& item: items)
+        if (const uint8_t* bit = m_bits.find(name))
         {
-            if (name == item.name)
-            {
-                bits |= item.bit;
-                break;
-            }
+            bits |= *bit;
         }
 
         const TokenValue& token = is.peek();
@@ -18,6 +18,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "DescriptorBase.h"
+#include "PerfectHash.h"
 
 
 struct BitfieldDescriptor : PropertyDescriptor
@@ -28,16 +29,24 @@ struct BitfieldDescriptor : PropertyDescriptor
         const char* name;
     };
 
+    // The name lookup is built once here, so that parsing does not have to search the items.
+    BitfieldDescriptor(uint8_t index, const char* name, std::vector<Item> items);
+
     void print_impl(uint32_t bits, std::ostream& os, uint16_t indent) const;
     void parse_impl(uint32_t& bits, TokenStream& is) const;
 
     std::vector<Item> items;
+
+private:
+    PerfectHash<uint8_t> m_bits;
 };
 
 
 template <typename T>
 struct BitfieldDescriptorT : BitfieldDescriptor
 {
+    using BitfieldDescriptor::BitfieldDescriptor;
+
     void print(const T& bits, std::ostream& os, uint16_t indent) const
     {
         uint32_t temp = bits;
@@ -18,21 +18,82 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "EnumDescriptor.h"
 #include <sstream>
+#include <algorithm>
 
 
-void EnumDescriptor::print_impl(uint32_t value, std::ostream& os, uint16_t indent) const
+namespace {
+
+
+// Values below this, or below a small multiple of the number of items, are indexed directly.
+constexpr uint32_t MIN_DENSE_VALUES = 64;
+
+
+} // namespace {
+
+
+EnumDescriptor::EnumDescriptor(uint8_t index, const char* name, std::vector<Item> items_)
+: PropertyDescriptor{index, name}
+, items{std::move(items_)}
 {
-    prefix(os, indent);
+    const uint32_t dense_limit = std::max<uint32_t>(MIN_DENSE_VALUES, 4 * static_cast<uint32_t>(items.size()));
 
+    std::vector<std::pair<std::string, uint32_t>> values;
     for (const auto& item: items)
     {
-        if (value == item.value)
+        values.emplace_back(item.name, item.value);
+
+        // The first item with a given value wins, as it did with a linear search.
+        if (item.value < dense_limit)
+        {
+            if (item.value >= m_names.size())
+            {
+                m_names.resize(item.value + 1, nullptr);
+            }
+            if (m_names[item.value] == nullptr)
+            {
+                m_names[item.value] = item.name;
+            }
+        }
+        else
         {
-            os << item.name << ";\n";
-            return;
+            m_sparse_names.push_back(item);
         }
     }
 
+    std::stable_sort(m_sparse_names.begin(), m_sparse_names.end(),
+        [](const Item& a, const Item& b) { return a.value < b.value; });
+    m_values.build(std::move(values));
+}
+
+
+const char* EnumDescriptor::find_name(uint32_t value) const
+{
+    if (value < m_names.size())
+    {
+        return m_names[value];
+    }
+
+    auto it = std::lower_bound(m_sparse_names.begin(), m_sparse_names.end(), value,
+        [](const Item& item, uint32_t value) { return item.value < value; });
+    if ((it != m_sparse_names.end()) && (it->value == value))
+    {
+        return it->name;
+    }
+
+    return nullptr;
+}
+
+
+void EnumDescriptor::print_impl(uint32_t value, std::ostream& os, uint16_t indent) const
+{
+    prefix(os, indent);
+
+    if (const char* name = find_name(value))
+    {
+        os << name << ";\n";
+        return;
+    }
+
     std::ostringstream ss;
     ss << "EnumDescriptor::print " << value;
     throw RUNTIME_ERROR(ss.str());
@@ -41,13 +102,10 @@ void EnumDescriptor::print_impl(uint32_t value, std::ostream& os, uint16_t inden
 
 void EnumDescriptor::print_value_impl(uint32_t value, std::ostream& os) const
 {
-    for (const auto& item: items)
+    if (const char* name = find_name(value))
     {
-        if (value == item.value)
-        {
-            os << item.name;
-            return;
-        }
+        os << name;
+        return;
     }
 
     std::ostringstream ss;
@@ -58,12 +116,9 @@ void EnumDescriptor::print_value_impl(uint32_t value, std::ostream& os) const
 
 const char* EnumDescriptor::value_impl(uint32_t value) const
 {
-    for (const auto& item: items)
+    if (const char* name = find_name(value))
     {
-        if (value == item.value)
-        {
-            return item.name;
-        }
+        return name;
     }
 
     std::ostringstream ss;
@@ -76,20 +131,13 @@ void EnumDescriptor::parse_impl(uint32_t& value, TokenStream& is) const
 {
     std::string name = is.match(TokenType::Ident);
 
-    for (const auto& item: items)
+    if (const uint32_t* found = m_values.find(name))
     {
-        if (name == item.name)
-        {
-            value = item.value;
-            return;
-        }
+        value = *found;
+        return;
     }
 
     std::ostringstream ss;
-    ss << "EnumDescriptor::parse " << value;
+    ss << "EnumDescriptor::parse " << name;
     throw RUNTIME_ERROR(ss.str());
 }
-
-
-
-
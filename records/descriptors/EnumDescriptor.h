@@ -18,6 +18,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "DescriptorBase.h"
+#include "PerfectHash.h"
 
 
 struct EnumDescriptor : PropertyDescriptor
@@ -28,18 +29,35 @@ struct EnumDescriptor : PropertyDescriptor
         const char* name;
     };
 
+    // The lookup tables are built once here, so that neither printing nor parsing has to
+    // search the items.
+    EnumDescriptor(uint8_t index, const char* name, std::vector<Item> items);
+
     void print_impl(uint32_t value, std::ostream& os, uint16_t indent) const;
     void print_value_impl(uint32_t value, std::ostream& os) const;
     void parse_impl(uint32_t& value, TokenStream& is) const;
     const char* value_impl(uint32_t value) const;
 
     std::vector<Item> items;
+
+private:
+    // Returns nullptr if the value is not one of the items.
+    const char* find_name(uint32_t value) const;
+
+private:
+    // Most enumerations are small and contiguous, so names are indexed directly by value.
+    // Any large values are sorted for a binary search.
+    std::vector<const char*> m_names;
+    std::vector<Item>        m_sparse_names;
+    PerfectHash<uint32_t>    m_values;
 };
 
 
 template <typename Enum>
 struct EnumDescriptorT : EnumDescriptor
 {
+    using EnumDescriptor::EnumDescriptor;
+
     void print(Enum value, std::ostream& os, uint16_t indent) const
     {
         uint32_t temp = static_cast<uint32_t>(value);
@@ -33,7 +33,8 @@ struct IntegerDescriptorT : PropertyDescriptor
     {
         // This is the name of the property.
         prefix(os, indent);
-        os << to_string(value, format) << ";\n";
+        print_uint(os, value, format);
+        os << ";\n";
     }
 
     void parse(T& value, TokenStream& is) const
@@ -56,7 +57,8 @@ struct IntegerListDescriptorT : PropertyDescriptor
         os << "[";
         for (const T value: values)
         {
-            os << " " << to_string(value, format);
+            os << " ";
+            print_uint(os, value, format);
         }
         os << " ];\n";
     }
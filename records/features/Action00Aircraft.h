@@ -30,36 +30,40 @@
 using CargosProperty = UInt8ListProperty;
 
 
-class Action00Aircraft : public Action00Vehicles
+class Action00AircraftProperties : public Action00VehiclesProperties
 {
-public:
-    Action00Aircraft() : Action00Vehicles{FeatureType::Aircraft} {}
-
 private:
-    UInt8Property     m_prop_08{m_properties, 0x08, "sprite_id"};
-    BoolHeliProperty  m_prop_09{m_properties, 0x09, "is_helicopter"};
-    BoolProperty      m_prop_0A{m_properties, 0x0A, "is_large"};
-    UInt8Property     m_prop_0B{m_properties, 0x0B, "cost_factor"};
-    UInt8Property     m_prop_0C{m_properties, 0x0C, "speed_8_mph"};
-    UInt8Property     m_prop_0D{m_properties, 0x0D, "acceleration"};
-    UInt8Property     m_prop_0E{m_properties, 0x0E, "running_cost_factor"};
-    UInt16Property    m_prop_0F{m_properties, 0x0F, "passenger_capacity"};
-    UInt8Property     m_prop_11{m_properties, 0x11, "mail_capacity"};
-    UInt8Property     m_prop_12{m_properties, 0x12, "sound_effect_type"};
-    UInt32Property    m_prop_13{m_properties, 0x13, "refit_cargo_types"};   // GRFv >= 6
-    UInt8Property     m_prop_14{m_properties, 0x14, "callback_flags_mask"}; // GRFv >= 6
-    UInt8Property     m_prop_15{m_properties, 0x15, "refit_cost"};
-    UInt8Property     m_prop_16{m_properties, 0x16, "retire_vehicle_early"};
-    UInt8Property     m_prop_17{m_properties, 0x17, "miscellaneous_flags"};
-    UInt16Property    m_prop_18{m_properties, 0x18, "refittable_cargo_classes"};
-    UInt16Property    m_prop_19{m_properties, 0x19, "non_refittable_cargo_classes"};
-    LongDateProperty  m_prop_1A{m_properties, 0x1A, "long_introduction_date"};
-    UInt8XProperty    m_prop_1B{m_properties, 0x1B, "sort_purchase_list"};
-    UInt16Property    m_prop_1C{m_properties, 0x1C, "custom_cargo_aging_period"};
-    CargosProperty    m_prop_1D{m_properties, 0x1D, "always_refittable_cargos"};
-    CargosProperty    m_prop_1E{m_properties, 0x1E, "never_refittable_cargos"};
-    UInt16Property    m_prop_1F{m_properties, 0x1F, "aircraft_range"};
-    UInt16Property    m_prop_20{m_properties, 0x20, "variant_group"};
-    UInt32Property    m_prop_21{m_properties, 0x21, "extra_flags"};
-    UInt8Property     m_prop_22{m_properties, 0x22, "extra_callback_flags_mask"};
+    UInt8Property     m_prop_08{m_table, 0x08, "sprite_id"};
+    BoolHeliProperty  m_prop_09{m_table, 0x09, "is_helicopter"};
+    BoolProperty      m_prop_0A{m_table, 0x0A, "is_large"};
+    UInt8Property     m_prop_0B{m_table, 0x0B, "cost_factor"};
+    UInt8Property     m_prop_0C{m_table, 0x0C, "speed_8_mph"};
+    UInt8Property     m_prop_0D{m_table, 0x0D, "acceleration"};
+    UInt8Property     m_prop_0E{m_table, 0x0E, "running_cost_factor"};
+    UInt16Property    m_prop_0F{m_table, 0x0F, "passenger_capacity"};
+    UInt8Property     m_prop_11{m_table, 0x11, "mail_capacity"};
+    UInt8Property     m_prop_12{m_table, 0x12, "sound_effect_type"};
+    UInt32Property    m_prop_13{m_table, 0x13, "refit_cargo_types"};   // GRFv >= 6
+    UInt8Property     m_prop_14{m_table, 0x14, "callback_flags_mask"}; // GRFv >= 6
+    UInt8Property     m_prop_15{m_table, 0x15, "refit_cost"};
+    UInt8Property     m_prop_16{m_table, 0x16, "retire_vehicle_early"};
+    UInt8Property     m_prop_17{m_table, 0x17, "miscellaneous_flags"};
+    UInt16Property    m_prop_18{m_table, 0x18, "refittable_cargo_classes"};
+    UInt16Property    m_prop_19{m_table, 0x19, "non_refittable_cargo_classes"};
+    LongDateProperty  m_prop_1A{m_table, 0x1A, "long_introduction_date"};
+    UInt8XProperty    m_prop_1B{m_table, 0x1B, "sort_purchase_list"};
+    UInt16Property    m_prop_1C{m_table, 0x1C, "custom_cargo_aging_period"};
+    CargosProperty    m_prop_1D{m_table, 0x1D, "always_refittable_cargos"};
+    CargosProperty    m_prop_1E{m_table, 0x1E, "never_refittable_cargos"};
+    UInt16Property    m_prop_1F{m_table, 0x1F, "aircraft_range"};
+    UInt16Property    m_prop_20{m_table, 0x20, "variant_group"};
+    UInt32Property    m_prop_21{m_table, 0x21, "extra_flags"};
+    UInt8Property     m_prop_22{m_table, 0x22, "extra_callback_flags_mask"};
+};
+
+
+class Action00Aircraft : public Action00Feature
+{
+public:
+    Action00Aircraft() : Action00Feature{FeatureType::Aircraft, static_property_table<Action00AircraftProperties>()} {}
 };
@@ -21,24 +21,28 @@
 #include "IntegerDescriptor.h"
 
 
-class Action00AirportTiles : public Action00Feature
+class Action00AirportTilesProperties : public FeatureProperties
 {
-public:
-    Action00AirportTiles() : Action00Feature{FeatureType::AirportTiles} {}
-
 private:
-    UInt8Property   m_prop_08{m_properties, 0x08, "substitute_tile_id"};
-    UInt8Property   m_prop_09{m_properties, 0x09, "aiport_tile_override"};
-    UInt8Property   m_prop_0E{m_properties, 0x0E, "callback_flags"};
+    UInt8Property   m_prop_08{m_table, 0x08, "substitute_tile_id"};
+    UInt8Property   m_prop_09{m_table, 0x09, "aiport_tile_override"};
+    UInt8Property   m_prop_0E{m_table, 0x0E, "callback_flags"};
     // The low byte specifies the number of animation frames minus one, so 00 means 1 frame,
     // 01 means 2 frames etc. The maximum number of frames is 256, although you can have some
     // problems if your animation exceeds FD (253) frames. The high byte must be 0 for
     // on-looping animations and 01 for looping animations. Every other value is reserved for
     // future use. In addition, if the whole word contains FFFF, animation is turned off for
     // this tile (this is the default value).
-    UInt16Property  m_prop_0F{m_properties, 0x0F, "animation_info"};
-    UInt8Property   m_prop_10{m_properties, 0x10, "animation_speed"};
-    UInt8Property   m_prop_11{m_properties, 0x11, "animation_triggers"};
+    UInt16Property  m_prop_0F{m_table, 0x0F, "animation_info"};
+    UInt8Property   m_prop_10{m_table, 0x10, "animation_speed"};
+    UInt8Property   m_prop_11{m_table, 0x11, "animation_triggers"};
+};
+
+
+class Action00AirportTiles : public Action00Feature
+{
+public:
+    Action00AirportTiles() : Action00Feature{FeatureType::AirportTiles, static_property_table<Action00AirportTilesProperties>()} {}
 };
 
 
@@ -25,20 +25,24 @@
 using AirportLayoutsProperty = Property<AirportLayouts>;
 
 
+class Action00AirportsProperties : public FeatureProperties
+{
+private:
+    UInt8Property          m_prop_08{m_table, 0x08, "airport_override_id"};
+    AirportLayoutsProperty m_prop_0A{m_table, 0x0A, "airport_layouts"};
+    Year16PairProperty     m_prop_0C{m_table, 0x0C, "years_available"};
+    UInt8Property          m_prop_0D{m_table, 0x0D, "compatible_ttd_airport"};
+    UInt8Property          m_prop_0E{m_table, 0x0E, "catchment_area"};
+    UInt8Property          m_prop_0F{m_table, 0x0F, "noise_level"};
+    UInt16Property         m_prop_10{m_table, 0x10, "airport_name_id"};
+    UInt16Property         m_prop_11{m_table, 0x11, "maintenance_cost_factor"};
+};
+
+
 class Action00Airports : public Action00Feature
 {
 public:
-    Action00Airports() : Action00Feature(FeatureType::Airports) {}
-
-private:
-    UInt8Property          m_prop_08{m_properties, 0x08, "airport_override_id"};
-    AirportLayoutsProperty m_prop_0A{m_properties, 0x0A, "airport_layouts"};
-    Year16PairProperty     m_prop_0C{m_properties, 0x0C, "years_available"};
-    UInt8Property          m_prop_0D{m_properties, 0x0D, "compatible_ttd_airport"};
-    UInt8Property          m_prop_0E{m_properties, 0x0E, "catchment_area"};
-    UInt8Property          m_prop_0F{m_properties, 0x0F, "noise_level"};
-    UInt16Property         m_prop_10{m_properties, 0x10, "airport_name_id"};
-    UInt16Property         m_prop_11{m_properties, 0x11, "maintenance_cost_factor"};
+    Action00Airports() : Action00Feature{FeatureType::Airports, static_property_table<Action00AirportsProperties>()} {}
 };
 
 
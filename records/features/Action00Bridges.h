@@ -27,25 +27,29 @@
 using BridgeLayoutProperty = Property<BridgeLayout>;
 
 
+class Action00BridgesProperties : public FeatureProperties
+{
+private:
+    UInt8Property        m_prop_00{m_table, 0x00, "fallback_type_id"};
+    Year8Property        m_prop_08{m_table, 0x08, "year_available"};
+    UInt8Property        m_prop_09{m_table, 0x09, "minimum_length"};
+    UInt8Property        m_prop_0A{m_table, 0x0A, "maximum_length"};
+    UInt8Property        m_prop_0B{m_table, 0x0B, "cost_factor"};
+    UInt16Property       m_prop_0C{m_table, 0x0C, "maximum_speed"};
+    BridgeLayoutProperty m_prop_0D{m_table, 0x0D, "bridge_layout"};
+    UInt8Property        m_prop_0E{m_table, 0x0E, "various_flags"};
+    Year32Property       m_prop_0F{m_table, 0x0F, "long_year_available"};
+    UInt16Property       m_prop_10{m_table, 0x10, "purchase_text"};
+    UInt16Property       m_prop_11{m_table, 0x11, "description_rail"};
+    UInt16Property       m_prop_12{m_table, 0x12, "description_road"};
+    UInt16Property       m_prop_13{m_table, 0x13, "cost_factor_word"};
+};
+
+
 class Action00Bridges : public Action00Feature
 {
 public:
-    Action00Bridges() : Action00Feature(FeatureType::Bridges) {}
-
-private:
-    UInt8Property        m_prop_00{m_properties, 0x00, "fallback_type_id"};
-    Year8Property        m_prop_08{m_properties, 0x08, "year_available"};
-    UInt8Property        m_prop_09{m_properties, 0x09, "minimum_length"};
-    UInt8Property        m_prop_0A{m_properties, 0x0A, "maximum_length"};
-    UInt8Property        m_prop_0B{m_properties, 0x0B, "cost_factor"};
-    UInt16Property       m_prop_0C{m_properties, 0x0C, "maximum_speed"};
-    BridgeLayoutProperty m_prop_0D{m_properties, 0x0D, "bridge_layout"};
-    UInt8Property        m_prop_0E{m_properties, 0x0E, "various_flags"};
-    Year32Property       m_prop_0F{m_properties, 0x0F, "long_year_available"};
-    UInt16Property       m_prop_10{m_properties, 0x10, "purchase_text"};
-    UInt16Property       m_prop_11{m_properties, 0x11, "description_rail"};
-    UInt16Property       m_prop_12{m_properties, 0x12, "description_road"};
-    UInt16Property       m_prop_13{m_properties, 0x13, "cost_factor_word"};
+    Action00Bridges() : Action00Feature{FeatureType::Bridges, static_property_table<Action00BridgesProperties>()} {}
 };
 
 
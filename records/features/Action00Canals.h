@@ -22,14 +22,18 @@
 #include "properties/PropertyMap.h"
 
 
+class Action00CanalsProperties : public FeatureProperties
+{
+private:
+    UInt8Property m_prop_08{m_table, 0x08, "callback_flags"};
+    UInt8Property m_prop_09{m_table, 0x09, "graphics_flags"};
+};
+
+
 class Action00Canals : public Action00Feature
 {
 public:
-    Action00Canals() : Action00Feature(FeatureType::Canals) {}
-
-private:
-    UInt8Property m_prop_08{m_properties, 0x08, "callback_flags"};
-    UInt8Property m_prop_09{m_properties, 0x09, "graphics_flags"};
+    Action00Canals() : Action00Feature{FeatureType::Canals, static_property_table<Action00CanalsProperties>()} {}
 };
 
 
@@ -23,23 +23,27 @@
 
 
 // TODO Add unit tests for this type.
+class Action00RoadStopsProperties : public FeatureProperties
+{
+private:
+    GRFLabelProperty m_prop_08{m_table, 0x08, "class_label"};
+    UInt8Property    m_prop_09{m_table, 0x09, "road_stop_type"};
+    UInt16Property   m_prop_0A{m_table, 0x0A, "road_stop_name_text_id"};
+    UInt16Property   m_prop_0B{m_table, 0x0B, "class_name_text_id"};
+    UInt8Property    m_prop_0C{m_table, 0x0C, "draw_mode"};
+    UInt32Property   m_prop_0D{m_table, 0x0D, "random_trigger_cargoes"}; 
+    UInt16Property   m_prop_0E{m_table, 0x0E, "animation_information"};
+    UInt8Property    m_prop_0F{m_table, 0x0F, "animation_speed"};
+    UInt16Property   m_prop_10{m_table, 0x10, "animation_triggers"}; 
+    UInt8Property    m_prop_11{m_table, 0x11, "callback_flags"};
+    UInt32Property   m_prop_12{m_table, 0x12, "general_flags"};
+    UInt16Property   m_prop_15{m_table, 0x15, "cost_multipliers"};
+};
+
+
 class Action00RoadStops : public Action00Feature
 {
 public:
-    Action00RoadStops() : Action00Feature(FeatureType::RoadStops) {}
-
-private:
-    GRFLabelProperty m_prop_08{m_properties, 0x08, "class_label"};
-    UInt8Property    m_prop_09{m_properties, 0x09, "road_stop_type"};
-    UInt16Property   m_prop_0A{m_properties, 0x0A, "road_stop_name_text_id"};
-    UInt16Property   m_prop_0B{m_properties, 0x0B, "class_name_text_id"};
-    UInt8Property    m_prop_0C{m_properties, 0x0C, "draw_mode"};
-    UInt32Property   m_prop_0D{m_properties, 0x0D, "random_trigger_cargoes"}; 
-    UInt16Property   m_prop_0E{m_properties, 0x0E, "animation_information"};
-    UInt8Property    m_prop_0F{m_properties, 0x0F, "animation_speed"};
-    UInt16Property   m_prop_10{m_properties, 0x10, "animation_triggers"}; 
-    UInt8Property    m_prop_11{m_properties, 0x11, "callback_flags"};
-    UInt32Property   m_prop_12{m_properties, 0x12, "general_flags"};
-    UInt16Property   m_prop_15{m_properties, 0x15, "cost_multipliers"};
+    Action00RoadStops() : Action00Feature{FeatureType::RoadStops, static_property_table<Action00RoadStopsProperties>()} {}
 };
 
@@ -33,40 +33,44 @@
 using Bit8Property = Property<BitfieldValue<uint8_t>>;
 
 
-class Action00Ships : public Action00Vehicles
+class Action00ShipsProperties : public Action00VehiclesProperties
 {
-public:
-    Action00Ships() : Action00Vehicles{FeatureType::Ships} {}
-
 private:
-    UInt8Property        m_prop_08{m_properties, 0x08, "sprite_id"};
-    BoolProperty         m_prop_09{m_properties, 0x09, "is_refittable"};
-    UInt8Property        m_prop_0A{m_properties, 0x0A, "cost_factor"};
-    UInt8Property        m_prop_0B{m_properties, 0x0B, "speed_2_kmh"};
-    UInt8Property        m_prop_0C{m_properties, 0x0C, "cargo_type"};
-    UInt16Property       m_prop_0D{m_properties, 0x0D, "cargo_capacity"};
-    UInt8Property        m_prop_0F{m_properties, 0x0F, "running_cost_factor"};
-    UInt8Property        m_prop_10{m_properties, 0x10, "sound_effect_type"};
-    UInt32Property       m_prop_11{m_properties, 0x11, "refit_cargo_types"};
-    UInt8Property        m_prop_12{m_properties, 0x12, "callback_flags_mask"};
-    UInt8Property        m_prop_13{m_properties, 0x13, "refit_cost"};
-    UInt8Property        m_prop_14{m_properties, 0x14, "ocean_speed_fraction"};
-    UInt8Property        m_prop_15{m_properties, 0x15, "canal_speed_fraction"};
-    UInt8Property        m_prop_16{m_properties, 0x16, "retire_vehicle_early"};
-    UInt8Property        m_prop_17{m_properties, 0x17, "miscellaneous_flags"};
-    UInt16Property       m_prop_18{m_properties, 0x18, "refittable_cargo_classes"};
-    UInt16Property       m_prop_19{m_properties, 0x19, "non_refittable_cargo_classes"};
-    LongDateProperty     m_prop_1A{m_properties, 0x1A, "long_introduction_date"};
-    UInt8XProperty       m_prop_1B{m_properties, 0x1B, "sort_purchase_list"};
-    VisualEffectProperty m_prop_1C{m_properties, 0x1C, "visual_effect"};
-    UInt16Property       m_prop_1D{m_properties, 0x1D, "custom_cargo_aging_period"};
-    UInt8ListProperty    m_prop_1E{m_properties, 0x1E, "always_refittable_cargos"};
-    UInt8ListProperty    m_prop_1F{m_properties, 0x1F, "never_refittable_cargos"};
-    UInt16Property       m_prop_20{m_properties, 0x20, "variant_group"};
-    UInt32Property       m_prop_21{m_properties, 0x21, "extra_flags"};
-    UInt8Property        m_prop_22{m_properties, 0x22, "extra_callback_flags_mask"};
-    UInt16Property       m_prop_23{m_properties, 0x23, "speed_3_2_mph"};
-    UInt8Property        m_prop_24{m_properties, 0x24, "acceleration_3_2_mph"};
+    UInt8Property        m_prop_08{m_table, 0x08, "sprite_id"};
+    BoolProperty         m_prop_09{m_table, 0x09, "is_refittable"};
+    UInt8Property        m_prop_0A{m_table, 0x0A, "cost_factor"};
+    UInt8Property        m_prop_0B{m_table, 0x0B, "speed_2_kmh"};
+    UInt8Property        m_prop_0C{m_table, 0x0C, "cargo_type"};
+    UInt16Property       m_prop_0D{m_table, 0x0D, "cargo_capacity"};
+    UInt8Property        m_prop_0F{m_table, 0x0F, "running_cost_factor"};
+    UInt8Property        m_prop_10{m_table, 0x10, "sound_effect_type"};
+    UInt32Property       m_prop_11{m_table, 0x11, "refit_cargo_types"};
+    UInt8Property        m_prop_12{m_table, 0x12, "callback_flags_mask"};
+    UInt8Property        m_prop_13{m_table, 0x13, "refit_cost"};
+    UInt8Property        m_prop_14{m_table, 0x14, "ocean_speed_fraction"};
+    UInt8Property        m_prop_15{m_table, 0x15, "canal_speed_fraction"};
+    UInt8Property        m_prop_16{m_table, 0x16, "retire_vehicle_early"};
+    UInt8Property        m_prop_17{m_table, 0x17, "miscellaneous_flags"};
+    UInt16Property       m_prop_18{m_table, 0x18, "refittable_cargo_classes"};
+    UInt16Property       m_prop_19{m_table, 0x19, "non_refittable_cargo_classes"};
+    LongDateProperty     m_prop_1A{m_table, 0x1A, "long_introduction_date"};
+    UInt8XProperty       m_prop_1B{m_table, 0x1B, "sort_purchase_list"};
+    VisualEffectProperty m_prop_1C{m_table, 0x1C, "visual_effect"};
+    UInt16Property       m_prop_1D{m_table, 0x1D, "custom_cargo_aging_period"};
+    UInt8ListProperty    m_prop_1E{m_table, 0x1E, "always_refittable_cargos"};
+    UInt8ListProperty    m_prop_1F{m_table, 0x1F, "never_refittable_cargos"};
+    UInt16Property       m_prop_20{m_table, 0x20, "variant_group"};
+    UInt32Property       m_prop_21{m_table, 0x21, "extra_flags"};
+    UInt8Property        m_prop_22{m_table, 0x22, "extra_callback_flags_mask"};
+    UInt16Property       m_prop_23{m_table, 0x23, "speed_3_2_mph"};
+    UInt8Property        m_prop_24{m_table, 0x24, "acceleration_3_2_mph"};
+};
+
+
+class Action00Ships : public Action00Feature
+{
+public:
+    Action00Ships() : Action00Feature{FeatureType::Ships, static_property_table<Action00ShipsProperties>()} {}
 };
 
 
@@ -22,17 +22,21 @@
 #include "properties/PropertyMap.h"
 
 
-class Action00SoundEffects : public Action00Feature
+class Action00SoundEffectsProperties : public FeatureProperties
 {
-public:
-    Action00SoundEffects() : Action00Feature{FeatureType::SoundEffects} {}
-
 private:
     // These are properties of the sound effect defined in Action11 with the matching instance ID.
     // Seems a bit convoluted, but I think I get it.
-    UInt8Property m_prop_08{m_properties, 0x08, "relative_volume"};
-    UInt8Property m_prop_09{m_properties, 0x09, "priority"};
-    UInt8Property m_prop_0A{m_properties, 0x0A, "override_old_sound"};
+    UInt8Property m_prop_08{m_table, 0x08, "relative_volume"};
+    UInt8Property m_prop_09{m_table, 0x09, "priority"};
+    UInt8Property m_prop_0A{m_table, 0x0A, "override_old_sound"};
+};
+
+
+class Action00SoundEffects : public Action00Feature
+{
+public:
+    Action00SoundEffects() : Action00Feature{FeatureType::SoundEffects, static_property_table<Action00SoundEffectsProperties>()} {}
 };
 
 
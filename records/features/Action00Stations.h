@@ -31,33 +31,37 @@ using CustomStationProperty = Property<CustomStation>;
 using SpriteLayoutsProperty = Property<Vector<SpriteLayout>>;
 
 
+class Action00StationsProperties : public FeatureProperties
+{
+private:
+    GRFLabelProperty      m_prop_08{m_table, 0x08, "class_id"};
+    StationLayoutProperty m_prop_09{m_table, 0x09, "sprite_layouts"};
+    UInt8Property         m_prop_0A{m_table, 0x0A, "copy_sprite_layout_id"};
+    UInt8Property         m_prop_0B{m_table, 0x0B, "callback_flags"};
+    UInt8Property         m_prop_0C{m_table, 0x0C, "disabled_platform_numbers"};
+    UInt8Property         m_prop_0D{m_table, 0x0D, "disabled_platform_lengths"};
+    CustomStationProperty m_prop_0E{m_table, 0x0E, "custom_layouts"};
+    UInt8Property         m_prop_0F{m_table, 0x0F, "copy_custom_layout_id"};
+    UInt16Property        m_prop_10{m_table, 0x10, "little_lots_threshold"};
+    UInt8Property         m_prop_11{m_table, 0x11, "pylon_placement"};
+    UInt32Property        m_prop_12{m_table, 0x12, "cargo_type_triggers"};
+    UInt8Property         m_prop_13{m_table, 0x13, "general_flags"};
+    UInt8Property         m_prop_14{m_table, 0x14, "overhead_wire_placement"};
+    UInt8Property         m_prop_15{m_table, 0x15, "can_train_enter_tile"};
+    UInt16Property        m_prop_16{m_table, 0x16, "animation_info"};
+    UInt8Property         m_prop_17{m_table, 0x17, "animation_speed"};
+    UInt16Property        m_prop_18{m_table, 0x18, "animation_triggers"};
+    SpriteLayoutsProperty m_prop_1A{m_table, 0x1A, "advanced_sprite_layout"};
+    UInt8ArrayProperty<8> m_prop_1B{m_table, 0x1B, "minimum_bridge_height"};
+    UInt16Property        m_prop_1C{m_table, 0x1C, "station_name_id"};
+    UInt16Property        m_prop_1D{m_table, 0x1D, "station_class_name_id"};
+};
+
+
 class Action00Stations : public Action00Feature
 {
 public:
-    Action00Stations() : Action00Feature{FeatureType::Stations} {}
-
-private:
-    GRFLabelProperty      m_prop_08{m_properties, 0x08, "class_id"};
-    StationLayoutProperty m_prop_09{m_properties, 0x09, "sprite_layouts"};
-    UInt8Property         m_prop_0A{m_properties, 0x0A, "copy_sprite_layout_id"};
-    UInt8Property         m_prop_0B{m_properties, 0x0B, "callback_flags"};
-    UInt8Property         m_prop_0C{m_properties, 0x0C, "disabled_platform_numbers"};
-    UInt8Property         m_prop_0D{m_properties, 0x0D, "disabled_platform_lengths"};
-    CustomStationProperty m_prop_0E{m_properties, 0x0E, "custom_layouts"};
-    UInt8Property         m_prop_0F{m_properties, 0x0F, "copy_custom_layout_id"};
-    UInt16Property        m_prop_10{m_properties, 0x10, "little_lots_threshold"};
-    UInt8Property         m_prop_11{m_properties, 0x11, "pylon_placement"};
-    UInt32Property        m_prop_12{m_properties, 0x12, "cargo_type_triggers"};
-    UInt8Property         m_prop_13{m_properties, 0x13, "general_flags"};
-    UInt8Property         m_prop_14{m_properties, 0x14, "overhead_wire_placement"};
-    UInt8Property         m_prop_15{m_properties, 0x15, "can_train_enter_tile"};
-    UInt16Property        m_prop_16{m_properties, 0x16, "animation_info"};
-    UInt8Property         m_prop_17{m_properties, 0x17, "animation_speed"};
-    UInt16Property        m_prop_18{m_properties, 0x18, "animation_triggers"};
-    SpriteLayoutsProperty m_prop_1A{m_properties, 0x1A, "advanced_sprite_layout"};
-    UInt8ArrayProperty<8> m_prop_1B{m_properties, 0x1B, "minimum_bridge_height"};
-    UInt16Property        m_prop_1C{m_properties, 0x1C, "station_name_id"};
-    UInt16Property        m_prop_1D{m_properties, 0x1D, "station_class_name_id"};
+    Action00Stations() : Action00Feature{FeatureType::Stations, static_property_table<Action00StationsProperties>()} {}
 };
 
 
@@ -31,50 +31,54 @@ using UInt8PropertyDec  = Property<UInt<uint8_t, false, UIntFormat::Dec>>;
 using UInt16PropertyDec = Property<UInt<uint16_t, false, UIntFormat::Dec>>;
 
 
-class Action00Trains : public Action00Vehicles
+class Action00TrainsProperties : public Action00VehiclesProperties
 {
-public:
-    Action00Trains() : Action00Vehicles{FeatureType::Trains} {}
-
 private:
-    UInt8PropertyDec     m_prop_05{m_properties, 0x05, "track_type"};
-    BoolProperty         m_prop_08{m_properties, 0x08, "ai_special_flag"};
-    UInt16PropertyDec    m_prop_09{m_properties, 0x09, "speed_kmh"};
-    UInt16PropertyDec    m_prop_0B{m_properties, 0x0B, "power"};
-    UInt8Property        m_prop_0D{m_properties, 0x0D, "running_cost_factor"};
-    UInt32Property       m_prop_0E{m_properties, 0x0E, "running_cost_base"};
-    UInt8Property        m_prop_12{m_properties, 0x12, "sprite_id"};
-    BoolProperty         m_prop_13{m_properties, 0x13, "is_dual_headed"};
-    UInt8PropertyDec     m_prop_14{m_properties, 0x14, "cargo_capacity"};
-    UInt8Property        m_prop_15{m_properties, 0x15, "cargo_type"};
-    UInt8PropertyDec     m_prop_16{m_properties, 0x16, "weight_tons"};
-    UInt8Property        m_prop_17{m_properties, 0x17, "cost_factor"};
-    UInt8Property        m_prop_18{m_properties, 0x18, "ai_engine_rank"};
-    UInt8Property        m_prop_19{m_properties, 0x19, "engine_traction_type"};
-    UInt8XProperty       m_prop_1A{m_properties, 0x1A, "sort_purchase_list"};
-    UInt16Property       m_prop_1B{m_properties, 0x1B, "power_from_each_wagon"};
-    UInt8Property        m_prop_1C{m_properties, 0x1C, "refit_cost"};
-    UInt32Property       m_prop_1D{m_properties, 0x1D, "refit_cargo_types"};
-    UInt8Property        m_prop_1E{m_properties, 0x1E, "callback_flags_mask"};
-    UInt8Property        m_prop_1F{m_properties, 0x1F, "coeff_of_tractive_effort"};
-    UInt8Property        m_prop_20{m_properties, 0x20, "coeff_of_air_drag"};
-    UInt8Property        m_prop_21{m_properties, 0x21, "shorten_vehicle"};
-    VisualEffectProperty m_prop_22{m_properties, 0x22, "visual_effect"};
-    UInt8Property        m_prop_23{m_properties, 0x23, "weight_from_wagons"};
-    UInt8Property        m_prop_24{m_properties, 0x24, "weight_high_byte"};
-    UInt8Property        m_prop_25{m_properties, 0x25, "mask_for_var_42"};
-    UInt8Property        m_prop_26{m_properties, 0x26, "retire_vehicle_early"};
-    UInt8Property        m_prop_27{m_properties, 0x27, "miscellaneous_flags"};
-    UInt16Property       m_prop_28{m_properties, 0x28, "refittable_cargo_classes"};
-    UInt16Property       m_prop_29{m_properties, 0x29, "non_refittable_cargo_classes"};
-    LongDateProperty     m_prop_2A{m_properties, 0x2A, "long_introduction_date"};
-    UInt16Property       m_prop_2B{m_properties, 0x2B, "custom_cargo_aging_period"};
-    UInt8ListProperty    m_prop_2C{m_properties, 0x2C, "always_refittable_cargos"};
-    UInt8ListProperty    m_prop_2D{m_properties, 0x2D, "never_refittable_cargos"};
-    UInt16Property       m_prop_2E{m_properties, 0x2E, "maximum_curve_speed_modifier"};
-    UInt16Property       m_prop_2F{m_properties, 0x2F, "variant_group"};
-    UInt32Property       m_prop_30{m_properties, 0x30, "extra_flags"};
-    UInt8Property        m_prop_31{m_properties, 0x31, "extra_callback_flags_mask"};
+    UInt8PropertyDec     m_prop_05{m_table, 0x05, "track_type"};
+    BoolProperty         m_prop_08{m_table, 0x08, "ai_special_flag"};
+    UInt16PropertyDec    m_prop_09{m_table, 0x09, "speed_kmh"};
+    UInt16PropertyDec    m_prop_0B{m_table, 0x0B, "power"};
+    UInt8Property        m_prop_0D{m_table, 0x0D, "running_cost_factor"};
+    UInt32Property       m_prop_0E{m_table, 0x0E, "running_cost_base"};
+    UInt8Property        m_prop_12{m_table, 0x12, "sprite_id"};
+    BoolProperty         m_prop_13{m_table, 0x13, "is_dual_headed"};
+    UInt8PropertyDec     m_prop_14{m_table, 0x14, "cargo_capacity"};
+    UInt8Property        m_prop_15{m_table, 0x15, "cargo_type"};
+    UInt8PropertyDec     m_prop_16{m_table, 0x16, "weight_tons"};
+    UInt8Property        m_prop_17{m_table, 0x17, "cost_factor"};
+    UInt8Property        m_prop_18{m_table, 0x18, "ai_engine_rank"};
+    UInt8Property        m_prop_19{m_table, 0x19, "engine_traction_type"};
+    UInt8XProperty       m_prop_1A{m_table, 0x1A, "sort_purchase_list"};
+    UInt16Property       m_prop_1B{m_table, 0x1B, "power_from_each_wagon"};
+    UInt8Property        m_prop_1C{m_table, 0x1C, "refit_cost"};
+    UInt32Property       m_prop_1D{m_table, 0x1D, "refit_cargo_types"};
+    UInt8Property        m_prop_1E{m_table, 0x1E, "callback_flags_mask"};
+    UInt8Property        m_prop_1F{m_table, 0x1F, "coeff_of_tractive_effort"};
+    UInt8Property        m_prop_20{m_table, 0x20, "coeff_of_air_drag"};
+    UInt8Property        m_prop_21{m_table, 0x21, "shorten_vehicle"};
+    VisualEffectProperty m_prop_22{m_table, 0x22, "visual_effect"};
+    UInt8Property        m_prop_23{m_table, 0x23, "weight_from_wagons"};
+    UInt8Property        m_prop_24{m_table, 0x24, "weight_high_byte"};
+    UInt8Property        m_prop_25{m_table, 0x25, "mask_for_var_42"};
+    UInt8Property        m_prop_26{m_table, 0x26, "retire_vehicle_early"};
+    UInt8Property        m_prop_27{m_table, 0x27, "miscellaneous_flags"};
+    UInt16Property       m_prop_28{m_table, 0x28, "refittable_cargo_classes"};
+    UInt16Property       m_prop_29{m_table, 0x29, "non_refittable_cargo_classes"};
+    LongDateProperty     m_prop_2A{m_table, 0x2A, "long_introduction_date"};
+    UInt16Property       m_prop_2B{m_table, 0x2B, "custom_cargo_aging_period"};
+    UInt8ListProperty    m_prop_2C{m_table, 0x2C, "always_refittable_cargos"};
+    UInt8ListProperty    m_prop_2D{m_table, 0x2D, "never_refittable_cargos"};
+    UInt16Property       m_prop_2E{m_table, 0x2E, "maximum_curve_speed_modifier"};
+    UInt16Property       m_prop_2F{m_table, 0x2F, "variant_group"};
+    UInt32Property       m_prop_30{m_table, 0x30, "extra_flags"};
+    UInt8Property        m_prop_31{m_table, 0x31, "extra_callback_flags_mask"};
+};
+
+
+class Action00Trains : public Action00Feature
+{
+public:
+    Action00Trains() : Action00Feature{FeatureType::Trains, static_property_table<Action00TrainsProperties>()} {}
 };
 
 
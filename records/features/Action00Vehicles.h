@@ -30,18 +30,15 @@ using UInt8PropertyDec = Property<UInt<uint8_t, false, UIntFormat::Dec>>;
 using Bit8Property     = Property<BitfieldValue<uint8_t>>;
 
 
-class Action00Vehicles : public Action00Feature
+class Action00VehiclesProperties : public FeatureProperties
 {
-public:
-    Action00Vehicles(FeatureType feature) : Action00Feature(feature) {}
-
 private:
     std::vector<BitfieldItem> m_climates{ {0, "Temperate"}, {1, "Arctic"}, {2, "Tropical"}, {3, "Toyland"} };
 
-    ShortDateProperty m_prop_00{m_properties, 0x00, "introduction_date"};
-    UInt8PropertyDec  m_prop_02{m_properties, 0x02, "reliability_decay_speed"};
-    UInt8PropertyDec  m_prop_03{m_properties, 0x03, "vehicle_life_years"};
-    UInt8PropertyDec  m_prop_04{m_properties, 0x04, "model_life_years"};
-    Bit8Property      m_prop_06{m_properties, 0x06, "climate_availability", m_climates};
-    UInt8Property     m_prop_07{m_properties, 0x07, "loading_speed"};
+    ShortDateProperty m_prop_00{m_table, 0x00, "introduction_date"};
+    UInt8PropertyDec  m_prop_02{m_table, 0x02, "reliability_decay_speed"};
+    UInt8PropertyDec  m_prop_03{m_table, 0x03, "vehicle_life_years"};
+    UInt8PropertyDec  m_prop_04{m_table, 0x04, "model_life_years"};
+    Bit8Property      m_prop_06{m_table, 0x06, "climate_availability", m_climates};
+    UInt8Property     m_prop_07{m_table, 0x07, "loading_speed"};
 };
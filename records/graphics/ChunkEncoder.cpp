@@ -19,6 +19,7 @@
 #include "ChunkEncoder.h"
 #include "RealSpriteRecord.h"
 #include "CommandLineOptions.h"
+#include "Profiler.h"
 #include <exception>
 
 
@@ -64,6 +65,7 @@ private:
 std::vector<uint8_t> encode_tile(const std::vector<uint8_t>& pixels, uint16_t xdim, uint16_t ydim,
     uint8_t compression, GRFFormat format)
 {
+    ScopedTimer timer{"Chunk encode"};
     ChunkEncoder encoder(pixels, xdim, ydim, compression, format);
     return encoder.encode();
 }
@@ -72,6 +74,7 @@ std::vector<uint8_t> encode_tile(const std::vector<uint8_t>& pixels, uint16_t xd
 std::vector<uint8_t> decode_tile(const std::vector<uint8_t>& chunks, uint16_t xdim, uint16_t ydim,
     uint8_t compression, GRFFormat format)
 {
+    ScopedTimer timer{"Chunk decode"};
     const uint16_t LAST_CHUNK = (xdim > 0x100) ? LONG_LAST_CHUNK : SHORT_LAST_CHUNK;
 
     bool     long_offset  = chunks.size() > 0x10000;
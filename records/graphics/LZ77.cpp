@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "LZ77.h"
+#include "StreamHelpers.h"
+#include "Exceptions.h"
+#include "Profiler.h"
+#include <array>
+#include <sstream>
+
+
+static void append_byte(std::vector<uint8_t>& output, uint8_t byte)
+{
+    output.push_back(byte);
+}
+
+
+static void append_bytes(std::vector<uint8_t>& output, const uint8_t* bytes, uint8_t length)
+{
+    for (uint8_t b = 0; b < length; ++b)
+    {
+        output.push_back(bytes[b]);
+    }
+}
+
+
+static inline int find(const uint8_t* pat_data, int32_t pat_size, const uint8_t* data, int32_t data_size)
+{
+    for (int32_t i = 0; i + pat_size <= data_size; ++i)
+    {
+        int32_t j = 0;
+        while (j < pat_size && pat_data[j] == data[i + j]) ++j;
+        if (j == pat_size)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+// This implementation is directly copied from _lz77.c found in the NML source.
+// Some types and whatnot have been changed, but the algorithm is the same.
+std::vector<uint8_t> encode_lz77(const std::vector<uint8_t>& input_data)
+{
+    ScopedTimer timer{"LZ77 encode"};
+
+    std::vector<uint8_t> output;
+
+    std::array<uint8_t, 0x80> literal;
+    uint8_t literal_size = 0;
+    int32_t input_size  = int32_t(input_data.size());
+
+    int32_t position = 0;
+    while (position < input_size)
+    {
+        int32_t start_pos = position - (1 << 11) + 1;
+        if (start_pos < 0) start_pos = 0;
+
+        // Loop through the lookahead buffer.
+        int32_t max_look = input_size - position + 1;
+        if (max_look > 16)
+        {
+            max_look = 16;
+        }
+
+        int32_t overlap_pos = 0;
+        int32_t overlap_len = 0;
+        int32_t i;
+        for (i = 3; i < max_look; ++i)
+        {
+            // Find the pattern match in the window.
+            int result = find(&input_data[0] + position, i, &input_data[0] + start_pos, position - start_pos);
+            // If match failed, we've found the longest.
+            if (result < 0) break;
+
+            overlap_pos = position - start_pos - result;
+            overlap_len = i;
+            start_pos += result;
+        }
+
+        if (overlap_len > 0)
+        {
+            if (literal_size > 0)
+            {
+                append_byte(output, literal_size);
+                append_bytes(output, &literal[0], literal_size);
+                literal_size = 0;
+            }
+            int32_t val = 0x80 | (16 - overlap_len) << 3 | overlap_pos >> 8;
+            append_byte(output, val);
+            append_byte(output, overlap_pos & 0xFF);
+            position += overlap_len;
+        }
+        else
+        {
+            literal[literal_size++] = input_data[position];
+            if (literal_size == sizeof(literal))
+            {
+                append_byte(output, 0);
+                append_bytes(output, &literal[0], literal_size);
+                literal_size = 0;
+            }
+            position += 1;
+        }
+    }
+
+    if (literal_size > 0)
+    {
+        append_byte(output, literal_size);
+        append_bytes(output, &literal[0], literal_size);
+        literal_size = 0;
+    }
+
+    return output;
+}
+
+
+// This decompression just follows the description in the GRF container documentation. The
+// expanded data is placed into a pre-sized buffer. Have subsequently compared the code to
+// OpenTTD, and it looks fine.
+std::vector<uint8_t> decode_lz77(std::istream& is, uint32_t output_size, uint32_t& input_size)
+{
+    ScopedTimer timer{"LZ77 decode"};
+
+    std::vector<uint8_t> output(output_size);
+    uint32_t index = 0;
+    input_size = 0;
+    while (output_size > 0)
+    {
+        int8_t code = read_uint8(is);
+        if (code < 0)
+        {
+            // The high bit is set, so we are going to copy data from earlier
+            // in the sprite.
+            uint16_t length = -(code >> 3);
+            uint8_t  byte   = read_uint8(is);
+            uint16_t offset = ((static_cast<uint16_t>(code) & 0x07) << 8) | byte;
+            input_size += 2;
+            if (offset > index)
+            {
+                std::ostringstream os;
+                os << "LZ77 decoding error: offset (=" << as_hex(offset);
+                os << ") greater than current byte index (=" << as_hex(index) << ")";
+                throw RUNTIME_ERROR(os.str());
+            }
+            if (output_size < length)
+            {
+                std::ostringstream os;
+                os << "LZ77 decoding error: length (=" << length;
+                os << ") greater than remaining image bytes (=" << output_size << ")";
+                throw RUNTIME_ERROR(os.str());
+            }
+
+            output_size -= length;
+            for (; length > 0; length--)
+            {
+                if (index < offset) throw RUNTIME_ERROR("1");
+                if (index >= output.size()) throw RUNTIME_ERROR("2");
+
+                output[index] = output[index - offset];
+                index++;
+            }
+        }
+        else
+        {
+            // The high bit is not set so we have to read the next number
+            // of bytes from the file.
+            uint16_t length = (code == 0) ? 0x80 : code;
+            input_size += 1 + length;
+            if (output_size < length)
+            {
+                throw RUNTIME_ERROR("3");
+            }
+
+            output_size -= length;
+            for (; length > 0; length--)
+            {
+                if (index >= output.size()) throw RUNTIME_ERROR("4");
+
+                uint8_t pix = read_uint8(is);
+                output[index] = pix;
+                ++index;
+            }
+        }
+    }
+
+    return output;
+}
@@ -0,0 +1,32 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <istream>
+#include <vector>
+#include <cstdint>
+
+
+// The image data for real sprites is compressed with a variant of LZ77, described in the
+// GRF container documentation. Literal runs of up to 0x80 bytes are interleaved with
+// back references of 3 to 16 bytes into the previous 2KB of output.
+std::vector<uint8_t> encode_lz77(const std::vector<uint8_t>& input);
+
+// Reads compressed data from the stream until output_size bytes have been decoded. The
+// number of compressed bytes consumed is returned in input_size.
+std::vector<uint8_t> decode_lz77(std::istream& is, uint32_t output_size, uint32_t& input_size);
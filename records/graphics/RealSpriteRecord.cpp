@@ -20,6 +20,7 @@
 #include "SpriteSheetReader.h"
 #include "StreamHelpers.h"
 #include "ChunkEncoder.h"
+#include "LZ77.h"
 #include <string>
 #include <sstream>
 #include <png.h>
@@ -28,6 +29,7 @@
 #include <algorithm>
 #include "FileSystem.h"
 #include "CommandLineOptions.h"
+#include "Profiler.h"
 #include "EnumDescriptor.h"
 #include "BitfieldDescriptor.h"
 
@@ -50,13 +52,13 @@ void RealSpriteRecord::read(std::istream& is, const GRFInfo& info)
 
     if (CommandLineOptions::options().debug())
     {
-        std::cout << "Reading sprite: " << to_hex(m_sprite_id);
-        std::cout << " zoom " << to_hex(static_cast<uint8_t>(m_zoom));
-        std::cout << " xdim " << to_hex(m_xdim);
-        std::cout << " ydim " << to_hex(m_ydim);
-        std::cout << " xrel " << to_hex(m_xrel);
-        std::cout << " yrel " << to_hex(m_yrel);
-        std::cout << " size " << to_hex(m_uncomp_size);
+        std::cout << "Reading sprite: " << as_hex(m_sprite_id);
+        std::cout << " zoom " << as_hex(static_cast<uint8_t>(m_zoom));
+        std::cout << " xdim " << as_hex(m_xdim);
+        std::cout << " ydim " << as_hex(m_ydim);
+        std::cout << " xrel " << as_hex(m_xrel);
+        std::cout << " yrel " << as_hex(m_yrel);
+        std::cout << " size " << as_hex(m_uncomp_size);
         std::cout << "\n";
     }
 
@@ -85,66 +87,18 @@ void RealSpriteRecord::read(std::istream& is, const GRFInfo& info)
     }
 
 
-    // Read the image data. This decompression is based on LZ77 in some way. I just followed
-    // the description in the GRF container documentation. Place the expanded data into a
-    // pre-sized buffer. Have subsequently compared the code to OpenTTD, and it looks fine.
-    std::vector<uint8_t> pixdata(img_size);
-    uint32_t index = 0;
-    while (img_size > 0)
+    // Read the image data. This is LZ77 compressed, and may also be chunk encoded.
+    m_chunked_size = img_size;
+    std::vector<uint8_t> pixdata;
+    try
     {
-        int8_t code = read_uint8(is);
-        if (code < 0)
-        {
-            // The high bit is set, so we are going to copy data from earlier
-            // in the sprite.
-            uint16_t length = -(code >> 3);
-            uint8_t  byte   = read_uint8(is);
-            uint16_t offset = ((static_cast<uint16_t>(code) & 0x07) << 8) | byte;
-            if (offset > index)
-            {
-                std::ostringstream os;
-                os << "LZ77 decoding error: sprite=" << to_hex(m_sprite_id);
-                os << " offset (=" << to_hex(offset) << ") greater than current byte index (=" << to_hex(index) << ")";
-                throw RUNTIME_ERROR(os.str());
-            }
-            if (img_size < length)
-            {
-                std::ostringstream os;
-                os << "LZ77 decoding error: sprite=" << to_hex(m_sprite_id);
-                os << " length (=" << length << ") greater than remaining image bytes (=" << img_size << ")";
-                throw RUNTIME_ERROR(os.str());
-            }
-
-            img_size -= length;
-            for (; length > 0; length--)
-            {
-                if (index < offset) throw RUNTIME_ERROR("1");
-                if (index >= pixdata.size()) throw RUNTIME_ERROR("2");
-
-                pixdata[index] = pixdata[index - offset];
-                index++;
-            }
-        }
-        else
-        {
-            // The high bit is not set so we have to read the next number
-            // of bytes from the file.
-            uint16_t length = (code == 0) ? 0x80 : code;
-            if (img_size < length)
-            {
-                throw RUNTIME_ERROR("3");
-            }
-
-            img_size -= length;
-            for (; length > 0; length--)
-            {
-                if (index >= pixdata.size()) throw RUNTIME_ERROR("4");
-
-                uint8_t pix = read_uint8(is);
-                pixdata[index] = pix;
-                ++index;
-            }
-        }
+        pixdata = decode_lz77(is, img_size, m_compressed_size);
+    }
+    catch (const std::exception& e)
+    {
+        std::ostringstream os;
+        os << e.what() << " sprite=" << as_hex(m_sprite_id);
+        throw RUNTIME_ERROR(os.str());
     }
 
     // This bit in the compression indicates that the image contains transparent sections.
@@ -203,6 +157,7 @@ void RealSpriteRecord::set_pixel(uint32_t x, uint32_t y, const Pixel& pixel)
 
     uint32_t offset = (y * m_xdim + x) * pix_size;
 
+    m_encoding.reset();
     if (m_colour & HAS_RGB)
     {
         m_pixels[offset++] = pixel.red;
@@ -233,30 +188,91 @@ void RealSpriteRecord::write(std::ostream& os, const GRFInfo& info) const
 }
 
 
-void RealSpriteRecord::write_format1(std::ostream& os) const
+std::vector<uint8_t> RealSpriteRecord::encode_image(bool chunked, GRFFormat format, uint32_t& uncomp_size) const
+{
+    if (chunked)
+    {
+        std::vector<uint8_t> chunked_data = encode_tile(m_pixels, m_xdim, m_ydim, m_colour, format);
+        uncomp_size = uint32_t(chunked_data.size());
+        return encode_lz77(chunked_data);
+    }
+
+    uncomp_size = uint32_t(m_pixels.size());
+    return encode_lz77(m_pixels);
+}
+
+
+int32_t RealSpriteRecord::choose_compression(GRFFormat format)
 {
-    // This is a fake sprite used where there is no image at all, but a slot for one in the NFO.
     if (m_pixels.size() == 0)
     {
-        write_uint8(os, 0x00);
-        return;
+        return 0;
     }
 
-    std::vector<uint8_t> output_data;
-    uint32_t uncomp_size = 0;
+    // The size of the sprite in the GRF, or nothing if the format cannot represent it. Container1
+    // has a 16-bit size field which holds the size before LZ77 compression, and Container2 adds a
+    // 32-bit field for the same thing to chunked sprites.
+    auto encoded_size = [&](const Encoding& encoding) -> std::optional<uint32_t>
+    {
+        uint32_t size = uint32_t(encoding.data.size());
+        if (format == GRFFormat::Container1)
+        {
+            if ((encoding.uncomp_size + 8) > 0xFFFF)
+                return std::nullopt;
+            return size;
+        }
+        return (encoding.compression & CHUNKED_FORMAT) ? (size + 4) : size;
+    };
+    auto encode = [&](uint8_t compression)
+    {
+        Encoding encoding{format, compression, 0, {}};
+        encoding.data = encode_image(compression & CHUNKED_FORMAT, format, encoding.uncomp_size);
+        return encoding;
+    };
 
-    if (m_compression & CHUNKED_FORMAT)
+    Encoding current = encode(m_compression);
+    Encoding other   = encode(m_compression ^ CHUNKED_FORMAT);
+    auto current_size = encoded_size(current);
+    auto other_size   = encoded_size(other);
+    if (!other_size || (current_size && (*current_size <= *other_size)))
     {
-        std::vector<uint8_t> chunked_data = encode_tile(m_pixels, m_xdim, m_ydim, m_colour, GRFFormat::Container1);
-        uncomp_size = uint32_t(chunked_data.size());
-        output_data = encode_lz77(chunked_data);
+        m_encoding = std::move(current);
+        return 0;
     }
-    else
+
+    m_compression ^= CHUNKED_FORMAT;
+    m_encoding = std::move(other);
+    return current_size ? int32_t(*current_size - *other_size) : 0;
+}
+
+
+const std::vector<uint8_t>& RealSpriteRecord::image_data(GRFFormat format, uint32_t& uncomp_size,
+    std::vector<uint8_t>& buffer) const
+{
+    if (m_encoding && (m_encoding->format == format) && (m_encoding->compression == m_compression))
     {
-        output_data = encode_lz77(m_pixels);
-        uncomp_size = uint32_t(m_xdim) * uint32_t(m_ydim);
+        uncomp_size = m_encoding->uncomp_size;
+        return m_encoding->data;
     }
 
+    buffer = encode_image(m_compression & CHUNKED_FORMAT, format, uncomp_size);
+    return buffer;
+}
+
+
+void RealSpriteRecord::write_format1(std::ostream& os) const
+{
+    // This is a fake sprite used where there is no image at all, but a slot for one in the NFO.
+    if (m_pixels.size() == 0)
+    {
+        write_uint8(os, 0x00);
+        return;
+    }
+
+    uint32_t uncomp_size = 0;
+    std::vector<uint8_t> buffer;
+    const std::vector<uint8_t>& output_data = image_data(GRFFormat::Container1, uncomp_size, buffer);
+
     // We need to know this value for reading chunked sprites.
     uncomp_size += 8;
     write_uint16(os, uint16_t(uncomp_size));
@@ -290,18 +306,9 @@ void RealSpriteRecord::write_format2(std::ostream& os) const
         return;
     }
 
-    std::vector<uint8_t> output_data;
     uint32_t uncomp_size = 0;
-    if (m_compression & CHUNKED_FORMAT)
-    {
-        std::vector<uint8_t> chunked_data = encode_tile(m_pixels, m_xdim, m_ydim, m_colour, GRFFormat::Container2);
-        output_data = encode_lz77(chunked_data);
-        uncomp_size = uint32_t(chunked_data.size());
-    }
-    else
-    {
-        output_data = encode_lz77(m_pixels);
-    }
+    std::vector<uint8_t> buffer;
+    const std::vector<uint8_t>& output_data = image_data(GRFFormat::Container2, uncomp_size, buffer);
 
     uint32_t output_size = uint32_t(output_data.size() + ((m_compression & CHUNKED_FORMAT) ? 14 : 10));
 
@@ -340,111 +347,6 @@ void RealSpriteRecord::write_format2(std::ostream& os) const
 }
 
 
-static void append_byte(std::vector<uint8_t>& output, uint8_t byte)
-{
-    output.push_back(byte);
-}
-
-
-static void append_bytes(std::vector<uint8_t>& output, const uint8_t* bytes, uint8_t length)
-{
-    for (uint8_t b = 0; b < length; ++b)
-    {
-        output.push_back(bytes[b]);
-    }
-}
-
-
-static inline int find(const uint8_t* pat_data, int32_t pat_size, const uint8_t* data, int32_t data_size)
-{
-    for (int32_t i = 0; i + pat_size <= data_size; ++i)
-    {
-        int32_t j = 0;
-        while (j < pat_size && pat_data[j] == data[i + j]) ++j;
-        if (j == pat_size)
-        {
-            return i;
-        }
-    }
-    return -1;
-}
-
-
-// This implementation is directly copied from _lz77.c found in the NML source.
-// Some types and whatnot have been changed, but the algorithm is the same.
-std::vector<uint8_t> RealSpriteRecord::encode_lz77(const std::vector<uint8_t>& input_data) const
-{
-    std::vector<uint8_t> output;
-
-    std::array<uint8_t, 0x80> literal;
-    uint8_t literal_size = 0;
-    int32_t input_size  = int32_t(input_data.size());
-
-    int32_t position = 0;
-    while (position < input_size)
-    {
-        int32_t start_pos = position - (1 << 11) + 1;
-        if (start_pos < 0) start_pos = 0;
-
-        // Loop through the lookahead buffer.
-        int32_t max_look = input_size - position + 1;
-        if (max_look > 16)
-        {
-            max_look = 16;
-        }
-
-        int32_t overlap_pos = 0;
-        int32_t overlap_len = 0;
-        int32_t i;
-        for (i = 3; i < max_look; ++i)
-        {
-            // Find the pattern match in the window.
-            int result = find(&input_data[0] + position, i, &input_data[0] + start_pos, position - start_pos);
-            // If match failed, we've found the longest.
-            if (result < 0) break;
-
-            overlap_pos = position - start_pos - result;
-            overlap_len = i;
-            start_pos += result;
-        }
-
-        if (overlap_len > 0)
-        {
-            if (literal_size > 0)
-            {
-                append_byte(output, literal_size);
-                append_bytes(output, &literal[0], literal_size);
-                literal_size = 0;
-            }
-            int32_t val = 0x80 | (16 - overlap_len) << 3 | overlap_pos >> 8;
-            append_byte(output, val);
-            append_byte(output, overlap_pos & 0xFF);
-            position += overlap_len;
-        }
-        else
-        {
-            literal[literal_size++] = input_data[position];
-            if (literal_size == sizeof(literal))
-            {
-                append_byte(output, 0);
-                append_bytes(output, &literal[0], literal_size);
-                literal_size = 0;
-            }
-            position += 1;
-        }
-    }
-
-    if (literal_size > 0)
-    {
-        append_byte(output, literal_size);
-        append_bytes(output, &literal[0], literal_size);
-        literal_size = 0;
-    }
-
-    return output;
-}
-
-
 namespace {
 
 
@@ -495,6 +397,137 @@ const BitfieldDescriptorT<uint8_t> colour_desc =
 } // namespace {
 
 
+void RealSpriteRecord::set_image(ZoomLevel zoom, uint16_t xdim, uint16_t ydim, int16_t xrel, int16_t yrel,
+    uint8_t colour, std::vector<uint8_t> pixels)
+{
+    m_zoom   = zoom;
+    m_xdim   = xdim;
+    m_ydim   = ydim;
+    m_xrel   = xrel;
+    m_yrel   = yrel;
+    m_colour = colour;
+    m_pixels = std::move(pixels);
+    m_encoding.reset();
+}
+
+
+uint8_t RealSpriteRecord::pixel_size() const
+{
+    uint8_t pix_size = 0;
+    pix_size  = (m_colour & HAS_RGB)     ? 3 : 0;
+    pix_size += (m_colour & HAS_ALPHA)   ? 1 : 0;
+    pix_size += (m_colour & HAS_PALETTE) ? 1 : 0;
+    return pix_size;
+}
+
+
+uint32_t RealSpriteRecord::crop()
+{
+    if ((m_compression & CROP_TRANSARENT_BORDER) || m_pixels.empty())
+    {
+        return 0;
+    }
+
+    // A pixel is transparent if its alpha is zero and its palette index is zero, for whichever
+    // of these the colour format has. The mask of an RGBAP sprite is kept even if the alpha is
+    // zero. RGB sprites without alpha have no transparent pixels.
+    const uint8_t pix_size = pixel_size();
+    const bool    has_alpha   = (m_colour & HAS_ALPHA) != 0;
+    const bool    has_palette = (m_colour & HAS_PALETTE) != 0;
+    if (!has_alpha && !has_palette)
+    {
+        return 0;
+    }
+
+    const uint8_t alpha_offset = (m_colour & HAS_RGB) ? 3 : 0;
+    const uint8_t index_offset = pix_size - 1;
+    auto opaque = [&](const uint8_t* pixel)
+    {
+        return (has_alpha && pixel[alpha_offset]) || (has_palette && pixel[index_offset]);
+    };
+
+    // Palette images are by far the most common. Their rows are plain byte ranges which are
+    // scanned a word at a time by the standard library.
+    const uint32_t row_size = m_xdim * pix_size;
+    auto row_is_transparent = [&](uint16_t y)
+    {
+        const uint8_t* row = m_pixels.data() + y * row_size;
+        if (pix_size == 1)
+        {
+            return std::all_of(row, row + row_size, [](uint8_t index) { return index == 0; });
+        }
+        for (uint32_t offset = 0; offset < row_size; offset += pix_size)
+        {
+            if (opaque(row + offset))
+                return false;
+        }
+        return true;
+    };
+
+    uint16_t top = 0;
+    while ((top < m_ydim) && row_is_transparent(top))
+    {
+        ++top;
+    }
+    if (top == m_ydim)
+    {
+        return 0;
+    }
+
+    uint16_t bottom = m_ydim;
+    while (row_is_transparent(bottom - 1))
+    {
+        --bottom;
+    }
+
+    uint16_t left  = m_xdim;
+    uint16_t right = 0;
+    for (uint16_t y = top; y < bottom; ++y)
+    {
+        const uint8_t* row = m_pixels.data() + y * row_size;
+        for (uint16_t x = 0; x < left; ++x)
+        {
+            if (opaque(row + x * pix_size))
+            {
+                left = x;
+                break;
+            }
+        }
+        for (uint16_t x = m_xdim; x > right; --x)
+        {
+            if (opaque(row + (x - 1) * pix_size))
+            {
+                right = x;
+                break;
+            }
+        }
+    }
+
+    const uint16_t xdim = right - left;
+    const uint16_t ydim = bottom - top;
+    if ((xdim == m_xdim) && (ydim == m_ydim))
+    {
+        return 0;
+    }
+
+    std::vector<uint8_t> pixels(xdim * ydim * pix_size);
+    for (uint16_t y = 0; y < ydim; ++y)
+    {
+        auto row = m_pixels.begin() + (y + top) * row_size + left * pix_size;
+        std::copy(row, row + xdim * pix_size, pixels.begin() + y * xdim * pix_size);
+    }
+
+    const uint32_t removed = (m_xdim * m_ydim) - (xdim * ydim);
+    m_xrel  += left;
+    m_yrel  += top;
+    m_xdim   = xdim;
+    m_ydim   = ydim;
+    m_pixels = std::move(pixels);
+    m_encoding.reset();
+    return removed;
+}
+
+
 void RealSpriteRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
     os << pad(indent) << "[" << m_xdim << ", " << m_ydim << ", " <<  m_xrel << ", " << m_yrel << "], ";
@@ -533,6 +566,39 @@ void RealSpriteRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uin
 }
 
 
+void RealSpriteRecord::print_nfo(std::ostream& os) const
+{
+    // grfcodec has its own names for the zoom levels, in the same order as ZoomLevel.
+    static constexpr const char* zoom_names[] = { "normal", "zi4", "zi2", "zo2", "zo4", "zo8" };
+    uint8_t zoom = static_cast<uint8_t>(m_zoom);
+    if (zoom >= std::size(zoom_names))
+    {
+        throw RUNTIME_ERROR("Invalid zoom level");
+    }
+
+    os << m_filename << ' ';
+    switch (m_colour)
+    {
+        case HAS_PALETTE:                       os << "8bpp"; break;
+        case HAS_RGB | HAS_ALPHA:               os << "32bpp"; break;
+        case HAS_RGB | HAS_ALPHA | HAS_PALETTE: os << "32bpp"; break;
+        default:  throw RUNTIME_ERROR("Invalid colour depth");
+    }
+
+    os << ' ' << m_xoff << ' ' << m_yoff << ' ' << m_xdim << ' ' << m_ydim;
+    os << ' ' << m_xrel << ' ' << m_yrel << ' ' << zoom_names[zoom];
+
+    if (m_compression & RealSpriteRecord::CHUNKED_FORMAT) os << " chunked";
+    if (m_compression & RealSpriteRecord::CROP_TRANSARENT_BORDER) os << " nocrop";
+
+    // grfcodec gives the mask for a 32bpp sprite its own line.
+    if ((m_colour & HAS_RGB) && (m_colour & HAS_PALETTE))
+    {
+        os << "\n    | " << m_mask_filename << " mask " << m_mask_xoff << ' ' << m_mask_yoff;
+    }
+}
+
+
 bool RealSpriteRecord::is_pure_white(const Pixel& pixel)
 {
     bool is_white = false;
@@ -558,6 +624,14 @@ bool RealSpriteRecord::is_pure_white(const Pixel& pixel)
 }
 
 
+std::string RealSpriteRecord::sprite_sheet_path(const std::string& filename)
+{
+    fs::path image_file = CommandLineOptions::options().yagl_dir();
+    image_file.append(filename);
+    return image_file.make_preferred().string();
+}
+
+
 void RealSpriteRecord::parse(TokenStream& is, SpriteZoomMap& sprites)
 {
     // [8, 21, -3, -11], normal, 8bpp,
@@ -622,22 +696,38 @@ void RealSpriteRecord::parse(TokenStream& is, SpriteZoomMap& sprites)
     // TODO this wants to be in a more global scope.
     SpriteSheetPool& pool = SpriteSheetPool::pool();
 
+    // Identical sprites share a rectangle in the sheets, so the pixels may already have been read.
+    SpriteRect rect;
+    rect.file_name = sprite_sheet_path(m_filename);
+    if (m_mask_filename.length() > 0)
+    {
+        rect.mask_file_name = sprite_sheet_path(m_mask_filename);
+    }
+    rect.xoff      = m_xoff;
+    rect.yoff      = m_yoff;
+    rect.mask_xoff = m_mask_xoff;
+    rect.mask_yoff = m_mask_yoff;
+    rect.xdim      = m_xdim;
+    rect.ydim      = m_ydim;
+    rect.colour    = m_colour;
+    if (auto pixels = pool.find_pixels(rect))
+    {
+        m_pixels = *pixels;
+        return;
+    }
+
     SpriteSheet::Colour colour = SpriteSheet::Colour::Palette;
     if ((m_colour & HAS_RGB) == HAS_RGB)
     {
         colour = SpriteSheet::Colour::RGBA;
     }
 
-    fs::path image_file = CommandLineOptions::options().yagl_dir();
-    image_file.append(m_filename);
-    SpriteSheet* image_sheet = &pool.get_sprite_sheet(image_file.make_preferred().string(), colour);
+    SpriteSheet* image_sheet = &pool.get_sprite_sheet(rect.file_name, colour);
 
     SpriteSheet* mask_sheet = nullptr;
     if (m_mask_filename.length() > 0)
     {
-        fs::path mask_file = CommandLineOptions::options().yagl_dir();
-        mask_file.append(m_mask_filename);
-        mask_sheet = &pool.get_sprite_sheet(mask_file.make_preferred().string(), SpriteSheet::Colour::Palette);
+        mask_sheet = &pool.get_sprite_sheet(rect.mask_file_name, SpriteSheet::Colour::Palette);
     }
 
     // Count the number of pure white pixels in the sprite. This should normally be none.
@@ -677,12 +767,14 @@ void RealSpriteRecord::parse(TokenStream& is, SpriteZoomMap& sprites)
 
     if (pure_white_pixels > 0)
     {
-        std::cout << "WARNING: Sprite #" << to_hex(m_sprite_id, false);
+        std::cout << "WARNING: Sprite #" << as_hex(m_sprite_id, false);
         std::cout << " contains " << pure_white_pixels << " pure white pixels. Its YAGL rectangle may be misaligned or too large.\n";
         std::cout << "    The first is at [" << xpos << ", " << ypos << "] in sprite sheet " << m_filename << std::endl;
     }
 
     check_white_border(image_sheet);
+
+    pool.add_pixels(rect, std::make_shared<const std::vector<uint8_t>>(m_pixels));
 }
 
 
@@ -723,7 +815,7 @@ void RealSpriteRecord::check_white_border(const SpriteSheet* sheet)
 
     if (non_white_pixels > 0)
     {
-        std::cout << "WARNING: Sprite #" << to_hex(m_sprite_id, false);
+        std::cout << "WARNING: Sprite #" << as_hex(m_sprite_id, false);
         std::cout << " has " << non_white_pixels << " non-white pixels in its border. Its YAGL rectangle may be misaligned or too small.\n";
         std::cout << "    The first is at [" << xpos << ", " << ypos << "] in sprite sheet " << m_filename << std::endl;
     }
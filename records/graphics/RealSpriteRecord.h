@@ -18,6 +18,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Record.h"
+#include <optional>
 #include <vector>
 
 
@@ -45,8 +46,8 @@ public:
     static constexpr uint8_t CHUNKED_FORMAT         = 0x08; // Indicates a tile sprite - use chunked format to
                                                             // compress transparent bits before (or in place of?)
                                                             // LZ77 compression
-    static constexpr uint8_t CROP_TRANSARENT_BORDER = 0x40; // Ignore for now - grfcodec trims extraneous transparent
-                                                            // borders from sprites
+    static constexpr uint8_t CROP_TRANSARENT_BORDER = 0x40; // Do not trim transparent borders from the sprite, as
+                                                            // grfcodec and --crop otherwise do
 
     // Zoom levels supported by OpenTTD.
     enum class ZoomLevel : uint8_t
@@ -81,6 +82,8 @@ public:
     // Text serialisation
     void print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const override;
     void parse(TokenStream& is, SpriteZoomMap& sprites) override;
+    // The description of the sprite in grfcodec's NFO, following the sprite number.
+    void print_nfo(std::ostream& os) const;
 
     uint32_t    sprite_id() const   { return m_sprite_id; }
     ZoomLevel   zoom() const        { return m_zoom; }
@@ -89,6 +92,9 @@ public:
 
     uint16_t  xdim() const { return m_xdim; }
     uint16_t  ydim() const { return m_ydim; }
+    int16_t   xrel() const { return m_xrel; }
+    int16_t   yrel() const { return m_yrel; }
+    const std::vector<uint8_t>& pixels() const { return m_pixels; }
 
     uint16_t  xoff() const { return m_xoff; }
     uint16_t  yoff() const { return m_yoff; }
@@ -96,6 +102,12 @@ public:
     uint16_t  mask_xoff() const { return m_mask_xoff; }
     uint16_t  mask_yoff() const { return m_mask_yoff; }
 
+    // Sizes of the image data at each stage of decoding, as read from the GRF. These are
+    // used for reporting how well the sprites compress.
+    uint32_t  compressed_size() const { return m_compressed_size; } // LZ77 data in the GRF
+    uint32_t  chunked_size() const    { return m_chunked_size; }    // After LZ77 decoding
+    uint32_t  pixels_size() const     { return static_cast<uint32_t>(m_pixels.size()); }
+
     // Only some of the members are filled, depending on the image colour depth, but this
     // provides a simple common API for the spritesheet generator.
     struct Pixel
@@ -109,21 +121,47 @@ public:
     Pixel pixel(uint32_t x, uint32_t y) const;
     void  set_pixel(uint32_t x, uint32_t y, const Pixel& pix);
 
+    // Creates the image directly rather than reading it from a GRF or a sprite sheet. This is
+    // used to generate synthetic GRFs. The pixels are laid out as they would be after decoding.
+    void set_image(ZoomLevel zoom, uint16_t xdim, uint16_t ydim, int16_t xrel, int16_t yrel,
+        uint8_t colour, std::vector<uint8_t> pixels);
+
+    // Removes the fully transparent rows and columns around the image, and moves the offsets
+    // so that it is drawn in the same place. Sprites marked no_crop, and those which are
+    // entirely transparent, are left alone. Returns the number of pixels removed.
+    uint32_t crop();
+    uint8_t  pixel_size() const;
+
+    // Compresses the image both with and without the chunked format, which describe the same
+    // image, and keeps whichever is smaller in the given container format. The winning encoding
+    // is kept so that writing the sprite does not compress it again. Returns the number of bytes
+    // saved.
+    int32_t choose_compression(GRFFormat format);
+
     void set_xoff(uint16_t offset) { m_xoff = offset; }
     void set_yoff(uint16_t offset) { m_yoff = offset; }
     void set_filename(const std::string& filename) { m_filename = filename; }
+    const std::string& filename() const { return m_filename; }
 
     // Only necessary for RGB[A]P sprites which contain both sprite and mask.
     void set_mask_xoff(uint16_t offset) { m_mask_xoff = offset; }
     void set_mask_yoff(uint16_t offset) { m_mask_yoff = offset; }
     void set_mask_filename(const std::string& filename) { m_mask_filename = filename; }
+    const std::string& mask_filename() const { return m_mask_filename; }
+
+    // Sprite sheet file names in the YAGL are relative to the YAGL directory. This is the
+    // full path used to open the sheet, which is also its key in the SpriteSheetPool.
+    static std::string sprite_sheet_path(const std::string& filename);
 
 private:
+    // The LZ77 compressed image data, and the size of the data before LZ77 compression.
+    std::vector<uint8_t> encode_image(bool chunked, GRFFormat format, uint32_t& uncomp_size) const;
+    // The same for the current compression, reusing the encoding kept by choose_compression()
+    // if it matches. The buffer holds the data if it has to be encoded again.
+    const std::vector<uint8_t>& image_data(GRFFormat format, uint32_t& uncomp_size, std::vector<uint8_t>& buffer) const;
     void write_format1(std::ostream& os) const;
     void write_format2(std::ostream& os) const;
 
-    std::vector<uint8_t> encode_lz77(const std::vector<uint8_t>& input) const;
-
     // Check whether a pixel is pure white - we warn about this, and perhaps fix.
     bool is_pure_white(const Pixel& pixel);
     // Non-owning pointers passed as a slightly more efficient implementation detail.
@@ -147,6 +185,9 @@ private:
     int16_t   m_yrel        = 0;
     uint32_t  m_uncomp_size = 0;
 
+    uint32_t  m_compressed_size = 0;
+    uint32_t  m_chunked_size    = 0;
+
     uint16_t  m_xoff        = 0;
     uint16_t  m_yoff        = 0;
     std::string m_filename;
@@ -156,4 +197,14 @@ private:
     std::string m_mask_filename;
 
     std::vector<uint8_t> m_pixels = {};
+
+    // The image as encoded by choose_compression(). This is dropped if the pixels change.
+    struct Encoding
+    {
+        GRFFormat            format;
+        uint8_t              compression;
+        uint32_t             uncomp_size;
+        std::vector<uint8_t> data;
+    };
+    std::optional<Encoding> m_encoding;
 };
@@ -76,13 +76,13 @@ void RecolourRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint1
                 {
                     if (start != (i-1))
                     {
-                        os << pad(indent + 4) << to_hex(uint8_t(start)) << ".." << to_hex(uint8_t(i-1)) << ": ";
-                        os << to_hex(m_colour_map[start]) << ".." << to_hex(m_colour_map[i-1]) << ";" << "\n";
+                        os << pad(indent + 4) << as_hex(uint8_t(start)) << ".." << as_hex(uint8_t(i-1)) << ": ";
+                        os << as_hex(m_colour_map[start]) << ".." << as_hex(m_colour_map[i-1]) << ";" << "\n";
                     }
                     else
                     {
-                        os << pad(indent + 4) << to_hex(uint8_t(start)) << ": ";
-                        os << to_hex(m_colour_map[start]) << ";" << "\n";
+                        os << pad(indent + 4) << as_hex(uint8_t(start)) << ": ";
+                        os << as_hex(m_colour_map[start]) << ";" << "\n";
                     }
                     state = 0;
                     if (diffs[i] != 0)
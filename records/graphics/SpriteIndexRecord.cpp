@@ -43,7 +43,7 @@ static constexpr const char* str_sprite_id = "sprite_id";
 
 void SpriteIndexRecord::print(std::ostream& os, const SpriteZoomMap& sprites, uint16_t indent) const
 {
-    os << pad(indent) << str_sprite_id << "<" << to_hex(m_sprite_id) << ">\n";
+    os << pad(indent) << str_sprite_id << "<" << as_hex(m_sprite_id) << ">\n";
     os << pad(indent) << "{" << '\n';
 
     if (sprites.find(m_sprite_id) != sprites.end())
@@ -73,6 +73,9 @@ void SpriteIndexRecord::parse(TokenStream& is, SpriteZoomMap& sprites)
     m_sprite_id = is.match_uint32();
     is.match(TokenType::CloseAngle);
 
+    // The same sprite may be referred to more than once, in which case the images are repeated
+    // at each reference. Only the first reference adds them to the map.
+    SpriteZoomVector sprite_list;
     is.match(TokenType::OpenBrace);
     while (is.peek().type != TokenType::CloseBrace)
     {
@@ -99,16 +102,11 @@ void SpriteIndexRecord::parse(TokenStream& is, SpriteZoomMap& sprites)
             record = std::make_unique<SpriteWrapperRecord>(m_sprite_id, std::move(effect));
         }
 
-        // This adds the sprite to the m_sprites map inside NewGRFData.
-        //append_real_sprite(m_sprite_id, record);
         // Sprites with the same ID are stored in map indexed by zoom level.
         // These maps are stored in a map index by the sprite ID.
-        if (sprites.find(m_sprite_id) == sprites.end())
-        {
-            sprites[m_sprite_id] = SpriteZoomVector{};
-        }
-        sprites[m_sprite_id].push_back(std::move(record));
+        sprite_list.push_back(std::move(record));
     }
 
     is.match(TokenType::CloseBrace);
+    sprites.emplace(m_sprite_id, std::move(sprite_list));
 }
@@ -37,6 +37,7 @@ public:
     }
 
     uint32_t sprite_id() const { return m_sprite_id; }
+    void set_sprite_id(uint32_t sprite_id) { m_sprite_id = sprite_id; }
 
     // Binary serialisation
     void read(std::istream& is, const GRFInfo& info) override;
@@ -21,8 +21,11 @@
 #include "RealSpriteRecord.h"
 #include "CommandLineOptions.h"
 #include "SpriteIDLabel.h"
+#include "Profiler.h"
 #include "png.hpp"
 #include <sstream>
+#include <string_view>
+#include <unordered_map>
 #include "FileSystem.h"
 
 
@@ -37,31 +40,23 @@ SpriteSheetGenerator::SpriteSheetGenerator(const std::map<uint32_t, SpriteZoomVe
 
 void SpriteSheetGenerator::generate()
 {
+    ScopedTimer timer{"Sheet layout"};
     partition_sprites();
 }
 
 
-void SpriteSheetGenerator::partition_sprite(std::map<Category, SpriteVector>& partitions,
-    Category cat, RealSpriteRecord* sprite)
+void SpriteSheetGenerator::partition_sprite(Partitions& partitions, Category cat, RealSpriteRecord* sprite)
 {
-    if (partitions.find(cat) == partitions.end())
-    {
-        SpriteVector ids{ sprite };
-        partitions[cat] = ids;
-    }
-    else
-    {
-        partitions[cat].push_back(sprite);
-    }
+    partitions[cat].push_back(sprite);
 }
 
 
-void SpriteSheetGenerator::partition_sprites()
+SpriteSheetGenerator::Partitions SpriteSheetGenerator::partition(const std::map<uint32_t, SpriteZoomVector>& sprites)
 {
     // First work out what the different colour classes are that we have.
     // This map is used to count the number of sprites in each class.
-    std::map<Category, SpriteVector> partitions;
-    for (const auto& it: m_sprites)
+    Partitions partitions;
+    for (const auto& it: sprites)
     {
         for (const auto& record: it.second)
         {
@@ -115,13 +110,89 @@ void SpriteSheetGenerator::partition_sprites()
         }
     }
 
-    for (const auto& p: partitions)
+    return partitions;
+}
+
+
+void SpriteSheetGenerator::partition_sprites()
+{
+    for (const auto& p: partition(m_sprites))
     {
         layout_sprites(p.first, p.second);
     }
 }
 
 
+std::string SpriteSheetGenerator::category_name(Category category)
+{
+    std::string result;
+    switch (category.colour)
+    {
+        case ColourType::Palette:
+            result = "8bpp";
+            break;
+        case ColourType::RGBA:
+            result = "32bpp";
+            break;
+        // Do these ever occur?
+        case ColourType::RGB:
+            result = "24bpp";
+            break;
+        case ColourType::Mask:
+            result = "mask";
+            break;
+        default:  throw RUNTIME_ERROR("Invalid colour depth");
+    }
+
+    switch (category.zoom)
+    {
+        case ZoomLevel::Normal:    result += "-normal"; break;
+        case ZoomLevel::ZoomInX2:  result += "-zin2";   break;
+        case ZoomLevel::ZoomInX4:  result += "-zin4";   break;
+        case ZoomLevel::ZoomOutX2: result += "-zout2";  break;
+        case ZoomLevel::ZoomOutX4: result += "-zout4";  break;
+        case ZoomLevel::ZoomOutX8: result += "-zout8";  break;
+    }
+    return result;
+}
+
+
+SpriteSheetGenerator::SpriteVector SpriteSheetGenerator::unique_sprites(const SpriteVector& sprites,
+    std::vector<std::pair<RealSpriteRecord*, const RealSpriteRecord*>>& duplicates)
+{
+    // The offsets are not part of the image in the sheet, so only the size, colour format
+    // and pixels have to match.
+    auto same_image = [](const RealSpriteRecord* sprite1, const RealSpriteRecord* sprite2)
+    {
+        return (sprite1->xdim() == sprite2->xdim()) && (sprite1->ydim() == sprite2->ydim()) &&
+            (sprite1->colour() == sprite2->colour()) && (sprite1->pixels() == sprite2->pixels());
+    };
+
+    SpriteVector unique;
+    std::unordered_map<std::size_t, SpriteVector> originals;
+    for (const auto sprite: sprites)
+    {
+        const auto& pixels = sprite->pixels();
+        std::size_t hash = std::hash<std::string_view>{}(
+            std::string_view{reinterpret_cast<const char*>(pixels.data()), pixels.size()});
+        hash ^= (std::size_t{sprite->xdim()} << 24) ^ (std::size_t{sprite->ydim()} << 8) ^ sprite->colour();
+
+        auto& candidates = originals[hash];
+        auto it = std::find_if(candidates.begin(), candidates.end(),
+            [&](const RealSpriteRecord* original) { return same_image(original, sprite); });
+        if (it != candidates.end())
+        {
+            duplicates.push_back({ sprite, *it });
+            continue;
+        }
+
+        candidates.push_back(sprite);
+        unique.push_back(sprite);
+    }
+    return unique;
+}
+
+
 void SpriteSheetGenerator::layout_sprites(Category category, SpriteVector sprites)
 {
     // Constants
@@ -142,6 +213,10 @@ void SpriteSheetGenerator::layout_sprites(Category category, SpriteVector sprite
     uint32_t xoffset    = xmargin;
     uint32_t yoffset    = ymargin;
 
+    // Each distinct image is placed only once.
+    std::vector<std::pair<RealSpriteRecord*, const RealSpriteRecord*>> duplicates;
+    sprites = unique_sprites(sprites, duplicates);
+
     SpriteVector layout;
     for (const auto sprite: sprites)
     {
@@ -189,6 +264,28 @@ void SpriteSheetGenerator::layout_sprites(Category category, SpriteVector sprite
 
     image_height = std::max(image_height, yoffset + row_height + ymargin);
     create_sprite_sheet(category, layout, index, image_width, image_height);
+
+    // Duplicates refer to the rectangle of the original in the YAGL.
+    for (const auto& [duplicate, original]: duplicates)
+    {
+        if (category.colour == ColourType::Mask)
+        {
+            duplicate->set_mask_xoff(original->mask_xoff());
+            duplicate->set_mask_yoff(original->mask_yoff());
+            duplicate->set_mask_filename(original->mask_filename());
+        }
+        else
+        {
+            duplicate->set_xoff(original->xoff());
+            duplicate->set_yoff(original->yoff());
+            duplicate->set_filename(original->filename());
+        }
+    }
+    if (!duplicates.empty())
+    {
+        std::cout << "Sprite sheets " << category_name(category) << ": " << duplicates.size();
+        std::cout << " duplicate images share the rectangle of an earlier sprite" << std::endl;
+    }
 }
 
 
@@ -199,35 +296,7 @@ void SpriteSheetGenerator::create_sprite_sheet(Category category, SpriteVector s
     // no sense to partition the sprites by zoom level, but let's do it
     // for now.
     std::ostringstream os;
-    os << m_base_name;
-
-    switch (category.colour)
-    {
-        case ColourType::Palette:
-            os << "-8bpp";
-            break;
-        case ColourType::RGBA:
-            os << "-32bpp";
-            break;
-        // Do these ever occur?
-        case ColourType::RGB:
-            os << "-24bpp";
-            break;
-        case ColourType::Mask:
-            os << "-mask";
-            break;
-        default:  throw RUNTIME_ERROR("Invalid colour depth");
-    }
-
-    switch (category.zoom)
-    {
-        case ZoomLevel::Normal:    os << "-normal-"; break;
-        case ZoomLevel::ZoomInX2:  os << "-zin2-";   break;
-        case ZoomLevel::ZoomInX4:  os << "-zin4-";   break;
-        case ZoomLevel::ZoomOutX2: os << "-zout2-";  break;
-        case ZoomLevel::ZoomOutX4: os << "-zout4-";  break;
-        case ZoomLevel::ZoomOutX8: os << "-zout8-";  break;
-    }
+    os << m_base_name << '-' << category_name(category) << '-';
     os << index << ".png";
     const std::string image_path = os.str();
 
@@ -319,6 +388,7 @@ void SpriteSheetGenerator::create_sprite_sheet_8bpp(const std::string& image_pat
         }
     }
 
+    ScopedTimer timer{"PNG write"};
     image.write(image_path);
 }
 
@@ -376,6 +446,7 @@ void SpriteSheetGenerator::create_sprite_sheet_24bpp(const std::string& image_pa
         }
     }
 
+    ScopedTimer timer{"PNG write"};
     image.write(image_path);
 }
 */
@@ -433,6 +504,7 @@ void SpriteSheetGenerator::create_sprite_sheet_32bpp(const std::string& image_pa
         }
     }
 
+    ScopedTimer timer{"PNG write"};
     image.write(image_path);
 }
 
@@ -500,6 +572,7 @@ void SpriteSheetGenerator::create_sprite_sheet_mask(const std::string& image_pat
         }
     }
 
+    ScopedTimer timer{"PNG write"};
     image.write(image_path);
 }
 
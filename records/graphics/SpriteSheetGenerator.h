@@ -27,7 +27,7 @@ class SpriteSheetGenerator
             const std::string& base_name, GRFFormat format);
         void generate();
 
-    private:
+    public:
         using SpriteVector = std::vector<RealSpriteRecord*>;
         using ZoomLevel    = RealSpriteRecord::ZoomLevel;
 
@@ -53,12 +53,22 @@ class SpriteSheetGenerator
                 return z1 < z2;
             }
         };
+        using Partitions = std::map<Category, SpriteVector>;
+
+        // Divides the real sprites by colour depth and zoom level. A 32bpp sprite with a mask
+        // appears in both the RGBA and Mask categories. This is also used for the --stats report.
+        static Partitions partition(const std::map<uint32_t, SpriteZoomVector>& sprites);
+        // For example "8bpp-normal". Sprite sheet file names are made from this.
+        static std::string category_name(Category category);
 
     private:
         void partition_sprites();
-        void partition_sprite(std::map<Category, SpriteVector>& partitions,
-            Category cat, RealSpriteRecord* sprite);
+        static void partition_sprite(Partitions& partitions, Category cat, RealSpriteRecord* sprite);
         void layout_sprites(Category category, SpriteVector sprites);
+        // Removes sprites whose image is the same as an earlier one, and lists them with the
+        // sprite whose place in the sheet they share.
+        static SpriteVector unique_sprites(const SpriteVector& sprites,
+            std::vector<std::pair<RealSpriteRecord*, const RealSpriteRecord*>>& duplicates);
 
         void create_sprite_sheet(Category category, SpriteVector sprites,
             uint32_t index, uint32_t width, uint32_t height);
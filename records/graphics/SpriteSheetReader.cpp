@@ -17,6 +17,7 @@
 // along with yagl. If not, see <https://www.gnu.org/licenses/>.
 ///////////////////////////////////////////////////////////////////////////////
 #include "SpriteSheetReader.h"
+#include "Profiler.h"
 
 
 // class RGBSpriteSheet : public SpriteSheet
@@ -96,35 +97,128 @@ SpriteSheetPool& SpriteSheetPool::pool()
 }
 
 
-SpriteSheet& SpriteSheetPool::get_sprite_sheet(const std::string file_name, SpriteSheet::Colour colour)
+namespace {
+
+std::unique_ptr<SpriteSheet> load_sprite_sheet(const std::string& file_name, SpriteSheet::Colour colour)
 {
-    auto it = m_sheets.find(file_name);
-    if (it == m_sheets.end())
+    using Colour = SpriteSheet::Colour;
+
+    std::cout << "Opening sprite sheet: " << file_name << "..." << std::endl;
+    ScopedTimer timer{"PNG read"};
+    std::unique_ptr<SpriteSheet> sheet;
+
+    // PNG++ will throw if the file does not exist.
+    switch (colour)
     {
-        using Colour = SpriteSheet::Colour;
+        case Colour::Palette:
+            sheet = std::make_unique<PaletteSpriteSheet>(file_name);
+            break;
+        // case Colour::RGB:
+        //     sheet = std::make_unique<RGBSpriteSheet>(file_name);
+        //     break;
+        case Colour::RGBA:
+            sheet = std::make_unique<RGBASpriteSheet>(file_name);
+            break;
+        default:
+            std::cout << "Failed to load sprite sheet because reasons.";
+    }
 
-        std::cout << "Opening sprite sheet: " << file_name << "..." << std::endl;
-        std::unique_ptr<SpriteSheet> sheet;
+    return sheet;
+}
+
+} // namespace {
+
+
+SpriteSheet& SpriteSheetPool::get_sprite_sheet(const std::string file_name, SpriteSheet::Colour colour)
+{
+    // The first thread to ask for a sheet decodes it without holding the lock, so that other
+    // sheets can be used meanwhile. Any other thread asking for the same sheet waits for it.
+    std::promise<std::unique_ptr<SpriteSheet>> promise;
+    Sheet sheet;
+    bool  load = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-        // PNG++ will throw if the file does not exist.
-        switch (colour)
+        auto it = m_sheets.find(file_name);
+        if (it == m_sheets.end())
+        {
+            sheet = promise.get_future().share();
+            m_sheets.emplace(file_name, sheet);
+            load = true;
+        }
+        else
         {
-            case Colour::Palette:
-                sheet = std::make_unique<PaletteSpriteSheet>(file_name);
-                break;
-            // case Colour::RGB:
-            //     sheet = std::make_unique<RGBSpriteSheet>(file_name);
-            //     break;
-            case Colour::RGBA:
-                sheet = std::make_unique<RGBASpriteSheet>(file_name);
-                break;
-            default:
-                std::cout << "Failed to load sprite sheet because reasons.";
+            sheet = it->second;
         }
+    }
 
-        m_sheets[file_name] = std::move(sheet);
+    if (load)
+    {
+        try
+        {
+            promise.set_value(load_sprite_sheet(file_name, colour));
+        }
+        catch (...)
+        {
+            // The waiting threads get the same exception, and a later request tries again.
+            promise.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_sheets.erase(file_name);
+            throw;
+        }
     }
 
     // We throw an exception before we get here, if the file does not exist.
-    return *m_sheets[file_name];
+    return *sheet.get();
+}
+
+
+void SpriteSheetPool::release_sprite_sheet(const std::string& file_name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_sheets.find(file_name);
+    if (it != m_sheets.end())
+    {
+        std::cout << "Closing sprite sheet: " << file_name << "..." << std::endl;
+        m_sheets.erase(it);
+    }
+
+    for (auto pix = m_pixels.begin(); pix != m_pixels.end(); )
+    {
+        const SpriteRect& rect = pix->first;
+        if ((rect.file_name == file_name) || (rect.mask_file_name == file_name))
+            pix = m_pixels.erase(pix);
+        else
+            ++pix;
+    }
+}
+
+
+void SpriteSheetPool::release_all()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& it: m_sheets)
+    {
+        std::cout << "Closing sprite sheet: " << it.first << "..." << std::endl;
+    }
+    m_sheets.clear();
+    m_pixels.clear();
+}
+
+
+SpriteSheetPool::Pixels SpriteSheetPool::find_pixels(const SpriteRect& rect)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_pixels.find(rect);
+    return (it != m_pixels.end()) ? it->second : nullptr;
+}
+
+
+void SpriteSheetPool::add_pixels(const SpriteRect& rect, Pixels pixels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pixels.emplace(rect, std::move(pixels));
 }
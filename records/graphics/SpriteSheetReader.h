@@ -17,8 +17,12 @@
 // along with yagl. If not, see <https://www.gnu.org/licenses/>.
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
 #include "png.hpp"
 #include "RealSpriteRecord.h"
 
@@ -39,8 +43,33 @@ public:
 };
 
 
+// A rectangle in the sprite sheets, with the mask rectangle for sprites which have one. Identical
+// sprites may share a rectangle, in which case they have the same pixels.
+struct SpriteRect
+{
+    std::string file_name;
+    std::string mask_file_name;
+    uint16_t    xoff{};
+    uint16_t    yoff{};
+    uint16_t    mask_xoff{};
+    uint16_t    mask_yoff{};
+    uint16_t    xdim{};
+    uint16_t    ydim{};
+    uint8_t     colour{};
+
+    bool operator<(const SpriteRect& other) const
+    {
+        return std::tie(file_name, mask_file_name, xoff, yoff, mask_xoff, mask_yoff, xdim, ydim, colour) <
+            std::tie(other.file_name, other.mask_file_name, other.xoff, other.yoff, other.mask_xoff,
+                other.mask_yoff, other.xdim, other.ydim, other.colour);
+    }
+};
+
+
 // Maintains a pool of open sprite sheets so that sprites can read their
-// pixels without opening and closing files a bazillion times.
+// pixels without opening and closing files a bazillion times. Records may be
+// parsed concurrently, so access to the pool is serialised, but each sheet is
+// decoded outside the lock. The sheets themselves are only read once loaded.
 class SpriteSheetPool
 {
 public:
@@ -48,7 +77,21 @@ public:
 
 public:
     SpriteSheet& get_sprite_sheet(const std::string file_name, SpriteSheet::Colour colour);
+    // Close a sheet which is no longer needed. It is simply re-opened if requested again.
+    void release_sprite_sheet(const std::string& file_name);
+    // Close all the sheets, once every sprite has read its pixels.
+    void release_all();
+
+    // The pixels already read for a rectangle, so that sprites which share it need not
+    // read them again. These are dropped when either of the sheets is released.
+    using Pixels = std::shared_ptr<const std::vector<uint8_t>>;
+    Pixels find_pixels(const SpriteRect& rect);
+    void   add_pixels(const SpriteRect& rect, Pixels pixels);
 
 private:
-    std::map<std::string, std::unique_ptr<SpriteSheet>> m_sheets;
+    // Ready once the sheet has been decoded by the thread which first asked for it.
+    using Sheet = std::shared_future<std::unique_ptr<SpriteSheet>>;
+    std::map<std::string, Sheet> m_sheets;
+    std::map<SpriteRect, Pixels> m_pixels;
+    std::mutex m_mutex;
 };
\ No newline at end of file
@@ -34,6 +34,8 @@ public:
     }
 
     uint32_t sprite_id() const { return m_sprite_id; }
+    // The record held in the sprite section, such as a sound effect.
+    const Record& sprite() const { return *m_sprite; }
 
     // Binary serialisation
     void read(std::istream& is, const GRFInfo& info) override;
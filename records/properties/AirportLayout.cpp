@@ -117,11 +117,11 @@ void AirportTile::print(std::ostream& os, uint16_t indent) const
             break;
         case Type::NewTile:
             os << pad(indent) << str_new_tile << "(";
-            os << int16_t(x_off) << ", " << int16_t(y_off) << ", " << to_hex(tile) << ");\n";
+            os << int16_t(x_off) << ", " << int16_t(y_off) << ", " << as_hex(tile) << ");\n";
             break;
         case Type::OldTile:
             os << pad(indent) << str_old_tile << "(";
-            os << int16_t(x_off) << ", " << int16_t(y_off) << ", " << to_hex(tile) << ");\n";
+            os << int16_t(x_off) << ", " << int16_t(y_off) << ", " << as_hex(tile) << ");\n";
             break;
     }
 }
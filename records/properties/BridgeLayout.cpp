@@ -58,7 +58,7 @@ void BridgeTable::print(std::ostream& os, uint16_t indent) const
             os << pad(indent + 4);
         }
 
-        os << to_hex(sprite) << " ";
+        os << as_hex(sprite) << " ";
 
         ++index;
         if ((index % 8) == 0)
@@ -118,7 +118,7 @@ void BridgeLayout::print(std::ostream& os, uint16_t indent) const
     os << pad(indent) << "{\n";
     for (const auto& table: m_tables)
     {
-        os << pad(indent + 4) << str_table << "<" << to_hex(table_id++) << ">\n";
+        os << pad(indent + 4) << str_table << "<" << as_hex(table_id++) << ">\n";
         table.print(os, indent + 4);
     }
     os << pad(indent) << "}";
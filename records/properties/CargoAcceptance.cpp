@@ -36,7 +36,7 @@ void CargoAcceptance::write(std::ostream& os) const
 
 void CargoAcceptance::print(std::ostream& os, uint16_t indent) const
 {
-    os << "{" << to_hex(m_cargo_type) << ": " << to_hex(m_acceptance) << "}";
+    os << "{" << as_hex(m_cargo_type) << ": " << as_hex(m_acceptance) << "}";
 }
 
 
@@ -54,9 +54,12 @@ public:
     void print(std::ostream& os, uint16_t indent = 0) const
     {
         os << str_date << "(";
-        os << to_string(m_year, UIntFormat::Dec)  << "/";
-        os << to_string(m_month, UIntFormat::Dec) << "/";
-        os << to_string(m_day, UIntFormat::Dec)   << ")";
+        print_uint(os, m_year, UIntFormat::Dec);
+        os << "/";
+        print_uint(os, m_month, UIntFormat::Dec);
+        os << "/";
+        print_uint(os, m_day, UIntFormat::Dec);
+        os << ")";
     }
 
     void parse(TokenStream& is)
@@ -52,7 +52,7 @@ void GenderCase::print(std::ostream& os, uint16_t indent) const
 
     for (const auto& item: m_items)
     {
-        os << to_hex(item.id) << ":\"" << item.name << "\" ";
+        os << as_hex(item.id) << ":\"" << item.name << "\" ";
     }
 
     os << "]";
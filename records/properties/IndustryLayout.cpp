@@ -115,11 +115,11 @@ void IndustryTile::print(std::ostream& os, uint16_t indent) const
             break;
         case Type::NewTile:
             os << pad(indent) << str_new_tile << "(";
-            os << int16_t(m_x_off) << ", " << int16_t(m_y_off) << ", " << to_hex(m_tile) << ");\n";
+            os << int16_t(m_x_off) << ", " << int16_t(m_y_off) << ", " << as_hex(m_tile) << ");\n";
             break;
         case Type::OldTile:
             os << pad(indent) << str_old_tile << "(";
-            os << int16_t(m_x_off) << ", " << int16_t(m_y_off) << ", " << to_hex(m_tile) << ");\n";
+            os << int16_t(m_x_off) << ", " << int16_t(m_y_off) << ", " << as_hex(m_tile) << ");\n";
             break;
     }
 }
@@ -204,7 +204,7 @@ void IndustryLayout::print(std::ostream& os, uint16_t indent) const
 {
     if (m_is_reference)
     {
-        os << pad(indent) << str_reference << "(" << to_hex(m_industry_num) << ", " << to_hex(m_layout_num) << ");\n";
+        os << pad(indent) << str_reference << "(" << as_hex(m_industry_num) << ", " << as_hex(m_layout_num) << ");\n";
     }
     else
     {
@@ -54,7 +54,7 @@ void IndustryMultipliers::print(std::ostream& os, uint16_t indent) const
         os << " [";
         for (uint8_t o = 0; o < m_num_outputs; ++o)
         {
-            os << " " << to_hex(m_items[index++]);
+            os << " " << as_hex(m_items[index++]);
         }
         os << " ]";
     }
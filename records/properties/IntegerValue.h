@@ -18,6 +18,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "TokenStream.h"
+#include "StreamHelpers.h"
 //#include "IntegerDescriptor.h"
 #include "properties/Vector.h"
 #include "properties/Array.h"
@@ -25,41 +26,46 @@
 #include <type_traits>
 #include <iostream>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 
 enum class UIntFormat { Dec, Hex, Bool };
 
 
+// Writes the value into the buffer, which must hold at least MaxFormatLen characters.
+// Returns a pointer past the last character.
 template <typename T>
-std::string to_string(T value, UIntFormat format = UIntFormat::Hex)
+char* format_uint(char* buffer, T value, UIntFormat format)
 {
-    char buffer[24];
+    // Widened as printf("%u") would, so that any signed values are shown the same way.
+    using Dec = std::conditional_t<(sizeof(T) <= sizeof(unsigned)), unsigned, uint64_t>;
+
+    const char* text = "<error>";
     switch (format)
     {
-        case UIntFormat::Hex:
-            if constexpr (sizeof(T) == 1)
-                std::snprintf(buffer, 16, "0x%02X", value & 0xFF);
-            else if constexpr (sizeof(T) == 2)
-                std::snprintf(buffer, 16, "0x%04X", value & 0xFFFF);
-            else if constexpr (sizeof(T) == 4)
-                std::snprintf(buffer, 16, "0x%08X", value & 0xFFFF'FFFF);
-            else if constexpr (sizeof(T) == 8)
-                std::snprintf(buffer, 16, "0x%016X", value);
-            break;
-
-        case UIntFormat::Dec:
-            std::snprintf(buffer, 16, "%u", value);
-            break;
-
-        case UIntFormat::Bool:
-            std::snprintf(buffer, 16, "%s", value != 0x00 ? "true" : "false");
-            break;
-
-        default:
-            std::snprintf(buffer, 16, "<error>");
+        case UIntFormat::Hex:  return format_hex(buffer, value);
+        case UIntFormat::Dec:  return format_dec(buffer, static_cast<Dec>(value));
+        case UIntFormat::Bool: text = (value != 0x00) ? "true" : "false"; break;
     }
+    return std::copy(text, text + std::strlen(text), buffer);
+}
+
+
+template <typename T>
+std::string to_string(T value, UIntFormat format = UIntFormat::Hex)
+{
+    char buffer[MaxFormatLen];
+    return std::string(buffer, format_uint(buffer, value, format));
+}
 
-    return std::string{buffer};
+
+// As to_string() but without the temporary.
+template <typename T>
+void print_uint(std::ostream& os, T value, UIntFormat format = UIntFormat::Hex)
+{
+    char buffer[MaxFormatLen];
+    os.write(buffer, format_uint(buffer, value, format) - buffer);
 }
 
 
@@ -80,7 +86,7 @@ public:
 
     void print(std::ostream& os, uint16_t indent = 0) const
     {
-        os << to_string(m_value, FORMAT);
+        print_uint(os, m_value, FORMAT);
     }
 
     void parse(TokenStream& is)
@@ -20,23 +20,127 @@
 #include "Exceptions.h"
 
 
-void PropertyMap::register_property(PropertyBase* property)
+void PropertyTable::register_property(const PropertyBase* property)
 {
-    auto index = property->index();
-    m_properties_by_index[index] = property;
+    m_properties_by_index[property->index()] = property;
+}
+
+
+void PropertyTable::finalise()
+{
+    std::vector<std::pair<std::string, const PropertyBase*>> labels;
+    for (const auto property: m_properties_by_index)
+    {
+        if (property != nullptr)
+        {
+            labels.push_back({property->label(), property});
+        }
+    }
+    m_properties_by_label.build(std::move(labels));
+}
+
+
+const PropertyBase* PropertyTable::find(const std::string& label) const
+{
+    auto property = m_properties_by_label.find(label);
+    return (property != nullptr) ? *property : nullptr;
+}
+
+
+void PropertyTable::print_info() const
+{
+    for (const auto property: m_properties_by_index)
+    {
+        if (property != nullptr)
+        {
+            property->print_info(std::cout);
+        }
+    }
+}
+
+
+PropertySlot::PropertySlot(const PropertyBase& property)
+: m_value{property.make_value(m_buffer)}
+, m_index{property.index()}
+{
+}
 
-    const auto& label = property->label();
-    m_properties_by_label[label] = property;
+
+PropertySlot::PropertySlot(PropertySlot&& other) noexcept
+: m_index{other.m_index}
+{
+    if (other.is_inline())
+    {
+        m_value = other.m_value->move_to(m_buffer);
+    }
+    else
+    {
+        m_value = other.m_value;
+        other.m_value = nullptr;
+    }
+}
+
+
+PropertySlot::~PropertySlot()
+{
+    if (is_inline())
+    {
+        m_value->~PropertyValueBase();
+    }
+    else
+    {
+        delete m_value;
+    }
+}
+
+
+const PropertyValueBase* PropertyMap::find_value(uint8_t index) const
+{
+    for (const auto& slot: m_values)
+    {
+        if (slot.index() == index)
+        {
+            return &slot.value();
+        }
+    }
+    return nullptr;
+}
+
+
+PropertyValueBase& PropertyMap::value(const PropertyBase& property)
+{
+    // Properties may appear more than once. The last value wins, as they share storage.
+    auto value = const_cast<PropertyValueBase*>(find_value(property.index()));
+    if (value == nullptr)
+    {
+        if (m_values.empty())
+        {
+            m_values.reserve(TypicalValues);
+        }
+        m_values.emplace_back(property);
+        value = &m_values.back().value();
+    }
+    return *value;
+}
+
+
+std::size_t PropertyMap::num_heap_values() const
+{
+    std::size_t count = 0;
+    for (const auto& slot: m_values)
+    {
+        count += slot.is_inline() ? 0 : 1;
+    }
+    return count;
 }
 
 
 bool PropertyMap::read_property(std::istream& is, uint8_t property)
 {
-    auto it = m_properties_by_index.find(property);
-    if (it != m_properties_by_index.end())
+    const PropertyBase* prop = m_table.find(property);
+    if (prop != nullptr)
     {
-        PropertyBase* prop = it->second;
-        prop->read(is);
+        value(*prop).read(is);
         return true;
     }
     return false;
@@ -45,11 +149,16 @@ bool PropertyMap::read_property(std::istream& is, uint8_t property)
 
 bool PropertyMap::write_property(std::ostream& os, uint8_t property) const
 {
-    auto it = m_properties_by_index.find(property);
-    if (it != m_properties_by_index.end())
+    const PropertyBase* prop = m_table.find(property);
+    if (prop != nullptr)
     {
-        PropertyBase* prop = it->second;
-        prop->write(os);
+        // A property which was never set is written with its default value.
+        const PropertyValueBase* value = find_value(property);
+        if (value == nullptr)
+        {
+            value = &prop->default_value();
+        }
+        value->write(os);
         return true;
     }
     return false;
@@ -58,11 +167,15 @@ bool PropertyMap::write_property(std::ostream& os, uint8_t property) const
 
 bool PropertyMap::print_property(std::ostream& os, uint8_t property, uint16_t indent) const
 {
-    auto it = m_properties_by_index.find(property);
-    if (it != m_properties_by_index.end())
+    const PropertyBase* prop = m_table.find(property);
+    if (prop != nullptr)
     {
-        PropertyBase* prop = it->second;
-        prop->print(os, indent);
+        const PropertyValueBase* value = find_value(property);
+        if (value == nullptr)
+        {
+            value = &prop->default_value();
+        }
+        prop->print(os, *value, indent);
         return true;
     }
     return false;
@@ -71,12 +184,11 @@ bool PropertyMap::print_property(std::ostream& os, uint8_t property, uint16_t in
 
 bool PropertyMap::parse_property(TokenStream& is, const std::string& label, uint8_t& property)
 {
-    auto it = m_properties_by_label.find(label);
-    if (it != m_properties_by_label.end())
+    const PropertyBase* prop = m_table.find(label);
+    if (prop != nullptr)
     {
-        PropertyBase* prop = it->second;
         property = prop->index();
-        prop->parse(is);
+        value(*prop).parse(is);
         return true;
     }
     return false;
@@ -85,8 +197,5 @@ bool PropertyMap::parse_property(TokenStream& is, const std::string& label, uint
 
 void PropertyMap::print_info() const
 {
-    for (auto [property, prop]: m_properties_by_index)
-    {
-        prop->print_info(std::cout);
-    }
+    m_table.print_info();
 }
@@ -23,21 +23,153 @@
 #include <iostream>
 #include <string>
 #include <cstdint>
-#include <map>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include "PerfectHash.h"
 
 
 // Defined below.
 class PropertyBase;
+class PropertyValueBase;
 
 
-// This maps a set of properties indices/labels to corresponding Property
-// objects which know how to read/write/print/parse the corresponding property
-// value. This is mainly useful for implementing Action00 for the various 
-// FeatureTypes, but could be useful in other places.
+// The set of properties for a feature, indexed by the property number and by the label used
+// in the YAGL. Each feature's table is built once and shared by all instances of the feature,
+// which only store the values of the properties they actually have. This is mainly useful for
+// implementing Action00 for the various FeatureTypes, but could be useful in other places.
+class PropertyTable
+{
+public:
+    void register_property(const PropertyBase* property);
+    // Builds the label lookup once all the properties have been registered.
+    void finalise();
+
+    const PropertyBase* find(uint8_t index) const { return m_properties_by_index[index]; }
+    const PropertyBase* find(const std::string& label) const;
+
+    void print_info() const;
+
+private:
+    std::array<const PropertyBase*, 256> m_properties_by_index{};
+    PerfectHash<const PropertyBase*>     m_properties_by_label;
+};
+
+
+// Properties register themselves with the table when they are constructed, so a table is
+// described by a class whose members are the properties. This creates a single instance of
+// that class on first use (which is thread safe), and returns its table.
+template <typename Properties>
+const PropertyTable& static_property_table()
+{
+    static const PropertyTable& table = []() -> const PropertyTable&
+    {
+        static Properties properties;
+        properties.table().finalise();
+        return properties.table();
+    }();
+    return table;
+}
+
+
+// The value of one property for one feature instance.
+class PropertyValueBase
+{
+public:
+    virtual ~PropertyValueBase() {}
+
+    virtual void read(std::istream& is) = 0;
+    virtual void write(std::ostream& os) const = 0;
+    virtual void print(std::ostream& os, uint16_t indent) const = 0;
+    virtual void parse(TokenStream& is) = 0;
+
+    // Move constructs this value into the given buffer, for values held inline in a
+    // PropertySlot. The caller destroys the original.
+    virtual PropertyValueBase* move_to(void* buffer) noexcept = 0;
+};
+
+
+template <typename T>
+class PropertyValue : public PropertyValueBase
+{
+public:
+    PropertyValue(const T& value) : m_value{value} {}
+
+    void read(std::istream& is) override                      { m_value.read(is); }
+    void write(std::ostream& os) const override               { m_value.write(os); }
+    void print(std::ostream& os, uint16_t indent) const override { m_value.print(os, indent); }
+    void parse(TokenStream& is) override                      { m_value.parse(is); }
+
+    // Defined below, as it depends on which values a PropertySlot holds inline.
+    PropertyValueBase* move_to(void* buffer) noexcept override;
+
+private:
+    T m_value;
+};
+
+
+// Storage for the value of one property, tagged with the property index. Most properties
+// are small integers, so values of up to a few words are held in the slot itself. Only the
+// larger ones, such as sprite layouts, are allocated on the heap.
+class PropertySlot
+{
+public:
+    static constexpr std::size_t Capacity = 32;
+
+    template <typename V>
+    static constexpr bool fits_inline()
+    {
+        return (sizeof(V) <= Capacity) && (alignof(V) <= alignof(std::max_align_t)) &&
+            std::is_nothrow_move_constructible_v<V>;
+    }
+
+public:
+    // Holds a copy of the property's default value.
+    PropertySlot(const PropertyBase& property);
+    PropertySlot(PropertySlot&& other) noexcept;
+    PropertySlot(const PropertySlot& other)            = delete;
+    PropertySlot& operator=(const PropertySlot& other) = delete;
+    PropertySlot& operator=(PropertySlot&& other)      = delete;
+    ~PropertySlot();
+
+    uint8_t index() const                  { return m_index; }
+    PropertyValueBase& value()             { return *m_value; }
+    const PropertyValueBase& value() const { return *m_value; }
+    bool is_inline() const                 { return static_cast<const void*>(m_value) == m_buffer; }
+
+private:
+    alignas(std::max_align_t) unsigned char m_buffer[Capacity];
+    PropertyValueBase* m_value{};
+    uint8_t            m_index{};
+};
+
+
+template <typename T>
+PropertyValueBase* PropertyValue<T>::move_to(void* buffer) noexcept
+{
+    if constexpr (PropertySlot::fits_inline<PropertyValue<T>>())
+    {
+        return new (buffer) PropertyValue<T>{std::move(*this)};
+    }
+    else
+    {
+        // Values which do not fit in the slot are on the heap, and are never moved.
+        std::abort();
+    }
+}
+
+
+// This holds the values of the properties for a single feature instance, such as a particular
+// train. Only properties which have been read or parsed are stored, and the table provides the
+// Property objects which know how to create, read, write, print and parse each value.
 class PropertyMap
 {
 public:
-    void register_property(PropertyBase* property);
+    PropertyMap(const PropertyTable& table) : m_table{table} {}
 
     bool read_property(std::istream& is, uint8_t property);
     bool write_property(std::ostream& os, uint8_t property) const;
@@ -46,38 +178,59 @@ public:
 
     void print_info() const;
 
+    // The number of properties which are actually stored.
+    std::size_t num_values() const { return m_values.size(); }
+    // The number of those values which needed a separate allocation.
+    std::size_t num_heap_values() const;
+
 private:
-    // TODO just have a vector and reduce complexity/memory.
-    // TODO can a feature have a static Property map?
-    std::map<uint8_t, PropertyBase*>     m_properties_by_index; 
-    std::map<std::string, PropertyBase*> m_properties_by_label; 
+    const PropertyValueBase* find_value(uint8_t index) const;
+    PropertyValueBase&       value(const PropertyBase& property);
+
+private:
+    // A typical Action00 sets only two or three properties per instance.
+    static constexpr std::size_t TypicalValues = 4;
+
+    const PropertyTable& m_table;
+
+    // A short vector searched linearly is both smaller and faster than a map here.
+    std::vector<PropertySlot> m_values;
 };
 
 
 // This is a common base class for all Action00 properties. The Action00 for each
 // FeatureType is basically a map from the property index to the property object.
-// The property object can read, write, print and parse itself.
+// The property object describes the property and creates values of the right type,
+// which can read, write, print and parse themselves.
 class PropertyBase
 {
 public:
-    PropertyBase(PropertyMap& container, uint8_t index, const char* label)
-    : m_index{index}, m_label{label} 
+    PropertyBase(PropertyTable& table, uint8_t index, const char* label)
+    : m_index{index}, m_label{label}
     {
-        container.register_property(this);
+        table.register_property(this);
     }
+    virtual ~PropertyBase() {}
 
-    uint8_t index() const     { return m_index; } 
+    uint8_t index() const     { return m_index; }
     const char* label() const { return m_label; }
 
-    // Each type of property has the same API, from a simple integer 
-    // to a complex sprite layout.
-    virtual void read(std::istream& is) = 0;
-    virtual void write(std::ostream& os) const = 0;
-    virtual void print(std::ostream& os, uint16_t indent) const = 0;
-    virtual void parse(TokenStream& is) = 0;
+    // Each type of property has the same API, from a simple integer
+    // to a complex sprite layout. Values are created in the buffer if they fit, and
+    // on the heap otherwise.
+    virtual PropertyValueBase* make_value(void* buffer) const = 0;
+    // Used for properties which have not been set.
+    virtual const PropertyValueBase& default_value() const = 0;
     virtual void print_info(std::ostream& os) const = 0;
 
-private:   
+    void print(std::ostream& os, const PropertyValueBase& value, uint16_t indent) const
+    {
+        os << pad(indent) << label() << ": ";
+        value.print(os, indent);
+        os << ";\n";
+    }
+
+private:
     uint8_t     m_index;
     const char* m_label;
 };
@@ -109,49 +262,46 @@ template <typename T>
 class Property : public PropertyBase
 {
 public:
+    // Any arguments are passed to the constructor of the value type, e.g. the names of
+    // bits in a bitfield. Every value of the property starts as a copy of this one.
     template <typename... Args>
-    Property(PropertyMap& container, uint8_t index, const char* label, const Args&... args)
-    : PropertyBase(container, index, label) 
-    , m_value{args...}
+    Property(PropertyTable& table, uint8_t index, const char* label, const Args&... args)
+    : PropertyBase(table, index, label)
+    , m_default{T{args...}}
     {
     }
 
-    void read(std::istream& is) override
-    {        
-        m_value.read(is);
-    }
-
-    void write(std::ostream& os) const override
-    {        
-        m_value.write(os);
-    }
-
-    void print(std::ostream& os, uint16_t indent) const override
-    { 
-        os << pad(indent) << label() << ": ";  
-        m_value.print(os, indent);
-        os << ";\n";  
+    PropertyValueBase* make_value(void* buffer) const override
+    {
+        if constexpr (PropertySlot::fits_inline<PropertyValue<T>>())
+        {
+            return new (buffer) PropertyValue<T>{m_default};
+        }
+        else
+        {
+            return new PropertyValue<T>{m_default};
+        }
     }
 
-    void parse(TokenStream& is) override
-    {   
-        m_value.parse(is);     
+    const PropertyValueBase& default_value() const override
+    {
+        return m_default;
     }
 
     void print_info(std::ostream& os) const override
     {
-        // typeid() is not very helpful as it gives the compiler's name for the type. 
+        // typeid() is not very helpful as it gives the compiler's name for the type.
         // Need to add type_name() method to each property, or some kind of trait.
-        //os << "    " << to_hex(index()) << "  " << typeid(T).name() << "  " << label() << ": ";
-        //os << "    " << to_hex(index()) << "  " << type_name<T>() << "  " << label() << ": ";
-        os << "    " << to_hex(index()) << "  " << label() << ": ";
+        //os << "    " << as_hex(index()) << "  " << typeid(T).name() << "  " << label() << ": ";
+        //os << "    " << as_hex(index()) << "  " << type_name<T>() << "  " << label() << ": ";
+        os << "    " << as_hex(index()) << "  " << label() << ": ";
         //m_value.print_info(os);
-        // Temporary output. We want the data type Byte, Word, DWord, Variable and other info. 
+        // Temporary output. We want the data type Byte, Word, DWord, Variable and other info.
         // Traits for properties? Could hold sample values and whatnot.
-        m_value.print(os);
-        os << ";\n";  
+        m_default.print(os, 0);
+        os << ";\n";
     }
 
 private:
-    T m_value{};
+    PropertyValue<T> m_default;
 };
@@ -48,7 +48,7 @@ void SnowLine::print(std::ostream& os, uint16_t indent) const
         os << pad(indent + 4);
         for (uint8_t day = 0; day < 32; ++day)
         {
-            os << to_hex(m_snow_heights[index++]) << " ";
+            os << as_hex(m_snow_heights[index++]) << " ";
         }
         os << "\n";
     }
@@ -239,7 +239,7 @@ void SpriteLayout::print(std::ostream& os, uint16_t indent) const
     // of whitespace.
     os << '\n' << pad(indent) << "{\n";
 
-    os << pad(indent + 4) << str_ground_sprite << "<" << to_hex(m_ground_sprite) << ">\n";
+    os << pad(indent + 4) << str_ground_sprite << "<" << as_hex(m_ground_sprite) << ">\n";
     os << pad(indent + 4) << "{" << '\n';
     m_ground_regs.print(os, true, indent + 8); // true = is a parent
     os << pad(indent + 4) << "}" << '\n';
@@ -248,18 +248,18 @@ void SpriteLayout::print(std::ostream& os, uint16_t indent) const
     {
         if (sprite.new_bb)
         {
-            os << pad(indent + 4) << str_building_sprite << "<" << to_hex(sprite.sprite) << ">\n";
+            os << pad(indent + 4) << str_building_sprite << "<" << as_hex(sprite.sprite) << ">\n";
             os << pad(indent + 4) << "{\n";
-            os << pad(indent + 8) << str_offset << ": " << to_hex(sprite.xofs) << ", " << to_hex(sprite.yofs) << ", " << to_hex(sprite.zofs) << ";\n";
-            os << pad(indent + 8) << str_extent << ": " << to_hex(sprite.xext) << ", " << to_hex(sprite.yext) << ", " << to_hex(sprite.zext) << ";\n";
+            os << pad(indent + 8) << str_offset << ": " << as_hex(sprite.xofs) << ", " << as_hex(sprite.yofs) << ", " << as_hex(sprite.zofs) << ";\n";
+            os << pad(indent + 8) << str_extent << ": " << as_hex(sprite.xext) << ", " << as_hex(sprite.yext) << ", " << as_hex(sprite.zext) << ";\n";
             sprite.regs.print(os, true, indent + 8); // true = is a parent
             os << pad(indent + 4) << "}\n";
         }
         else
         {
-            os << pad(indent + 4) << str_child_sprite << "<" << to_hex(sprite.sprite) << ">\n";
+            os << pad(indent + 4) << str_child_sprite << "<" << as_hex(sprite.sprite) << ">\n";
             os << pad(indent + 4) << "{\n";
-            os << pad(indent + 8) << str_offset << ": " << to_hex(sprite.xofs) << ", " << to_hex(sprite.yofs) << ";\n";
+            os << pad(indent + 8) << str_offset << ": " << as_hex(sprite.xofs) << ", " << as_hex(sprite.yofs) << ";\n";
             sprite.regs.print(os, false, indent + 8); // false = not a parent
             os << pad(indent + 4) << "}\n";
         }
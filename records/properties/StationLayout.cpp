@@ -72,15 +72,15 @@ void StationTileData::print(std::ostream& os, uint16_t indent) const
 {
     if (m_new_bb)
     {
-        os << pad(indent) << str_sprite << "(" << to_hex(m_sprite) << ", ";
-        os << to_hex(m_x_off) << ", " << to_hex(m_y_off) << ", " << to_hex(m_z_off) << ", ";
-        os << to_hex(m_x_ext) << ", " << to_hex(m_y_ext) << ", " << to_hex(m_z_ext);
+        os << pad(indent) << str_sprite << "(" << as_hex(m_sprite) << ", ";
+        os << as_hex(m_x_off) << ", " << as_hex(m_y_off) << ", " << as_hex(m_z_off) << ", ";
+        os << as_hex(m_x_ext) << ", " << as_hex(m_y_ext) << ", " << as_hex(m_z_ext);
         os << ");\n";
     }
     else
     {
-        os << pad(indent) << str_sprite << "(" << to_hex(m_sprite) << ", ";
-        os << to_hex(m_x_off) << ", " << to_hex(m_y_off);
+        os << pad(indent) << str_sprite << "(" << as_hex(m_sprite) << ", ";
+        os << as_hex(m_x_off) << ", " << as_hex(m_y_off);
         os << ");\n";
     }
 }
@@ -152,7 +152,7 @@ void StationTile::write(std::ostream& os) const
 
 void StationTile::print(std::ostream& os, uint16_t indent) const
 {
-    os << pad(indent) << str_tile << "<" << to_hex(m_ground_sprite) << ">\n";
+    os << pad(indent) << str_tile << "<" << as_hex(m_ground_sprite) << ">\n";
     os << pad(indent) << "{\n";
 
     if (m_ground_sprite != 0x0000'0000)
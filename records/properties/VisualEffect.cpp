@@ -86,7 +86,7 @@ void VisualEffect::print(std::ostream& os, uint16_t indent) const
 {
     os << str_effect << "(";
     os << desc_effect.value(m_effect) << ", ";
-    os << to_hex(m_position) << ", ";
+    os << as_hex(m_position) << ", ";
     os << desc_power.value(m_wagon_power) << ")";
 }
 
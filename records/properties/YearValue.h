@@ -42,7 +42,7 @@ public:
 
     void print(std::ostream& os, uint16_t indent = 0) const
     {
-        os << to_string(m_year, UIntFormat::Dec);
+        print_uint(os, m_year, UIntFormat::Dec);
     }
 
     void parse(TokenStream& is)
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "catch.hpp"
+#include "NewGRFData.h"
+#include "FileSystem.h"
+#include "Version.h"
+#include <sstream>
+#include <string>
+
+
+// Runs a test in a new empty directory, which is removed afterwards. Decoding writes the sprite
+// sheets into its "sprites" sub-directory, which is where encoding looks for them by default.
+class ScopedTestDir
+{
+public:
+    explicit ScopedTestDir(const std::string& name)
+    : m_previous{fs::current_path()}
+    , m_dir{fs::temp_directory_path() / name}
+    {
+        fs::remove_all(m_dir);
+        fs::create_directories(m_dir / "sprites");
+        fs::current_path(m_dir);
+    }
+
+    ~ScopedTestDir()
+    {
+        fs::current_path(m_previous);
+        fs::remove_all(m_dir);
+    }
+
+private:
+    fs::path m_previous;
+    fs::path m_dir;
+};
+
+
+// Decodes a GRF to YAGL as --decode does, writing sprite sheets named after the base name.
+inline std::string decode_grf(const std::string& grf, const std::string& base_name)
+{
+    std::istringstream is(grf);
+    NewGRFData grf_data;
+    grf_data.read(is);
+
+    std::ostringstream os;
+    grf_data.print(os, "sprites", "sprites/" + base_name);
+    return os.str();
+}
+
+
+// Encodes YAGL to a GRF as --encode does.
+inline std::string encode_yagl(const std::string& yagl)
+{
+    std::istringstream is(yagl);
+    TokenStream ts{is};
+    NewGRFData grf_data;
+    grf_data.parse(ts, "sprites", "");
+
+    std::stringstream os;
+    grf_data.write(os);
+    return os.str();
+}
+
+
+// Parses YAGL records as --encode does, after the version and format lines which start every script.
+inline void parse_yagl(NewGRFData& grf_data, const std::string& records)
+{
+    std::ostringstream os;
+    os << "yagl_version: \"" << str_yagl_version << "\";\n";
+    os << "grf_format: Container2;\n";
+    os << records;
+
+    std::istringstream is(os.str());
+    TokenStream ts{is};
+    grf_data.parse(ts, "", "");
+}
@@ -68,3 +68,147 @@ TEST_CASE("Action02VariableRecord", "[actions]")
     test_yagl<Action02VariableRecord, 0x02>(str_YAGL, str_NFO);
 }
 
+
+
+namespace {
+
+static constexpr const char* str_YAGL_simplify =
+    "switch<Trains, 0xFD, PrimaryWord> // Action02 variable\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x1A] & 0x00000004;\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x00000003;\n"
+    "        value1 = Addition(value1, value2);\n"
+    "\n"
+    "        value2 = variable[0x40] & 0x000000FF;\n"
+    "        value1 = Assign(value1, value2);\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x00000000;\n"
+    "        value1 = Addition(value1, value2);\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x0000FFFF;\n"
+    "        value1 = BitwiseAnd(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000: 0x0001;\n"
+    "        0x00000001..0x00000004: 0x0002;\n"
+    "        0x00000005..0x00000009: 0x0002;\n"
+    "        0x0000000A: 0x0003;\n"
+    "        0x0000000B: 0x0004;\n"
+    "    };\n"
+    "    default: 0x0003;\n"
+    "}\n";
+// The constants are folded and then discarded, the operations which do nothing are dropped,
+// and the ranges are merged.
+static constexpr const char* str_YAGL_simplified =
+    "switch<Trains, 0xFD, PrimaryWord> // Action02 variable\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x40] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000: 0x0001;\n"
+    "        0x00000001..0x00000009: 0x0002;\n"
+    "        0x0000000B: 0x0004;\n"
+    "    };\n"
+    "    default: 0x0003;\n"
+    "}\n";
+
+static constexpr const char* str_YAGL_constant =
+    "switch<Trains, 0xFD, PrimaryByte> // Action02 variable\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x1A] & 0x00000003;\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x00000002;\n"
+    "        value1 = ShiftLeft(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000..0x0000000B: 0x0001;\n"
+    "        0x0000000C: 0x0002;\n"
+    "    };\n"
+    "    default: 0x0003;\n"
+    "}\n";
+
+// Calls switch 0x05 as a procedure, and also selects it.
+static constexpr const char* str_YAGL_procedure =
+    "switch<Trains, 0xFD, PrimaryByte> // Action02 variable\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x7E, 0x05] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000: 0x0005;\n"
+    "    };\n"
+    "    default: 0x0006;\n"
+    "}\n";
+
+
+Action02VariableRecord parse_switch(const char* yagl)
+{
+    SpriteZoomMap sprites;
+    std::istringstream is(yagl);
+    TokenStream ts{is};
+    Action02VariableRecord action;
+    action.parse(ts, sprites);
+    return action;
+}
+
+} // namespace {
+
+
+TEST_CASE("Action02VariableRecord simplify", "[actions]")
+{
+    SpriteZoomMap sprites;
+    auto original = parse_switch(str_YAGL_simplify);
+    auto action   = original;
+    CHECK(action.simplify());
+    CHECK(!action.simplify());
+    CHECK(action.equivalent(original, 1000));
+
+    std::ostringstream os;
+    action.print(os, sprites, 0);
+    CHECK(os.str() == str_YAGL_simplified);
+
+    auto read_variable = [](uint8_t variable, uint32_t /*parameter*/) -> std::optional<uint32_t>
+    {
+        if (variable == 0x40)
+            return 0x1234;
+        return std::nullopt;
+    };
+    auto outcome = action.evaluate(read_variable);
+    CHECK(outcome.available);
+    CHECK(outcome.value == 0x34);
+    CHECK(outcome.set_id == 0x0003);
+
+    // A constant calculation selects the same set every time.
+    auto constant = parse_switch(str_YAGL_constant);
+    CHECK(!constant.single_target());
+    CHECK(constant.simplify());
+    CHECK(constant.single_target() == 0x0002);
+    CHECK(constant.equivalent(parse_switch(str_YAGL_constant), 100));
+    CHECK(!constant.equivalent(original, 100));
+}
+
+
+TEST_CASE("Action02VariableRecord rename", "[actions]")
+{
+    auto action = parse_switch(str_YAGL_procedure);
+    action.rename_act02_set_id(0x05, 0x07);
+    CHECK(action.act02_set_ids() == std::vector<uint16_t>{ 0x0007, 0x0006 });
+    CHECK(action.actions()[0].parameter == 0x07);
+
+    // A procedure cannot be replaced by a callback result.
+    action.rename_act02_set_id(0x07, 0x8001);
+    CHECK(action.act02_set_ids() == std::vector<uint16_t>{ 0x8001, 0x0006 });
+    CHECK(action.actions()[0].parameter == 0x07);
+}
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "ChainCostAnalyser.h"
+#include "NewGRFData.h"
+#include "Test_GRFHelpers.h"
+#include <sstream>
+
+
+namespace {
+
+// A switch on the callback, one branch of which reads a 60+x variable and uses storage.
+static constexpr const char* str_YAGL =
+    "sprite_groups<Trains, 0x01>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "switch<Trains, 0x02, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x60, 0x05] & 0x000000FF;\n"
+    "        value2 = variable[0x7D, 0x00] & 0x000000FF;\n"
+    "        value1 = TempStore(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000001: 0x0001;\n"
+    "    };\n"
+    "    default: 0x0001;\n"
+    "}\n"
+    "switch<Trains, 0x03, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x0C] & 0x0000FFFF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000136: 0x0002;\n"
+    "    };\n"
+    "    default: 0x8001;\n"
+    "}\n"
+    "feature_graphics<Trains>\n"
+    "{\n"
+    "    livery_override: false;\n"
+    "    default_set_id: 0x0003;\n"
+    "    feature_ids: [ 0x0005 ];\n"
+    "}\n";
+
+// Switch 0x03 calls switch 0x02 as a procedure, whichever set it selects.
+static constexpr const char* str_YAGL_procedure =
+    "switch<Trains, 0x02, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x60, 0x05] & 0x000000FF;\n"
+    "\n"
+    "        value2 = variable[0x40] & 0x000000FF;\n"
+    "        value1 = Addition(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "    };\n"
+    "    default: 0x8000;\n"
+    "}\n"
+    "switch<Trains, 0x03, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x7E, 0x02] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000001: 0x8001;\n"
+    "    };\n"
+    "    default: 0x8002;\n"
+    "}\n";
+
+} // namespace {
+
+
+TEST_CASE("ChainCostAnalyser", "[graph]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL);
+
+    ChainCostAnalyser analyser{grf_data.data_records()};
+
+    // The storage switch is reached from half of the branches of the callback switch.
+    auto cost = analyser.cost(2);
+    CHECK(cost.worst.variables == 3);
+    CHECK(cost.worst.parameterised == 2);
+    CHECK(cost.worst.storage == 2);
+    CHECK(cost.average.variables == 2);
+    CHECK(cost.average.storage == 1);
+
+    ChainBudgets budgets;
+    budgets.variables = 2;
+    std::ostringstream os;
+    CHECK(analyser.report(os, budgets) == 1);
+
+    std::string report = os.str();
+    CHECK(report.find("#4 Trains [0x0005] default callback 0x0136:  variables   3 /   3.00  parameterised   2 /   2.00  storage   2 /   2.00  OVER BUDGET: variables\n") != std::string::npos);
+    CHECK(report.find("#4 Trains [0x0005] default other callbacks:  variables   1 /   1.00") != std::string::npos);
+}
+
+
+TEST_CASE("ChainCostAnalyser procedures", "[graph]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL_procedure);
+
+    ChainCostAnalyser analyser{grf_data.data_records()};
+    auto cost = analyser.cost(1);
+    CHECK(cost.worst.variables == 3);
+    CHECK(cost.worst.parameterised == 2);
+    CHECK(cost.average.variables == 3);
+    CHECK(cost.average.parameterised == 2);
+}
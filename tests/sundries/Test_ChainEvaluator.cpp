@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "ChainEvaluator.h"
+#include "NewGRFData.h"
+#include "Test_GRFHelpers.h"
+#include <sstream>
+
+
+namespace {
+
+// A switch on the callback, one branch of which stores a 60+x variable in temporary storage
+// and reads it back.
+static constexpr const char* str_YAGL =
+    "sprite_groups<Trains, 0x01>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "switch<Trains, 0x02, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x60, 0x05] & 0x000000FF;\n"
+    "        value2 = variable[0x1A] & 0x00000007;\n"
+    "        value1 = TempStore(value1, value2);\n"
+    "        value2 = variable[0x7D, 0x07] & 0x000000FF;\n"
+    "        value1 = Addition(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000002: 0x0001;\n"
+    "    };\n"
+    "    default: 0x8010;\n"
+    "}\n"
+    "switch<Trains, 0x03, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x0C] & 0x0000FFFF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000036: 0x0002;\n"
+    "    };\n"
+    "    default: 0x8001;\n"
+    "}\n"
+    "feature_graphics<Trains>\n"
+    "{\n"
+    "    livery_override: false;\n"
+    "    default_set_id: 0x0003;\n"
+    "    feature_ids: [ 0x0005 ];\n"
+    "}\n";
+
+
+
+// Switch 0x02 stores 9 in register 3 and reads it back through variable 7B, with the register
+// as the running value. Switch 0x04 reads the last value through variable 7B. The first range
+// of each is selected if a variable is not available. Switch 0x05 calculates a failed callback.
+static constexpr const char* str_YAGL_indirect =
+    "switch<Trains, 0x04, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x7B, 0x1C] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000: 0x8001;\n"
+    "        0x00000009: 0x8004;\n"
+    "    };\n"
+    "    default: 0x8002;\n"
+    "}\n"
+    "switch<Trains, 0x02, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x1A] & 0x00000009;\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x00000003;\n"
+    "        value1 = TempStore(value1, value2);\n"
+    "\n"
+    "        value2 = variable[0x1A] & 0x00000003;\n"
+    "        value1 = Assign(value1, value2);\n"
+    "\n"
+    "        value2 = variable[0x7B, 0x7D] & 0x000000FF;\n"
+    "        value1 = Assign(value1, value2);\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000000: 0x8001;\n"
+    "        0x00000009: 0x0004;\n"
+    "    };\n"
+    "    default: 0x8002;\n"
+    "}\n"
+    "feature_graphics<Trains>\n"
+    "{\n"
+    "    livery_override: false;\n"
+    "    default_set_id: 0x0002;\n"
+    "    feature_ids: [ 0x0005 ];\n"
+    "}\n"
+    "switch<Trains, 0x05, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x1A] & 0x0000FFFF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "    };\n"
+    "    default: 0x8002;\n"
+    "}\n"
+    "feature_graphics<Trains>\n"
+    "{\n"
+    "    livery_override: false;\n"
+    "    default_set_id: 0x0005;\n"
+    "    feature_ids: [ 0x0006 ];\n"
+    "}\n";
+
+ChainEvaluator::Environment parse_env(const char* json)
+{
+    std::istringstream is(json);
+    TokenStream ts{is};
+    return ChainEvaluator::Environment::parse(ts);
+}
+
+} // namespace {
+
+
+TEST_CASE("ChainEvaluator", "[graph]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL);
+
+    using Kind = ChainEvaluator::Result::Kind;
+    ChainEvaluator evaluator{grf_data.data_records()};
+
+    auto env = parse_env("{ \"feature\": \"Trains\", \"feature_id\": 5, \"variables\": { \"0x0C\": 54, \"0x60:0x05\": 1 } }");
+    std::vector<uint32_t> trace;
+    auto result = evaluator.evaluate(env, trace);
+    CHECK(result.kind == Kind::SpriteGroup);
+    CHECK(result.value == 0);
+    CHECK(result.last_value == 2);
+    CHECK(result.instructions == 6);
+    CHECK(trace == std::vector<uint32_t>{ 2, 1 });
+
+    env.variables[{ 0x60, 0x05 }] = 3;
+    result = evaluator.evaluate(env);
+    CHECK(result.kind == Kind::Callback);
+    CHECK(result.value == 0x10);
+
+    // The set of the first range is used if a variable is not available.
+    env.variables.erase({ 0x60, 0x05 });
+    result = evaluator.evaluate(env);
+    CHECK(result.kind == Kind::SpriteGroup);
+    CHECK(result.last_value == 0x36);
+
+    env.variables[{ 0x0C, 0x00 }] = 0x10;
+    result = evaluator.evaluate(env);
+    CHECK(result.kind == Kind::Callback);
+    CHECK(result.value == 0x01);
+
+    env.feature_id = 6;
+    CHECK(evaluator.evaluate(env).kind == Kind::NoChain);
+
+    // Both paths from the callback are taken with random values for the other variables.
+    env.feature_id = 5;
+    env.variables.clear();
+    env.variables[{ 0x0C, 0x00 }] = 0x36;
+    std::ostringstream os;
+    evaluator.fuzz(os, env, 1000);
+    CHECK(os.str().find("Evaluations: 1000 in") != std::string::npos);
+    CHECK(os.str().find("callback 0x0010") != std::string::npos);
+    CHECK(os.str().find("#1 sprite_groups 0x01") != std::string::npos);
+}
+
+
+TEST_CASE("ChainEvaluator indirect", "[graph]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL_indirect);
+
+    using Kind = ChainEvaluator::Result::Kind;
+    ChainEvaluator evaluator{grf_data.data_records()};
+
+    // Storage and the last value are read through variable 7B without the environment.
+    auto env = parse_env("{ \"feature\": \"Trains\", \"feature_id\": 5 }");
+    auto result = evaluator.evaluate(env);
+    CHECK(result.kind == Kind::Callback);
+    CHECK(result.value == 0x04);
+
+    // A calculated result of 0xFFFF is a failed callback, which is not masked.
+    env.feature_id = 6;
+    result = evaluator.evaluate(env);
+    CHECK(result.kind == Kind::Callback);
+    CHECK(result.value == 0xFFFF);
+    std::ostringstream os;
+    evaluator.print_result(os, result);
+    CHECK(os.str() == "callback failed");
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "EnumDescriptor.h"
+#include "BitfieldDescriptor.h"
+#include "TokenStream.h"
+#include <sstream>
+
+
+namespace {
+
+
+enum class Colour : uint32_t { Red = 0, Green = 1, Blue = 7, Far = 0x12345678 };
+
+
+const EnumDescriptorT<Colour> desc_colour =
+{
+    0x00, "colour",
+    {
+        { 0x00,       "Red" },
+        { 0x01,       "Green" },
+        { 0x07,       "Blue" },
+        { 0x07,       "Azure" },   // Duplicate value: the first name is printed.
+        { 0x12345678, "Far" },     // Too large to index directly.
+    }
+};
+
+
+const BitfieldDescriptorT<uint8_t> desc_flags =
+{
+    0x00, "flags",
+    {
+        { 0x01, "One" },
+        { 0x04, "Four" },
+        { 0x80, "High" },
+    }
+};
+
+
+template <typename Desc, typename T>
+T parse_value(const Desc& desc, const std::string& text)
+{
+    std::istringstream is(text);
+    TokenStream ts{is};
+    T value{};
+    desc.parse(value, ts);
+    return value;
+}
+
+
+} // namespace {
+
+
+TEST_CASE("EnumDescriptor", "[descriptors]")
+{
+    CHECK(std::string{desc_colour.value(Colour::Red)} == "Red");
+    CHECK(std::string{desc_colour.value(Colour::Blue)} == "Blue");
+    CHECK(std::string{desc_colour.value(Colour::Far)} == "Far");
+    CHECK_THROWS(desc_colour.value(static_cast<Colour>(2)));
+    CHECK_THROWS(desc_colour.value(static_cast<Colour>(0x12345679)));
+
+    std::ostringstream os;
+    desc_colour.print(Colour::Green, os, 4);
+    CHECK(os.str() == "    colour: Green;\n");
+
+    CHECK(parse_value<EnumDescriptorT<Colour>, Colour>(desc_colour, "Azure") == Colour::Blue);
+    CHECK(parse_value<EnumDescriptorT<Colour>, Colour>(desc_colour, "Far") == Colour::Far);
+    CHECK_THROWS(parse_value<EnumDescriptorT<Colour>, Colour>(desc_colour, "Purple"));
+}
+
+
+TEST_CASE("BitfieldDescriptor", "[descriptors]")
+{
+    std::ostringstream os;
+    desc_flags.print(0x85, os, 0);
+    CHECK(os.str() == "flags: One | Four | High;\n");
+
+    CHECK(parse_value<BitfieldDescriptorT<uint8_t>, uint8_t>(desc_flags, "High | One") == 0x81);
+}
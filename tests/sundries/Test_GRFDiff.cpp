@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "GRFDiff.h"
+#include "GRFGenerator.h"
+#include "NewGRFData.h"
+#include <sstream>
+
+
+namespace {
+
+std::unique_ptr<NewGRFData> generate(const GRFGenerator::Config& config)
+{
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    auto grf_data = std::make_unique<NewGRFData>();
+    grf_data->read(grf);
+    return grf_data;
+}
+
+} // namespace {
+
+
+TEST_CASE("GRFDiff", "[diff]")
+{
+    GRFGenerator::Config config;
+    config.instances = 16;
+    config.strings   = 16;
+    config.sprites   = 1;
+    auto grf_data1 = generate(config);
+
+    // A third Action00 record comes before the strings.
+    config.instances = 24;
+    auto grf_data2 = generate(config);
+
+    // The image of the sprite is changed.
+    config.transparency = 0.25;
+    auto grf_data3 = generate(config);
+
+    std::ostringstream os;
+    diff_grfs(*grf_data1, *grf_data1, os);
+    CHECK(os.str() == "Records:   6 => 6\nUnchanged: 6\nChanged:   0\nRemoved:   0\nAdded:     0\n");
+
+    os.str("");
+    diff_grfs(*grf_data1, *grf_data2, os);
+    std::string diff = os.str();
+    CHECK(diff.find("Records:   6 => 7\nUnchanged: 6\nChanged:   0\nRemoved:   0\nAdded:     1\n") == 0);
+    CHECK(diff.find("\nAdded record #4\n+ properties<Trains, 0x0010> // Action00\n") != std::string::npos);
+    CHECK(diff.find("\n- ") == std::string::npos);
+
+    os.str("");
+    diff_grfs(*grf_data2, *grf_data3, os);
+    diff = os.str();
+    CHECK(diff.find("Records:   7 => 7\nUnchanged: 6\nChanged:   1\nRemoved:   0\nAdded:     0\n") == 0);
+    CHECK(diff.find("\nChanged record #7 => #7\n") != std::string::npos);
+}
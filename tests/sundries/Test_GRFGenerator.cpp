@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "GRFGenerator.h"
+#include "NewGRFData.h"
+#include <sstream>
+
+
+namespace {
+
+// A generated GRF should be read and written again without any changes, which also
+// confirms that the generator writes GRFs in the same way as yagl.
+void test_round_trip(const GRFGenerator::Config& config)
+{
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+
+    NewGRFData grf_data;
+    grf_data.read(grf);
+    std::stringstream os;
+    grf_data.write(os);
+
+    CHECK(os.str() == grf.str());
+}
+
+} // namespace {
+
+
+TEST_CASE("GRFGenerator round trip", "[generator]")
+{
+    GRFGenerator::Config config;
+    config.instances = 20;
+    config.strings   = 40;
+    config.switches  = 5;
+    config.sprites   = 20;
+
+    SECTION("Container1")
+    {
+        config.format = GRFFormat::Container1;
+        test_round_trip(config);
+    }
+
+    SECTION("Container2")
+    {
+        config.zooms  = { GRFGenerator::ZoomLevel::Normal, GRFGenerator::ZoomLevel::ZoomInX2 };
+        config.colour = GRFGenerator::Colour::RGBAMask;
+        config.graphics = true;
+        test_round_trip(config);
+    }
+}
+
+
+TEST_CASE("GRFGenerator seed", "[generator]")
+{
+    GRFGenerator::Config config;
+    config.sprites = 10;
+
+    auto generate = [&config]()
+    {
+        std::stringstream os;
+        GRFGenerator{config}.write(os);
+        return os.str();
+    };
+
+    std::string first = generate();
+    CHECK(generate() == first);
+    config.seed = 2;
+    CHECK(generate() != first);
+
+    config.format = GRFFormat::Container1;
+    config.colour = GRFGenerator::Colour::RGBA;
+    CHECK_THROWS(GRFGenerator{config});
+}
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "GRFSpecialiser.h"
+#include "NewGRFData.h"
+#include "Action07Record.h"
+#include "Test_GRFHelpers.h"
+#include <sstream>
+
+
+namespace {
+
+// Skips on parameter 1, which is calculated from parameter 0, on the climate, on a value patched
+// by an Action06, and on an unknown variable around a skip which is always taken.
+static constexpr const char* str_YAGL =
+    "set_parameter\n"
+    "{\n"
+    "    target: 0x01;\n"
+    "    operation: 0x01;\n"
+    "    source1: 0x00;\n"
+    "    source2: 0xFF;\n"
+    "    data_value: 0x00000001;\n"
+    "}\n"
+    "if_act7 (is_equal(param[0x01] & 0xFF, 0x03))\n"
+    "{\n"
+    "    skip_sprites: 0x01;\n"
+    "}\n"
+    "sprite_groups<Trains, 0x01>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "if_act9 (is_equal(param[0x01] & 0xFF, 0x03))\n"
+    "{\n"
+    "    skip_sprites: 0x01;\n"
+    "}\n"
+    "set_parameter\n"
+    "{\n"
+    "    target: 0x02;\n"
+    "    operation: 0x00;\n"
+    "    source1: 0xFF;\n"
+    "    source2: 0x00;\n"
+    "    data_value: 0x00000005;\n"
+    "}\n"
+    "if_act7 (is_equal(global_var[0x83] & 0xFF, 0x02))\n"
+    "{\n"
+    "    skip_sprites: 0x01;\n"
+    "}\n"
+    "sprite_groups<Trains, 0x02>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "modify_next\n"
+    "{\n"
+    "    modification(parameter[0x00], 1, 4, false);\n"
+    "}\n"
+    "if_act7 (is_equal(param[0x00] & 0xFF, 0x00))\n"
+    "{\n"
+    "    skip_sprites: 0x01;\n"
+    "}\n"
+    "sprite_groups<Trains, 0x03>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "if_act7 (is_equal(global_var[0x85] & 0xFF, 0x00))\n"
+    "{\n"
+    "    skip_sprites: 0x03;\n"
+    "}\n"
+    "if_act7 (is_bit_set(param[0x00] & 0xFF, 1 << 1))\n"
+    "{\n"
+    "    skip_sprites: 0x01;\n"
+    "}\n"
+    "sprite_groups<Trains, 0x04>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "sprite_groups<Trains, 0x05>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n";
+
+
+
+GRFSpecialiser::Profile parse_profile(const char* json)
+{
+    std::istringstream is(json);
+    TokenStream ts{is};
+    return GRFSpecialiser::Profile::parse(ts);
+}
+
+
+std::vector<RecordType> record_types(const NewGRFData& grf_data)
+{
+    std::vector<RecordType> types;
+    for (const auto record: grf_data.data_records())
+        types.push_back(record->record_type());
+    return types;
+}
+
+} // namespace {
+
+
+TEST_CASE("GRFSpecialiser", "[specialise]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL);
+    grf_data.specialise(parse_profile("{ \"parameters\": [ 2 ], \"variables\": { \"0x83\": 1 } }"));
+
+    // The skip on the unknown variable remains, and now skips only the last sprite group.
+    auto records = grf_data.data_records();
+    CHECK(record_types(grf_data) == std::vector<RecordType>{ RecordType::ACTION_0D,
+        RecordType::ACTION_02_BASIC, RecordType::ACTION_07, RecordType::ACTION_02_BASIC });
+    REQUIRE(records.size() == 4);
+    CHECK(static_cast<const Action07Record*>(records[2])->num_sprites() == 1);
+
+    // Without the climate, the skip on it remains.
+    NewGRFData grf_data2;
+    parse_yagl(grf_data2, str_YAGL);
+    grf_data2.specialise(parse_profile("{ \"parameters\": [ 2 ] }"));
+    CHECK(grf_data2.data_records().size() == 5);
+
+    // Parameter 1 is not 3, so the records after the first two skips are kept.
+    NewGRFData grf_data3;
+    parse_yagl(grf_data3, str_YAGL);
+    grf_data3.specialise(parse_profile("{ \"parameters\": [ 0x10 ], \"variables\": { \"0x83\": 1 } }"));
+    CHECK(record_types(grf_data3) == std::vector<RecordType>{ RecordType::ACTION_0D,
+        RecordType::ACTION_02_BASIC, RecordType::ACTION_0D, RecordType::ACTION_02_BASIC, RecordType::ACTION_07,
+        RecordType::ACTION_02_BASIC, RecordType::ACTION_02_BASIC });
+    REQUIRE(grf_data3.data_records().size() == 7);
+    CHECK(static_cast<const Action07Record*>(grf_data3.data_records()[4])->num_sprites() == 2);
+}
+
+
+TEST_CASE("GRFSpecialiser labels", "[specialise]")
+{
+    // A jump back to a label cannot be followed, so nothing is changed.
+    static constexpr const char* str_loop =
+        "label<0x05>\n"
+        "{\n"
+        "}\n"
+        "if_act7 (is_grf_activated(\"ABCD\", 0xFFFFFFFF))\n"
+        "{\n"
+        "    skip_sprites: 0x05;\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_loop);
+    grf_data.specialise(parse_profile("{ \"grfs\": [ \"ABCD\" ] }"));
+    CHECK(grf_data.data_records().size() == 2);
+
+    // A jump forward to a label which is never taken is removed.
+    static constexpr const char* str_jump =
+        "if_act7 (is_grf_activated(\"ABCD\", 0xFFFFFFFF))\n"
+        "{\n"
+        "    skip_sprites: 0x05;\n"
+        "}\n"
+        "sprite_groups<Trains, 0x01>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n"
+        "label<0x05>\n"
+        "{\n"
+        "}\n";
+
+    NewGRFData grf_data2;
+    parse_yagl(grf_data2, str_jump);
+    grf_data2.specialise(parse_profile("{ \"grfs\": [ \"WXYZ\" ] }"));
+    CHECK(record_types(grf_data2) == std::vector<RecordType>{ RecordType::ACTION_02_BASIC, RecordType::ACTION_10 });
+
+    NewGRFData grf_data3;
+    parse_yagl(grf_data3, str_jump);
+    grf_data3.specialise(parse_profile("{ \"grfs\": [ \"ABCD\" ] }"));
+    CHECK(record_types(grf_data3) == std::vector<RecordType>{ RecordType::ACTION_10 });
+}
+
+
+TEST_CASE("GRFSpecialiser unlisted GRF", "[specialise]")
+{
+    // The GRF tested may not be in the configuration at all, in which case the game does not
+    // skip, so the records are kept. If the GRF is listed as active, the skip is never taken.
+    static constexpr const char* str_not_active =
+        "if_act7 (is_grf_not_activated(\"ABCD\", 0xFFFFFFFF))\n"
+        "{\n"
+        "    skip_sprites: 0x01;\n"
+        "}\n"
+        "sprite_groups<Trains, 0x01>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_not_active);
+    grf_data.specialise(parse_profile("{ \"grfs\": [ \"WXYZ\" ] }"));
+    CHECK(record_types(grf_data) == std::vector<RecordType>{ RecordType::ACTION_07, RecordType::ACTION_02_BASIC });
+
+    NewGRFData grf_data2;
+    parse_yagl(grf_data2, str_not_active);
+    grf_data2.specialise(parse_profile("{ \"grfs\": [ \"ABCD\" ] }"));
+    CHECK(record_types(grf_data2) == std::vector<RecordType>{ RecordType::ACTION_02_BASIC });
+}
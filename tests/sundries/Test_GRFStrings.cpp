@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "GRFStrings.h"
+#include "TokenStream.h"
+#include <sstream>
+
+
+namespace {
+
+
+std::string decode(const std::string& binary)
+{
+    std::istringstream is{binary};
+    GRFString str;
+    str.read(is, StringTerm::None);
+    return str.readable();
+}
+
+
+std::string encode(const std::string& readable)
+{
+    std::istringstream is{"\"" + readable + "\""};
+    TokenStream ts{is};
+    GRFString str;
+    str.parse(ts);
+    std::ostringstream os;
+    str.write(os, StringTerm::None);
+    return os.str();
+}
+
+
+void check_round_trip(const std::string& binary, const std::string& readable)
+{
+    CHECK(decode(binary) == readable);
+    CHECK(encode(readable) == binary);
+}
+
+
+} // namespace {
+
+
+TEST_CASE("GRFString plain text", "[strings]")
+{
+    check_round_trip("", "");
+    check_round_trip("Coal Mine", "Coal Mine");
+    check_round_trip("A string which is long enough to be scanned in several words (1.2.3)",
+        "A string which is long enough to be scanned in several words (1.2.3)");
+}
+
+
+TEST_CASE("GRFString control codes", "[strings]")
+{
+    // Latin1 strings.
+    check_round_trip("\x88" "Coal\x0D" "Mine", "{blue}Coal{new-line}Mine");
+    check_round_trip("Say \x22hello\x22", "Say {dq}hello{dq}");
+    check_round_trip("\x7B\x7C\x7D\x7E\x7F", "{sd}{sw}{sb}{uw}{sd-currency}");
+
+    // Arguments are sign extended.
+    check_round_trip("\x01\x05" "x", "{x-off 0x0005}x");
+    check_round_trip("\x1F\x85\x7F", "{xy-offs 0xFF85 0x007F}");
+    check_round_trip("\x01\xFF", "{x-off 0xFFFF}");
+
+    // Extension codes.
+    check_round_trip("\x9A\x1F" "x" "\x9A\x20", "{ext push-colour}x{ext pop-colour}");
+    check_round_trip("\x9A\x03\x34\x12", "{ext push-w 0x0034 0x0012}");
+
+    // Arguments which run off the end of the string are zero.
+    CHECK(decode("\x1F\x01") == "{xy-offs 0x0001 0x0000}");
+}
+
+
+TEST_CASE("GRFString UTF-8", "[strings]")
+{
+    // Strings are UTF-8 if they begin with a thorn.
+    check_round_trip("\xC3\x9E" "f\xC3\xBCr \xEE\x82\x88" "Gr\xC3\xB6\xC3\x9F" "e\x0D",
+        "f\xC3\xBCr {blue}Gr\xC3\xB6\xC3\x9F" "e{new-line}");
+    check_round_trip("\xC3\x9E" "\xE7\x85\xA4\xEE\x82\x9A\x1F" "x\xEE\x80\xA2",
+        "\xE7\x85\xA4{ext push-colour}x{dq}");
+
+    // Invalid UTF-8 sequences are treated as Latin1 bytes.
+    CHECK(decode("\xC3\x9E" "\x88" "x") == "{blue}x");
+    // Characters outside the basic multilingual plane are stored as surrogate pairs.
+    check_round_trip("\xC3\x9E" "\xED\xA0\xBD\xED\xB8\x80", "\xF0\x9F\x98\x80");
+    CHECK_THROWS(decode("\xC3\x9E" "\xF0\x9F\x98\x80"));
+
+    // Literal braces are only distinct from control codes in UTF-8 strings.
+    CHECK(encode("a{{b}") == "\xC3\x9E" "a{b}");
+}
+
+
+TEST_CASE("GRFString errors", "[strings]")
+{
+    CHECK_THROWS(encode("{unknown}"));
+    CHECK_THROWS(encode("{ blue}"));
+    CHECK_THROWS(encode("{blue 0x01}"));
+    CHECK_THROWS(encode("{x-off}"));
+    CHECK_THROWS(encode("{ext unknown}"));
+    CHECK_THROWS(encode("{ext push-w 0x01}"));
+    CHECK_THROWS(encode("a\x80"));
+    CHECK_THROWS(decode("\x9A\xFF"));
+}
+
+
+TEST_CASE("GRFString pool", "[strings]")
+{
+    StringPool& pool = StringPool::pool();
+    StringPool::Stats before = pool.stats();
+
+    // Identical strings share one entry, however they were created.
+    const std::string binary{"\x88" "Pooled\x0D" "string"};
+    const StringPool::Entry* read1 = pool.intern(binary);
+    const StringPool::Entry* read2 = pool.intern(binary);
+    const StringPool::Entry* parse = pool.intern_readable("{blue}Pooled{new-line}string");
+    CHECK(read1 == read2);
+    CHECK(read1 == parse);
+    CHECK(pool.intern_readable("{blue}Pooled{new-line}string") == parse);
+
+    // The readable form is converted once.
+    CHECK(&read1->readable() == &read2->readable());
+    CHECK(read1->readable() == "{blue}Pooled{new-line}string");
+
+    StringPool::Stats after = pool.stats();
+    CHECK(after.strings - before.strings == 4);
+    CHECK(after.unique - before.unique == 1);
+    CHECK(after.bytes - before.bytes == 4 * binary.size());
+    CHECK(after.unique_bytes - before.unique_bytes == binary.size());
+    CHECK(after.conversions - before.conversions == 2);
+
+    CHECK(GRFString{}.length() == 0);
+}
+
+
+TEST_CASE("GRFString pool scope", "[strings]")
+{
+    // Strings go into the pool of the innermost scope, and the shared pool is not affected.
+    StringPool::Stats before = StringPool::pool().stats();
+    StringPool outer;
+    StringPool inner;
+    {
+        StringPool::Scope outer_scope{outer};
+        std::istringstream is{std::string{"Outer\0", 6}};
+        GRFString str;
+        str.read(is);
+        {
+            StringPool::Scope inner_scope{inner};
+            CHECK(&StringPool::pool() == &inner);
+            std::istringstream is{std::string{"Inner\0", 6}};
+            GRFString str;
+            str.read(is);
+        }
+        CHECK(&StringPool::pool() == &outer);
+    }
+
+    CHECK(outer.stats().strings == 1);
+    CHECK(inner.stats().strings == 1);
+    CHECK(StringPool::pool().stats().strings == before.strings);
+}
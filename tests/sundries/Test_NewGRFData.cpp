@@ -0,0 +1,402 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "NewGRFData.h"
+#include "GRFGenerator.h"
+#include "Test_GRFHelpers.h"
+#include "Version.h"
+#include "FileSystem.h"
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+
+namespace {
+
+static constexpr const char* str_YAGL =
+    "grf // Action08\n"
+    "{\n"
+    "    grf_id: \"ABCD\";\n"
+    "    version: GRF8;\n"
+    "    name: \"Dutch Trainset\";\n"
+    "    description: \"{lt-gray}Dutch Trains for OpenTTD\";\n"
+    "}\n"
+    "strings<Trains, en_GB, 0xD098*> // <feature, language, first_id> Action04, English (GB)\n"
+    "{\n"
+    "    /* 0xD098 */ \"{black}StringA\";\n"
+    "    /* 0xD099 */ \"{black}StringB\";\n"
+    "}\n";
+
+
+std::string make_yagl(const char* format)
+{
+    std::ostringstream os;
+    os << "yagl_version: \"" << str_yagl_version << "\";\n";
+    os << "grf_format: " << format << ";\n";
+    // Plenty of records so that parse() spreads them over several tasks.
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        os << str_YAGL;
+    }
+    return os.str();
+}
+
+
+// Streaming the encode should give exactly the same GRF as parsing everything first.
+// This also compares the concurrent parse with the sequential parse used for streaming.
+void test_stream_encode(const char* format)
+{
+    std::istringstream is(make_yagl(format));
+    TokenStream ts{is};
+    NewGRFData grf_data;
+    grf_data.parse(ts, "", "");
+    std::ostringstream os;
+    grf_data.write(os);
+
+    std::string spool_file = (fs::temp_directory_path() / "yagl_test.grf.spool").string();
+    std::istringstream is2(make_yagl(format));
+    TokenStream ts2{is2};
+    NewGRFData grf_data2;
+    std::stringstream os2;
+    grf_data2.stream_encode(ts2, os2, spool_file);
+
+    CHECK(os.str() == os2.str());
+    CHECK(!fs::exists(spool_file));
+}
+
+} // namespace {
+
+
+TEST_CASE("NewGRFData stream encode", "[grf]")
+{
+    SECTION("Container1")
+    {
+        test_stream_encode("Container1");
+    }
+
+    SECTION("Container2")
+    {
+        test_stream_encode("Container2");
+    }
+}
+
+
+TEST_CASE("NewGRFData stream encode sprites", "[grf]")
+{
+    // Real sprites go through the spool file, which is only used for Container2. A sprite
+    // referred to twice is spooled once, and each sheet is released after its last use.
+    ScopedTestDir dir{"yagl_test_stream"};
+
+    GRFGenerator::Config config;
+    config.instances = 10;
+    config.strings   = 10;
+    config.sprites   = 30;
+    config.graphics  = true;
+
+    SECTION("Container1")
+    {
+        config.format = GRFFormat::Container1;
+    }
+
+    SECTION("Container2")
+    {
+        config.zooms  = { GRFGenerator::ZoomLevel::Normal, GRFGenerator::ZoomLevel::ZoomInX2 };
+        config.colour = GRFGenerator::Colour::RGBAMask;
+    }
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    std::string base_name = (config.format == GRFFormat::Container1) ? "stream1" : "stream2";
+    std::string yagl = decode_grf(grf.str(), base_name);
+    std::string expected = encode_yagl(yagl);
+
+    std::string spool_file = (fs::current_path() / "yagl_test.grf.spool").string();
+    std::istringstream is(yagl);
+    TokenStream ts{is};
+    NewGRFData grf_data;
+    std::stringstream os;
+    grf_data.stream_encode(ts, os, spool_file);
+
+    CHECK(os.str() == expected);
+    CHECK(!fs::exists(spool_file));
+}
+
+
+TEST_CASE("NewGRFData merged sprites", "[grf]")
+{
+    // After --optimise merges identical sprites, each reference to a merged sprite repeats its
+    // images in the YAGL. Encoding must store them once, whether streamed or not.
+    ScopedTestDir dir{"yagl_test_merged"};
+
+    GRFGenerator::Config config;
+    config.instances = 10;
+    config.strings   = 10;
+    config.sprites   = 20;
+    config.distinct  = 5;
+    config.graphics  = true;
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    NewGRFData grf_data;
+    grf_data.read(grf);
+    grf_data.optimise();
+
+    std::stringstream expected;
+    grf_data.write(expected);
+    std::ostringstream yagl;
+    grf_data.print(yagl, "sprites", "sprites/merged");
+
+    CHECK(encode_yagl(yagl.str()) == expected.str());
+
+    std::string spool_file = (fs::current_path() / "yagl_test.grf.spool").string();
+    std::istringstream is(yagl.str());
+    TokenStream ts{is};
+    NewGRFData grf_data2;
+    std::stringstream os;
+    grf_data2.stream_encode(ts, os, spool_file);
+    CHECK(os.str() == expected.str());
+}
+
+
+TEST_CASE("NewGRFData repeated images", "[grf]")
+{
+    // Identical images are placed once in the sheets, and every sprite which uses them refers
+    // to the same rectangle. Encoding reads each rectangle once and gives back the same GRF.
+    ScopedTestDir dir{"yagl_test_repeated"};
+
+    GRFGenerator::Config config;
+    config.instances = 0;
+    config.strings   = 0;
+    config.sprites   = 20;
+    config.distinct  = 5;
+    config.graphics  = true;
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    std::string yagl = decode_grf(grf.str(), "repeated");
+
+    // Each sprite line ends with the sheet and the position of the rectangle.
+    std::map<std::string, uint32_t> rects;
+    std::istringstream is(yagl);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        auto pos = line.find(".png\", [");
+        if (pos != std::string::npos)
+            ++rects[line.substr(line.rfind('"', pos))];
+    }
+    REQUIRE(rects.size() == 5);
+    for (const auto& it: rects)
+    {
+        CHECK(it.second == 4);
+    }
+
+    CHECK(encode_yagl(yagl) == grf.str());
+}
+
+
+TEST_CASE("NewGRFData sprite stats", "[grf]")
+{
+    // The ratios are written with three decimal places, as fractions of the original size.
+    auto field = [](const std::string& line, const std::string& name)
+    {
+        auto pos = line.find("\"" + name + "\": ");
+        REQUIRE(pos != std::string::npos);
+        return std::stod(line.substr(pos + name.size() + 4));
+    };
+    auto ratio = [](double numerator, double denominator)
+    {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(3) << (numerator / denominator);
+        return std::stod(os.str());
+    };
+
+    GRFGenerator::Config config;
+    config.instances = 0;
+    config.strings   = 0;
+    config.sprites   = 10;
+    std::string category;
+
+    SECTION("Opaque")
+    {
+        // Images with no transparency are not chunked.
+        config.transparency = 0.0;
+        category = "8bpp-normal";
+    }
+
+    SECTION("Transparent")
+    {
+        config.colour       = GRFGenerator::Colour::RGBA;
+        config.transparency = 0.5;
+        category = "32bpp-normal";
+    }
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    NewGRFData grf_data;
+    grf_data.read(grf);
+
+    std::ostringstream os;
+    grf_data.stats(os);
+    std::string json = os.str();
+    auto start = json.find("\"" + category + "\": {");
+    REQUIRE(start != std::string::npos);
+    std::string line = json.substr(start, json.find('\n', start) - start);
+
+    double pixel_bytes      = field(line, "pixel_bytes");
+    double chunked_bytes    = field(line, "chunked_bytes");
+    double compressed_bytes = field(line, "compressed_bytes");
+    CHECK(field(line, "sprites") == 10);
+    CHECK(compressed_bytes < chunked_bytes);
+    if (config.transparency == 0.0)
+        CHECK(chunked_bytes == pixel_bytes);
+    else
+        CHECK(chunked_bytes < pixel_bytes);
+
+    CHECK(field(line, "chunk_ratio") == ratio(chunked_bytes, pixel_bytes));
+    CHECK(field(line, "lz77_ratio") == ratio(compressed_bytes, chunked_bytes));
+    CHECK(field(line, "ratio") == ratio(compressed_bytes, pixel_bytes));
+}
+
+
+TEST_CASE("NewGRFData parse errors", "[grf]")
+{
+    std::string yagl = make_yagl("Container2");
+
+    // Break one record in the middle, and leave an incomplete record at the end.
+    yagl.replace(yagl.find("grf_id", yagl.size() / 2), 6, "grf_xx");
+    yagl += "strings<Trains, en_GB, 0xD098*>\n";
+
+    std::istringstream is(yagl);
+    TokenStream ts{is};
+    NewGRFData grf_data;
+    CHECK_THROWS(grf_data.parse(ts, "", ""));
+}
+
+
+TEST_CASE("NewGRFData stats", "[grf]")
+{
+    std::istringstream is(make_yagl("Container2"));
+    TokenStream ts{is};
+    NewGRFData grf_data;
+    grf_data.parse(ts, "", "");
+
+    std::ostringstream os;
+    grf_data.stats(os);
+    std::string json = os.str();
+
+    // Each Action04 has a 6 byte header followed by two 9 byte strings.
+    CHECK(json.find("\"format\": \"Container2\"") != std::string::npos);
+    CHECK(json.find("\"records\": 400,") != std::string::npos);
+    CHECK(json.find("\"strings\": { \"count\": 200, \"bytes\": 4800 }") != std::string::npos);
+    CHECK(json.find("\"Trains\": { \"records\": 200, \"bytes\": 4800 }") != std::string::npos);
+
+    // The string pool counts are for this GRF alone, however many have been parsed.
+    std::istringstream is2(make_yagl("Container2"));
+    TokenStream ts2{is2};
+    NewGRFData grf_data2;
+    grf_data2.parse(ts2, "", "");
+
+    std::ostringstream os2;
+    grf_data2.stats(os2);
+    std::string json2 = os2.str();
+    std::string pool = json.substr(json.rfind("\"strings\": { \"count\""));
+    CHECK(pool == json2.substr(json2.rfind("\"strings\": { \"count\"")));
+    CHECK(pool.find("\"count\": 800,") != std::string::npos);
+}
+
+
+
+TEST_CASE("NewGRFData nfo", "[grf]")
+{
+    // Pseudo-sprites are written as hex, and each real sprite as a line for each zoom level
+    // referring to the sprite sheets, which are written first.
+    ScopedTestDir dir{"yagl_test_nfo"};
+
+    GRFGenerator::Config config;
+    config.instances = 0;
+    config.strings   = 0;
+    config.sprites   = 2;
+    config.graphics  = true;
+    config.zooms     = { GRFGenerator::ZoomLevel::Normal, GRFGenerator::ZoomLevel::ZoomInX2 };
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    NewGRFData grf_data;
+    grf_data.read(grf);
+
+    std::ostringstream os;
+    grf_data.nfo_dump(os, "sprites/nfo");
+
+    std::string expected = std::string{"// Automatically generated by yagl "} + str_yagl_version + ". Do not modify!\n"
+        "// (Info version 32)\n"
+        "// Format: spritenum imagefile depth xpos ypos xsize ysize xrel yrel zoom flags\n"
+        "    0 * 4\t 06 00 00 00\n"
+        "    1 * 42\t 08 08 59 41 47 4C 53 79 6E 74 68 65 74 69 63 20 47 52 46 00 "
+        "47 65 6E 65 72 61 74 65 64 20 62 79 20 79 61 67 6C 5F 67 65 6E 00\n"
+        "    2 * 6\t 01 00 01 FF 02 00\n"
+        "    3 nfo-8bpp-normal-0.png 8bpp 10 10 93 8 -46 -4 normal chunked\n"
+        "    | nfo-8bpp-zin2-0.png 8bpp 10 10 186 16 -93 -8 zi2 chunked\n"
+        "    4 nfo-8bpp-normal-0.png 8bpp 113 10 112 46 -56 -23 normal chunked\n"
+        "    | nfo-8bpp-zin2-0.png 8bpp 206 10 224 92 -112 -46 zi2 chunked\n"
+        "    5 * 7\t 02 00 00 01 00 00 00\n"
+        "    6 * 7\t 03 00 01 00 00 00 00\n";
+    CHECK(os.str() == expected);
+    CHECK(fs::exists("sprites/nfo-8bpp-normal-0.png"));
+    CHECK(fs::exists("sprites/nfo-8bpp-zin2-0.png"));
+}
+
+
+TEST_CASE("NewGRFData nfo sound effects", "[grf]")
+{
+    // Container2 files can store sound effects in the sprite section, where they are written
+    // as pseudo-sprites in place of the sprite reference.
+    ScopedTestDir dir{"yagl_test_nfo_sound"};
+    {
+        std::ofstream wav{"sprites/beep.wav", std::ios::binary};
+        wav << "RIFF";
+    }
+
+    std::string yagl =
+        "sound_effects // Action11\n"
+        "{\n"
+        "    sprite_id<0x00000001>\n"
+        "    {\n"
+        "        binary(\"sprites/beep.wav\");\n"
+        "    }\n"
+        "}\n";
+    NewGRFData encoded;
+    parse_yagl(encoded, yagl);
+    std::stringstream grf;
+    encoded.write(grf);
+
+    NewGRFData grf_data;
+    grf_data.read(grf);
+    std::ostringstream os;
+    grf_data.nfo_dump(os, "sprites/nfo");
+
+    std::string expected = std::string{"// Automatically generated by yagl "} + str_yagl_version + ". Do not modify!\n"
+        "// (Info version 32)\n"
+        "// Format: spritenum imagefile depth xpos ypos xsize ysize xrel yrel zoom flags\n"
+        "    0 * 4\t 02 00 00 00\n"
+        "    1 * 3\t 11 01 00\n"
+        "    2 * 15\t FF 08 62 65 65 70 2E 77 61 76 00 52 49 46 46\n";
+    CHECK(os.str() == expected);
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include <sstream>
+
+
+TEST_CASE("Profiler", "[profiler]")
+{
+    Profiler& profiler = Profiler::profiler();
+    profiler.enable();
+
+    {
+        ScopedTimer timer{"Test outer"};
+        ThreadPool pool{2};
+        std::vector<std::future<void>> results;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            results.push_back(pool.submit([]() { ScopedTimer timer{"Test inner"}; }));
+        }
+        for (auto& result: results)
+        {
+            result.get();
+        }
+
+        ScopedTimer stopped{"Test stopped"};
+        stopped.stop();
+    }
+
+    std::ostringstream trace;
+    profiler.write_trace(trace);
+    CHECK(trace.str().find("{\"traceEvents\":[") == 0);
+    CHECK(trace.str().find("\"name\":\"Test outer\"") != std::string::npos);
+    CHECK(trace.str().find("\"name\":\"Test inner\"") != std::string::npos);
+    CHECK(trace.str().find("\"args\":{\"name\":\"worker") != std::string::npos);
+    CHECK(trace.str().find("\"args\":{\"name\":\"main\"}") != std::string::npos);
+
+    std::ostringstream timings;
+    profiler.print_timings(timings);
+    std::istringstream is(timings.str());
+    std::string line;
+    uint32_t found = 0;
+    while (std::getline(is, line))
+    {
+        std::istringstream row(line);
+        std::string word1, word2;
+        uint32_t count = 0;
+        row >> word1 >> word2 >> count;
+        if (word1 != "Test") continue;
+        if (word2 == "outer")   { CHECK(count == 1); ++found; }
+        if (word2 == "inner")   { CHECK(count == 8); ++found; }
+        if (word2 == "stopped") { CHECK(count == 1); ++found; }
+    }
+    CHECK(found == 3);
+}
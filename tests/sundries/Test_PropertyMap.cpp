@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "Action00Feature.h"
+#include "properties/IntegerValue.h"
+#include "properties/SnowLine.h"
+#include "StreamHelpers.h"
+#include <sstream>
+
+
+namespace {
+
+
+using SnowLineProperty = Property<SnowLine>;
+
+
+class TestProperties : public FeatureProperties
+{
+    UInt8Property     m_prop_08{m_table, 0x08, "small_value"};
+    UInt8ListProperty m_prop_09{m_table, 0x09, "list_value"};
+    SnowLineProperty  m_prop_0A{m_table, 0x0A, "large_value"};
+};
+
+
+} // namespace {
+
+
+TEST_CASE("PropertyMap sparse storage", "[properties]")
+{
+    static_assert(PropertySlot::fits_inline<PropertyValue<UInt8>>());
+    static_assert(PropertySlot::fits_inline<PropertyValue<Vector<UInt8>>>());
+    static_assert(!PropertySlot::fits_inline<PropertyValue<SnowLine>>());
+
+    const PropertyTable& table = static_property_table<TestProperties>();
+    CHECK(&table == &static_property_table<TestProperties>());
+
+    PropertyMap map{table};
+    CHECK(map.num_values() == 0);
+
+    // Properties which were never set are written with their default values.
+    std::ostringstream os;
+    CHECK(map.write_property(os, 0x08));
+    CHECK(os.str() == std::string(1, '\0'));
+    CHECK(!map.write_property(os, 0x0B));
+    CHECK(map.num_values() == 0);
+
+    std::istringstream is{std::string{"\x12\x03\x01\x02\x03\x34", 6}};
+    CHECK(map.read_property(is, 0x08));
+    CHECK(map.read_property(is, 0x09));
+    CHECK(map.read_property(is, 0x08));
+    CHECK(map.num_values() == 2);
+    CHECK(map.num_heap_values() == 0);
+
+    // Enough values to force the slots to be relocated.
+    std::string snow(32 * 12, '\x05');
+    std::istringstream is2{snow};
+    CHECK(map.read_property(is2, 0x0A));
+    CHECK(map.num_values() == 3);
+    CHECK(map.num_heap_values() == 1);
+
+    // Duplicates share storage so the last value wins.
+    std::ostringstream os2;
+    map.write_property(os2, 0x08);
+    map.write_property(os2, 0x09);
+    CHECK(os2.str() == std::string{"\x34\x03\x01\x02\x03", 5});
+
+    std::ostringstream os3;
+    map.write_property(os3, 0x0A);
+    CHECK(os3.str() == snow);
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "RealSpriteRecord.h"
+#include <sstream>
+
+
+TEST_CASE("RealSpriteRecord crop", "[sprites]")
+{
+    using ZoomLevel = RealSpriteRecord::ZoomLevel;
+
+    // A 4x3 palette image with a single opaque column of two pixels.
+    std::vector<uint8_t> pixels = {
+        0, 0, 0, 0,
+        0, 0, 7, 0,
+        0, 0, 9, 0 };
+
+    SECTION("Palette")
+    {
+        RealSpriteRecord sprite{1, 0, 0};
+        sprite.set_image(ZoomLevel::Normal, 4, 3, -2, -10, RealSpriteRecord::HAS_PALETTE, pixels);
+        CHECK(sprite.crop() == 10);
+        CHECK(sprite.xdim() == 1);
+        CHECK(sprite.ydim() == 2);
+        CHECK(sprite.xrel() == 0);
+        CHECK(sprite.yrel() == -9);
+        CHECK(sprite.pixels() == std::vector<uint8_t>{7, 9});
+        CHECK(sprite.crop() == 0);
+    }
+
+    SECTION("No crop")
+    {
+        RealSpriteRecord sprite{1, 0, RealSpriteRecord::CROP_TRANSARENT_BORDER};
+        sprite.set_image(ZoomLevel::Normal, 4, 3, -2, -10, RealSpriteRecord::HAS_PALETTE, pixels);
+        CHECK(sprite.crop() == 0);
+        CHECK(sprite.xdim() == 4);
+    }
+
+    SECTION("Transparent")
+    {
+        RealSpriteRecord sprite{1, 0, 0};
+        sprite.set_image(ZoomLevel::Normal, 4, 3, -2, -10, RealSpriteRecord::HAS_PALETTE, std::vector<uint8_t>(12));
+        CHECK(sprite.crop() == 0);
+        CHECK(sprite.ydim() == 3);
+    }
+
+    SECTION("RGBA with mask")
+    {
+        // Pixels with zero alpha are kept if they have a mask index.
+        std::vector<uint8_t> rgbap = {
+            1, 2, 3, 0, 0,   1, 2, 3, 0, 0,   1, 2, 3, 0, 0,
+            1, 2, 3, 0, 5,   1, 2, 3, 0, 0,   1, 2, 3, 255, 0 };
+        RealSpriteRecord sprite{1, 0, 0};
+        sprite.set_image(ZoomLevel::Normal, 3, 2, 0, 0,
+            RealSpriteRecord::HAS_RGB | RealSpriteRecord::HAS_ALPHA | RealSpriteRecord::HAS_PALETTE, rgbap);
+        CHECK(sprite.crop() == 3);
+        CHECK(sprite.xdim() == 3);
+        CHECK(sprite.ydim() == 1);
+        CHECK(sprite.yrel() == 1);
+    }
+}
+
+
+TEST_CASE("RealSpriteRecord choose_compression", "[sprites]")
+{
+    using ZoomLevel = RealSpriteRecord::ZoomLevel;
+
+    // A sparse image favours the chunked format, and a noisy one favours plain LZ77.
+    std::vector<uint8_t> sparse(64 * 64);
+    std::vector<uint8_t> noisy(64 * 64);
+    for (uint32_t i = 0; i < noisy.size(); ++i)
+    {
+        sparse[i] = ((i % 64) == 32) ? 0x10 : 0x00;
+        noisy[i]  = uint8_t(1 + (i * 2654435761U >> 24) % 254);
+    }
+
+    GRFInfo info;
+    info.format = GRFFormat::Container2;
+    for (const auto* image: { &sparse, &noisy })
+    {
+        const auto& pixels = *image;
+        auto written = [&](uint8_t compression, const GRFInfo& info)
+        {
+            RealSpriteRecord sprite{1, 0, compression};
+            sprite.set_image(ZoomLevel::Normal, 64, 64, 0, 0, RealSpriteRecord::HAS_PALETTE, pixels);
+            std::ostringstream os;
+            sprite.write(os, info);
+            return os.str();
+        };
+        auto written_size = [&](uint8_t compression) { return int32_t(written(compression, info).size()); };
+        int32_t plain   = written_size(0);
+        int32_t chunked = written_size(RealSpriteRecord::CHUNKED_FORMAT);
+        CHECK((chunked < plain) == (image == &sparse));
+
+        for (uint8_t compression: { uint8_t{0}, RealSpriteRecord::CHUNKED_FORMAT })
+        {
+            RealSpriteRecord sprite{1, 0, compression};
+            sprite.set_image(ZoomLevel::Normal, 64, 64, 0, 0, RealSpriteRecord::HAS_PALETTE, pixels);
+            int32_t before = written_size(compression);
+            int32_t saved  = sprite.choose_compression(GRFFormat::Container2);
+            CHECK(written_size(sprite.compression()) == std::min(plain, chunked));
+            CHECK(saved == before - std::min(plain, chunked));
+
+            // The encoding kept by choose_compression() is written, unless the format differs.
+            GRFInfo info1;
+            info1.format = GRFFormat::Container1;
+            std::ostringstream os;
+            sprite.write(os, info);
+            CHECK(os.str() == written(sprite.compression(), info));
+            std::ostringstream os1;
+            sprite.write(os1, info1);
+            CHECK(os1.str() == written(sprite.compression(), info1));
+
+            // Changing the image drops the kept encoding.
+            sprite.set_image(ZoomLevel::Normal, 64, 64, 0, 0, RealSpriteRecord::HAS_PALETTE, std::vector<uint8_t>(64 * 64));
+            std::ostringstream blank;
+            sprite.write(blank, info);
+            CHECK(blank.str().size() < os.str().size());
+        }
+    }
+}
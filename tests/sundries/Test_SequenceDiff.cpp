@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "SequenceDiff.h"
+
+
+namespace {
+
+// Applies the edits to a, checking that the equal runs really are equal.
+std::vector<uint64_t> apply(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b,
+    const std::vector<DiffEdit>& edits, uint32_t& num_equal)
+{
+    std::vector<uint64_t> result;
+    uint32_t ia = 0;
+    uint32_t ib = 0;
+    num_equal = 0;
+    for (const auto& edit: edits)
+    {
+        REQUIRE(edit.length > 0);
+        switch (edit.op)
+        {
+            case DiffEdit::Op::Equal:
+                REQUIRE(edit.a == ia);
+                REQUIRE(edit.b == ib);
+                for (uint32_t i = 0; i < edit.length; ++i)
+                {
+                    REQUIRE(a[ia + i] == b[ib + i]);
+                    result.push_back(a[ia + i]);
+                }
+                ia += edit.length;
+                ib += edit.length;
+                num_equal += edit.length;
+                break;
+
+            case DiffEdit::Op::Remove:
+                REQUIRE(edit.a == ia);
+                ia += edit.length;
+                break;
+
+            case DiffEdit::Op::Add:
+                REQUIRE(edit.b == ib);
+                result.insert(result.end(), b.begin() + ib, b.begin() + ib + edit.length);
+                ib += edit.length;
+                break;
+        }
+    }
+    CHECK(ia == a.size());
+    CHECK(ib == b.size());
+    return result;
+}
+
+
+uint32_t lcs_length(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+{
+    std::vector<std::vector<uint32_t>> table(a.size() + 1, std::vector<uint32_t>(b.size() + 1));
+    for (uint32_t i = 1; i <= a.size(); ++i)
+        for (uint32_t j = 1; j <= b.size(); ++j)
+            table[i][j] = (a[i - 1] == b[j - 1]) ? table[i - 1][j - 1] + 1
+                : std::max(table[i - 1][j], table[i][j - 1]);
+    return table[a.size()][b.size()];
+}
+
+} // namespace {
+
+
+TEST_CASE("SequenceDiff simple", "[diff]")
+{
+    std::vector<uint64_t> a{ 1, 2, 3, 4, 5, 6 };
+    std::vector<uint64_t> b{ 1, 2, 7, 4, 5, 6, 8 };
+
+    std::vector<DiffEdit> edits = diff_sequences(a, b);
+    REQUIRE(edits.size() == 5);
+    CHECK(edits[0].op == DiffEdit::Op::Equal);
+    CHECK(edits[0].length == 2);
+    CHECK(edits[1].op == DiffEdit::Op::Remove);
+    CHECK(edits[1].a == 2);
+    CHECK(edits[2].op == DiffEdit::Op::Add);
+    CHECK(edits[2].b == 2);
+    CHECK(edits[3].op == DiffEdit::Op::Equal);
+    CHECK(edits[3].length == 3);
+    CHECK(edits[4].op == DiffEdit::Op::Add);
+    CHECK(edits[4].b == 6);
+
+    CHECK(diff_sequences(a, a).size() == 1);
+    CHECK(diff_sequences({}, {}).empty());
+}
+
+
+TEST_CASE("SequenceDiff is minimal", "[diff]")
+{
+    // Small alphabets give plenty of repeated values, which is the hard case.
+    uint32_t state = 12345;
+    auto next = [&state]() { state = state * 1103515245U + 12345U; return (state >> 16) & 0x7FFF; };
+
+    for (uint32_t test = 0; test < 200; ++test)
+    {
+        std::vector<uint64_t> a(next() % 40);
+        std::vector<uint64_t> b(next() % 40);
+        for (auto& value: a) value = next() % 4;
+        for (auto& value: b) value = next() % 4;
+
+        uint32_t num_equal = 0;
+        CHECK(apply(a, b, diff_sequences(a, b), num_equal) == b);
+        CHECK(num_equal == lcs_length(a, b));
+    }
+}
+
+
+TEST_CASE("SequenceDiff edit limit", "[diff]")
+{
+    std::vector<uint64_t> a{ 1, 2, 3, 4 };
+    std::vector<uint64_t> b{ 5, 1, 6, 2, 7, 3, 8, 4, 9 };
+
+    // With too few edits allowed, the whole range is replaced.
+    uint32_t num_equal = 0;
+    std::vector<DiffEdit> edits = diff_sequences(a, b, 1);
+    CHECK(apply(a, b, edits, num_equal) == b);
+    CHECK(num_equal == 0);
+
+    edits = diff_sequences(a, b);
+    CHECK(apply(a, b, edits, num_equal) == b);
+    CHECK(num_equal == 4);
+}
@@ -0,0 +1,418 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "SpriteGroupGraph.h"
+#include "NewGRFData.h"
+#include "GRFGenerator.h"
+#include "Action02VariableRecord.h"
+#include "Action03Record.h"
+#include "Test_GRFHelpers.h"
+#include <sstream>
+
+
+namespace {
+
+// Set 0x0002 is only used by an Action02 which is replaced before the Action03, and the
+// switch 0x04 is never used.
+static constexpr const char* str_YAGL =
+    "sprite_sets<Trains, 0x0000>\n"
+    "{\n"
+    "    sprite_set { }\n"
+    "    sprite_set { }\n"
+    "}\n"
+    "sprite_sets<Trains, 0x0002>\n"
+    "{\n"
+    "    sprite_set { }\n"
+    "}\n"
+    "sprite_groups<Trains, 0x01>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "    secondary_spritesets: [ 0x0001 ];\n"
+    "}\n"
+    "sprite_groups<Trains, 0x02>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0002 ];\n"
+    "}\n"
+    "sprite_groups<Trains, 0x02>\n"
+    "{\n"
+    "    primary_spritesets: [ 0x0000 ];\n"
+    "}\n"
+    "switch<Trains, 0x03, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x40] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "        0x00000001: 0x0001;\n"
+    "    };\n"
+    "    default: 0x0002;\n"
+    "}\n"
+    "switch<Trains, 0x04, PrimaryDWord>\n"
+    "{\n"
+    "    expression:\n"
+    "    {\n"
+    "        value1 = variable[0x40] & 0x000000FF;\n"
+    "    };\n"
+    "    ranges:\n"
+    "    {\n"
+    "    };\n"
+    "    default: 0x8001;\n"
+    "}\n"
+    "feature_graphics<Trains>\n"
+    "{\n"
+    "    livery_override: false;\n"
+    "    default_set_id: 0x0003;\n"
+    "    feature_ids: [ 0x0000 ];\n"
+    "    cargo_types:\n"
+    "    {\n"
+    "        0x12: 0x0001;\n"
+    "    };\n"
+    "}\n";
+
+
+} // namespace {
+
+
+TEST_CASE("SpriteGroupGraph", "[graph]")
+{
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_YAGL);
+    SpriteGroupGraph graph{grf_data.data_records()};
+
+    CHECK(graph.is_static());
+    CHECK(graph.num_unresolved() == 0);
+
+    // Each reference binds to the latest definition before it.
+    CHECK(graph.references(2) == std::vector<uint32_t>{ 0, 0 });
+    CHECK(graph.references(3) == std::vector<uint32_t>{ 1 });
+    CHECK(graph.references(5) == std::vector<uint32_t>{ 2, 4 });
+    CHECK(graph.references(7) == std::vector<uint32_t>{ 2, 5 });
+
+    std::vector<bool> dead;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        dead.push_back(graph.is_dead(i));
+    }
+    CHECK(dead == std::vector<bool>{ false, true, false, true, false, false, true, false });
+
+    grf_data.optimise();
+    CHECK(grf_data.data_records().size() == 5);
+}
+
+
+TEST_CASE("SpriteGroupGraph optimise sprites", "[graph]")
+{
+    // Without any Action03, nothing uses the sprite sets or the switches.
+    GRFGenerator::Config config;
+    config.switches = 5;
+    config.sprites  = 20;
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    NewGRFData grf_data;
+    grf_data.read(grf);
+    grf_data.optimise();
+
+    std::stringstream os;
+    grf_data.write(os);
+    NewGRFData grf_data2;
+    grf_data2.read(os);
+
+    std::ostringstream stats;
+    grf_data2.stats(stats);
+    CHECK(stats.str().find("\"sprites\": 0,") != std::string::npos);
+    for (const auto record: grf_data2.data_records())
+    {
+        CHECK(record->record_type() != RecordType::ACTION_01);
+        CHECK(record->record_type() != RecordType::ACTION_02_VARIABLE);
+    }
+}
+
+
+TEST_CASE("NewGRFData merge duplicate sets", "[graph]")
+{
+    // The second sprite group repeats the first, and then the second switch repeats the first.
+    static constexpr const char* str_duplicates =
+        "sprite_sets<Trains, 0x0000>\n"
+        "{\n"
+        "    sprite_set { }\n"
+        "}\n"
+        "sprite_groups<Trains, 0x01>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n"
+        "sprite_groups<Trains, 0x02>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n"
+        "switch<Trains, 0x03, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x0001;\n"
+        "    };\n"
+        "    default: 0x0002;\n"
+        "}\n"
+        "switch<Trains, 0x04, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x0002;\n"
+        "    };\n"
+        "    default: 0x0001;\n"
+        "}\n"
+        "feature_graphics<Trains>\n"
+        "{\n"
+        "    livery_override: false;\n"
+        "    default_set_id: 0x0004;\n"
+        "    feature_ids: [ 0x0000 ];\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_duplicates);
+    grf_data.optimise();
+
+    auto records = grf_data.data_records();
+    REQUIRE(records.size() == 4);
+    REQUIRE(records[3]->record_type() == RecordType::ACTION_03);
+    CHECK(static_cast<const Action03Record*>(records[3])->act02_set_ids() == std::vector<uint16_t>{ 0x0003 });
+}
+
+
+TEST_CASE("NewGRFData merge duplicate sprites", "[graph]")
+{
+    GRFGenerator::Config config;
+    config.sprites  = 20;
+    config.distinct = 5;
+    config.graphics = true;
+    config.zooms    = { GRFGenerator::ZoomLevel::Normal, GRFGenerator::ZoomLevel::ZoomInX2 };
+
+    std::stringstream grf;
+    GRFGenerator{config}.write(grf);
+    NewGRFData grf_data;
+    grf_data.read(grf);
+    grf_data.optimise();
+
+    std::stringstream os;
+    grf_data.write(os);
+    CHECK(os.str().size() < grf.str().size());
+
+    // Every sprite reference still finds its images.
+    NewGRFData grf_data2;
+    grf_data2.read(os);
+    std::ostringstream stats;
+    grf_data2.stats(stats);
+    CHECK(stats.str().find("\"sprites\": 10,") != std::string::npos);
+}
+
+
+TEST_CASE("NewGRFData bypass switches", "[graph]")
+{
+    // Switch 0x02 always selects sprite group 0x01, so switch 0x03 can use that directly.
+    static constexpr const char* str_bypass =
+        "sprite_sets<Trains, 0x0000>\n"
+        "{\n"
+        "    sprite_set { }\n"
+        "}\n"
+        "sprite_groups<Trains, 0x01>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n"
+        "switch<Trains, 0x02, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x0001;\n"
+        "        0x00000002: 0x0001;\n"
+        "    };\n"
+        "    default: 0x0001;\n"
+        "}\n"
+        "switch<Trains, 0x03, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x41] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x0002;\n"
+        "    };\n"
+        "    default: 0x8001;\n"
+        "}\n"
+        "feature_graphics<Trains>\n"
+        "{\n"
+        "    livery_override: false;\n"
+        "    default_set_id: 0x0003;\n"
+        "    feature_ids: [ 0x0000 ];\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_bypass);
+    grf_data.optimise();
+
+    auto records = grf_data.data_records();
+    REQUIRE(records.size() == 4);
+    REQUIRE(records[2]->record_type() == RecordType::ACTION_02_VARIABLE);
+    CHECK(static_cast<const Action02VariableRecord*>(records[2])->act02_set_ids() == std::vector<uint16_t>{ 0x0001, 0x8001 });
+}
+
+
+TEST_CASE("NewGRFData procedure calls", "[graph]")
+{
+    // Switches 0x05 and 0x06 are only used as procedures by switch 0x03. Switch 0x06 always
+    // gives the same callback result, but the procedure call cannot be replaced by that.
+    static constexpr const char* str_procedures =
+        "sprite_sets<Trains, 0x0000>\n"
+        "{\n"
+        "    sprite_set { }\n"
+        "}\n"
+        "sprite_groups<Trains, 0x01>\n"
+        "{\n"
+        "    primary_spritesets: [ 0x0000 ];\n"
+        "}\n"
+        "switch<Trains, 0x05, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "    };\n"
+        "    default: 0x8000;\n"
+        "}\n"
+        "switch<Trains, 0x06, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x41] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x8002;\n"
+        "    };\n"
+        "    default: 0x8002;\n"
+        "}\n"
+        "switch<Trains, 0x03, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x7E, 0x05] & 0x000000FF;\n"
+        "\n"
+        "        value2 = variable[0x7E, 0x06] & 0x000000FF;\n"
+        "        value1 = Addition(value1, value2);\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "        0x00000001: 0x0001;\n"
+        "    };\n"
+        "    default: 0x8000;\n"
+        "}\n"
+        "feature_graphics<Trains>\n"
+        "{\n"
+        "    livery_override: false;\n"
+        "    default_set_id: 0x0003;\n"
+        "    feature_ids: [ 0x0000 ];\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_procedures);
+    SpriteGroupGraph graph{grf_data.data_records()};
+    CHECK(graph.references(4) == std::vector<uint32_t>{ 2, 3, 1 });
+    CHECK(!graph.is_dead(2));
+    CHECK(!graph.is_dead(3));
+
+    grf_data.optimise();
+    auto records = grf_data.data_records();
+    REQUIRE(records.size() == 6);
+    REQUIRE(records[4]->record_type() == RecordType::ACTION_02_VARIABLE);
+    CHECK(static_cast<const Action02VariableRecord*>(records[4])->procedure_set_ids() == std::vector<uint16_t>{ 0x05, 0x06 });
+}
+
+
+TEST_CASE("NewGRFData merge duplicate procedures", "[graph]")
+{
+    // Switch 0x06 repeats switch 0x05, and both are only called as procedures.
+    static constexpr const char* str_procedures =
+        "switch<Trains, 0x05, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "    };\n"
+        "    default: 0x8000;\n"
+        "}\n"
+        "switch<Trains, 0x06, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x40] & 0x000000FF;\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "    };\n"
+        "    default: 0x8000;\n"
+        "}\n"
+        "switch<Trains, 0x03, PrimaryDWord>\n"
+        "{\n"
+        "    expression:\n"
+        "    {\n"
+        "        value1 = variable[0x7E, 0x05] & 0x000000FF;\n"
+        "\n"
+        "        value2 = variable[0x7E, 0x06] & 0x000000FF;\n"
+        "        value1 = Addition(value1, value2);\n"
+        "    };\n"
+        "    ranges:\n"
+        "    {\n"
+        "    };\n"
+        "    default: 0x8000;\n"
+        "}\n"
+        "feature_graphics<Trains>\n"
+        "{\n"
+        "    livery_override: false;\n"
+        "    default_set_id: 0x0003;\n"
+        "    feature_ids: [ 0x0000 ];\n"
+        "}\n";
+
+    NewGRFData grf_data;
+    parse_yagl(grf_data, str_procedures);
+    grf_data.optimise();
+
+    auto records = grf_data.data_records();
+    REQUIRE(records.size() == 3);
+    REQUIRE(records[1]->record_type() == RecordType::ACTION_02_VARIABLE);
+    CHECK(static_cast<const Action02VariableRecord*>(records[1])->procedure_set_ids() == std::vector<uint16_t>{ 0x05, 0x05 });
+}
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "SpriteSheetReader.h"
+#include "ThreadPool.h"
+#include "Test_GRFHelpers.h"
+
+
+TEST_CASE("SpriteSheetPool pixels", "[sprites]")
+{
+    SpriteSheetPool& pool = SpriteSheetPool::pool();
+
+    SpriteRect rect;
+    rect.file_name      = "test-pool-image.png";
+    rect.mask_file_name = "test-pool-mask.png";
+    rect.xoff   = 10;
+    rect.yoff   = 20;
+    rect.xdim   = 2;
+    rect.ydim   = 2;
+    rect.colour = RealSpriteRecord::HAS_PALETTE;
+    CHECK(pool.find_pixels(rect) == nullptr);
+
+    auto pixels = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{1, 2, 3, 4});
+    pool.add_pixels(rect, pixels);
+    CHECK(pool.find_pixels(rect) == pixels);
+
+    // Any difference in the rectangle is a different image.
+    SpriteRect other = rect;
+    other.yoff = 21;
+    CHECK(pool.find_pixels(other) == nullptr);
+
+    // The pixels are forgotten when either sheet is closed.
+    pool.release_sprite_sheet("test-pool-mask.png");
+    CHECK(pool.find_pixels(rect) == nullptr);
+
+    // And when all the sheets are closed at the end of parsing.
+    pool.add_pixels(rect, pixels);
+    pool.release_all();
+    CHECK(pool.find_pixels(rect) == nullptr);
+}
+
+
+TEST_CASE("SpriteSheetPool concurrent", "[sprites]")
+{
+    ScopedTestDir dir{"yagl_test_sheet_pool"};
+
+    png::palette palette(256);
+    png::image<png::index_pixel> image;
+    image.set_palette(palette);
+    image.resize(4, 4);
+    image[2][3] = 0x42;
+    image.write("sprites/pool.png");
+
+    // Every task gets the same sheet, which is decoded once by whichever asks first.
+    SpriteSheetPool& pool = SpriteSheetPool::pool();
+    ThreadPool threads{4};
+    std::vector<std::future<SpriteSheet*>> sheets;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        sheets.push_back(threads.submit([&pool]()
+        {
+            return &pool.get_sprite_sheet("sprites/pool.png", SpriteSheet::Colour::Palette);
+        }));
+    }
+    SpriteSheet* first = sheets[0].get();
+    for (uint32_t i = 1; i < sheets.size(); ++i)
+    {
+        CHECK(sheets[i].get() == first);
+    }
+    CHECK(first->pixel(3, 2).index == 0x42);
+
+    // A sheet which fails to load is not remembered, so the next request tries again.
+    CHECK_THROWS(pool.get_sprite_sheet("sprites/missing.png", SpriteSheet::Colour::Palette));
+    image.write("sprites/missing.png");
+    CHECK(pool.get_sprite_sheet("sprites/missing.png", SpriteSheet::Colour::Palette).pixel(3, 2).index == 0x42);
+
+    pool.release_all();
+}
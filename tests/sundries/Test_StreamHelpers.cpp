@@ -18,6 +18,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "catch.hpp"
 #include "StreamHelpers.h"
+#include "TextBuffer.h"
 #include <sstream>
 
 
@@ -226,4 +227,62 @@ TEST_CASE("to_hex() template", "[integers]")
         CHECK(to_hex(value) == "0x13234567");
         CHECK(to_hex(value, false) == "13234567"); // No prefix
     }
-}
\ No newline at end of file
+
+    SECTION("to_hex<int8_t>")
+    {
+        int8_t value = -2;
+        CHECK(to_hex(value) == "0xFE"); // No sign extension
+    }
+
+    SECTION("to_hex<uint64_t>")
+    {
+        uint64_t value = 0x0123'4567'89AB'CDEF;
+        CHECK(to_hex(value) == "0x0123456789ABCDEF");
+    }
+}
+
+
+TEST_CASE("pad() manipulator", "[formatting]")
+{
+    std::ostringstream os;
+    os << pad(0) << "a" << pad(3) << "b" << pad(150) << "c";
+    CHECK(os.str() == "a   b" + std::string(150, ' ') + "c");
+}
+
+
+TEST_CASE("as_hex() manipulator", "[formatting]")
+{
+    std::ostringstream os;
+    os << as_hex(uint8_t{0x13}) << ' ' << as_hex(uint16_t{0x1357}, false) << ' ' << as_hex(int8_t{-2});
+    CHECK(os.str() == "0x13 1357 0xFE");
+}
+
+
+TEST_CASE("TextBuffer", "[formatting]")
+{
+    TextBuffer os;
+    os << "Record #" << 12 << ' ' << to_hex(uint16_t{0xAB}) << pad(2) << ';';
+    CHECK(os.text() == "Record #12 0x00AB  ;");
+
+    std::string text = os.take();
+    CHECK(text == "Record #12 0x00AB  ;");
+}
+
+TEST_CASE("append_hex_bytes()", "[formatting]")
+{
+    std::string data;
+    for (uint16_t byte = 0; byte < 18; ++byte)
+    {
+        data += static_cast<char>(byte * 15);
+    }
+
+    std::string dump = "Data\n";
+    append_hex_bytes(dump, data, HexLayout::Dump);
+    CHECK(dump == "Data\n"
+        "00 0F 1E 2D 3C 4B 5A 69 78 87 96 A5 B4 C3 D2 E1 \n"
+        "F0 FF ");
+
+    std::string nfo = "    1 * 3\t";
+    append_hex_bytes(nfo, data.substr(15), HexLayout::NFO);
+    CHECK(nfo == "    1 * 3\t E1 F0 FF");
+}
@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "catch.hpp"
+#include "ThreadPool.h"
+#include "FileQueue.h"
+#include "FileSystem.h"
+#include <fstream>
+#include <stdexcept>
+
+
+TEST_CASE("ThreadPool results", "[threads]")
+{
+    ThreadPool pool{4};
+    CHECK(pool.num_threads() == 4);
+
+    std::vector<std::future<uint32_t>> results;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        results.push_back(pool.submit([i]() { return i * i; }));
+    }
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        CHECK(results[i].get() == i * i);
+    }
+
+    // Exceptions are passed back to the caller.
+    auto failed = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+    CHECK_THROWS_AS(failed.get(), std::runtime_error);
+}
+
+
+TEST_CASE("ThreadPool nested tasks", "[threads]")
+{
+    // Tasks which wait for their own tasks run them while waiting, so even a single worker
+    // does not deadlock.
+    ThreadPool pool{1};
+    auto outer = pool.submit([&pool]()
+    {
+        std::vector<std::future<uint32_t>> inner;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            inner.push_back(pool.submit([i]() { return i; }));
+        }
+
+        uint32_t total = 0;
+        for (auto& result: inner)
+        {
+            total += pool.get(result);
+        }
+        return total;
+    });
+    CHECK(pool.get(outer) == 28);
+
+    std::vector<ThreadPool::WorkerStats> stats = pool.worker_stats();
+    // The counters are updated just after each result is set, so they may lag slightly.
+    REQUIRE(stats.size() == 2);
+    CHECK((stats[0].tasks + stats[1].tasks) <= 9);
+}
+
+
+TEST_CASE("ThreadPool ordered results", "[threads]")
+{
+    ThreadPool pool{4};
+
+    std::vector<uint32_t> results;
+    pool.for_each_ordered(1000,
+        [](uint32_t index) { return index * 3; },
+        [&results](uint32_t index, uint32_t result)
+        {
+            CHECK(index == results.size());
+            results.push_back(result);
+        });
+
+    REQUIRE(results.size() == 1000);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        CHECK(results[i] == i * 3);
+    }
+
+    uint64_t tasks = 0;
+    for (const auto& worker: pool.worker_stats())
+    {
+        tasks += worker.tasks;
+    }
+    CHECK(tasks <= 1000);
+}
+
+
+TEST_CASE("ThreadPool ordered exceptions", "[threads]")
+{
+    // The exception is seen when the results are more than one batch ahead, so some tasks are
+    // still queued for the only worker, which is the thread running the loop.
+    ThreadPool pool{1};
+    uint32_t count = pool.num_threads() * 64 * 3;
+    std::atomic<uint32_t> made{0};
+    auto outer = pool.submit([&pool, &made, count]()
+    {
+        pool.for_each_ordered(count,
+            [&made](uint32_t index)
+            {
+                ++made;
+                if (index == 1)
+                    throw std::runtime_error("failed");
+                return index;
+            },
+            [](uint32_t, uint32_t) {});
+        return 0;
+    });
+    // This thread does not help, so only the worker can run the queued tasks.
+    CHECK_THROWS_AS(outer.get(), std::runtime_error);
+    CHECK(made < count);
+}
+
+
+TEST_CASE("FileQueue ordering", "[threads]")
+{
+    fs::path file_name = fs::temp_directory_path() / "yagl_test_queue.bin";
+    fs::remove(file_name);
+
+    ThreadPool pool{4};
+    FileQueue& files = FileQueue::queue();
+
+    // The same file is written by each task, so only the last one in sequence should survive.
+    std::vector<std::future<void>> results;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        results.push_back(pool.submit([i, file_name]()
+        {
+            FileQueue::Deferral deferral{i};
+            FileQueue::queue().write_file(file_name.string(), std::vector<uint8_t>{uint8_t(i)});
+        }));
+    }
+
+    for (auto& result: results)
+    {
+        result.get();
+    }
+    CHECK(!fs::exists(file_name));
+
+    files.flush(15);
+    std::ifstream is(file_name, std::ios::binary);
+    CHECK(is.get() == 15);
+    is.close();
+    fs::remove(file_name);
+}
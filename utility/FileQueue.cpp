@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "FileQueue.h"
+#include <fstream>
+#include <iostream>
+
+
+namespace {
+
+// The sequence number of the record being printed on this thread, if any.
+thread_local bool     t_deferred = false;
+thread_local uint32_t t_sequence = 0;
+
+} // namespace {
+
+
+FileQueue& FileQueue::queue()
+{
+    static FileQueue instance;
+    return instance;
+}
+
+
+FileQueue::Deferral::Deferral(uint32_t sequence)
+: m_deferred{t_deferred}
+, m_sequence{t_sequence}
+{
+    t_deferred = true;
+    t_sequence = sequence;
+}
+
+
+FileQueue::Deferral::~Deferral()
+{
+    t_deferred = m_deferred;
+    t_sequence = m_sequence;
+}
+
+
+void FileQueue::write_file(const std::string& file_name, const std::vector<uint8_t>& data)
+{
+    if (!t_deferred)
+    {
+        write_now(file_name, data);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.insert({t_sequence, PendingFile{file_name, data}});
+}
+
+
+void FileQueue::flush(uint32_t sequence)
+{
+    std::multimap<uint32_t, PendingFile> files;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto end = m_files.upper_bound(sequence);
+        files.insert(m_files.begin(), end);
+        m_files.erase(m_files.begin(), end);
+    }
+
+    for (const auto& it: files)
+    {
+        write_now(it.second.file_name, it.second.data);
+    }
+}
+
+
+void FileQueue::write_now(const std::string& file_name, const std::vector<uint8_t>& data)
+{
+    std::cout << "Writing binary file: " << file_name << "..." << std::endl;
+
+    std::ofstream os(file_name, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
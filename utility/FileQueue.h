@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// Some records write files as a side effect of being printed (ActionFF writes WAV files). When
+// records are printed concurrently these writes are queued against the index of the record, so
+// that they can be performed in record order as the text for each record is written out.
+class FileQueue
+{
+public:
+    static FileQueue& queue();
+
+    // Writes the file immediately, unless the calling thread is inside a Deferral,
+    // in which case the data is queued until flush() reaches the deferral's sequence.
+    void write_file(const std::string& file_name, const std::vector<uint8_t>& data);
+
+    // Write out all the queued files with a sequence number up to and including this one.
+    void flush(uint32_t sequence);
+
+    // Scope guard used by the task printing a record. A thread waiting for a result may run
+    // other tasks, so deferrals can be nested, and the outer one is restored afterwards.
+    class Deferral
+    {
+    public:
+        explicit Deferral(uint32_t sequence);
+        ~Deferral();
+
+    private:
+        bool     m_deferred;
+        uint32_t m_sequence;
+    };
+
+private:
+    struct PendingFile
+    {
+        std::string          file_name;
+        std::vector<uint8_t> data;
+    };
+
+    static void write_now(const std::string& file_name, const std::vector<uint8_t>& data);
+
+private:
+    std::mutex                              m_mutex;
+    std::multimap<uint32_t, PendingFile>    m_files;
+};
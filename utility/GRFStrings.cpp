@@ -18,227 +18,352 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "GRFStrings.h"
 #include "StreamHelpers.h"
-#include <map>
+#include "PerfectHash.h"
+#include <array>
+#include <cstring>
+#include <cstdlib>
 #include <iostream>
-#include <sstream>
-#include <locale>
-#include <codecvt>
+#include <string_view>
 #include <algorithm>
 
 
 struct ControlCode
 {
-    uint8_t         code;         // The numeric value of the code as it appears in the string.
-    const char16_t* name;         // The human readable name used to represent the code.
-    uint8_t         data_size;    // The number of bytes in the string used as arguments
-    const char*     description;
+    uint8_t     code;         // The numeric value of the code as it appears in the string.
+    const char* name;         // The human readable name used to represent the code.
+    uint8_t     data_size;    // The number of bytes in the string used as arguments
+    const char* description;
 };
 
 
-static const std::map<uint8_t, ControlCode> g_control_codes =
-{
-    { 0x01, { 0x01, u"x-off",       1, "X offset in next byte of string (variable space)" } },
-    { 0x0D, { 0x0D, u"new-line",    0, "New line" } },
-    { 0x0E, { 0x0E, u"small-font",  0, "Set small font size" } },
-    { 0x0F, { 0x0F, u"large-font",  0, "Set large font size" } },
-    { 0x1F, { 0x1F, u"xy-offs",     2, "X and Y offsets in next two bytes of string" } },
-    { 0x22, { 0x22, u"dq",          0, "Double quote" } },
-    { 0x7B, { 0x7B, u"sd",          0, "Print signed dword" } },
-    { 0x7C, { 0x7C, u"sw",          0, "Print signed word" } },
-    { 0x7D, { 0x7D, u"sb",          0, "Print signed byte" } },
-    { 0x7E, { 0x7E, u"uw",          0, "Print unsigned word" } },
-    { 0x7F, { 0x7F, u"sd-currency", 0, "Print dword in currency units" } },
-    { 0x80, { 0x80, u"substring1",  0, "Print substring (text ID from stack)" } },
-    { 0x81, { 0x81, u"substring2",  2, "Print substring (text ID in next 2 bytes of string)" } },
-    { 0x82, { 0x82, u"d-m-year",    0, "Print date (day, month, year) (based on year 1920)" } },
-    { 0x83, { 0x83, u"m-year",      0, "Print short date (month and year) (based on year 1920)" } },
-    { 0x84, { 0x84, u"sw-speed",    0, "Print signed word in speed units" } },
-    { 0x85, { 0x85, u"discard",     0, "Discard next word from stack" } },
-    { 0x86, { 0x86, u"rotate",      0, "Rotate down top 4 words on stack" } },
-    { 0x87, { 0x87, u"sw-litres",   0, "Print signed word in litres" } },
-    { 0x88, { 0x88, u"blue",        0, "Blue" } },
-    { 0x89, { 0x89, u"lt-gray",     0, "Light Gray" } },
-    { 0x8A, { 0x8A, u"gold",        0, "Light Orange ('Gold')" } },
-    { 0x8B, { 0x8B, u"red",         0, "Red" } },
-    { 0x8C, { 0x8C, u"purple",      0, "Purple" } },
-    { 0x8D, { 0x8D, u"gray-green",  0, "Gray-Green" } },
-    { 0x8E, { 0x8E, u"orange",      0, "Orange" } },
-    { 0x8F, { 0x8F, u"green",       0, "Green" } },
-    { 0x90, { 0x90, u"yellow",      0, "Yellow" } },
-    { 0x91, { 0x91, u"lt-green",    0, "Light Green" } },
-    { 0x92, { 0x92, u"red-brown",   0, "Red-Brown" } },
-    { 0x93, { 0x93, u"brown",       0, "Brown" } },
-    { 0x94, { 0x94, u"white",       0, "White" } },
-    { 0x95, { 0x95, u"lt-blue",     0, "Light Blue" } },
-    { 0x96, { 0x96, u"dk-gray",     0, "Dark Gray" } },
-    { 0x97, { 0x97, u"mauve",       0, "Mauve (grayish purple)" } },
-    { 0x98, { 0x98, u"black",       0, "Black" } },
-    { 0x99, { 0x99, u"switch-cc",   1, "Switch to company colour that follows in next byte (enabled by enhancegui)" } },
-    { 0x9A, { 0x9A, u"ext",         0, "Extended format code in next byte:" } },
-    { 0x9E, { 0x9E, u"euro",        0, "Euro character" } },
-    { 0x9F, { 0x9F, u"Y-umlaut",    0, "Capital Y umlaut" } },
-    { 0xA0, { 0xA0, u"scroll-up",   0, "Scroll button up" } },
-    { 0xAA, { 0xAA, u"scroll-down", 0, "Scroll button down" } },
-    { 0xAC, { 0xAC, u"tick",        0, "Tick mark" } },
-    { 0xAD, { 0xAD, u"x",           0, "X mark" } },
-    { 0xAF, { 0xAF, u"scroll-right", 0, "Scroll button right" } },
-    { 0xB4, { 0xB4, u"train",       0, "Train symbol" } },
-    { 0xB5, { 0xB5, u"truck",       0, "Truck symbol" } },
-    { 0xB6, { 0xB6, u"bus",         0, "Bus symbol" } },
-    { 0xB7, { 0xB7, u"plane",       0, "Plane symbol" } },
-    { 0xB8, { 0xB8, u"ship",        0, "Ship symbol" } },
-    { 0xB9, { 0xB9, u"super-1",     0, "Superscript -1" } },
-    { 0xBC, { 0xBC, u"small-up",    0, "Small scroll button up" } },
-    { 0xBD, { 0xBD, u"small-down",  0, "Small scroll button down"  } },
+namespace {
+
+
+const ControlCode g_control_codes[] =
+{
+    { 0x01, "x-off",       1, "X offset in next byte of string (variable space)" },
+    { 0x0D, "new-line",    0, "New line" },
+    { 0x0E, "small-font",  0, "Set small font size" },
+    { 0x0F, "large-font",  0, "Set large font size" },
+    { 0x1F, "xy-offs",     2, "X and Y offsets in next two bytes of string" },
+    { 0x22, "dq",          0, "Double quote" },
+    { 0x7B, "sd",          0, "Print signed dword" },
+    { 0x7C, "sw",          0, "Print signed word" },
+    { 0x7D, "sb",          0, "Print signed byte" },
+    { 0x7E, "uw",          0, "Print unsigned word" },
+    { 0x7F, "sd-currency", 0, "Print dword in currency units" },
+    { 0x80, "substring1",  0, "Print substring (text ID from stack)" },
+    { 0x81, "substring2",  2, "Print substring (text ID in next 2 bytes of string)" },
+    { 0x82, "d-m-year",    0, "Print date (day, month, year) (based on year 1920)" },
+    { 0x83, "m-year",      0, "Print short date (month and year) (based on year 1920)" },
+    { 0x84, "sw-speed",    0, "Print signed word in speed units" },
+    { 0x85, "discard",     0, "Discard next word from stack" },
+    { 0x86, "rotate",      0, "Rotate down top 4 words on stack" },
+    { 0x87, "sw-litres",   0, "Print signed word in litres" },
+    { 0x88, "blue",        0, "Blue" },
+    { 0x89, "lt-gray",     0, "Light Gray" },
+    { 0x8A, "gold",        0, "Light Orange ('Gold')" },
+    { 0x8B, "red",         0, "Red" },
+    { 0x8C, "purple",      0, "Purple" },
+    { 0x8D, "gray-green",  0, "Gray-Green" },
+    { 0x8E, "orange",      0, "Orange" },
+    { 0x8F, "green",       0, "Green" },
+    { 0x90, "yellow",      0, "Yellow" },
+    { 0x91, "lt-green",    0, "Light Green" },
+    { 0x92, "red-brown",   0, "Red-Brown" },
+    { 0x93, "brown",       0, "Brown" },
+    { 0x94, "white",       0, "White" },
+    { 0x95, "lt-blue",     0, "Light Blue" },
+    { 0x96, "dk-gray",     0, "Dark Gray" },
+    { 0x97, "mauve",       0, "Mauve (grayish purple)" },
+    { 0x98, "black",       0, "Black" },
+    { 0x99, "switch-cc",   1, "Switch to company colour that follows in next byte (enabled by enhancegui)" },
+    { 0x9A, "ext",         0, "Extended format code in next byte:" },
+    { 0x9E, "euro",        0, "Euro character" },
+    { 0x9F, "Y-umlaut",    0, "Capital Y umlaut" },
+    { 0xA0, "scroll-up",   0, "Scroll button up" },
+    { 0xAA, "scroll-down", 0, "Scroll button down" },
+    { 0xAC, "tick",        0, "Tick mark" },
+    { 0xAD, "x",           0, "X mark" },
+    { 0xAF, "scroll-right", 0, "Scroll button right" },
+    { 0xB4, "train",       0, "Train symbol" },
+    { 0xB5, "truck",       0, "Truck symbol" },
+    { 0xB6, "bus",         0, "Bus symbol" },
+    { 0xB7, "plane",       0, "Plane symbol" },
+    { 0xB8, "ship",        0, "Ship symbol" },
+    { 0xB9, "super-1",     0, "Superscript -1" },
+    { 0xBC, "small-up",    0, "Small scroll button up" },
+    { 0xBD, "small-down",  0, "Small scroll button down"  },
 };
 
 
-static const std::map<uint8_t, ControlCode> g_extension_codes =
-{
-    { 0x00, { 0x00, u"64-currency0",       0, "Display 64-bit value from stack in currency units" } },
-    { 0x01, { 0x01, u"64-currency1",       0, "Display 64-bit value from stack in currency units" } },
-    { 0x02, { 0x02, u"ignore-colour",      0, "Ignore next colour byte. Multiple instances will skip multiple colour bytes." } },
-    { 0x03, { 0x03, u"push-w",             2, "WORD Push WORD onto the textref stack" } },
-    { 0x04, { 0x04, u"unprint-b",          1, "BYTE Un-print the previous BYTE characters." } },
-    { 0x05, { 0x05, u"internal5",          0, "For internal use only. Not valid in GRF files." } },
-    { 0x06, { 0x06, u"b-hex",              0, "Print byte in hex" } },
-    { 0x07, { 0x07, u"w-hex",              0, "Print word in hex" } },
-    { 0x08, { 0x08, u"d-hex",              0, "Print dword in hex" } },
-    { 0x09, { 0x09, u"internal9",          0, "For internal use only. Usage in NewGRFs will most likely crash TTDPatch." } },
-    { 0x0A, { 0x0A, u"internalA",          0, "For internal use only. Usage in NewGRFs will most likely crash TTDPatch." } },
-    { 0x0B, { 0x0B, u"64-hex",             0, "Print 64-bit value in hex" } },
-    { 0x0C, { 0x0C, u"station",            0, "Print name of station with id in next textrefstack word" } },
-    { 0x0D, { 0x0D, u"uw-tonnes",          0, "Print unsigned word in tonnes" } },
-    { 0x0E, { 0x0E, u"gender",             1, "Set gender of string, NewGRF internal ID in next byte. Must be first in a string." } },
-    { 0x0F, { 0x0F, u"case",               1, "Select case for next substring, NewGRF internal ID in next byte" } },
-    { 0x10, { 0x10, u"list-value",         1, "Begin choice list value, NewGRF internal ID in next byte" } },
-    { 0x11, { 0x11, u"list-default",       0, "Begin choice list default" } },
-    { 0x12, { 0x12, u"end-list",           0, "End choice list" } },
-    { 0x13, { 0x13, u"gender-list",        1, "Begin gender choice list, stack offset of substring to get gender from in next byte" } },
-    { 0x14, { 0x14, u"case-list",          0, "Begin case choice list" } },
-    { 0x15, { 0x15, u"plural-list",        1, "Begin plural choice list, stack offset of value to get plural for in next byte" } },
-    { 0x16, { 0x16, u"dw-date",            0, "Print dword as date (day, month, year) (based on year 0)" } },
-    { 0x17, { 0x17, u"dw-short-date",      0, "Print dword as short date (month and year) (based on year 0)" } },
-    { 0x18, { 0x18, u"uw-hp",              0, "Print unsigned word in horse power" } },
-    { 0x19, { 0x19, u"uw-volume",          0, "Print unsigned word as short volume" } },
-    { 0x1A, { 0x1A, u"uw-weight",          0, "Print unsigned word as short weight" } },
- 	{ 0x1B, { 0x1B, u"dw-cargo-long",      0, "Use two words to print an amount of cargo (long form: '10 bags of mail')." } },
-	{ 0x1C, { 0x1C, u"dw-cargo-short",     0, "Use two words to print an amount of cargo (short form: '10 bags')." } },
-    { 0x1D, { 0x1D, u"dw-cargo-tiny",      0, "Use two words to print an amount of cargo (tiny form: '10')." } }, 
-    { 0x1E, { 0x1E, u"uw-cargo-type",      0, "Print unsigned word as name of a cargo type." } },
-	{ 0x1F, { 0x1F, u"push-colour",        0, "Push current colour onto colour stack. Use this if you need to switch colour and restore later." } },
-	{ 0x20, { 0x20, u"pop-colour",         0, "Pop last colour from colour stack. Use this to restore previous colour." } },
-	{ 0x21, { 0x21, u"uw-force-value",     0, "Print unsigned dword from stack as force." } },     
+const ControlCode g_extension_codes[] =
+{
+    { 0x00, "64-currency0",       0, "Display 64-bit value from stack in currency units" },
+    { 0x01, "64-currency1",       0, "Display 64-bit value from stack in currency units" },
+    { 0x02, "ignore-colour",      0, "Ignore next colour byte. Multiple instances will skip multiple colour bytes." },
+    { 0x03, "push-w",             2, "WORD Push WORD onto the textref stack" },
+    { 0x04, "unprint-b",          1, "BYTE Un-print the previous BYTE characters." },
+    { 0x05, "internal5",          0, "For internal use only. Not valid in GRF files." },
+    { 0x06, "b-hex",              0, "Print byte in hex" },
+    { 0x07, "w-hex",              0, "Print word in hex" },
+    { 0x08, "d-hex",              0, "Print dword in hex" },
+    { 0x09, "internal9",          0, "For internal use only. Usage in NewGRFs will most likely crash TTDPatch." },
+    { 0x0A, "internalA",          0, "For internal use only. Usage in NewGRFs will most likely crash TTDPatch." },
+    { 0x0B, "64-hex",             0, "Print 64-bit value in hex" },
+    { 0x0C, "station",            0, "Print name of station with id in next textrefstack word" },
+    { 0x0D, "uw-tonnes",          0, "Print unsigned word in tonnes" },
+    { 0x0E, "gender",             1, "Set gender of string, NewGRF internal ID in next byte. Must be first in a string." },
+    { 0x0F, "case",               1, "Select case for next substring, NewGRF internal ID in next byte" },
+    { 0x10, "list-value",         1, "Begin choice list value, NewGRF internal ID in next byte" },
+    { 0x11, "list-default",       0, "Begin choice list default" },
+    { 0x12, "end-list",           0, "End choice list" },
+    { 0x13, "gender-list",        1, "Begin gender choice list, stack offset of substring to get gender from in next byte" },
+    { 0x14, "case-list",          0, "Begin case choice list" },
+    { 0x15, "plural-list",        1, "Begin plural choice list, stack offset of value to get plural for in next byte" },
+    { 0x16, "dw-date",            0, "Print dword as date (day, month, year) (based on year 0)" },
+    { 0x17, "dw-short-date",      0, "Print dword as short date (month and year) (based on year 0)" },
+    { 0x18, "uw-hp",              0, "Print unsigned word in horse power" },
+    { 0x19, "uw-volume",          0, "Print unsigned word as short volume" },
+    { 0x1A, "uw-weight",          0, "Print unsigned word as short weight" },
+    { 0x1B, "dw-cargo-long",      0, "Use two words to print an amount of cargo (long form: '10 bags of mail')." },
+    { 0x1C, "dw-cargo-short",     0, "Use two words to print an amount of cargo (short form: '10 bags')." },
+    { 0x1D, "dw-cargo-tiny",      0, "Use two words to print an amount of cargo (tiny form: '10')." },
+    { 0x1E, "uw-cargo-type",      0, "Print unsigned word as name of a cargo type." },
+    { 0x1F, "push-colour",        0, "Push current colour onto colour stack. Use this if you need to switch colour and restore later." },
+    { 0x20, "pop-colour",         0, "Pop last colour from colour stack. Use this to restore previous colour." },
+    { 0x21, "uw-force-value",     0, "Print unsigned dword from stack as force." },
 };
 
 
-// Helpers.
-static std::u16string grf_string_latin1_to_utf16(const std::string& str);
-static std::u16string grf_string_utf8_to_utf16(const std::string& str);
-static void process_utf16_extension_codes(uint16_t u16, std::basic_ostringstream<char16_t>& os,
-    const std::string& str, uint16_t& pos);
-static void process_utf16_control_codes(uint16_t u16, std::basic_ostringstream<char16_t>& os,
-    const std::string& str, uint16_t& pos);
-static std::u16string grf_string_to_utf16(const std::string& str);
-static std::u16string grf_string_utf16_to_readable_utf16(const std::u16string& str);
-static std::string binary_utf16_to_latin1(const std::u16string& str);
 
 
-static void print_control_code_info(const std::map<uint8_t, ControlCode>& controls)
+// Control codes are looked up by their value when reading binary strings, and by their
+// names when parsing YAGL strings.
+class ControlCodeTable
 {
-    size_t max_length{4}; // Min length to ensure the captions line up.
-    std::vector<uint8_t> keys;
-    for (auto& [key, value]: controls)
+public:
+    template <size_t N>
+    ControlCodeTable(const ControlCode (&codes)[N])
     {
-        keys.push_back(key);
-        max_length = std::max(max_length, std::u16string(value.name).size());
+        std::vector<std::pair<std::string, const ControlCode*>> names;
+        for (const ControlCode& code: codes)
+        {
+            m_by_code[code.code] = &code;
+            names.push_back({code.name, &code});
+        }
+        m_by_name.build(std::move(names));
     }
-    std::sort(keys.begin(), keys.end());
-    max_length += 2;
-
-    std::cout << "    Code  NArgs  Name";  
-    for (size_t i = 4; i < max_length; ++i) std::cout << ' '; 
-    std::cout << "Description\n";
-
-    std::cout << "    ----  -----  ----";  
-    for (size_t i = 6; i < max_length; ++i) std::cout << '-'; 
-    std::cout << "  -----------\n";
 
-    for (auto key: keys)
+    const ControlCode* find(uint8_t code) const { return m_by_code[code]; }
+    const ControlCode* find(std::string_view name) const
     {
-        const ControlCode& control = controls.at(key); 
-        std::u16string name{control.name};
-        std::cout << "    " << to_hex(control.code) << "    " << to_hex(control.data_size, false) << "   ";
-        std::cout << binary_utf16_to_latin1(name);
-        for (size_t i = name.size(); i < max_length; ++i) std::cout << ' '; 
-        std::cout << control.description << "\n";
+        auto code = m_by_name.find(name);
+        return (code != nullptr) ? *code : nullptr;
     }
+
+    void print_info() const;
+
+private:
+    std::array<const ControlCode*, 256> m_by_code{};
+    PerfectHash<const ControlCode*>     m_by_name;
+};
+
+
+const ControlCodeTable& control_codes()
+{
+    static const ControlCodeTable table{g_control_codes};
+    return table;
 }
 
 
-void print_control_code_info()
+const ControlCodeTable& extension_codes()
 {
-    std::cout << "Basic string control codes:\n\n";
-    print_control_code_info(g_control_codes);
+    static const ControlCodeTable table{g_extension_codes};
+    return table;
+}
 
-    std::cout << "\nExtended string control codes:\n\n";
-    print_control_code_info(g_extension_codes);
 
-    std::cout << "\nExample YAGL string with control codes:\n\n";
-    std::cout << "    name: \"Ridiculous Town Names {ext push-colour}{blue}1.2.3{ext pop-colour}\";\n\n";
+// The code which introduces an extension code in the next byte.
+constexpr uint8_t EXTENSION_CODE = 0x9A;
+// Control codes are placed into the private use area 0xE0xx to disambiguate them from characters.
+constexpr char16_t CONTROL_AREA  = 0xE000;
+
+
+bool is_control_area(char16_t c)
+{
+    return (c & 0xFF00) == CONTROL_AREA;
 }
 
 
-std::string grf_string_to_readable_utf8(const std::string& str)
+bool is_high_surrogate(char32_t c) { return (c >= 0xD800) && (c <= 0xDBFF); }
+bool is_low_surrogate(char32_t c)  { return (c >= 0xDC00) && (c <= 0xDFFF); }
+
+
+// Each character is encoded on its own, so a surrogate pair becomes two three byte sequences.
+void append_utf8(std::string& str, uint32_t value)
 {
-    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-    std::u16string str16  = grf_string_to_utf16(str);
-    std::u16string read16 = grf_string_utf16_to_readable_utf16(str16);
-    return converter.to_bytes(read16);
+    if (value < 0x80)
+    {
+        str += char(value);
+    }
+    else if (value < 0x800)
+    {
+        str += char(((value >> 6) & 0x1F) | 0xC0);
+        str += char((value & 0x3F) | 0x80);
+    }
+    else if (value < 0x10000)
+    {
+        str += char(((value >> 12) & 0x0F) | 0xE0);
+        str += char(((value >> 6) & 0x3F) | 0x80);
+        str += char((value & 0x3F) | 0x80);
+    }
+    else if (value < 0x110000)
+    {
+        str += char(((value >> 18) & 0x07) | 0xF0);
+        str += char(((value >> 12) & 0x3F) | 0x80);
+        str += char(((value >> 6) & 0x3F) | 0x80);
+        str += char((value & 0x3F) | 0x80);
+    }
 }
 
 
-// GRF strings are stored in one of two formats: Latin1 (sort of), or UTF8 (also sort of).
-// We first determine which one before proceeding. Decoding is then in two phases. First
-// we convert both formats to a common UTF16 format. This makes life a little easier. Second
-// we convert the UTF16 string into readable UTF8
-std::u16string grf_string_to_utf16(const std::string& str)
+// Same as to_hex(value, false) for a 16-bit value.
+void append_hex16(std::string& str, char16_t value)
 {
-    // We are UTF8 if the string begins with an upper case 'Thorn' character.
-    if (str.size() >= 2)
+    static constexpr char digits[] = "0123456789ABCDEF";
+    str += digits[(value >> 12) & 0xF];
+    str += digits[(value >> 8) & 0xF];
+    str += digits[(value >> 4) & 0xF];
+    str += digits[value & 0xF];
+}
+
+
+// A plain string contains no control codes, quotes, braces or non-ASCII characters. It is
+// the same in a GRF and a YAGL file, so no conversion is needed in either direction. This
+// is by far the most common case, so we check eight bytes at a time.
+struct TextScan
+{
+    bool plain;
+    bool ascii;
+};
+
+
+TextScan scan_text(const std::string& str)
+{
+    static constexpr uint64_t ONES = 0x0101010101010101ULL;
+    static constexpr uint64_t HIGH = 0x8080808080808080ULL;
+
+    auto scan_word = [](uint64_t x, uint64_t& special, uint64_t& high)
+    {
+        uint64_t quotes = x ^ (ONES * '"');
+        special |= (x - ONES * 0x20) & ~x & HIGH;           // Any byte < 0x20
+        special |= (quotes - ONES) & ~quotes & HIGH;         // Any byte == '"'
+        special |= ((x + ONES * (127 - 0x7A)) | x) & HIGH;  // Any byte > 0x7A, including braces
+        high    |= x & HIGH;
+    };
+
+    uint64_t special = 0;
+    uint64_t high    = 0;
+
+    const char* data = str.data();
+    size_t      size = str.size();
+    size_t      pos  = 0;
+    for (; (pos + sizeof(uint64_t)) <= size; pos += sizeof(uint64_t))
     {
-        uint8_t c0 = str[0];
-        uint8_t c1 = str[1];
-        if ((c0 == 0xC3) && (c1 == 0x9E))
+        uint64_t x;
+        std::memcpy(&x, data + pos, sizeof(x));
+        scan_word(x, special, high);
+        if (high != 0)
         {
-            return grf_string_utf8_to_utf16(str);
+            return { false, false };
         }
     }
 
-    return grf_string_latin1_to_utf16(str);
+    // Pad the tail with spaces, which are plain.
+    uint64_t x = ONES * ' ';
+    std::memcpy(&x, data + pos, size - pos);
+    scan_word(x, special, high);
+
+    return { (special | high) == 0, high == 0 };
 }
 
 
-// Convert a Latin-1 string to UTF-16. The control codes are placed into the
-// private 0xE0xx area to disambiguate them.
-std::u16string grf_string_latin1_to_utf16(const std::string& str)
+// GRF strings are stored in one of two formats: Latin1 (sort of), or UTF8 (also sort of).
+// This reads either format as a sequence of UTF-16 characters, in which the control codes
+// are placed into the private 0xE0xx area, and each is followed by its arguments. This
+// used to be built as an intermediate string, but is now consumed as it is decoded.
+class GRFStringReader
 {
-    std::basic_ostringstream<char16_t> os;
+public:
+    GRFStringReader(const std::string& str)
+    : m_str{str}
+    {
+        // We are UTF8 if the string begins with an upper case 'Thorn' character.
+        if ((str.size() >= 2) && (byte(0) == 0xC3) && (byte(1) == 0x9E))
+        {
+            // Skip the leading thorn character - we don't actually need this.
+            m_utf8 = true;
+            m_pos  = 2;
+        }
+    }
 
-    uint16_t length = uint16_t(str.size());
-    for (uint16_t pos = 0; pos < length; ++pos)
+    bool next(char16_t& c)
     {
-        uint8_t u16 = str[pos];
-        process_utf16_control_codes(u16, os, str, pos);
+        if (m_head == m_count)
+        {
+            if (m_pos >= m_str.size())
+            {
+                return false;
+            }
+            m_head  = 0;
+            m_count = 0;
+            m_utf8 ? decode_utf8() : decode_latin1();
+        }
+
+        c = m_pending[m_head++];
+        return true;
     }
 
-    return os.str();
+    // Arguments which run off the end of the string are read as zero.
+    char16_t next_or_zero()
+    {
+        char16_t c = 0;
+        next(c);
+        return c;
+    }
+
+private:
+    uint8_t byte(size_t pos) const { return (pos < m_str.size()) ? uint8_t(m_str[pos]) : 0; }
+    void push(char16_t c)          { m_pending[m_count++] = c; }
+
+    // Arguments are sign extended, as they always have been, so bytes >= 0x80
+    // appear in the YAGL as 0xFFxx.
+    char16_t argument()            { return char16_t(int8_t(byte(++m_pos))); }
+
+    void decode_latin1();
+    void decode_utf8();
+    void process_control_code(uint16_t u16);
+
+private:
+    const std::string& m_str;
+    size_t             m_pos{};
+    bool               m_utf8{};
+
+    // A control code can produce up to six values: the code, an extension code and arguments.
+    std::array<char16_t, 8> m_pending{};
+    uint8_t                 m_head{};
+    uint8_t                 m_count{};
+};
+
+
+void GRFStringReader::decode_latin1()
+{
+    process_control_code(byte(m_pos));
+    ++m_pos;
 }
 
 
-// Convert a UTF-8 string to UTF-16. The control codes are placed into the
-// private 0xE0xx area to disambiguate them.
-//
 // Basically there are three possibilities:
 //
 // 1. Characters U+E020..U+E0FF in the E0xx Private Use Area do what their respective
@@ -259,9 +384,8 @@ std::u16string grf_string_latin1_to_utf16(const std::string& str)
 // E082        EE 82 82                 Print date (day, month, year)
 // E0AC        EE 82 AC                 Tick mark
 //
-// These examples go wrong on the first byte, what about going wrong on the second
-// or subsequent bytes?
-std::u16string grf_string_utf8_to_utf16(const std::string& str)
+// ASCII characters are also treated as possible control codes, as in the Latin1 case.
+void GRFStringReader::decode_utf8()
 {
     // Constants to help avoid issues with unicode encoding.
     static constexpr uint8_t MASK_2_BYTE = 0xE0;
@@ -273,618 +397,649 @@ std::u16string grf_string_utf8_to_utf16(const std::string& str)
     static constexpr uint8_t MASK_NEXT   = 0xC0;
     static constexpr uint8_t LEAD_NEXT   = 0x80;
 
-    std::basic_ostringstream<char16_t> os;
-
-    uint16_t length = uint16_t(str.size());
-    //for (uint16_t pos = 0; pos < length; ++pos)
-    // Skip the leading thorn character - we don't actually need this.
-    for (uint16_t pos = 2; pos < length; ++pos)
+    // Extract the next character from the UTF8 string. This is either a valid
+    // multibyte sequence, or we take the first byte.
+    uint8_t  c0      = byte(m_pos);
+    uint16_t u16     = c0;
+    bool     invalid = true;
+    if ((c0 & MASK_4_BYTE) == LEAD_4_BYTE)
     {
-        // Extract the next character from the UTF8 string. This is either a valid
-        // multibyte sequence, or we take the first byte.
-        uint8_t  c0      = str[pos];
-        uint16_t u16     = c0;
-        bool     invalid = true;
-        if (c0 < 0x80)
+        uint8_t c1 = byte(m_pos + 1);
+        uint8_t c2 = byte(m_pos + 2);
+        uint8_t c3 = byte(m_pos + 3);
+        if (((c1 & MASK_NEXT) == LEAD_NEXT) && ((c2 & MASK_NEXT) == LEAD_NEXT) && ((c3 & MASK_NEXT) == LEAD_NEXT))
         {
-            // One byte value
-            u16 = c0;
+            // We should encode this as UTF16. Very unlikely that we will see any of these.
+            throw RUNTIME_ERROR("Character from outside the basic multilingual plane");
         }
-        else if ((c0 & MASK_4_BYTE) == LEAD_4_BYTE)
-        {
-            // Four byte value
-            uint8_t c1 = str[pos+1];
-            uint8_t c2 = str[pos+2];
-            uint8_t c3 = str[pos+3];
-            if (((c1 & MASK_NEXT) == LEAD_NEXT) && ((c2 & MASK_NEXT) == LEAD_NEXT) && ((c3 & MASK_NEXT) == LEAD_NEXT))
-            {
-                // We should encode this as UTF16. Very unlikely that we will see any of these.
-                throw RUNTIME_ERROR("Character from outside the basic multilingual plane");
-
-                //uint32_t u32;
-                //u32   = (c0 & ~MASK_4_BYTE) << 18;
-                //u32  |= (c1 & ~MASK_NEXT)   << 12;
-                //u32  |= (c2 & ~MASK_NEXT)   << 6;
-                //u32  |= (c3 & ~MASK_NEXT);
-                //pos += 3;
-                //invalid = false;
-            }
-        }
-        else if ((c0 & MASK_3_BYTE) == LEAD_3_BYTE)
+    }
+    else if ((c0 & MASK_3_BYTE) == LEAD_3_BYTE)
+    {
+        uint8_t c1 = byte(m_pos + 1);
+        uint8_t c2 = byte(m_pos + 2);
+        if (((c1 & MASK_NEXT) == LEAD_NEXT) && ((c2 & MASK_NEXT) == LEAD_NEXT))
         {
-            // Three byte value
-            uint8_t c1 = str[pos+1];
-            uint8_t c2 = str[pos+2];
-            if (((c1 & MASK_NEXT) == LEAD_NEXT) && ((c2 & MASK_NEXT) == LEAD_NEXT))
-            {
-                u16   = (c0 & ~MASK_3_BYTE) << 12;
-                u16  |= (c1 & ~MASK_NEXT) << 6;
-                u16  |= (c2 & ~MASK_NEXT);
-                pos  += 2;
-                invalid = false;
-            }
+            u16    = (c0 & ~MASK_3_BYTE) << 12;
+            u16   |= (c1 & ~MASK_NEXT) << 6;
+            u16   |= (c2 & ~MASK_NEXT);
+            m_pos += 2;
+            invalid = false;
         }
-        else if ((c0 & MASK_2_BYTE) == LEAD_2_BYTE)
+    }
+    else if ((c0 & MASK_2_BYTE) == LEAD_2_BYTE)
+    {
+        uint8_t c1 = byte(m_pos + 1);
+        if ((c1 & MASK_NEXT) == LEAD_NEXT)
         {
-            // Two byte value
-            uint8_t c1 = str[pos+1];
-            if ((c1 & MASK_NEXT) == LEAD_NEXT)
-            {
-                u16   = (c0 & ~MASK_2_BYTE) << 6;
-                u16  |= (c1 & ~MASK_NEXT);
-                pos  += 1;
-                invalid = false;
-            }
+            u16    = (c0 & ~MASK_2_BYTE) << 6;
+            u16   |= (c1 & ~MASK_NEXT);
+            m_pos += 1;
+            invalid = false;
         }
+    }
+
+    // Check for control codes. This really just to extract any arguments that
+    // might be in the string for some of the codes.
+    if (invalid || (u16 <= 0x20) || is_control_area(u16))
+    {
+        process_control_code(u16);
+    }
+    else
+    {
+        // This is not a control code.
+        push(u16);
+    }
+    ++m_pos;
+}
 
-        // Check for control codes. This really just to extract any arguments that
-        // might be in the string for some of the codes.
-        if (invalid || (u16 <= 0x20) || ((u16 & 0xFF00) == 0xE000))
+
+void GRFStringReader::process_control_code(uint16_t u16)
+{
+    const ControlCode* code = control_codes().find(u16 & 0xFF);
+    if (code == nullptr)
+    {
+        // This is not a control code.
+        push(u16);
+        return;
+    }
+
+    // This is a control code. Store in the range 0xE0xx.
+    push(u16 | CONTROL_AREA);
+    for (uint8_t d = 0; d < code->data_size; ++d)
+    {
+        push(argument());
+    }
+
+    if ((u16 & 0xFF) == EXTENSION_CODE)
+    {
+        // No need to place the extension sub-code into 0xE0xx.
+        uint8_t c = byte(++m_pos);
+        const ControlCode* extension = extension_codes().find(c);
+        if (extension == nullptr)
         {
-            process_utf16_control_codes(u16, os, str, pos);
+            throw RUNTIME_ERROR("unexpected extension code");
         }
-        else
+
+        push(c);
+        for (uint8_t d = 0; d < extension->data_size; ++d)
         {
-            // This is not a control code.
-            os << static_cast<char16_t>(u16);
+            push(argument());
         }
     }
-
-    return os.str();
 }
 
 
-// Convert a UTF-16 string with control codes into a UTF-16 string with human readable
-// versions of the codes. This can be converted to UTF-8 for display or printing.
-// Could probably short circuit some of the conversion steps, but it seems wise to be
-// clear about what is going on.
-std::u16string grf_string_utf16_to_readable_utf16(const std::u16string& str)
+// Writes the human readable UTF-8 version of a string. Characters are converted as they would be
+// from UTF-16, so a surrogate pair is combined into a single character.
+class ReadableWriter
 {
-    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-    std::basic_ostringstream<char16_t> os;
+public:
+    ReadableWriter(std::string& str) : m_str{str} {}
 
-    uint16_t length = uint16_t(str.size());
-    for (uint16_t pos = 0; pos < length; ++pos)
+    void append(char16_t c)
     {
-        char16_t c = str[pos];
-        uint16_t u = c;
-        if ((c & 0xFF00) == 0xE000)
+        if (m_high != 0)
         {
-            // This is a control code.
-            const auto& it = g_control_codes.find(c & 0x00FF);
-            if (it != g_control_codes.end())
-            {
-                const ControlCode& code = it->second;
-                os << u"{" << code.name;
-                for (uint8_t d = 0; d < code.data_size; ++d)
-                {
-                    os << u" 0x" << converter.from_bytes(to_hex(str[++pos], false));
-                }
-
-                if ((c & 0xFF) == 0x9A)
-                {
-                    // This is an extension control code.
-                    c = str[++pos];
-                    const auto& it2 = g_extension_codes.find(c & 0x00FF);
-                    if (it2 != g_extension_codes.end())
-                    {
-                        const ControlCode& code = it2->second;
-                        os << u" " << code.name;
-                        for (uint8_t d = 0; d < code.data_size; ++d)
-                        {
-                            os << u" 0x" << converter.from_bytes(to_hex(str[++pos], false));
-                        }
-                    }
-                    else
-                    {
-                        throw RUNTIME_ERROR("unexpected extension code");
-                    }
-                }
-
-                os << u"}";
-            }
-            else
+            if (!is_low_surrogate(c))
             {
-                // Shouldn't get here. It means the string contains a control code we don't know about.
-                // But the string was processed with the list that we do know about already...
-                os <<  u"{<unknown> 0x" << converter.from_bytes(to_hex(str[++pos], false)) << u"}";
+                throw RUNTIME_ERROR("Unpaired surrogate in string");
             }
+            append_utf8(m_str, 0x10000 + ((m_high - 0xD800) << 10) + (c - 0xDC00));
+            m_high = 0;
         }
-        else if (c == '"')
+        else if (is_high_surrogate(c))
         {
-            // This is a bit of a pain. We need to escape double quotes because these are
-            // important when parsing the YAGL in again. Also going to need an escape for '{'
-            // in case anyone wants to use it in strings.
-            os << u"{dq}";
+            // An unpaired high surrogate at the end of the string is dropped.
+            m_high = c;
+        }
+        else if (is_low_surrogate(c))
+        {
+            throw RUNTIME_ERROR("Unpaired surrogate in string");
         }
         else
         {
-            os << c;
+            append_utf8(m_str, c);
         }
     }
 
-    return os.str();
-}
+    // Text added for control codes is all ASCII.
+    void append(const char* text)
+    {
+        if (m_high != 0)
+        {
+            throw RUNTIME_ERROR("Unpaired surrogate in string");
+        }
+        m_str += text;
+    }
 
+    void append_hex(char16_t value)
+    {
+        append(" 0x");
+        append_hex16(m_str, value);
+    }
+
+private:
+    std::string& m_str;
+    char16_t     m_high{};
+};
 
-// Insert the given character into the stream and any arguments for the control codes.
-static void process_utf16_extension_codes(uint16_t u16, std::basic_ostringstream<char16_t>& os,
-    const std::string& str, uint16_t& pos)
+
+// Writes the binary version of a string from a sequence of UTF-16 characters in which control codes
+// are in the 0xE0xx area. Control codes are followed by their arguments, which are written as bytes.
+// Strings are written as UTF-8 if they contain any characters which are not ASCII, or which would be
+// confused with the control codes. This is only known at the end, so the writer records whether
+// UTF-8 was needed, and the caller tries again if the guess was wrong.
+class GRFStringWriter
 {
-    // This may be an extension code.
-    if ((u16 & 0xFF) == 0x9A)
+public:
+    GRFStringWriter(bool utf8)
+    : m_utf8{utf8}
     {
-        uint8_t c = str[++pos];
-        const auto& it2 = g_extension_codes.find(c);
-        if (it2 != g_extension_codes.end())
+        if (m_utf8)
         {
-            // This is an extension control code. No need to place
-            // this extension sub-code into 0xE0xx.
-            const ControlCode& code = it2->second;
-            os << static_cast<char16_t>(c);
+            // Thorn indicates that this string is encoded with UTF8.
+            append_utf8(m_str, 0x00DE);
+        }
+    }
 
-            // Arguments for the code, if any.
-            for (uint8_t d = 0; d < code.data_size; ++d)
+    void append(char16_t c)
+    {
+        if (m_extension)
+        {
+            // The extension code and any arguments are placed into the string without special encoding.
+            m_str += char(c);
+            const ControlCode* extension = extension_codes().find(c & 0xFF);
+            m_extension = false;
+            m_args      = (extension != nullptr) ? extension->data_size : 0;
+        }
+        else if (m_args > 0)
+        {
+            m_str += char(c);
+            --m_args;
+        }
+        else if (is_control_area(c))
+        {
+            if (!m_utf8 || (c == 0xE00D))
             {
-                os << static_cast<char16_t>(str[++pos]);
+                m_str += char(c);
+            }
+            else
+            {
+                append_utf8(m_str, c);
+            }
+
+            const ControlCode* code = control_codes().find(c & 0xFF);
+            if (code != nullptr)
+            {
+                m_extension = (code->code == EXTENSION_CODE);
+                m_args      = m_extension ? 0 : code->data_size;
             }
         }
         else
         {
-            throw RUNTIME_ERROR("unexpected extension code");
+            // Force UTF8 encoding if the string contains braces.
+            m_needs_utf8 |= (c == u'{') || (c == u'}') || (c >= 0x80);
+            if (m_utf8)
+            {
+                append_utf8(m_str, c);
+            }
+            else
+            {
+                m_str += char(c);
+            }
         }
     }
-}
 
+    bool is_utf8() const    { return m_utf8; }
+    bool needs_utf8() const { return m_needs_utf8; }
+    std::string& str()      { return m_str; }
+
+private:
+    std::string m_str;
+    bool        m_utf8{};
+    bool        m_needs_utf8{};
+    bool        m_extension{};
+    uint8_t     m_args{};
+};
 
-// Insert the given character into the stream and any arguments for the control codes.
-static void process_utf16_control_codes(uint16_t u16, std::basic_ostringstream<char16_t>& os,
-    const std::string& str, uint16_t& pos)
+
+// Reads the next character from a UTF-8 string as UTF-16, following the rules of the standard
+// library's codecvt_utf8_utf16 conversion which was used previously. Returns false at the end
+// of the string, or if there are too few bytes left for the next character.
+bool read_utf8(const std::string& str, size_t& pos, char32_t& c)
 {
-    // This may be a control code.
-    const auto& it = g_control_codes.find(u16 & 0xFF);
-    if (it != g_control_codes.end())
+    size_t avail = str.size() - pos;
+    if (avail == 0)
     {
-        // This is a control code. Store in the range 0xE0xx.
-        const ControlCode& code = it->second;
-        os << static_cast<char16_t>(u16 | 0xE000);
+        return false;
+    }
 
-        // Arguments for the code, if any.
-        for (uint8_t d = 0; d < code.data_size; ++d)
+    auto invalid = []() { return RUNTIME_ERROR("Invalid UTF-8 in string"); };
+    auto next    = [&str, &pos, &invalid](size_t offset)
+    {
+        uint8_t b = str[pos + offset];
+        if ((b & 0xC0) != 0x80)
         {
-            os << static_cast<char16_t>(str[++pos]);
+            throw invalid();
         }
+        return char32_t(b & 0x3F);
+    };
 
-        process_utf16_extension_codes(u16, os, str, pos);
-    }
-    else
+    uint8_t c1 = str[pos];
+    if (c1 < 0x80)
     {
-        // This is not a control code.
-        os << static_cast<char16_t>(u16);
+        c = c1;
+        pos += 1;
+        return true;
     }
-}
-
 
-std::string read_string(std::istream& is)
-{
-    std::string result;
-    std::getline(is, result, char(0));
-
-    if (is.fail())
+    // Continuation bytes, overlong two byte sequences and values beyond U+10FFFF are invalid.
+    if ((c1 < 0xC2) || (c1 >= 0xF5))
     {
-        throw RUNTIME_ERROR("read_string failed");
+        throw invalid();
     }
 
-    return result;
-}
+    // A character which is cut short stops the conversion, and the rest of the string is ignored.
+    size_t length = (c1 < 0xE0) ? 2 : (c1 < 0xF0) ? 3 : 4;
+    if (avail < length)
+    {
+        return false;
+    }
 
+    if (length == 2)
+    {
+        c = ((c1 & 0x1F) << 6) | next(1);
+    }
+    else if (length == 3)
+    {
+        char32_t c2 = next(1);
+        if ((c1 == 0xE0) && (c2 < 0x20)) throw invalid();
+        c = ((c1 & 0x0F) << 12) | (c2 << 6) | next(2);
+    }
+    else
+    {
+        char32_t c2 = next(1);
+        if ((c1 == 0xF0) && (c2 < 0x10)) throw invalid();
+        if ((c1 == 0xF4) && (c2 >= 0x10)) throw invalid();
+        c = ((c1 & 0x07) << 18) | (c2 << 12) | (next(2) << 6) | next(3);
+    }
 
-void write_string(std::ostream& os, const std::string& value, StringTerm term)
-{
-    // Optionally write without a 0 terminator - one or two strings in the GRF are terminated by end of record or whatever.
-    os.write(value.c_str(), value.length() + ((term == StringTerm::None) ? 0 : 1));
+    pos += length;
+    return true;
 }
 
 
-void write_string(std::ostream& os, const std::string& value)
+void append_utf16(GRFStringWriter& writer, char32_t c)
 {
-    write_string(os, value, StringTerm::Null);
+    if (c >= 0x10000)
+    {
+        c -= 0x10000;
+        writer.append(char16_t(0xD800 + (c >> 10)));
+        writer.append(char16_t(0xDC00 + (c & 0x3FF)));
+    }
+    else
+    {
+        writer.append(char16_t(c));
+    }
 }
 
 
-static const ControlCode& find_extension_code(const std::u16string& name)
+// Arguments are written in hex with a leading '0x', which is assumed rather than checked.
+char16_t parse_control_argument(std::string_view arg)
 {
-    for (const auto& item: g_extension_codes)
+    if (arg.size() < 2)
     {
-        const ControlCode& control = item.second;
-        if (control.name == name)
-        {
-            return control;
-        }
+        return 0;
     }
-    throw RUNTIME_ERROR("Unknown extension code");
+    std::string digits{arg.substr(2)};
+    return char16_t(strtoul(digits.c_str(), nullptr, 16));
 }
 
 
-static void parse_extension_code(std::vector<std::u16string>& args, std::basic_ostringstream<char16_t>& os)
+// The arguments in a control code are the name, an extension name if any, and hex values.
+struct ControlArgs
 {
-    const ControlCode& extension = find_extension_code(args[1]);
-    os << char16_t(extension.code);
+    static constexpr uint8_t MAX_ARGS = 4;
+    std::array<std::string_view, MAX_ARGS> args;
+    size_t count{};
 
-    if (args.size() == (extension.data_size + 2))
+    void push(std::string_view arg)
     {
-        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-
-        for (uint8_t i = 0; i < extension.data_size; ++i)
+        if (count < MAX_ARGS)
         {
-            std::string arg = converter.to_bytes(args[i + 2]);
-            char16_t value = char16_t (strtoul(arg.c_str() + 2, nullptr, 16));
-            os << value;
+            args[count] = arg;
         }
+        ++count;
     }
-    else
-    {
-        throw RUNTIME_ERROR("Incorrect number of control arguments");
-    }
-}
+};
 
 
-static const ControlCode& find_control_code(const std::u16string& name)
+void parse_control_code(const ControlArgs& args, GRFStringWriter& writer)
 {
-    for (const auto& item: g_control_codes)
+    const ControlCode* control = control_codes().find(args.args[0]);
+    if (control == nullptr)
     {
-        const ControlCode& control = item.second;
-        if (control.name == name)
-        {
-            return control;
-        }
+        throw RUNTIME_ERROR("Unknown control code");
     }
-    throw RUNTIME_ERROR("Unknown control code");
-}
-
+    writer.append(char16_t(control->code | CONTROL_AREA));
 
-static void parse_control_code(std::vector<std::u16string>& args, std::basic_ostringstream<char16_t>& os)
-{
-    const ControlCode& control = find_control_code(args[0]);
-    os << char16_t(control.code | 0xE000);
-
-    if (control.code == 0x9A)
+    if (control->code == EXTENSION_CODE)
     {
-        parse_extension_code(args, os);
+        const ControlCode* extension = (args.count >= 2) ? extension_codes().find(args.args[1]) : nullptr;
+        if (extension == nullptr)
+        {
+            throw RUNTIME_ERROR("Unknown extension code");
+        }
+        writer.append(char16_t(extension->code));
+
+        if (args.count != size_t(extension->data_size + 2))
+        {
+            throw RUNTIME_ERROR("Incorrect number of control arguments");
+        }
+        for (uint8_t i = 0; i < extension->data_size; ++i)
+        {
+            writer.append(parse_control_argument(args.args[i + 2]));
+        }
     }
     else
     {
-        if (args.size() == (control.data_size + 1))
+        if (args.count != size_t(control->data_size + 1))
         {
-           std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-
-           for (uint8_t i = 0; i < control.data_size; ++i)
-            {
-                std::string arg = converter.to_bytes(args[i + 1]);
-                char16_t value = char16_t(strtoul(arg.c_str() + 2, nullptr, 16));
-                os << value;
-            }
+            throw RUNTIME_ERROR("Incorrect number of extension arguments");
         }
-        else
+        for (uint8_t i = 0; i < control->data_size; ++i)
         {
-            throw RUNTIME_ERROR("Incorrect number of extension arguments");
+            writer.append(parse_control_argument(args.args[i + 1]));
         }
     }
 }
 
 
-static std::u16string readable_utf16_to_binary_utf16(const std::u16string& str)
+bool is_space(char32_t c)
+{
+    return (c == ' ') || ((c >= '\t') && (c <= '\r'));
+}
+
+
+// Translate the human readable control codes into their binary form, and write the result.
+void parse_readable(const std::string& str, GRFStringWriter& writer)
 {
     enum class State { Normal, Brace, Control };
     State state = State::Normal;
 
-    // Output string with text control codes converted to binary equivalents.
-    std::basic_ostringstream<char16_t> os;
+    ControlArgs args;
+    size_t      start = 0;
 
-    // Probably not the most efficient method of finding the control codes within the string,
-    // but we can refactor later. At least this is simple to understand. The vector of strings
-    // is to deal with extension codes and arguments.
-    std::basic_ostringstream<char16_t> cs;
-    std::vector<std::u16string> args;
-
-    uint16_t length = uint16_t(str.length());
-    for (uint16_t pos = 0; pos < length; ++pos)
+    size_t   pos = 0;
+    size_t   end = 0;
+    char32_t c   = 0;
+    while (read_utf8(str, end, c))
     {
-        char16_t u16 = str[pos];
         switch (state)
         {
             case State::Normal:
                 // '{' is the escape sequence which potentially begins a control code,
                 // or just accept the character.
-                if (u16 == u'{')
+                if (c == U'{')
                 {
                     state = State::Brace;
                 }
                 else
                 {
-                    os << u16;
+                    append_utf16(writer, c);
                 }
                 break;
 
             case State::Brace:
                 // '{{' is the escape sequence meaning a literal '{',
                 // or we have started a control code sequence.
-                if (u16 == u'{')
+                if (c == U'{')
                 {
                     state = State::Normal;
-                    os << u'{';
+                    writer.append(u'{');
                     break;
                 }
                 state = State::Control;
+                args  = ControlArgs{};
+                start = pos;
                 // Fall through
 
             case State::Control:
-                if (u16 == u'}')
+                if (c == U'}')
                 {
-                    args.push_back(cs.str());
-                    cs.str(u"");
-
-                    // Process control codes we found.
-                    parse_control_code(args, os);
-
-                    args.clear();
+                    args.push(std::string_view{str}.substr(start, pos - start));
+                    parse_control_code(args, writer);
                     state = State::Normal;
                 }
-                else if (std::isspace(u16))
+                else if (is_space(c))
                 {
-                    // This seems to ignore empty strings, which is what we want.
-                    args.push_back(cs.str());
-                    cs.str(u"");
-                }
-                else
-                {
-                    // This is a control code character.
-                    cs << u16;
+                    // Empty arguments are kept, and lead to an error.
+                    args.push(std::string_view{str}.substr(start, pos - start));
+                    start = end;
                 }
                 break;
         }
-    }
 
-    auto result = os.str();
-    auto c = result[0];
-    return result;
+        pos = end;
+    }
 }
 
 
-static void convert_utf32_utf8(uint32_t value, std::ostringstream& os)
+void ControlCodeTable::print_info() const
 {
-    if (value < 0x80)
-    {
-        os << uint8_t(value);
-    }
-    else if (value < 0x800)
-    {
-        os << uint8_t(((value >> 6) & 0x1F) | 0xC0);
-        os << uint8_t((value & 0x3F) | 0x80);
-    }
-    else if (value < 0x10000)
+    size_t max_length{4}; // Min length to ensure the captions line up.
+    for (auto control: m_by_code)
     {
-        os << uint8_t(((value >> 12) & 0x0F) | 0xE0);
-        os << uint8_t(((value >> 6) & 0x3F) | 0x80);
-        os << uint8_t((value & 0x3F) | 0x80);
+        if (control != nullptr)
+        {
+            max_length = std::max(max_length, std::strlen(control->name));
+        }
     }
-    else if (value < 0x110000)
+    max_length += 2;
+
+    std::cout << "    Code  NArgs  Name";
+    for (size_t i = 4; i < max_length; ++i) std::cout << ' ';
+    std::cout << "Description\n";
+
+    std::cout << "    ----  -----  ----";
+    for (size_t i = 6; i < max_length; ++i) std::cout << '-';
+    std::cout << "  -----------\n";
+
+    for (auto control: m_by_code)
     {
-        value = value - 0x10000;
-        os << uint8_t(((value >> 18) & 0x07) | 0xF0);
-        os << uint8_t(((value >> 12) & 0x3F) | 0x80);
-        os << uint8_t(((value >> 6) & 0x3F) | 0x80);
-        os << uint8_t((value & 0x3F) | 0x80);
+        if (control != nullptr)
+        {
+            std::cout << "    " << to_hex(control->code) << "    " << to_hex(control->data_size, false) << "   ";
+            std::cout << control->name;
+            for (size_t i = std::strlen(control->name); i < max_length; ++i) std::cout << ' ';
+            std::cout << control->description << "\n";
+        }
     }
 }
 
 
-static bool binary_utf16_is_utf8(const std::u16string& str)
-{
-    uint16_t length = uint16_t(str.length());
-    uint16_t pos = 0;
-    while (pos < length)
-    {
-        // Items are mostly converted to UTF8 ...
-        auto c = str[pos++];
+} // namespace {
 
-        // ... but control codes get further treatment.
-        if ((c & 0xFF00) == 0xE000)
-        {
-            // If this is an extension, the index is placed into the string without special encoding.
-            auto it = g_control_codes.find(c & 0xFF);
-            if (it->second.code == 0x9A)
-            {
-                c = str[pos++];
-                it = g_extension_codes.find(c & 0xFF);
-            }
 
-            // If the control or extension code has arguments, these are places into the string
-            // without special encoding.
-            for (uint8_t arg = 0; arg < it->second.data_size; ++arg)
-            {
-                c = str[pos++];
-            }
-        }
-        // Force UTF8 encoding if the string contains braces.
-        else if ((c == u'{') || (c == u'}'))
-        {
-            return true;
-        }
-        else if (c >= 0x80)
-        {
-            return true;
-        }
-    }
+void print_control_code_info()
+{
+    std::cout << "Basic string control codes:\n\n";
+    control_codes().print_info();
+
+    std::cout << "\nExtended string control codes:\n\n";
+    extension_codes().print_info();
 
-    return false;
+    std::cout << "\nExample YAGL string with control codes:\n\n";
+    std::cout << "    name: \"Ridiculous Town Names {ext push-colour}{blue}1.2.3{ext pop-colour}\";\n\n";
 }
 
 
-static std::string binary_utf16_to_utf8(const std::u16string& str)
+// Convert a binary GRF string into readable UTF-8 in a single pass. Control codes are
+// replaced by their names in braces, followed by any arguments in hex.
+std::string grf_string_to_readable_utf8(const std::string& str)
 {
-    std::ostringstream os;
-    // Thorn indicates that this string is encoded with UTF8.
-    convert_utf32_utf8(0x00DE, os);
-
-    uint16_t length = uint16_t(str.length());
-    uint16_t pos = 0;
-    while (pos < length)
+    if (scan_text(str).plain)
     {
-        // Items are mostly converted to UTF8 ...
-        auto c = str[pos++];
+        return str;
+    }
 
-        // ... but control codes get further treatment.
-        if ((c & 0xFF00) == 0xE000)
+    std::string result;
+    result.reserve(str.size() + str.size() / 2);
+
+    ReadableWriter  writer{result};
+    GRFStringReader reader{str};
+    char16_t c;
+    while (reader.next(c))
+    {
+        if (is_control_area(c))
         {
-            if (c == 0xE00D)
-            {
-                os << uint8_t(c);
-            }
-            else
+            const ControlCode* code = control_codes().find(c & 0xFF);
+            if (code != nullptr)
             {
-                convert_utf32_utf8(c, os);
-            }
+                writer.append("{");
+                writer.append(code->name);
+                for (uint8_t d = 0; d < code->data_size; ++d)
+                {
+                    writer.append_hex(reader.next_or_zero());
+                }
 
-            // If this is an extension, the index is placed into the string without special encoding.
-            auto it = g_control_codes.find(c & 0xFF);
-            if (it->second.code == 0x9A)
-            {
-                c = str[pos++];
-                os << uint8_t(c);
+                if ((c & 0xFF) == EXTENSION_CODE)
+                {
+                    c = reader.next_or_zero();
+                    const ControlCode* extension = extension_codes().find(c & 0xFF);
+                    if (extension == nullptr)
+                    {
+                        throw RUNTIME_ERROR("unexpected extension code");
+                    }
 
-                it = g_extension_codes.find(c & 0xFF);
-            }
+                    writer.append(" ");
+                    writer.append(extension->name);
+                    for (uint8_t d = 0; d < extension->data_size; ++d)
+                    {
+                        writer.append_hex(reader.next_or_zero());
+                    }
+                }
 
-            // If the control or extension code has arguments, these are places into the string
-            // without special encoding.
-            for (uint8_t arg = 0; arg < it->second.data_size; ++arg)
+                writer.append("}");
+            }
+            else
             {
-                c = str[pos++];
-                os << uint8_t(c);
+                // A UTF-8 string may contain a character in the private area which is not a
+                // control code we know about.
+                writer.append("{<unknown>");
+                writer.append_hex(reader.next_or_zero());
+                writer.append("}");
             }
         }
+        else if (c == u'"')
+        {
+            // This is a bit of a pain. We need to escape double quotes because these are
+            // important when parsing the YAGL in again. Also going to need an escape for '{'
+            // in case anyone wants to use it in strings.
+            writer.append("{dq}");
+        }
         else
         {
-            convert_utf32_utf8(c, os);
+            writer.append(c);
         }
-
     }
 
-    return os.str();
+    return result;
 }
 
 
-static std::string binary_utf16_to_latin1(const std::u16string& str)
+// Convert a readable UTF-8 string from the YAGL into a binary GRF string in a single pass.
+std::string readable_utf8_to_grf_string(const std::string& str)
 {
-    std::ostringstream os;
-
-    uint16_t length = uint16_t(str.length());
-    uint16_t pos = 0;
-    while (pos < length)
+    TextScan scan = scan_text(str);
+    if (scan.plain)
     {
-        // Items are mostly converted to UTF8 ...
-        auto c = str[pos++];
+        return str;
+    }
 
-        // ... but control codes get further treatment.
-        if ((c & 0xFF00) == 0xE000)
-        {
-            os << uint8_t(c);
+    // Strings with non-ASCII characters are almost always written as UTF-8, but the choice
+    // depends on the characters which are not part of control codes. Guess, and try again
+    // with the other encoding if we were wrong.
+    GRFStringWriter writer{!scan.ascii};
+    parse_readable(str, writer);
+    if (writer.needs_utf8() != writer.is_utf8())
+    {
+        writer = GRFStringWriter{writer.needs_utf8()};
+        parse_readable(str, writer);
+    }
 
-            // If this is an extension, the index is placed into the string without special encoding.
-            auto it = g_control_codes.find(c & 0xFF);
-            if (it->second.code == 0x9A)
-            {
-                c = str[pos++];
-                os << uint8_t(c);
+    return std::move(writer.str());
+}
 
-                it = g_extension_codes.find(c & 0xFF);
-            }
 
-            // If the control or extension code has arguments, these are places into the string
-            // without special encoding.
-            for (uint8_t arg = 0; arg < it->second.data_size; ++arg)
-            {
-                c = str[pos++];
-                os << uint8_t(c);
-            }
-        }
-        else
-        {
-            os << uint8_t(c);
-        }
+std::string read_string(std::istream& is)
+{
+    std::string result;
+    std::getline(is, result, char(0));
 
+    if (is.fail())
+    {
+        throw RUNTIME_ERROR("read_string failed");
     }
 
-    return os.str();
+    return result;
 }
 
 
-static std::string readable_utf8_to_grf_string(const std::string& str)
+void write_string(std::ostream& os, const std::string& value, StringTerm term)
 {
-    // Input is the string that comes from the YAGL.
-
-    // Convert to UTF16 as an intermediate (all characters are single elements).
-    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
-    std::u16string readable_utf16 = converter.from_bytes(str);
+    // Optionally write without a 0 terminator - one or two strings in the GRF are terminated by end of record or whatever.
+    os.write(value.c_str(), value.length() + ((term == StringTerm::None) ? 0 : 1));
+}
 
-    // Translate the control codes into their UTF16 binary form.
-    std::u16string binary_u16 = readable_utf16_to_binary_utf16(readable_utf16);
 
-    // Test for non-Latin characters, other than control codes and their arguments.
-    std::string result;
-    if (binary_utf16_is_utf8(binary_u16))
-    {
-        result = binary_utf16_to_utf8(binary_u16);
-    }
-    else
-    {
-        result = binary_utf16_to_latin1(binary_u16);
-    }
-    return result;
+void write_string(std::ostream& os, const std::string& value)
+{
+    write_string(os, value, StringTerm::Null);
 }
 
 
 void GRFString::read(std::istream& is, StringTerm term)
 {
+    std::string value;
     if (term == StringTerm::None)
     {
-        m_value = {};
         while (is.peek() != EOF)
         {
-            m_value.push_back(read_uint8(is));
+            value.push_back(read_uint8(is));
         }
     }
     else
     {
-        m_value = read_string(is);
+        value = read_string(is);
     }
+    m_value = StringPool::pool().intern(std::move(value));
 }
 
 
 void GRFString::write(std::ostream& os, StringTerm term) const
 {
-    write_string(os, m_value, term);
+    write_string(os, m_value->value(), term);
 }
 
 
@@ -904,9 +1059,10 @@ void string_to_hex(const std::string& str)
 }
 
 
-std::string GRFString::readable() const
+const std::string& GRFString::readable() const
 {
-    std::string readable = grf_string_to_readable_utf8(m_value);
+    // Converted once per distinct string.
+    const std::string& readable = m_value->readable();
 
     // This is just for testing. Convert the string to readable
     // and back again, and see if it matches. There are some
@@ -914,9 +1070,9 @@ std::string GRFString::readable() const
     // the GRF string encoding is non-unique.
     /*
     std::string binary   = readable_utf8_to_grf_string(readable);
-    if (m_value != binary)
+    if (m_value->value() != binary)
     {
-        string_to_hex(m_value);
+        string_to_hex(m_value->value());
         string_to_hex(binary);
     }
     */
@@ -927,7 +1083,7 @@ std::string GRFString::readable() const
 
 void GRFString::parse(TokenStream& is)
 {
-    std::string readable = is.match(TokenType::String);
-    m_value = readable_utf8_to_grf_string(readable);
+    const std::string& readable = is.match(TokenType::String);
+    m_value = StringPool::pool().intern_readable(readable);
 }
 
@@ -22,6 +22,7 @@
 #include "Languages.h"
 #include "Record.h"
 #include "DescriptorBase.h"
+#include "StringPool.h"
 
 
 //std::string grf_string_to_readable_utf8(const std::string& str);
@@ -33,6 +34,8 @@ enum class StringTerm { None, Null };
 class GRFString
 {
 public:
+    GRFString() : m_value{StringPool::pool().empty()} {}
+
     // Binary serialisation
     // Directly read or write m_value.
     void read(std::istream& is, StringTerm term = StringTerm::Null);
@@ -41,18 +44,18 @@ public:
     // Text serialisation
     // Convert the internal representation to a human readable version.
     void print(std::ostream& os, uint16_t indent = 0) const;
-    std::string readable() const;
+    const std::string& readable() const;
     // Convert the value that is read into the internal representation.
     // Determine whether or not the internal version needs to be UTF8.
     void parse(TokenStream& is);
 
-    uint32_t length() const { return uint32_t(m_value.length()); }
+    uint32_t length() const { return uint32_t(m_value->value().length()); }
 
 private:
     // This is the value as read from or written to a binary GRF file.
     // When reading from or writing to a YAGL file, some conversion is
-    // necessary.
-    std::string m_value;
+    // necessary. Identical strings share a single entry in the pool.
+    const StringPool::Entry* m_value;
 };
 
 
@@ -60,6 +63,7 @@ std::string read_string(std::istream& is);
 void write_string(std::ostream& os, const std::string& value, StringTerm term);
 void write_string(std::ostream& os, const std::string& value);
 std::string grf_string_to_readable_utf8(const std::string& value);
+std::string readable_utf8_to_grf_string(const std::string& value);
 
 // Added to support info mode by dumping all the supported string control codes.
 void print_control_code_info();
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// A perfect hash table for a fixed set of string keys, built once and then only read. This is
+// the "hash and displace" scheme: keys are first split into buckets by one hash, and then each
+// bucket is given its own seed for a second hash which places all of its keys into empty slots.
+// Lookups therefore need two hashes and a single string comparison. Used for mapping the labels
+// found in YAGL onto properties, enumerations and so on.
+template <typename T>
+class PerfectHash
+{
+public:
+    PerfectHash() = default;
+    explicit PerfectHash(std::vector<std::pair<std::string, T>> items) { build(std::move(items)); }
+
+    // Duplicate keys are not permitted: the first one wins.
+    void build(std::vector<std::pair<std::string, T>> items);
+
+    // Returns nullptr if the key is not present.
+    const T* find(std::string_view key) const
+    {
+        if (m_items.empty())
+        {
+            return nullptr;
+        }
+
+        uint32_t bucket = hash(key, 0) & (m_seeds.size() - 1);
+        uint32_t slot   = hash(key, m_seeds[bucket]) & (m_slots.size() - 1);
+        uint32_t item   = m_slots[slot];
+        if ((item != EMPTY) && (m_items[item].first == key))
+        {
+            return &m_items[item].second;
+        }
+        return nullptr;
+    }
+
+    uint32_t size() const { return static_cast<uint32_t>(m_items.size()); }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;
+
+    // FNV-1a, with the seed folded into the offset basis.
+    static uint32_t hash(std::string_view key, uint32_t seed)
+    {
+        uint32_t result = 2166136261U ^ (seed * 0x9E3779B9U);
+        for (char c: key)
+        {
+            result ^= static_cast<uint8_t>(c);
+            result *= 16777619U;
+        }
+        // Mix the high bits down as only the low bits are used to index the tables.
+        result ^= result >> 15;
+        result *= 0x2C1B3C6DU;
+        result ^= result >> 12;
+        return result;
+    }
+
+    static uint32_t round_up_pow2(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::pair<std::string, T>> m_items;
+    std::vector<uint32_t>                  m_seeds;
+    std::vector<uint32_t>                  m_slots;
+};
+
+
+template <typename T>
+void PerfectHash<T>::build(std::vector<std::pair<std::string, T>> items)
+{
+    m_items.clear();
+    for (auto& item: items)
+    {
+        auto same = [&item](const auto& other) { return other.first == item.first; };
+        if (std::find_if(m_items.begin(), m_items.end(), same) == m_items.end())
+        {
+            m_items.push_back(std::move(item));
+        }
+    }
+
+    // Around two keys per bucket, and a load factor of at most one half for the slots.
+    // Both are powers of two so that we can mask rather than divide.
+    uint32_t num_items = static_cast<uint32_t>(m_items.size());
+    m_seeds.assign(round_up_pow2(std::max(1U, num_items / 2)), 0);
+    m_slots.assign(round_up_pow2(std::max(1U, num_items * 2)), EMPTY);
+
+    std::vector<std::vector<uint32_t>> buckets(m_seeds.size());
+    for (uint32_t item = 0; item < num_items; ++item)
+    {
+        buckets[hash(m_items[item].first, 0) & (m_seeds.size() - 1)].push_back(item);
+    }
+
+    // Place the largest buckets first, while there are plenty of free slots.
+    std::vector<uint32_t> order(buckets.size());
+    for (uint32_t bucket = 0; bucket < order.size(); ++bucket)
+    {
+        order[bucket] = bucket;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&buckets](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    std::vector<uint32_t> slots;
+    for (uint32_t bucket: order)
+    {
+        if (buckets[bucket].empty())
+        {
+            break;
+        }
+
+        // Keep trying seeds until all the keys in the bucket land in distinct empty slots.
+        // With the tables at most half full this terminates quickly.
+        for (uint32_t seed = 1; ; ++seed)
+        {
+            slots.clear();
+            bool placed = true;
+            for (uint32_t item: buckets[bucket])
+            {
+                uint32_t slot = hash(m_items[item].first, seed) & (m_slots.size() - 1);
+                if ((m_slots[slot] != EMPTY) || (std::find(slots.begin(), slots.end(), slot) != slots.end()))
+                {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+
+            if (placed)
+            {
+                m_seeds[bucket] = seed;
+                for (uint32_t i = 0; i < slots.size(); ++i)
+                {
+                    m_slots[slots[i]] = buckets[bucket][i];
+                }
+                break;
+            }
+        }
+    }
+}
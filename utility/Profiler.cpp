@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+
+Profiler& Profiler::profiler()
+{
+    static Profiler instance;
+    return instance;
+}
+
+
+void Profiler::enable()
+{
+    m_origin      = Clock::now();
+    m_main_thread = std::this_thread::get_id();
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+
+Profiler::ThreadEvents& Profiler::thread_events()
+{
+    // Each thread finds its own list of events without taking the lock.
+    thread_local ThreadEvents* t_events = nullptr;
+    if (t_events == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto events = std::make_unique<ThreadEvents>();
+        events->thread_id = static_cast<uint32_t>(m_threads.size());
+        events->main      = std::this_thread::get_id() == m_main_thread;
+        t_events = events.get();
+        m_threads.push_back(std::move(events));
+    }
+    return *t_events;
+}
+
+
+void Profiler::record(const char* name, Clock::time_point start, Clock::time_point end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    Event event;
+    event.name     = name;
+    event.start_us = duration_cast<microseconds>(start - m_origin).count();
+    event.dur_us   = duration_cast<microseconds>(end - start).count();
+
+    // The list is only appended to by this thread, but it may be read while writing the output.
+    ThreadEvents& events = thread_events();
+    std::lock_guard<std::mutex> lock(events.mutex);
+    events.events.push_back(event);
+}
+
+
+void Profiler::write_trace(std::ostream& os) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    os << "{\"traceEvents\":[\n";
+    bool comma = false;
+    for (const auto& thread: m_threads)
+    {
+        std::lock_guard<std::mutex> thread_lock(thread->mutex);
+
+        // Name the lanes. A worker may record something before the main thread does.
+        if (comma) os << ",\n";
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->thread_id;
+        os << ",\"args\":{\"name\":\"";
+        if (thread->main)
+            os << "main";
+        else
+            os << "worker " << thread->thread_id;
+        os << "\"}}";
+        comma = true;
+
+        for (const auto& event: thread->events)
+        {
+            os << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"yagl\",\"ph\":\"X\"";
+            os << ",\"ts\":" << event.start_us << ",\"dur\":" << event.dur_us;
+            os << ",\"pid\":1,\"tid\":" << thread->thread_id << "}";
+        }
+    }
+    os << "\n]}\n";
+}
+
+
+void Profiler::print_timings(std::ostream& os) const
+{
+    struct Summary
+    {
+        uint32_t count    = 0;
+        int64_t  total_us = 0;
+        int64_t  max_us   = 0;
+    };
+
+    std::map<std::string, Summary> summaries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& thread: m_threads)
+        {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            for (const auto& event: thread->events)
+            {
+                Summary& summary = summaries[event.name];
+                ++summary.count;
+                summary.total_us += event.dur_us;
+                summary.max_us    = std::max(summary.max_us, event.dur_us);
+            }
+        }
+    }
+
+    // Largest total first. Stages which run on several threads at once may add up to more
+    // than the elapsed time.
+    std::vector<std::pair<std::string, Summary>> rows(summaries.begin(), summaries.end());
+    std::stable_sort(rows.begin(), rows.end(),
+        [](const auto& a, const auto& b) { return a.second.total_us > b.second.total_us; });
+
+    auto ms = [](int64_t us) { return static_cast<double>(us) / 1000.0; };
+
+    os << "\nTimings (ms):\n";
+    os << std::left << std::setw(24) << "Stage" << std::right;
+    os << std::setw(10) << "Count" << std::setw(14) << "Total" << std::setw(12) << "Mean" << std::setw(12) << "Max" << '\n';
+    os << std::fixed << std::setprecision(3);
+    for (const auto& [name, summary]: rows)
+    {
+        os << std::left << std::setw(24) << name << std::right;
+        os << std::setw(10) << summary.count;
+        os << std::setw(14) << ms(summary.total_us);
+        os << std::setw(12) << ms(summary.total_us) / summary.count;
+        os << std::setw(12) << ms(summary.max_us) << '\n';
+    }
+    os << std::defaultfloat;
+}
+
+
+void Profiler::print_workers(std::ostream& os, const std::vector<ThreadPool::WorkerStats>& workers) const
+{
+    const int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_origin).count();
+
+    os << "\nWorkers:\n";
+    os << std::left << std::setw(24) << "Worker" << std::right;
+    os << std::setw(10) << "Tasks" << std::setw(14) << "Steals" << std::setw(12) << "Busy (ms)" << std::setw(12) << "Busy (%)" << '\n';
+    os << std::fixed << std::setprecision(3);
+    for (uint32_t index = 0; index < workers.size(); ++index)
+    {
+        // The last entry is for the threads which ran tasks while waiting for results.
+        const auto& worker = workers[index];
+        os << std::left << std::setw(24);
+        if ((index + 1) < workers.size())
+            os << index;
+        else
+            os << "Waiting threads";
+        os << std::right;
+        os << std::setw(10) << worker.tasks;
+        os << std::setw(14) << worker.steals;
+        os << std::setw(12) << static_cast<double>(worker.busy_us) / 1000.0;
+        os << std::setw(12) << ((elapsed_us > 0) ? 100.0 * static_cast<double>(worker.busy_us) / elapsed_us : 0.0) << '\n';
+    }
+    os << std::defaultfloat;
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+
+// Records how long each stage of reading, parsing, printing and writing a GRF takes. Each thread
+// appends to its own list of events, so the timers can be used inside tasks on the thread pool
+// without contention. Nothing is recorded unless the profiler has been enabled, which is done
+// by the --profile and --timings options.
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char* name;     // Expected to be a string literal.
+        int64_t     start_us; // Relative to the time the profiler was enabled.
+        int64_t     dur_us;
+    };
+
+public:
+    static Profiler& profiler();
+
+    // Called on the main thread, which is named as such in the trace.
+    void enable();
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // Chrome Trace Event format, which can be loaded into chrome://tracing or Perfetto.
+    // Each thread has its own lane.
+    void write_trace(std::ostream& os) const;
+    // A table of the count, total, mean and maximum time for each stage.
+    void print_timings(std::ostream& os) const;
+    // A table of the tasks run by each worker in the thread pool, and by threads waiting for
+    // results, and the fraction of the time since the profiler was enabled for which each was busy.
+    void print_workers(std::ostream& os, const std::vector<ThreadPool::WorkerStats>& workers) const;
+
+private:
+    Profiler() = default;
+
+    struct ThreadEvents
+    {
+        uint32_t           thread_id;
+        bool               main;
+        // Only ever contended while the output is being written.
+        std::mutex         mutex;
+        std::vector<Event> events;
+    };
+
+    ThreadEvents& thread_events();
+
+private:
+    std::atomic<bool> m_enabled{false};
+    Clock::time_point m_origin{};
+    std::thread::id   m_main_thread{};
+
+    mutable std::mutex                         m_mutex;
+    std::vector<std::unique_ptr<ThreadEvents>> m_threads;
+};
+
+
+// Times the enclosing scope, or until stop() is called. This does nothing if the profiler is
+// not enabled, so the timers can be left in place.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char* name)
+    : m_name{Profiler::profiler().enabled() ? name : nullptr}
+    {
+        if (m_name)
+        {
+            m_start = Profiler::Clock::now();
+        }
+    }
+
+    ~ScopedTimer() { stop(); }
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    void stop()
+    {
+        if (m_name)
+        {
+            Profiler::profiler().record(m_name, m_start, Profiler::Clock::now());
+            m_name = nullptr;
+        }
+    }
+
+private:
+    const char*                 m_name;
+    Profiler::Clock::time_point m_start{};
+};
@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "SequenceDiff.h"
+#include <algorithm>
+
+
+namespace {
+
+class SequenceDiff
+{
+public:
+    SequenceDiff(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, uint32_t max_edits)
+    : m_a{a}, m_b{b}, m_max_edits{max_edits}
+    {
+    }
+
+    std::vector<DiffEdit> diff()
+    {
+        diff(0, uint32_t(m_a.size()), 0, uint32_t(m_b.size()));
+        return std::move(m_edits);
+    }
+
+private:
+    void add(DiffEdit::Op op, uint32_t a, uint32_t b, uint32_t length);
+    void diff(uint32_t a0, uint32_t a1, uint32_t b0, uint32_t b1);
+    void bisect(uint32_t a0, uint32_t a1, uint32_t b0, uint32_t b1);
+
+private:
+    const std::vector<uint64_t>& m_a;
+    const std::vector<uint64_t>& m_b;
+    const uint32_t               m_max_edits;
+    std::vector<DiffEdit>        m_edits;
+};
+
+
+void SequenceDiff::add(DiffEdit::Op op, uint32_t a, uint32_t b, uint32_t length)
+{
+    if (length == 0)
+        return;
+
+    // The recursion produces runs in order, so adjacent runs of the same kind are merged.
+    if (!m_edits.empty() && (m_edits.back().op == op))
+    {
+        m_edits.back().length += length;
+        return;
+    }
+    m_edits.push_back({op, a, b, length});
+}
+
+
+void SequenceDiff::diff(uint32_t a0, uint32_t a1, uint32_t b0, uint32_t b1)
+{
+    uint32_t prefix = 0;
+    while ((a0 + prefix < a1) && (b0 + prefix < b1) && (m_a[a0 + prefix] == m_b[b0 + prefix]))
+        ++prefix;
+    add(DiffEdit::Op::Equal, a0, b0, prefix);
+    a0 += prefix;
+    b0 += prefix;
+
+    uint32_t suffix = 0;
+    while ((a1 - suffix > a0) && (b1 - suffix > b0) && (m_a[a1 - suffix - 1] == m_b[b1 - suffix - 1]))
+        ++suffix;
+    a1 -= suffix;
+    b1 -= suffix;
+
+    if (a0 == a1)
+    {
+        add(DiffEdit::Op::Add, a0, b0, b1 - b0);
+    }
+    else if (b0 == b1)
+    {
+        add(DiffEdit::Op::Remove, a0, b0, a1 - a0);
+    }
+    else
+    {
+        bisect(a0, a1, b0, b1);
+    }
+
+    add(DiffEdit::Op::Equal, a1, b1, suffix);
+}
+
+
+// Follows the forward and reverse paths until they overlap, and then solves the two halves
+// on either side of the overlap separately.
+void SequenceDiff::bisect(uint32_t a0, uint32_t a1, uint32_t b0, uint32_t b1)
+{
+    const int64_t n        = a1 - a0;
+    const int64_t m        = b1 - b0;
+    const int64_t max_d    = std::min<int64_t>((n + m + 1) / 2, m_max_edits);
+    const int64_t v_offset = max_d;
+    const int64_t v_length = 2 * max_d + 2;
+
+    // The furthest x reached on each diagonal k, going forwards from the start and backwards
+    // from the end respectively.
+    std::vector<int64_t> v1(v_length, -1);
+    std::vector<int64_t> v2(v_length, -1);
+    v1[v_offset + 1] = 0;
+    v2[v_offset + 1] = 0;
+
+    const int64_t delta = n - m;
+    // If the total number of items is odd, the front path will collide with the reverse path.
+    const bool front = (delta % 2) != 0;
+
+    // Offsets for the start and end of the k loops, which prevent mapping of space beyond the grid.
+    int64_t k1start = 0;
+    int64_t k1end   = 0;
+    int64_t k2start = 0;
+    int64_t k2end   = 0;
+    for (int64_t d = 0; d < max_d; ++d)
+    {
+        for (int64_t k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+        {
+            const int64_t k1_offset = v_offset + k1;
+            int64_t x1 = ((k1 == -d) || ((k1 != d) && (v1[k1_offset - 1] < v1[k1_offset + 1])))
+                ? v1[k1_offset + 1] : v1[k1_offset - 1] + 1;
+            int64_t y1 = x1 - k1;
+            while ((x1 < n) && (y1 < m) && (m_a[a0 + x1] == m_b[b0 + y1]))
+            {
+                ++x1;
+                ++y1;
+            }
+            v1[k1_offset] = x1;
+
+            if (x1 > n)
+            {
+                // Ran off the right of the grid.
+                k1end += 2;
+            }
+            else if (y1 > m)
+            {
+                // Ran off the bottom of the grid.
+                k1start += 2;
+            }
+            else if (front)
+            {
+                const int64_t k2_offset = v_offset + delta - k1;
+                if ((k2_offset >= 0) && (k2_offset < v_length) && (v2[k2_offset] != -1))
+                {
+                    // Mirror x2 onto the top-left coordinate system.
+                    const int64_t x2 = n - v2[k2_offset];
+                    if (x1 >= x2)
+                    {
+                        diff(a0, a0 + uint32_t(x1), b0, b0 + uint32_t(y1));
+                        diff(a0 + uint32_t(x1), a1, b0 + uint32_t(y1), b1);
+                        return;
+                    }
+                }
+            }
+        }
+
+        for (int64_t k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+        {
+            const int64_t k2_offset = v_offset + k2;
+            int64_t x2 = ((k2 == -d) || ((k2 != d) && (v2[k2_offset - 1] < v2[k2_offset + 1])))
+                ? v2[k2_offset + 1] : v2[k2_offset - 1] + 1;
+            int64_t y2 = x2 - k2;
+            while ((x2 < n) && (y2 < m) && (m_a[a1 - x2 - 1] == m_b[b1 - y2 - 1]))
+            {
+                ++x2;
+                ++y2;
+            }
+            v2[k2_offset] = x2;
+
+            if (x2 > n)
+            {
+                k2end += 2;
+            }
+            else if (y2 > m)
+            {
+                k2start += 2;
+            }
+            else if (!front)
+            {
+                const int64_t k1_offset = v_offset + delta - k2;
+                if ((k1_offset >= 0) && (k1_offset < v_length) && (v1[k1_offset] != -1))
+                {
+                    const int64_t x1 = v1[k1_offset];
+                    const int64_t y1 = v_offset + x1 - k1_offset;
+                    if (x1 >= n - x2)
+                    {
+                        diff(a0, a0 + uint32_t(x1), b0, b0 + uint32_t(y1));
+                        diff(a0 + uint32_t(x1), a1, b0 + uint32_t(y1), b1);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // No overlap was found within the limit, so there is nothing in common worth finding.
+    add(DiffEdit::Op::Remove, a0, b0, a1 - a0);
+    add(DiffEdit::Op::Add, a1, b0, b1 - b0);
+}
+
+} // namespace {
+
+
+std::vector<DiffEdit> diff_sequences(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b,
+    uint32_t max_edits)
+{
+    return SequenceDiff{a, b, max_edits}.diff();
+}
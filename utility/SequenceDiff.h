@@ -0,0 +1,43 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <vector>
+
+
+// One run of a shortest edit script between two sequences: length items are equal at a and
+// b, are removed from a, or are added from b.
+struct DiffEdit
+{
+    enum class Op { Equal, Remove, Add };
+
+    Op       op;
+    uint32_t a;      // Index of the first item in the first sequence.
+    uint32_t b;      // Index of the first item in the second sequence.
+    uint32_t length;
+};
+
+
+// Aligns two sequences of hashes using Myers' O(ND) algorithm, in its linear space form
+// which bisects the problem at the middle snake. Common prefixes and suffixes are trimmed
+// first, which is most of the work when comparing two releases of a GRF. If the sequences
+// are so different that more than max_edits edits would be needed at any one step, the
+// remaining range is treated as simply removed and added.
+std::vector<DiffEdit> diff_sequences(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b,
+    uint32_t max_edits = 20'000);
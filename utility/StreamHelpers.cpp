@@ -127,6 +127,64 @@ void dump_hex(std::istream& is, uint16_t length)
 }
 */
 
+namespace {
+
+
+// Two upper case hex digits for each byte value.
+struct HexByteTable
+{
+    constexpr HexByteTable()
+    {
+        constexpr char digits[] = "0123456789ABCDEF";
+        for (int byte = 0; byte < 256; ++byte)
+        {
+            chars[byte][0] = digits[byte >> 4];
+            chars[byte][1] = digits[byte & 0xF];
+        }
+    }
+
+    char chars[256][2]{};
+};
+
+
+constexpr HexByteTable g_hex_bytes;
+
+
+} // namespace {
+
+
+void append_hex_bytes(std::string& out, const std::string& data, HexLayout layout)
+{
+    // Three characters per byte, plus the line breaks.
+    std::size_t start = out.size();
+    std::size_t size  = data.size();
+    std::size_t len   = 3 * size + ((layout == HexLayout::Dump) ? size / 16 : 0);
+    out.resize(start + len);
+
+    char* dest = &out[start];
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        const char* hex = g_hex_bytes.chars[static_cast<uint8_t>(data[index])];
+        if (layout == HexLayout::Dump)
+        {
+            *dest++ = hex[0];
+            *dest++ = hex[1];
+            *dest++ = ' ';
+            if ((index % 16) == 15)
+            {
+                *dest++ = '\n';
+            }
+        }
+        else
+        {
+            *dest++ = ' ';
+            *dest++ = hex[0];
+            *dest++ = hex[1];
+        }
+    }
+}
+
+
 // Used for the unit tests.
 std::string hex_dump(const std::string& data, bool split_lines)
 {
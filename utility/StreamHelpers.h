@@ -18,6 +18,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Exceptions.h"
+#include <algorithm>
+#include <charconv>
 #include <cstdint>
 #include <iostream>
 #include <iomanip>
@@ -97,21 +99,84 @@ void write_uint(std::ostream& os, T value)
 }
 
 
+// The number of characters needed for the longest value produced by format_hex()
+// or format_dec(), including a 0x prefix.
+constexpr std::size_t MaxFormatLen = 2 + 2 * sizeof(uint64_t);
+
+
+// Writes the value as upper case hex digits, zero padded to the full width of T, into the buffer,
+// which must hold at least MaxFormatLen characters. Returns a pointer past the last character.
+// This sits under almost every print() so it avoids streams and allocations altogether.
 template <typename T>
-std::string to_hex(T value, bool prefix = true)
+char* format_hex(char* buffer, T value, bool prefix = true)
 {
     // Signed values are used here and there in the GRF specs. These should be converted to unsigned types of the
     // same size so that the sign extension to 32 or 64 bits doesn't appear in the YAGL.
     using U = std::make_unsigned_t<T>;
-    U unsigned_value = static_cast<U>(value);
+    uint64_t unsigned_value = static_cast<U>(value);
 
-    std::ostringstream os;
+    static constexpr char digits[] = "0123456789ABCDEF";
     if (prefix)
     {
-        os << "0x";
+        *buffer++ = '0';
+        *buffer++ = 'x';
     }
-    os << std::uppercase << std::hex << std::setfill('0') << std::setw(2*sizeof(T)) << static_cast<uint64_t>(unsigned_value);
-    return os.str();
+    for (int shift = 8 * sizeof(T) - 4; shift >= 0; shift -= 4)
+    {
+        *buffer++ = digits[(unsigned_value >> shift) & 0xF];
+    }
+    return buffer;
+}
+
+
+// Writes the value in decimal into the buffer, which must hold at least MaxFormatLen characters.
+// Returns a pointer past the last character.
+template <typename T>
+char* format_dec(char* buffer, T value)
+{
+    return std::to_chars(buffer, buffer + MaxFormatLen, value).ptr;
+}
+
+
+template <typename T>
+std::string to_hex(T value, bool prefix = true)
+{
+    // Short enough for the small string optimisation for all but 64-bit values.
+    char buffer[MaxFormatLen];
+    return std::string(buffer, format_hex(buffer, value, prefix));
+}
+
+
+// Manipulator which writes a value as to_hex() does, but straight into the stream:
+// os << as_hex(value) << ...
+template <typename T>
+class HexValue
+{
+public:
+    HexValue(T value, bool prefix) : m_value{value}, m_prefix{prefix} {}
+    void execute(std::ostream& os) const
+    {
+        char buffer[MaxFormatLen];
+        os.write(buffer, format_hex(buffer, m_value, m_prefix) - buffer);
+    }
+private:
+    T    m_value;
+    bool m_prefix;
+};
+
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const HexValue<T>& value)
+{
+    value.execute(os);
+    return os;
+}
+
+
+template <typename T>
+HexValue<T> as_hex(T value, bool prefix = true)
+{
+    return HexValue<T>(value, prefix);
 }
 
 
@@ -123,8 +188,19 @@ public:
     explicit Padding(uint16_t len) : m_len{len} {}
     void execute(std::ostream& os) const
     {
-        std::string spaces(m_len, ' ');
-        os << spaces;
+        // Indents are short, so they are written from a fixed run of spaces rather than building
+        // a new string for every line.
+        static constexpr uint16_t MaxChunk = 64;
+        static constexpr char spaces[MaxChunk + 1] =
+            "                                                                ";
+
+        uint16_t len = m_len;
+        while (len > 0)
+        {
+            uint16_t chunk = std::min(len, MaxChunk);
+            os.write(spaces, chunk);
+            len -= chunk;
+        }
     }
 private:
     uint16_t m_len;
@@ -147,6 +223,19 @@ inline Padding pad(uint16_t len)
 }
 
 
+// How the bytes are laid out by append_hex_bytes().
+enum class HexLayout
+{
+    Dump, // "XX " for each byte, with a line break after every 16 bytes.
+    NFO   // " XX" for each byte, all on one line as grfcodec writes pseudo-sprites.
+};
+
+
+// Appends the bytes to the string as upper case hex. Whole GRFs are dumped this way, so this
+// works from a lookup table straight into the string rather than formatting each byte.
+void append_hex_bytes(std::string& out, const std::string& data, HexLayout layout);
+
+
 // Used for the unit tests.
 std::string hex_dump(const std::string& data, bool split_lines = false);
 
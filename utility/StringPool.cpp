@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "StringPool.h"
+#include "GRFStrings.h"
+
+
+namespace {
+
+thread_local StringPool* t_pool = nullptr;
+
+} // namespace {
+
+
+StringPool& StringPool::pool()
+{
+    static StringPool pool;
+    return (t_pool != nullptr) ? *t_pool : pool;
+}
+
+
+StringPool::Scope::Scope(StringPool& pool)
+: m_previous{t_pool}
+{
+    t_pool = &pool;
+}
+
+
+StringPool::Scope::~Scope()
+{
+    t_pool = m_previous;
+}
+
+
+StringPool::StringPool()
+{
+    // The empty string is not counted, as it was not read or parsed.
+    m_empty = intern({});
+    m_strings = 0;
+    m_unique  = 0;
+}
+
+
+const std::string& StringPool::Entry::readable() const
+{
+    std::call_once(m_readable_once, [this]()
+    {
+        m_readable = grf_string_to_readable_utf8(m_value);
+        ++m_pool.m_conversions;
+    });
+    return m_readable;
+}
+
+
+StringPool::Shard& StringPool::shard(std::string_view value)
+{
+    return m_shards[std::hash<std::string_view>{}(value) % NUM_SHARDS];
+}
+
+
+const StringPool::Entry* StringPool::intern(std::string value)
+{
+    ++m_strings;
+    m_bytes += value.size();
+
+    Shard& s = shard(value);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.entries.find(value);
+    if (it != s.entries.end())
+    {
+        return it->second.get();
+    }
+
+    ++m_unique;
+    m_unique_bytes += value.size();
+
+    // The key refers to the entry's own copy of the string.
+    auto entry = std::make_unique<Entry>(std::move(value), *this);
+    const Entry* result = entry.get();
+    s.entries.emplace(std::string_view{result->value()}, std::move(entry));
+    return result;
+}
+
+
+const StringPool::Entry* StringPool::intern_readable(const std::string& readable)
+{
+    Shard& s = shard(readable);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.readables.find(readable);
+        if (it != s.readables.end())
+        {
+            ++m_strings;
+            m_bytes += it->second->value().size();
+            return it->second;
+        }
+    }
+
+    // Converted outside the lock. Two threads may occasionally convert the same
+    // string, but they will get the same entry.
+    std::string value = readable_utf8_to_grf_string(readable);
+    ++m_conversions;
+    const Entry* entry = intern(std::move(value));
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.readables.emplace(readable, entry);
+    return entry;
+}
+
+
+StringPool::Stats StringPool::stats() const
+{
+    return { m_strings, m_unique, m_bytes, m_unique_bytes, m_conversions };
+}
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// Large multi-language sets repeat the same strings (cargo names, units, colour codes, ...)
+// thousands of times across Action04, Action13 and Action14 records. Each distinct binary
+// string is held once in this pool, and GRFString refers to its entry. The readable form of
+// each entry is converted only when it is first printed, and the binary form of each distinct
+// YAGL string is converted only when it is first parsed. Each NewGRFData owns a pool, so that
+// the entries and the counts are for that GRF alone, and the entries live as long as its records.
+// Records are read and parsed concurrently, so the pool is divided into shards with their own
+// locks.
+class StringPool
+{
+public:
+    class Entry
+    {
+    public:
+        Entry(std::string value, StringPool& pool) : m_value{std::move(value)}, m_pool{pool} {}
+
+        const std::string& value() const { return m_value; }
+        const std::string& readable() const;
+
+    private:
+        std::string            m_value;
+        StringPool&            m_pool;
+        mutable std::once_flag m_readable_once;
+        mutable std::string    m_readable;
+    };
+
+    // Counters used to show how much duplication there is.
+    struct Stats
+    {
+        uint64_t strings;      // Number of strings read or parsed.
+        uint64_t unique;       // Number of distinct binary strings held.
+        uint64_t bytes;        // Total length of the strings read or parsed.
+        uint64_t unique_bytes; // Total length of the distinct strings.
+        uint64_t conversions;  // Number of readable/binary conversions actually performed.
+    };
+
+public:
+    // The pool of the innermost Scope on this thread, or else a pool shared by everything else.
+    static StringPool& pool();
+
+    // Scope guard used while reading or parsing the records of a GRF. A thread waiting for a
+    // result may run the tasks of another GRF, so scopes can be nested, and the outer one is
+    // restored afterwards.
+    class Scope
+    {
+    public:
+        explicit Scope(StringPool& pool);
+        ~Scope();
+
+    private:
+        StringPool* m_previous;
+    };
+
+public:
+    StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // The entry for a binary string.
+    const Entry* intern(std::string value);
+    // The entry for the binary form of a readable string from the YAGL.
+    const Entry* intern_readable(const std::string& readable);
+
+    const Entry* empty() const { return m_empty; }
+    Stats stats() const;
+
+private:
+    struct Shard
+    {
+        std::mutex                                                   mutex;
+        std::unordered_map<std::string_view, std::unique_ptr<Entry>> entries;
+        std::unordered_map<std::string, const Entry*>                readables;
+    };
+
+    static constexpr uint32_t NUM_SHARDS = 16;
+    Shard& shard(std::string_view value);
+
+private:
+    std::array<Shard, NUM_SHARDS> m_shards;
+    const Entry*                  m_empty{};
+
+    std::atomic<uint64_t> m_strings{};
+    std::atomic<uint64_t> m_unique{};
+    std::atomic<uint64_t> m_bytes{};
+    std::atomic<uint64_t> m_unique_bytes{};
+    mutable std::atomic<uint64_t> m_conversions{};
+};
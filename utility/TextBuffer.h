@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+
+// The string buffer for TextBuffer. This is a base class rather than a member so that it is
+// constructed before the std::ostream base which is given a pointer to it.
+class TextBufferStorage
+{
+protected:
+    struct StringBuf : public std::streambuf
+    {
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                text.push_back(traits_type::to_char_type(ch));
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            text.append(s, static_cast<std::size_t>(count));
+            return count;
+        }
+
+        std::string text;
+    };
+
+    StringBuf m_buffer;
+};
+
+
+// An output stream which appends directly to a std::string. This is used in place of
+// std::ostringstream when printing records: the text can be moved out rather than copied,
+// and the stream buffer does no bookkeeping of its own beyond the string.
+class TextBuffer : private TextBufferStorage, public std::ostream
+{
+public:
+    explicit TextBuffer(std::size_t reserve = 0)
+    : std::ostream{&m_buffer}
+    {
+        m_buffer.text.reserve(reserve);
+    }
+
+    const std::string& text() const { return m_buffer.text; }
+    std::string take()              { return std::move(m_buffer.text); }
+};
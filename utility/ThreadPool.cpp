@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+
+namespace {
+
+uint32_t g_pool_size = 0;
+
+// The pool and worker index of the current thread, if it is a worker.
+thread_local const ThreadPool* t_pool  = nullptr;
+thread_local uint32_t          t_index = 0;
+
+} // namespace {
+
+
+void ThreadPool::set_pool_size(uint32_t num_threads)
+{
+    g_pool_size = num_threads;
+}
+
+
+ThreadPool& ThreadPool::pool()
+{
+    // hardware_concurrency() is allowed to return zero if it doesn't know.
+    static ThreadPool instance{(g_pool_size > 0) ? g_pool_size : std::max(1U, std::thread::hardware_concurrency())};
+    return instance;
+}
+
+
+ThreadPool::ThreadPool(uint32_t num_threads)
+{
+    num_threads = std::max(1U, num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::worker, this, i);
+    }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread: m_threads)
+    {
+        thread.join();
+    }
+}
+
+
+std::vector<ThreadPool::WorkerStats> ThreadPool::worker_stats() const
+{
+    auto make_stats = [](const Worker& worker)
+    {
+        WorkerStats stats;
+        stats.tasks   = worker.num_tasks.load(std::memory_order_relaxed);
+        stats.steals  = worker.num_steals.load(std::memory_order_relaxed);
+        stats.busy_us = worker.busy_us.load(std::memory_order_relaxed);
+        return stats;
+    };
+
+    std::vector<WorkerStats> stats;
+    for (const auto& worker: m_workers)
+    {
+        stats.push_back(make_stats(*worker));
+    }
+    stats.push_back(make_stats(m_callers));
+    return stats;
+}
+
+
+void ThreadPool::push(Task task)
+{
+    // Workers keep their own tasks together, which tends to keep related data in their cache.
+    uint32_t index = (t_pool == this) ? t_index :
+        (m_next_queue.fetch_add(1, std::memory_order_relaxed) % num_threads());
+
+    // The count is raised first so that it never drops below the number of queued tasks.
+    m_num_queued.fetch_add(1);
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    // Taking the lock means a worker cannot miss the count changing between checking it and
+    // going to sleep.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+
+// Takes the newest task from the given worker's own queue, or else steals the oldest task
+// from one of the others.
+bool ThreadPool::pop(uint32_t index, Task& task, bool& stolen)
+{
+    const uint32_t count = num_threads();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Worker& worker = *m_workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            continue;
+        }
+
+        stolen = (i > 0);
+        if (stolen)
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        else
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+        m_num_queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+
+bool ThreadPool::run_pending_task()
+{
+    // Other threads have no queue of their own, so everything they run is stolen.
+    const bool is_worker = (t_pool == this);
+    Worker*  self  = is_worker ? m_workers[t_index].get() : &m_callers;
+    uint32_t index = is_worker ? t_index : (m_next_queue.load(std::memory_order_relaxed) % num_threads());
+
+    Task task;
+    bool stolen = false;
+    if (!pop(index, task, stolen))
+    {
+        return false;
+    }
+    if (stolen || !is_worker)
+    {
+        self->num_steals.fetch_add(1, std::memory_order_relaxed);
+    }
+    run(*self, task);
+    return true;
+}
+
+
+void ThreadPool::run(Worker& worker, Task& task)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    task();
+
+    int64_t busy_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    worker.num_tasks.fetch_add(1, std::memory_order_relaxed);
+    worker.busy_us.fetch_add(busy_us, std::memory_order_relaxed);
+}
+
+
+void ThreadPool::worker(uint32_t index)
+{
+    t_pool  = this;
+    t_index = index;
+
+    while (true)
+    {
+        if (run_pending_task())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_stopping || (m_num_queued.load() > 0); });
+
+        // Drain the queues before stopping.
+        if (m_stopping && (m_num_queued.load() == 0))
+        {
+            return;
+        }
+    }
+}
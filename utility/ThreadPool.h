@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 Alan Chambers (unicycle.bloke@gmail.com)
+//
+// This file is part of yagl.
+//
+// yagl is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// yagl is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with yagl. If not, see <https://www.gnu.org/licenses/>.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+
+// The pool of worker threads shared by every parallel stage. Each worker has its own queue of
+// tasks. Tasks submitted by a worker go on its own queue, and tasks submitted from other threads
+// are shared out between the queues in turn. A worker takes its newest task first, and when
+// its queue is empty it steals the oldest task from another worker. Each task returns a future
+// so that the caller can collect the results in whatever order it needs (usually the order of
+// the records in the GRF).
+class ThreadPool
+{
+public:
+    // The shared pool. Its size is set by --jobs, and defaults to the number of hardware threads.
+    static ThreadPool& pool();
+    // Sets the size of the shared pool. This must be called before the pool is first used.
+    // Zero means the number of hardware threads.
+    static void set_pool_size(uint32_t num_threads);
+
+    // Counters for one worker, for reporting how well the work was shared out.
+    struct WorkerStats
+    {
+        uint64_t tasks   = 0; // Tasks run by this worker.
+        uint64_t steals  = 0; // Tasks taken from the queues of other workers.
+        int64_t  busy_us = 0; // Time spent running tasks.
+    };
+
+public:
+    explicit ThreadPool(uint32_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    uint32_t num_threads() const { return static_cast<uint32_t>(m_threads.size()); }
+
+    // Exceptions thrown by the task are rethrown by the future's get().
+    template <typename Func>
+    auto submit(Func func) -> std::future<decltype(func())>
+    {
+        using Result = decltype(func());
+        // std::function must be copyable, so the packaged_task is held by a shared_ptr.
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(func));
+        std::future<Result> result = task->get_future();
+        push([task]() { (*task)(); });
+        return result;
+    }
+
+    // Waits for a result, running queued tasks in the meantime. This keeps the calling thread
+    // busy, and means that a task can wait for the tasks it submits without tying up a worker.
+    template <typename T>
+    T get(std::future<T>& future)
+    {
+        while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+        {
+            // If there is nothing queued, the task we are waiting for is already running.
+            if (!run_pending_task())
+            {
+                break;
+            }
+        }
+        return future.get();
+    }
+
+    // Runs make_result(index) for each index on the pool, and passes the results to
+    // consume(index, result) on the calling thread in index order. The number of results
+    // in flight is limited to bound memory use for very large GRFs.
+    template <typename MakeResult, typename Consume>
+    void for_each_ordered(uint32_t count, MakeResult make_result, Consume consume)
+    {
+        using Result = decltype(make_result(uint32_t{}));
+        const uint32_t max_pending = num_threads() * 64;
+
+        std::deque<std::future<Result>> pending;
+        uint32_t consumed = 0;
+        auto consume_next = [&]()
+        {
+            std::future<Result> task = std::move(pending.front());
+            pending.pop_front();
+            consume(consumed++, get(task));
+        };
+
+        try
+        {
+            for (uint32_t index = 0; index < count; ++index)
+            {
+                pending.push_back(submit([&make_result, index]() { return make_result(index); }));
+                if (pending.size() >= max_pending)
+                {
+                    consume_next();
+                }
+            }
+
+            while (!pending.empty())
+            {
+                consume_next();
+            }
+        }
+        catch (...)
+        {
+            // The tasks refer to the caller's data, so make sure they have all finished before leaving.
+            // They are run here if need be, as this may be the only thread which would run them.
+            for (auto& task: pending)
+            {
+                try
+                {
+                    get(task);
+                }
+                catch (...)
+                {
+                    // Only the first exception is passed on.
+                }
+            }
+            throw;
+        }
+    }
+
+    // One entry for each worker, followed by one for the tasks run by other threads while they
+    // were waiting for results.
+    std::vector<WorkerStats> worker_stats() const;
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        // Each queue is only contended by thieves, so a plain mutex is enough.
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+
+        std::atomic<uint64_t> num_tasks{0};
+        std::atomic<uint64_t> num_steals{0};
+        std::atomic<int64_t>  busy_us{0};
+    };
+
+    void push(Task task);
+    bool pop(uint32_t index, Task& task, bool& stolen);
+    bool run_pending_task();
+    void run(Worker& worker, Task& task);
+    void worker(uint32_t index);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    Worker                               m_callers;
+    std::vector<std::thread>             m_threads;
+    std::atomic<uint32_t>                m_next_queue{0};
+
+    // Idle workers sleep until the number of queued tasks is non-zero.
+    std::atomic<uint32_t>   m_num_queued{0};
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+    bool                    m_stopping = false;
+};